@@ -0,0 +1,149 @@
+/*
+ *  private/output/AsyncWriter.h
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaOutputAsyncWriter_h
+#define AvidaOutputAsyncWriter_h
+
+#include "apto/core/Thread.h"
+#include "apto/platform.h"
+#include "avida/output/Types.h"
+
+#include <cstdio>
+#include <streambuf>
+
+
+namespace Avida {
+  namespace Output {
+    
+    class AsyncFileBuffer;
+    
+    
+    // Output::AsyncWriter - background thread that performs file writes on behalf of output files
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // Files format into fixed size buffers drawn from a shared pool.  Full buffers are queued to the writer thread,
+    // which issues one large write per buffer.  The number of queued buffers is bounded by max_queued (UNBOUNDED for no
+    // limit); a file that submits to a full queue waits for the writer to catch up.  Aside from that back-pressure the
+    // simulation thread only waits at explicit sync points (Sync) and when reopening a path whose close is still pending.
+    // Failed writes and closes are recorded by path and handed to the user by ReportFailures.
+    
+    class AsyncWriter : public Apto::Thread, public Apto::RefCountObject<Apto::ThreadSafe>
+    {
+    public:
+      enum { UNBOUNDED = -1 };
+      
+    private:
+      enum OpType { OP_WRITE, OP_FLUSH, OP_CLOSE };
+      struct sOp
+      {
+        OpType type;
+        std::FILE* fp;
+        char* buf;
+        int len;
+        OutputID path;
+      };
+      
+      const int m_max_queued;
+      const int m_buffer_size;
+      
+      Apto::Mutex m_mutex;
+      Apto::ConditionVariable m_work_cond;    // signaled when operations are queued, or on shutdown
+      Apto::ConditionVariable m_retire_cond;  // signaled when the writer retires an operation
+      
+      Apto::Array<sOp> m_ops;                 // ring buffer of pending operations
+      int m_head;
+      int m_count;
+      int m_queued_buffers;
+      bool m_busy;
+      bool m_running;
+      bool m_shutdown;
+      
+      Apto::Array<char*> m_free_buffers;
+      Apto::Map<OutputID, int> m_closing;    // number of pending closes per path
+      Apto::Array<OutputID> m_failed;         // paths with failed output awaiting ReportFailures
+      
+      
+    public:
+      LIB_LOCAL AsyncWriter(int max_queued, int buffer_size);
+      LIB_LOCAL ~AsyncWriter();
+      
+      LIB_LOCAL inline int BufferSize() const { return m_buffer_size; }
+      
+      LIB_LOCAL AsyncFileBuffer* Open(const OutputID& path, bool append, bool binary = false);
+      
+      LIB_LOCAL char* AcquireBuffer();
+      LIB_LOCAL void ReleaseBuffer(char* buf);
+      
+      LIB_LOCAL void SubmitWrite(std::FILE* fp, const OutputID& path, char* buf, int len);
+      LIB_LOCAL void SubmitFlush(std::FILE* fp, const OutputID& path);
+      LIB_LOCAL void SubmitClose(std::FILE* fp, const OutputID& path);
+      
+      LIB_LOCAL void Sync();      // wait for all queued operations to reach the operating system
+      LIB_LOCAL void Shutdown();  // drain the queue and stop the thread, later submissions are performed inline
+      
+      // Report (once) each path whose output failed to reach the disk, to stderr when feedback is NULL
+      LIB_LOCAL void ReportFailures(Feedback* feedback);
+      
+    protected:
+      void Run();
+      
+    private:
+      LIB_LOCAL void submit(const sOp& op);
+      LIB_LOCAL bool perform(sOp& op);
+      LIB_LOCAL void recordFailure(const OutputID& path);
+    };
+    
+    typedef Apto::SmartPtr<AsyncWriter, Apto::InternalRCObject> AsyncWriterPtr;
+    
+    
+    // Output::AsyncFileBuffer - stream buffer that hands filled buffers off to an AsyncWriter
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // Installed as the stream buffer of an Output::File, so that all existing stream based output is captured.  Stream
+    // flushes (std::endl, etc.) are deliberately ignored; data is submitted when a buffer fills, on Flush, and on Close.
+    
+    class AsyncFileBuffer : public std::streambuf
+    {
+    private:
+      AsyncWriterPtr m_writer;
+      std::FILE* m_fp;
+      OutputID m_path;
+      char* m_buf;
+      
+    public:
+      LIB_LOCAL AsyncFileBuffer(AsyncWriterPtr writer, std::FILE* fp, const OutputID& path);
+      LIB_LOCAL ~AsyncFileBuffer();
+      
+      LIB_LOCAL void Flush();
+      LIB_LOCAL void Close();
+      
+    protected:
+      int_type overflow(int_type c);
+      int sync();
+      
+    private:
+      LIB_LOCAL void handOff();
+    };
+    
+  };
+};
+
+#endif
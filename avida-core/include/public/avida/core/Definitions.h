@@ -88,6 +88,12 @@ enum eDEATH_METHOD
   DEATH_METHOD_MULTIPLE
 };
 
+enum eRANDOM_GENERATOR
+{
+  RANDOM_GENERATOR_AVIDA = 0,
+  RANDOM_GENERATOR_PHILOX
+};
+
 enum eALLOC_METHOD
 {
   ALLOC_METHOD_DEFAULT = 0,
@@ -62,6 +62,7 @@ namespace Avida {
   public:
     LIB_EXPORT Genome();
     LIB_EXPORT Genome(HardwareTypeID hw, const PropertyMap& props, GeneticRepresentationPtr rep);
+    LIB_EXPORT Genome(HardwareTypeID hw, const Apto::String& inst_set, int inst_set_id, GeneticRepresentationPtr rep);
     LIB_EXPORT explicit Genome(const Apto::String& genome_str);
     LIB_EXPORT Genome(const Genome& genome);
     
@@ -69,6 +70,9 @@ namespace Avida {
     // Accessors
     LIB_EXPORT inline HardwareTypeID HardwareType() const { return m_hw_type; }
     
+    // Interned ID of the instruction set name (see cHardwareManager::InstSetNameID), -1 if none has been set
+    LIB_EXPORT inline int InstSetID() const { return m_props.InstSetID(); }
+    
     LIB_EXPORT inline PropertyMap& Properties() { assert(m_props.GetSize() > 0); return m_props; }
     LIB_EXPORT inline const PropertyMap& Properties() const { assert(m_props.GetSize() > 0); return m_props; }
     
@@ -109,11 +113,15 @@ namespace Avida {
     {
     private:
       StringProperty m_inst_set;
+      int m_inst_set_id;
       
     public:
       LIB_LOCAL InstSetPropertyMap();
       LIB_LOCAL ~InstSetPropertyMap();
       
+      LIB_LOCAL inline int InstSetID() const { return m_inst_set_id; }
+      LIB_LOCAL void SetInstSet(const Apto::String& name, int name_id);
+      
       LIB_LOCAL int GetSize() const;
       
       LIB_LOCAL bool operator==(const PropertyMap& p) const;
@@ -65,16 +65,31 @@ namespace Avida {
   // InstructionSequence - a series of bytes containing a base level genetic sequence
   // --------------------------------------------------------------------------------------------------------------
 
+  // Copies of a sequence share its instruction storage, which is reference counted and copied on the first write.  Genomes,
+  // genotypes and organism memories built from one offspring therefore hold a single copy until one of them changes.
+  // References returned by the non-const accessors must not be held across a copy of the sequence.
+
   class InstructionSequence : public GeneticRepresentation
   {
   protected:
-    Apto::Array<Instruction> m_seq;
+    class Storage : public Apto::RefCountObject<Apto::ThreadSafe>
+    {
+    public:
+      Apto::Array<Instruction> seq;
+      
+      inline Storage() { ; }
+      inline explicit Storage(int size) : seq(size) { ; }
+      inline Storage(const Storage& storage) : Apto::RefCountObject<Apto::ThreadSafe>(), seq(storage.seq) { ; }
+    };
+    typedef Apto::SmartPtr<Storage, Apto::InternalRCObject> StoragePtr;
+    
+    StoragePtr m_storage;
     int m_active_size;
     
   public:
-    LIB_EXPORT inline InstructionSequence() : m_active_size(0) { ; }
+    LIB_EXPORT inline InstructionSequence() : m_storage(new Storage), m_active_size(0) { ; }
     LIB_EXPORT InstructionSequence(const InstructionSequence& seq);
-    LIB_EXPORT inline explicit InstructionSequence(int size) : m_seq(size), m_active_size(size) { ; }
+    LIB_EXPORT inline explicit InstructionSequence(int size) : m_storage(new Storage(size)), m_active_size(size) { ; }
     LIB_EXPORT explicit InstructionSequence(const Apto::String& str);
     LIB_EXPORT virtual ~InstructionSequence();
     
@@ -82,8 +97,11 @@ namespace Avida {
     // Accessors
     LIB_EXPORT inline int GetSize() const { return m_active_size; }
     
-    LIB_EXPORT inline Instruction& operator[](int idx) { assert(idx >= 0 && idx < m_active_size);  return m_seq[idx]; }
-    LIB_EXPORT inline const Instruction& operator[](int idx) const { assert(idx >= 0 && idx < m_active_size);  return m_seq[idx]; }
+    LIB_EXPORT inline Instruction& operator[](int idx) { assert(idx >= 0 && idx < m_active_size);  return mutableSeq()[idx]; }
+    LIB_EXPORT inline const Instruction& operator[](int idx) const { assert(idx >= 0 && idx < m_active_size);  return seq()[idx]; }
+    
+    // Number of sequences currently sharing this sequence's instruction storage
+    LIB_EXPORT inline int GetShareCount() const { return m_storage->RefCount(); }
 
 
     // GeneticRepresentation Interface
@@ -139,6 +157,11 @@ namespace Avida {
     
     
   protected:
+    // Storage for reading, and storage for writing (a private copy is taken first if it is shared)
+    inline const Apto::Array<Instruction>& seq() const { return m_storage->seq; }
+    inline Apto::Array<Instruction>& mutableSeq() { if (m_storage->RefCount() != 1) copyStorage(); return m_storage->seq; }
+    LIB_EXPORT void copyStorage();
+    
     LIB_EXPORT virtual void adjustCapacity(int new_size);
     LIB_EXPORT virtual void prepareInsert(int pos, int num_sites);
   };
@@ -43,6 +43,18 @@ namespace Avida {
       typedef Apto::Set<Apto::String, Apto::DefaultHashBTree, Apto::Multi> ArgMultiSet;
       typedef Apto::SmartPtr<ArgMultiSet> ArgMultiSetPtr;
       
+      struct sResolvedID
+      {
+        DataID data_id;
+        ProviderPtr provider;
+        ArgumentedProviderPtr arg_provider;
+        DataID raw_id;
+        Argument argument;
+        int num_recorders;  // attached recorders requesting this id, the slot is free when zero
+        
+        sResolvedID() : num_recorders(0) { ; }
+      };
+      
     private:
       World* m_world;
       
@@ -61,8 +73,14 @@ namespace Avida {
       Apto::Map<DataID, ArgumentedProviderPtr> m_active_arg_provider_map;
       Apto::Map<DataID, ArgMultiSetPtr> m_active_args;
       
-      mutable Apto::Mutex m_current_value_mutex;
-      mutable Apto::Map<DataID, PackagePtr> m_current_values;
+      Apto::Array<sResolvedID> m_resolved;
+      Apto::Array<DataHandle> m_free_handles;
+      ConstDataHandleMapPtr m_handles;
+      
+      // Most recently published snapshot, holding one reference.  Swapped atomically so that readers never lock;
+      // m_snapshot_readers counts readers between loading the pointer and taking their own reference.
+      const Snapshot* volatile m_snapshot;
+      mutable volatile long m_snapshot_readers;
       
       static bool s_registered_with_facet_factory;
       
@@ -76,6 +94,9 @@ namespace Avida {
       
       LIB_EXPORT Apto::String Describe(const DataID& data_id) const;
       
+      LIB_EXPORT DataHandle HandleOf(const DataID& data_id) const;  // valid while a recorder requesting data_id is attached
+      LIB_EXPORT ConstSnapshotPtr CurrentSnapshot() const;
+      
       LIB_EXPORT bool AttachRecorder(RecorderPtr recorder, bool concurrent_update = false);
       LIB_EXPORT bool DetachRecorder(RecorderPtr recorder);
       
@@ -95,6 +116,11 @@ namespace Avida {
       
     public:
       LIB_LOCAL PackagePtr GetCurrentValue(const DataID& data_id) const;
+      
+    private:
+      LIB_LOCAL DataHandle resolveHandle(const DataID& data_id, DataHandleMap& handles);
+      LIB_LOCAL Snapshot* buildSnapshot(Update current_update) const;
+      LIB_LOCAL void publishSnapshot(const Snapshot* snapshot);
     };
     
   };
@@ -0,0 +1,68 @@
+/*
+ *  data/Snapshot.h
+ *  avida-core
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AvidaDataSnapshot_h
+#define AvidaDataSnapshot_h
+
+#include "apto/platform.h"
+#include "avida/core/Types.h"
+#include "avida/data/Types.h"
+
+
+namespace Avida {
+  namespace Data {
+    
+    // Data::Snapshot - immutable set of data values published by the manager for a single update
+    // --------------------------------------------------------------------------------------------------------------
+    //
+    // Values are stored densely by DataHandle.  A snapshot is fully populated before it is published and is never
+    // modified afterwards, so recorders may read from it without any locking.
+    
+    class Snapshot : public Apto::RefCountObject<Apto::ThreadSafe>
+    {
+      friend class Manager;
+    private:
+      Update m_update;
+      ConstDataHandleMapPtr m_handles;
+      Apto::Array<PackagePtr> m_values;
+      
+    public:
+      LIB_EXPORT ~Snapshot();
+      
+      LIB_EXPORT inline Update GetUpdate() const { return m_update; }
+      LIB_EXPORT inline int GetSize() const { return m_values.GetSize(); }
+      
+      LIB_EXPORT DataHandle HandleOf(const DataID& data_id) const;
+      
+      LIB_EXPORT inline PackagePtr GetValue(DataHandle handle) const
+      {
+        return (handle >= 0 && handle < m_values.GetSize()) ? m_values[handle] : PackagePtr();
+      }
+      LIB_EXPORT PackagePtr GetValueOf(const DataID& data_id) const;
+      
+    private:
+      LIB_LOCAL Snapshot(Update update, ConstDataHandleMapPtr handles, int num_values);
+    };
+    
+  };
+};
+
+#endif
@@ -38,12 +38,16 @@ namespace Avida {
     class Package;
     class Provider;    
     class Recorder;
+    class Snapshot;
 
     
     // Type Declarations
     // --------------------------------------------------------------------------------------------------------------
 
     typedef Apto::String DataID;
+    typedef int DataHandle; // Dense index of an active data id, resolved once when a recorder is attached
+    typedef Apto::Map<DataID, DataHandle> DataHandleMap;
+    typedef Apto::SmartPtr<const DataHandleMap, Apto::ThreadSafeRefCount> ConstDataHandleMapPtr;
     typedef Apto::SmartPtr<Provider, Apto::InternalRCObject> ProviderPtr;
     typedef Apto::Functor<ProviderPtr, Apto::TL::Create<World*>, SmallObjectMalloc> ProviderActivateFunctor;
     
@@ -66,6 +70,8 @@ namespace Avida {
     
     typedef Apto::Functor<PackagePtr, Apto::TL::Create<const DataID&>, SmallObjectMalloc> DataRetrievalFunctor;
     
+    typedef Apto::SmartPtr<const Snapshot, Apto::InternalRCObject> ConstSnapshotPtr;
+    
     typedef Apto::SmartPtr<Manager, Apto::InternalRCObject> ManagerPtr;
   };
 };
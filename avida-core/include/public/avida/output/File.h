@@ -34,6 +34,9 @@
 namespace Avida {
   namespace Output {
     
+    class AsyncFileBuffer;
+    
+    
     // Output::Socket - Protocol defining interface for output sockets that can be managed by the output manager
     // --------------------------------------------------------------------------------------------------------------
     
@@ -49,20 +52,35 @@ namespace Avida {
       int m_num_cols;
       
       std::ofstream m_fp;
+      AsyncFileBuffer* m_async_buf; // stream buffer feeding the manager's background writer, NULL when synchronous
 
       
     public:
       LIB_EXPORT inline static FilePtr CreateWithPath(World* world, Apto::String path, Feedback* feedback = NULL)
       {
-        return createWithPath(world, path, false, feedback);
+        return createWithPath(world, path, false, false, feedback);
       }
       
       LIB_EXPORT inline static FilePtr AppendWithPath(World* world, Apto::String path, Feedback* feedback = NULL)
       {
-        return createWithPath(world, path, true, feedback);
+        return createWithPath(world, path, true, false, feedback);
+      }
+      
+      LIB_EXPORT inline static FilePtr StaticWithPath(World* world, Apto::String path, Feedback* feedback = NULL)
+      {
+        return staticWithPath(world, path, false, feedback);
       }
       
-      LIB_EXPORT static FilePtr StaticWithPath(World* world, Apto::String path, Feedback* feedback = NULL);
+      // Binary variants open the file without newline translation, for formats such as binary grid dumps
+      LIB_EXPORT inline static FilePtr CreateBinaryWithPath(World* world, Apto::String path, Feedback* feedback = NULL)
+      {
+        return createWithPath(world, path, false, true, feedback);
+      }
+      
+      LIB_EXPORT inline static FilePtr StaticBinaryWithPath(World* world, Apto::String path, Feedback* feedback = NULL)
+      {
+        return staticWithPath(world, path, true, feedback);
+      }
       
       LIB_EXPORT ~File();
       
@@ -122,9 +140,10 @@ namespace Avida {
       
       
     private:
-      LIB_EXPORT static FilePtr createWithPath(World* world, Apto::String path, bool append, Feedback* feedback);
+      LIB_EXPORT static FilePtr createWithPath(World* world, Apto::String path, bool append, bool binary, Feedback* feedback);
+      LIB_EXPORT static FilePtr staticWithPath(World* world, Apto::String path, bool binary, Feedback* feedback);
 
-      LIB_LOCAL File(World* world, const OutputID& output_id, bool append = false);
+      LIB_LOCAL File(World* world, const OutputID& output_id, bool append = false, bool binary = false);
     };
     
 
@@ -33,11 +33,15 @@
 namespace Avida {
   namespace Output {
     
+    class AsyncWriter;
+    
+    
     // Output::Manager - Manages output sockets (files, etc.) and their identifiers
     // --------------------------------------------------------------------------------------------------------------
     
     class Manager : public WorldFacet
     {
+      friend class File;
       friend class Socket;
     private:
       World* m_world;
@@ -48,6 +52,8 @@ namespace Avida {
       Apto::Map<OutputID, SocketWeakRef> m_sockets;
       Apto::Map<OutputID, SocketPtr> m_static_sockets;
       
+      Apto::SmartPtr<AsyncWriter, Apto::InternalRCObject> m_writer;
+      
     public:
       LIB_EXPORT Manager(const Apto::String& output_path);
       LIB_EXPORT ~Manager();
@@ -59,7 +65,12 @@ namespace Avida {
       LIB_EXPORT bool IsOpen(const OutputID& output_id) const;
       LIB_EXPORT bool Close(const OutputID& output_id);
       
-      LIB_EXPORT void FlushAll();
+      LIB_EXPORT void FlushAll(); // Sync point: returns once all output has been handed to the operating system
+      
+      // Route files opened from here on through a background writer thread.  max_queued bounds the number of filled
+      // buffers awaiting the writer (the simulation waits when full), use -1 for an unbounded queue.
+      LIB_EXPORT bool StartAsyncWriter(int max_queued, int buffer_size);
+      LIB_EXPORT inline bool IsAsync() const { return (m_writer) ? true : false; }
       
       LIB_EXPORT bool AttachTo(World* world);
       LIB_EXPORT static ManagerPtr Of(World* world);
@@ -70,6 +81,7 @@ namespace Avida {
     public:
       LIB_LOCAL WorldFacetID UpdateBefore() const;
       LIB_LOCAL WorldFacetID UpdateAfter() const;
+      LIB_LOCAL void PerformUpdate(Context& ctx, Update current_update);
       
     private:
       LIB_EXPORT bool RegisterSocket(const OutputID& output_id, SocketWeakRef socket_ref);
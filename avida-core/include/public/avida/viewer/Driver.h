@@ -59,6 +59,7 @@ namespace Avida {
       bool m_done;
       bool m_paused;
       bool m_sync_mode;
+      bool m_map_refresh;
       
       Update m_pause_at;
       
@@ -104,6 +105,8 @@ namespace Avida {
       LIB_EXPORT inline int PendingInjectCount() const { return m_inject_queue.GetSize(); }
       LIB_EXPORT const InjectGenomeInfo PendingInject(int idx) const;
 
+      LIB_EXPORT void RefreshMap();
+      
       LIB_EXPORT void AttachListener(Listener* listener);
       LIB_EXPORT void DetachListener(Listener* listener);
 
@@ -156,6 +159,9 @@ namespace Avida {
     protected:
       LIB_LOCAL void Run();
       
+    private:
+      LIB_LOCAL void notifyMap();
+      
       
       // Private Implementation Details
       // ------------------------------------------------------------------------------------------------------------  
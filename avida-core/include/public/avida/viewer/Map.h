@@ -25,6 +25,7 @@
 #define AvidaViewerMap_h
 
 #include "apto/core.h"
+#include "avida/viewer/Types.h"
 
 class cPopulation;
 class cWorld;
@@ -87,7 +88,75 @@ namespace Avida {
       virtual bool SetProperty(const Apto::String& property, const Apto::String& value) = 0;
       virtual Apto::String GetProperty(const Apto::String& property) const = 0;
       
-      virtual void Update(cPopulation& pop) = 0;
+      // Update the mode from the population.  changed_cells lists the cells whose organism was replaced or has divided
+      // since the previous call, or is NULL when every cell must be recomputed.
+      virtual void Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>* changed_cells) = 0;
+    };
+    
+    
+    // MapLayer Definition
+    // --------------------------------------------------------------------------------------------------------------  
+    
+    class MapLayer : public DiscreteScale
+    {
+      friend class Map;
+    private:
+      int m_mode;
+      Apto::Array<int> m_values;
+      Apto::Array<int> m_counts;
+      Apto::Array<Entry> m_entries;
+      int m_scale_range;
+      bool m_categorical;
+      Apto::String m_scale_label;
+      
+    public:
+      MapLayer() : m_mode(-1), m_scale_range(0), m_categorical(false) { ; }
+      ~MapLayer() { ; }
+      
+      inline int GetMode() const { return m_mode; }
+      inline const Apto::Array<int>& GetValues() const { return m_values; }
+      inline const Apto::Array<int>& GetCounts() const { return m_counts; }
+      inline const Apto::String& GetScaleLabel() const { return m_scale_label; }
+      
+      // DiscreteScale Interface
+      int GetScaleRange() const { return m_scale_range; }
+      int GetNumLabeledEntries() const { return m_entries.GetSize(); }
+      Entry GetEntry(int index) const { return m_entries[index]; }
+      bool IsCategorical() const { return m_categorical; }
+    };
+    
+    
+    // MapSnapshot Definition
+    // --------------------------------------------------------------------------------------------------------------  
+    //
+    // Immutable copy of the displayed map layers for a single update.  A snapshot is fully built before it is published
+    // and is never modified afterwards, so the viewer may hold and read it while the next update is being computed.
+    
+    class MapSnapshot : public Apto::RefCountObject<Apto::ThreadSafe>
+    {
+      friend class Map;
+    private:
+      int m_update;
+      int m_width;
+      int m_height;
+      int m_num_organisms;
+      
+      MapLayer m_color;
+      MapLayer m_symbol;
+      MapLayer m_tag;
+      
+    public:
+      MapSnapshot() : m_update(-1), m_width(0), m_height(0), m_num_organisms(0) { ; }
+      ~MapSnapshot() { ; }
+      
+      inline int GetUpdate() const { return m_update; }
+      inline int GetWidth() const { return m_width; }
+      inline int GetHeight() const { return m_height; }
+      inline int GetNumOrganisms() const { return m_num_organisms; }
+      
+      inline const MapLayer& GetColorLayer() const { return m_color; }
+      inline const MapLayer& GetSymbolLayer() const { return m_symbol; }
+      inline const MapLayer& GetTagLayer() const { return m_tag; }
     };
     
     
@@ -97,25 +166,36 @@ namespace Avida {
     class Map
     {
     protected:
+      cWorld* m_world;
+      Driver* m_driver;
       int m_width;
       int m_height;
       int m_num_viewer_colors;
       
       Apto::Array<MapMode*> m_view_modes;  // List of view modes...
+      Apto::Array<bool> m_mode_current;    // Mode was updated for the most recent update
       int m_color_mode;      // Current map color mode (index into m_view_modes, -1 = off)
       int m_symbol_mode;     // Current map symbol mode (index into m_view_modes, -1 = off)
       int m_tag_mode;        // Current map tag mode (index into m_view_modes, -1 = off)
       
-      Apto::RWLock m_rw_lock;
+      Apto::Mutex m_mode_mutex;            // Guards the view modes and their state, never held by snapshot readers
+      
+      Apto::Array<int> m_cell_org_ids;     // Organism in each cell at the last update, -1 = empty
+      Apto::Array<int> m_cell_divides;     // Divide count of that organism at the last update
+      Apto::Array<int, Apto::Smart> m_changed_cells;
+      
+      mutable Apto::Mutex m_snapshot_mutex;
+      ConstMapSnapshotPtr m_snapshot;
+      ConstMapSnapshotPtr m_retained;
       
       
     public:
-      Map(cWorld* world);
+      Map(cWorld* world, Driver* driver);
       ~Map();
       
       
-      inline int GetWidth() const { return m_width; }
-      inline int GetHeight() const { return m_height; }
+      inline int GetWidth() const { return (m_retained) ? m_retained->GetWidth() : m_width; }
+      inline int GetHeight() const { return (m_retained) ? m_retained->GetHeight() : m_height; }
       
       
       inline int GetColorMode() const { return m_color_mode; }
@@ -123,21 +203,58 @@ namespace Avida {
       inline int GetTagMode() const { return m_tag_mode; }
       
       
-      inline const Apto::Array<int>& GetColors() const { return m_view_modes[m_color_mode]->GetGridValues(); }
-      inline const Apto::Array<int>& GetSymbols() const { return m_view_modes[m_symbol_mode]->GetGridValues(); }
-      inline const Apto::Array<int>& GetTags() const { return m_view_modes[m_tag_mode]->GetGridValues(); }
+      // Layer accessors read from the snapshot held by Retain, or from the live view modes when nothing is retained
+      inline const Apto::Array<int>& GetColors() const
+      {
+        return (m_retained) ? m_retained->GetColorLayer().GetValues() : m_view_modes[m_color_mode]->GetGridValues();
+      }
+      inline const Apto::Array<int>& GetSymbols() const
+      {
+        return (m_retained) ? m_retained->GetSymbolLayer().GetValues() : m_view_modes[m_symbol_mode]->GetGridValues();
+      }
+      inline const Apto::Array<int>& GetTags() const
+      {
+        return (m_retained) ? m_retained->GetTagLayer().GetValues() : m_view_modes[m_tag_mode]->GetGridValues();
+      }
       
-      inline const Apto::Array<int>& GetColorCounts() const { return m_view_modes[m_color_mode]->GetValueCounts(); }
-      inline const Apto::Array<int>& GetSymbolCounts() const { return m_view_modes[m_symbol_mode]->GetValueCounts(); }
-      inline const Apto::Array<int>& GetTagCounts() const { return m_view_modes[m_tag_mode]->GetValueCounts(); }
+      inline const Apto::Array<int>& GetColorCounts() const
+      {
+        return (m_retained) ? m_retained->GetColorLayer().GetCounts() : m_view_modes[m_color_mode]->GetValueCounts();
+      }
+      inline const Apto::Array<int>& GetSymbolCounts() const
+      {
+        return (m_retained) ? m_retained->GetSymbolLayer().GetCounts() : m_view_modes[m_symbol_mode]->GetValueCounts();
+      }
+      inline const Apto::Array<int>& GetTagCounts() const
+      {
+        return (m_retained) ? m_retained->GetTagLayer().GetCounts() : m_view_modes[m_tag_mode]->GetValueCounts();
+      }
       
-      inline const DiscreteScale& GetColorScale() const { return m_view_modes[m_color_mode]->GetScale(); }
-      inline const DiscreteScale& GetSymbolScale() const { return m_view_modes[m_symbol_mode]->GetScale(); }
-      inline const DiscreteScale& GetTagScale() const { return m_view_modes[m_tag_mode]->GetScale(); }
+      inline const DiscreteScale& GetColorScale() const
+      {
+        return (m_retained) ? static_cast<const DiscreteScale&>(m_retained->GetColorLayer()) : m_view_modes[m_color_mode]->GetScale();
+      }
+      inline const DiscreteScale& GetSymbolScale() const
+      {
+        return (m_retained) ? static_cast<const DiscreteScale&>(m_retained->GetSymbolLayer()) : m_view_modes[m_symbol_mode]->GetScale();
+      }
+      inline const DiscreteScale& GetTagScale() const
+      {
+        return (m_retained) ? static_cast<const DiscreteScale&>(m_retained->GetTagLayer()) : m_view_modes[m_tag_mode]->GetScale();
+      }
       
-      inline const Apto::String& GetColorScaleLabel() const { return m_view_modes[m_color_mode]->GetScaleLabel(); }
-      inline const Apto::String& GetSymbolScaleLabel() const { return m_view_modes[m_symbol_mode]->GetScaleLabel(); }
-      inline const Apto::String& GetTagScaleLabel() const { return m_view_modes[m_tag_mode]->GetScaleLabel(); }
+      inline const Apto::String& GetColorScaleLabel() const
+      {
+        return (m_retained) ? m_retained->GetColorLayer().GetScaleLabel() : m_view_modes[m_color_mode]->GetScaleLabel();
+      }
+      inline const Apto::String& GetSymbolScaleLabel() const
+      {
+        return (m_retained) ? m_retained->GetSymbolLayer().GetScaleLabel() : m_view_modes[m_symbol_mode]->GetScaleLabel();
+      }
+      inline const Apto::String& GetTagScaleLabel() const
+      {
+        return (m_retained) ? m_retained->GetTagLayer().GetScaleLabel() : m_view_modes[m_tag_mode]->GetScaleLabel();
+      }
       
       inline int GetNumModes() const { return m_view_modes.GetSize(); }
       inline const Apto::String& GetModeName(int idx) const { return m_view_modes[idx]->GetName(); }
@@ -149,8 +266,12 @@ namespace Avida {
       inline void SetNumViewerColors(int num_colors) { m_num_viewer_colors = num_colors; }
       
       
-      inline void Retain() { m_rw_lock.ReadLock(); }
-      inline void Release() { m_rw_lock.ReadUnlock(); }
+      // Most recently published snapshot, may be held for as long as needed
+      ConstMapSnapshotPtr CurrentSnapshot() const;
+      
+      // Pin the current snapshot for the layer accessors above (viewer thread only)
+      inline void Retain() { m_retained = CurrentSnapshot(); }
+      inline void Release() { m_retained = ConstMapSnapshotPtr(); }
       
       
       // Core Viewer Internal Methods
@@ -158,7 +279,10 @@ namespace Avida {
       
       
     protected:
-      void updateMap(cPopulation& pop, int map_id);
+      void findChangedCells(cPopulation& pop, bool& full);
+      MapSnapshot* buildSnapshot(int update, int num_organisms) const;
+      void fillLayer(MapLayer& layer, int mode) const;
+      void publishSnapshot(ConstMapSnapshotPtr snapshot);
     };
     
   };
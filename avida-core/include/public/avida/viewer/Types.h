@@ -44,6 +44,7 @@ namespace Avida {
     class HardwareSnapshot;
     class Listener;
     class Map;
+    class MapSnapshot;
     class OrganismTrace;
     
     
@@ -54,6 +55,7 @@ namespace Avida {
     typedef Apto::SmartPtr<Graphic> GraphicPtr;
     typedef Apto::SmartPtr<const Graphic> ConstGraphicPtr;
     typedef Apto::SmartPtr<OrganismTrace> OrganismTracePtr;
+    typedef Apto::SmartPtr<const MapSnapshot, Apto::InternalRCObject> ConstMapSnapshotPtr;
     
 
     // Enumerations
@@ -1529,7 +1529,7 @@ public:
       // count the number of target instructions in the genome
       ConstInstructionSequencePtr seq;
       seq.DynamicCastFrom(cell.GetOrganism()->GetGenome().Representation());
-			count = seq->CountInst(m_world->GetHardwareManager().GetInstSet(cell.GetOrganism()->GetGenome().Properties().Get("instset").StringValue()).GetInst(m_inst));
+			count = seq->CountInst(m_world->GetHardwareManager().GetInstSet(cell.GetOrganism()->GetGenome()).GetInst(m_inst));
       
       // decide if it should be killed or not, based on the count and a the kill probability
       if (count >= m_limit) {
@@ -1591,9 +1591,9 @@ public:
 			// get the number of instructions of each type.
       ConstInstructionSequencePtr seq;
       seq.DynamicCastFrom(cell.GetOrganism()->GetGenome().Representation());
-      Apto::String instset(cell.GetOrganism()->GetGenome().Properties().Get("instset").StringValue());
-			count1 = seq->CountInst(m_world->GetHardwareManager().GetInstSet(instset).GetInst(m_inst1));
-			count2 = seq->CountInst(m_world->GetHardwareManager().GetInstSet(instset).GetInst(m_inst2));
+      const cInstSet& instset = m_world->GetHardwareManager().GetInstSet(cell.GetOrganism()->GetGenome());
+			count1 = seq->CountInst(instset.GetInst(m_inst1));
+			count2 = seq->CountInst(instset.GetInst(m_inst2));
 			
 			// decide if it should be killed or not, based on the two counts and a the kill probability
 			if ((count1 >= m_limit) && (count2 >= m_limit)) {
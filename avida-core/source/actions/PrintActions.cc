@@ -42,6 +42,7 @@
 #include "cAnalyzeGenotype.h"
 #include "cCPUTestInfo.h"
 #include "cEnvironment.h"
+#include "cGridDump.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
 #include "cHistogram.h"
@@ -857,7 +858,7 @@ public:
     const int num_cells = population.GetSize();
     for (int x = 0; x < num_cells; x++) {
       cPopulationCell& cell = population.GetCell(x);
-      if (cell.IsOccupied() && cell.GetOrganism()->GetGenome().Properties().Get("instset").StringValue() == is.GetInstSetName()) {
+      if (cell.IsOccupied() && &m_world->GetHardwareManager().GetInstSet(cell.GetOrganism()->GetGenome()) == &is) {
         // access this CPU's code block
         cCPUMemory& cpu_mem = cell.GetOrganism()->GetHardware().GetMemory();
         const int mem_size = cpu_mem.GetSize();
@@ -3321,33 +3322,94 @@ private:
 };
 
 
+// Grid dump output shared by the numeric Dump*Grid actions.  Each accepts an optional "format=text|binary|binary-lz"
+// word anywhere in its argument list; the binary formats write a cGridDump frame in place of whitespace separated rows.
+// A grid holding several world-sized layers is written as a 3D frame (text dumps separate the layers by a blank line).
+static cGridDump::eFormat popGridDumpFormat(cString& args, Feedback& feedback)
+{
+  cGridDump::eFormat format = cGridDump::FORMAT_TEXT;
+  cString remaining;
+  while (args.GetSize()) {
+    cString word = args.PopWord();
+    if (!word.GetSize()) continue;
+    if (word.IsSubstring("format=", 0)) {
+      cString format_name = word.Substring(7, word.GetSize() - 7);
+      if (!cGridDump::ParseFormat(format_name, format)) {
+        feedback.Warning("unknown grid dump format '%s', using text", (const char*)format_name);
+        format = cGridDump::FORMAT_TEXT;
+      }
+    } else {
+      if (remaining.GetSize()) remaining += " ";
+      remaining += word;
+    }
+  }
+  args = remaining;
+  return format;
+}
+
+static Avida::Output::FilePtr openGridDump(cWorld* world, const cString& filename, cGridDump::eFormat format, bool is_static)
+{
+  if (format == cGridDump::FORMAT_TEXT) {
+    if (is_static) return Avida::Output::File::StaticWithPath(world->GetNewWorld(), (const char*)filename);
+    return Avida::Output::File::CreateWithPath(world->GetNewWorld(), (const char*)filename);
+  }
+  if (is_static) return Avida::Output::File::StaticBinaryWithPath(world->GetNewWorld(), (const char*)filename);
+  return Avida::Output::File::CreateBinaryWithPath(world->GetNewWorld(), (const char*)filename);
+}
+
+template <typename T>
+static void writeGridDump(cWorld* world, const cString& filename, cGridDump::eFormat format, const Apto::Array<T>& grid,
+                          bool is_static = false)
+{
+  const int world_x = world->GetPopulation().GetWorldX();
+  const int world_y = world->GetPopulation().GetWorldY();
+  const int num_layers = grid.GetSize() / (world_x * world_y);
+  assert(num_layers * world_x * world_y == grid.GetSize());
+  
+  Avida::Output::FilePtr df = openGridDump(world, filename, format, is_static);
+  if (!df) return;
+  ofstream& fp = df->OFStream();
+  
+  if (format == cGridDump::FORMAT_TEXT) {
+    for (int k = 0; k < num_layers; k++) {
+      if (k > 0) fp << endl;
+      for (int j = 0; j < world_y; j++) {
+        for (int i = 0; i < world_x; i++) fp << grid[(k * world_y + j) * world_x + i] << " ";
+        fp << endl;
+      }
+    }
+  } else {
+    cGridDump::WriteFrame(fp, world->GetStats().GetUpdate(), world_x, world_y, num_layers, grid,
+                          format == cGridDump::FORMAT_BINARY_LZ);
+  }
+}
+
+
 class cActionDumpEnergyGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpEnergyGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpEnergyGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_energy.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    for (int i = 0; i < m_world->GetPopulation().GetWorldY(); i++) {
-      for (int j = 0; j < m_world->GetPopulation().GetWorldX(); j++) {
-        cPopulationCell& cell = m_world->GetPopulation().GetCell(i * m_world->GetPopulation().GetWorldX() + j);
-        double cell_energy = (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().GetStoredEnergy() : 0.0;
-        fp << cell_energy << " ";
-      }
-      fp << endl;
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<double> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      cPopulationCell& cell = pop.GetCell(cell_id);
+      grid[cell_id] = (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().GetStoredEnergy() : 0.0;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -3355,29 +3417,27 @@ class cActionDumpExecutionRatioGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpExecutionRatioGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpExecutionRatioGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_exe_ratio.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    for (int i = 0; i < m_world->GetPopulation().GetWorldY(); i++) {
-      for (int j = 0; j < m_world->GetPopulation().GetWorldX(); j++) {
-        cPopulationCell& cell = m_world->GetPopulation().GetCell(i * m_world->GetPopulation().GetWorldX() + j);
-        double cell_executionRatio = (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().GetEnergyUsageRatio() : 1.0;
-        fp << cell_executionRatio << " ";
-      }
-      fp << endl;
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<double> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      cPopulationCell& cell = pop.GetCell(cell_id);
+      grid[cell_id] = (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().GetEnergyUsageRatio() : 1.0;
     }
+    writeGridDump(m_world, filename, m_format, grid, true);
   }
 };
 
@@ -3385,29 +3445,26 @@ class cActionDumpCellDataGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpCellDataGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpCellDataGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_cell_data.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    for (int i = 0; i < m_world->GetPopulation().GetWorldY(); i++) {
-      for (int j = 0; j < m_world->GetPopulation().GetWorldX(); j++) {
-        cPopulationCell& cell = m_world->GetPopulation().GetCell(i * m_world->GetPopulation().GetWorldX() + j);
-        double cell_data = cell.GetCellData();
-        fp << cell_data << " ";
-      }
-      fp << endl;
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<double> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      grid[cell_id] = pop.GetCell(cell_id).GetCellData();
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -3415,29 +3472,27 @@ class cActionDumpFitnessGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpFitnessGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpFitnessGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_fitness-%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
-      for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
-        cPopulationCell& cell = m_world->GetPopulation().GetCell(j * m_world->GetPopulation().GetWorldX() + i);
-        double fitness = (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().GetFitness() : 0.0;
-        fp << fitness << " ";
-      }
-      fp << endl;
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<double> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      cPopulationCell& cell = pop.GetCell(cell_id);
+      grid[cell_id] = (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().GetFitness() : 0.0;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -3447,31 +3502,29 @@ class cActionDumpClassificationIDGrid : public cAction
 private:
   cString m_filename;
   cString m_role;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpClassificationIDGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename(""), m_role("genotype")
+  cActionDumpClassificationIDGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_role("genotype"), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
     if (largs.GetSize()) m_role = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname_prefix='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname_prefix=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename = "grid_class_id";
     filename.Set("%s-%d.dat", (const char*)filename, m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
-      for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
-        cPopulationCell& cell = m_world->GetPopulation().GetCell(j * m_world->GetPopulation().GetWorldX() + i);
-        int id = (cell.IsOccupied() && cell.GetOrganism()->SystematicsGroup((const char*)m_role)) ? cell.GetOrganism()->SystematicsGroup((const char*)m_role)->ID() : -1;
-        fp << id << " ";
-      }
-      fp << endl;
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<int> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      cPopulationCell& cell = pop.GetCell(cell_id);
+      grid[cell_id] = (cell.IsOccupied() && cell.GetOrganism()->SystematicsGroup((const char*)m_role)) ? cell.GetOrganism()->SystematicsGroup((const char*)m_role)->ID() : -1;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -3482,12 +3535,14 @@ private:
   int m_threshold;
   cString m_filename;
   Apto::Array<int> m_genotype_chart;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpGenotypeColorGrid(cWorld* world, const cString& args, Feedback&)
-  : cAction(world, args), m_num_colors(12), m_threshold(10), m_filename(""), m_genotype_chart(0)
+  cActionDumpGenotypeColorGrid(cWorld* world, const cString& args, Feedback& feedback)
+  : cAction(world, args), m_num_colors(12), m_threshold(10), m_filename(""), m_genotype_chart(0), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_num_colors = largs.PopWord().AsInt();
     if (largs.GetSize()) m_threshold = largs.PopWord().AsInt();
     if (largs.GetSize()) m_filename = largs.PopWord();
@@ -3495,7 +3550,7 @@ public:
     m_genotype_chart.Resize(m_num_colors, 0);
   }
   
-  static const cString GetDescription() { return "Arguments: [int num_colors=12] [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [int num_colors=12] [string fname=''] [format=text]"; }
   
   void Process(cAvidaContext&)
   {
@@ -3521,24 +3576,21 @@ public:
     
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_genotype_color-%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
-      for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
-        cPopulationCell& cell = m_world->GetPopulation().GetCell(j * m_world->GetPopulation().GetWorldX() + i);
-        Systematics::GroupPtr bg = (cell.IsOccupied()) ? cell.GetOrganism()->SystematicsGroup("genotype") : Systematics::GroupPtr(NULL);
-        if (bg) {
-          int color = 0;
-          for (; color < m_num_colors; color++) if (m_genotype_chart[color] == bg->ID()) break;
-          if (color == m_num_colors && (bool)Apto::StrAs(bg->Properties().Get("threshold"))) color++;
-          fp << color << " ";
-        } else {
-          fp << "-1 ";
-        }
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<int> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      cPopulationCell& cell = pop.GetCell(cell_id);
+      Systematics::GroupPtr bg = (cell.IsOccupied()) ? cell.GetOrganism()->SystematicsGroup("genotype") : Systematics::GroupPtr(NULL);
+      if (bg) {
+        int color = 0;
+        for (; color < m_num_colors; color++) if (m_genotype_chart[color] == bg->ID()) break;
+        if (color == m_num_colors && (bool)Apto::StrAs(bg->Properties().Get("threshold"))) color++;
+        grid[cell_id] = color;
+      } else {
+        grid[cell_id] = -1;
       }
-      fp << endl;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
   
 private:
@@ -3569,29 +3621,27 @@ class cActionDumpPhenotypeIDGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpPhenotypeIDGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpPhenotypeIDGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_phenotype_id.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
-      for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
-        cPopulationCell& cell = m_world->GetPopulation().GetCell(j * m_world->GetPopulation().GetWorldX() + i);
-        int id = (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().CalcID() : -1;
-        fp << id << " ";
-      }
-      fp << endl;
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<int> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      cPopulationCell& cell = pop.GetCell(cell_id);
+      grid[cell_id] = (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().CalcID() : -1;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -3599,29 +3649,27 @@ class cActionDumpIDGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpIDGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpIDGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();  
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("id_grid.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
-      for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
-        cPopulationCell& cell = m_world->GetPopulation().GetCell(j * m_world->GetPopulation().GetWorldX() + i);
-        int id = (cell.IsOccupied()) ? cell.GetOrganism()->GetID() : -1;
-        fp << id << " ";
-      }
-      fp << endl;
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<int> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      cPopulationCell& cell = pop.GetCell(cell_id);
+      grid[cell_id] = (cell.IsOccupied()) ? cell.GetOrganism()->GetID() : -1;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -3629,29 +3677,27 @@ class cActionDumpVitalityGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpVitalityGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpVitalityGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();  
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_dumps/vitality_grid.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
-      for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
-        cPopulationCell& cell = m_world->GetPopulation().GetCell(j * m_world->GetPopulation().GetWorldX() + i);
-        double id = (cell.IsOccupied()) ? cell.GetOrganism()->GetVitality() : -1;
-        fp << id << " ";
-      }
-      fp << endl;
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<double> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      cPopulationCell& cell = pop.GetCell(cell_id);
+      grid[cell_id] = (cell.IsOccupied()) ? cell.GetOrganism()->GetVitality() : -1;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -3659,53 +3705,46 @@ class cActionDumpTargetGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpTargetGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpTargetGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();  
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
-    const int worldx = m_world->GetPopulation().GetWorldX();
+    cPopulation& pop = m_world->GetPopulation();
     cString filename(m_filename);
+    Apto::Array<int> grid(pop.GetWorldX() * pop.GetWorldY());
     
     if (m_world->GetConfig().USE_AVATARS.Get()) {
       if (filename == "") filename.Set("grid_dumps/avatar_grid.%d.dat", m_world->GetStats().GetUpdate());
-      Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-      ofstream& fp = df->OFStream();
       
-      for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
-        for (int i = 0; i < worldx; i++) {
-          cPopulationCell& cell = m_world->GetPopulation().GetCell(j * worldx + i);
-          int target = -99;
-          if (cell.HasAV()) {
-            if (cell.HasPredAV()) target = cell.GetRandPredAV()->GetForageTarget();
-            else target = cell.GetRandPreyAV()->GetForageTarget();
-          } 
-          fp << target << " ";
-        }
-        fp << endl;
+      for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+        cPopulationCell& cell = pop.GetCell(cell_id);
+        int target = -99;
+        if (cell.HasAV()) {
+          if (cell.HasPredAV()) target = cell.GetRandPredAV()->GetForageTarget();
+          else target = cell.GetRandPreyAV()->GetForageTarget();
+        } 
+        grid[cell_id] = target;
       }
     }    
     
     else {
       if (filename == "") filename.Set("grid_dumps/target_grid.%d.dat", m_world->GetStats().GetUpdate());
-      Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-      ofstream& fp = df->OFStream();
       
-      for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
-        for (int i = 0; i < worldx; i++) {
-          cPopulationCell& cell = m_world->GetPopulation().GetCell(j * worldx + i);
-          int target = -99;
-          if (cell.IsOccupied()) target = cell.GetOrganism()->GetForageTarget();
-          fp << target << " ";
-        }
-        fp << endl;
+      for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+        cPopulationCell& cell = pop.GetCell(cell_id);
+        grid[cell_id] = (cell.IsOccupied()) ? cell.GetOrganism()->GetForageTarget() : -99;
       }
     }
+    
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -3714,24 +3753,26 @@ class cActionDumpMaxResGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpMaxResGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpMaxResGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();  
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext& ctx)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_dumps/max_res_grid.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
     
+    const int world_x = m_world->GetPopulation().GetWorldX();
+    Apto::Array<double> grid(world_x * m_world->GetPopulation().GetWorldY());
     for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
-      for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
-        const Apto::Array<double> res_count = m_world->GetPopulation().GetCellResources(j * m_world->GetPopulation().GetWorldX() + i, ctx);
+      for (int i = 0; i < world_x; i++) {
+        const Apto::Array<double> res_count = m_world->GetPopulation().GetCellResources(j * world_x + i, ctx);
         double max_resource = 0.0;    
         // get the resource library
         const cResourceLib& resource_lib = m_world->GetEnvironment().GetResourceLib();
@@ -3751,10 +3792,10 @@ public:
           }
         }
         max_resource = max_resource + topo_height;
-        fp << max_resource << " ";
+        grid[j * world_x + i] = max_resource;
       }
-      fp << endl;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -3763,29 +3804,27 @@ class cActionDumpSleepGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpSleepGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpSleepGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_sleep.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    for (int i = 0; i < m_world->GetPopulation().GetWorldY(); i++) {
-      for (int j = 0; j < m_world->GetPopulation().GetWorldX(); j++) {
-        cPopulationCell& cell = m_world->GetPopulation().GetCell(i * m_world->GetPopulation().GetWorldX() + j);
-        double cell_energy = (cell.IsOccupied()) ? cell.GetOrganism()->IsSleeping() : 0.0;
-        fp << cell_energy << " ";
-      }
-      fp << endl;
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<double> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      cPopulationCell& cell = pop.GetCell(cell_id);
+      grid[cell_id] = (cell.IsOccupied()) ? cell.GetOrganism()->IsSleeping() : 0.0;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -3794,39 +3833,83 @@ class cActionDumpGenomeLengthGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpGenomeLengthGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpGenomeLengthGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_genome_length.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    cPopulation* pop = &m_world->GetPopulation();
-    
-    for (int j = 0; j < pop->GetWorldY(); j++) {
-      for (int i = 0; i < pop->GetWorldX(); i++) {
-        int genome_length = 0;
-        int cell_num = j * pop->GetWorldX() + i;
-        if (pop->GetCell(cell_num).IsOccupied() == true)
-        {
-          cOrganism* organism = pop->GetCell(cell_num).GetOrganism();
-          ConstInstructionSequencePtr seq;
-          seq.DynamicCastFrom(organism->GetGenome().Representation());
-          genome_length = seq->GetSize();
-        }
-        else { genome_length = -1; }
-        fp << genome_length << " ";
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<int> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      int genome_length = -1;
+      if (pop.GetCell(cell_id).IsOccupied() == true) {
+        cOrganism* organism = pop.GetCell(cell_id).GetOrganism();
+        ConstInstructionSequencePtr seq;
+        seq.DynamicCastFrom(organism->GetGenome().Representation());
+        genome_length = seq->GetSize();
       }
-      fp << endl;
+      grid[cell_id] = genome_length;
+    }
+    writeGridDump(m_world, filename, m_format, grid);
+  }
+};
+
+
+// Dumps one layer per organism property, in the order: organism ID, genotype ID, fitness, merit, gestation time, genome
+// length, age, generation.  Empty cells hold -1 in every layer.
+class cActionDumpPopulationGrid : public cAction
+{
+private:
+  cString m_filename;
+  cGridDump::eFormat m_format;
+  
+  enum { LAYER_ID = 0, LAYER_GENOTYPE, LAYER_FITNESS, LAYER_MERIT, LAYER_GESTATION, LAYER_LENGTH, LAYER_AGE,
+         LAYER_GENERATION, NUM_LAYERS };
+  
+public:
+  cActionDumpPopulationGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
+  {
+    cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
+    if (largs.GetSize()) m_filename = largs.PopWord();
+  }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
+  void Process(cAvidaContext&)
+  {
+    cString filename(m_filename);
+    if (filename == "") filename.Set("grid_population.%d.dat", m_world->GetStats().GetUpdate());
+    cPopulation& pop = m_world->GetPopulation();
+    const int num_cells = pop.GetWorldX() * pop.GetWorldY();
+    Apto::Array<double> grid(num_cells * NUM_LAYERS);
+    grid.SetAll(-1.0);
+    for (int cell_id = 0; cell_id < num_cells; cell_id++) {
+      cPopulationCell& cell = pop.GetCell(cell_id);
+      if (!cell.IsOccupied()) continue;
+      cOrganism* organism = cell.GetOrganism();
+      cPhenotype& phenotype = organism->GetPhenotype();
+      Systematics::GroupPtr genotype = organism->SystematicsGroup("genotype");
+      ConstInstructionSequencePtr seq;
+      seq.DynamicCastFrom(organism->GetGenome().Representation());
+      
+      grid[LAYER_ID * num_cells + cell_id] = organism->GetID();
+      grid[LAYER_GENOTYPE * num_cells + cell_id] = (genotype) ? genotype->ID() : -1;
+      grid[LAYER_FITNESS * num_cells + cell_id] = phenotype.GetFitness();
+      grid[LAYER_MERIT * num_cells + cell_id] = phenotype.GetMerit().GetDouble();
+      grid[LAYER_GESTATION * num_cells + cell_id] = phenotype.GetGestationTime();
+      grid[LAYER_LENGTH * num_cells + cell_id] = (seq) ? seq->GetSize() : -1;
+      grid[LAYER_AGE * num_cells + cell_id] = phenotype.GetAge();
+      grid[LAYER_GENERATION * num_cells + cell_id] = phenotype.GetGeneration();
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -3835,46 +3918,45 @@ class cActionDumpTaskGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpTaskGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpTaskGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext& ctx)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_task.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
     
     cPopulation* pop = &m_world->GetPopulation();
     cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
     
     const int num_tasks = m_world->GetEnvironment().GetNumTasks();
     
-    for (int i = 0; i < pop->GetWorldY(); i++) {
-      for (int j = 0; j < pop->GetWorldX(); j++) {
-        int task_sum = -1;
-        int cell_num = i * pop->GetWorldX() + j;
-        if (pop->GetCell(cell_num).IsOccupied() == true) {
-          task_sum = 0;
-          cOrganism* organism = pop->GetCell(cell_num).GetOrganism();
-          cCPUTestInfo test_info;
-          testcpu->TestGenome(ctx, test_info, organism->GetGenome());
-          cPhenotype& test_phenotype = test_info.GetTestPhenotype();
-          for (int k = 0; k < num_tasks; k++) {
-            if (test_phenotype.GetLastTaskCount()[k] > 0) task_sum += static_cast<int>(pow(2.0, k));
-          }
+    Apto::Array<int> grid(pop->GetWorldX() * pop->GetWorldY());
+    for (int cell_num = 0; cell_num < grid.GetSize(); cell_num++) {
+      int task_sum = -1;
+      if (pop->GetCell(cell_num).IsOccupied() == true) {
+        task_sum = 0;
+        cOrganism* organism = pop->GetCell(cell_num).GetOrganism();
+        cCPUTestInfo test_info;
+        testcpu->TestGenome(ctx, test_info, organism->GetGenome());
+        cPhenotype& test_phenotype = test_info.GetTestPhenotype();
+        for (int k = 0; k < num_tasks; k++) {
+          if (test_phenotype.GetLastTaskCount()[k] > 0) task_sum += static_cast<int>(pow(2.0, k));
         }
-        fp << task_sum << " ";
       }
-      fp << endl;
+      grid[cell_num] = task_sum;
     }
     
     delete testcpu;
+    
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -3926,42 +4008,36 @@ class cActionDumpHostTaskGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpHostTaskGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpHostTaskGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_task_hosts.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    cPopulation* pop = &m_world->GetPopulation();
-    
     const int num_tasks = m_world->GetEnvironment().GetNumTasks();
     
-    for (int j = 0; j < pop->GetWorldY(); j++) {
-      for (int i = 0; i < pop->GetWorldX(); i++) {
-        int task_sum = 0;
-        int cell_num = j * pop->GetWorldX() + i;
-        if (pop->GetCell(cell_num).IsOccupied() == true) {
-          cOrganism* organism = pop->GetCell(cell_num).GetOrganism();
-          cPhenotype& test_phenotype = organism->GetPhenotype();
-          
-          for (int k = 0; k < num_tasks; k++) {
-            if (test_phenotype.GetLastHostTaskCount()[k] > 0) task_sum += static_cast<int>(pow(2.0, k));
-          }
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<int> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      int task_sum = -1;
+      if (pop.GetCell(cell_id).IsOccupied() == true) {
+        task_sum = 0;
+        cPhenotype& test_phenotype = pop.GetCell(cell_id).GetOrganism()->GetPhenotype();
+        for (int k = 0; k < num_tasks; k++) {
+          if (test_phenotype.GetLastHostTaskCount()[k] > 0) task_sum += static_cast<int>(pow(2.0, k));
         }
-        else { task_sum = -1; }
-        fp << task_sum << " ";
       }
-      fp << endl;
+      grid[cell_id] = task_sum;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -3972,47 +4048,36 @@ class cActionDumpParasiteTaskGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpParasiteTaskGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpParasiteTaskGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_task_parasite.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    cPopulation* pop = &m_world->GetPopulation();
-    
     const int num_tasks = m_world->GetEnvironment().GetNumTasks();
     
-    for (int j = 0; j < pop->GetWorldY(); j++) {
-      for (int i = 0; i < pop->GetWorldX(); i++) {
-        int task_sum = 0;
-        int cell_num = j * pop->GetWorldX() + i;
-        if (pop->GetCell(cell_num).IsOccupied() == true) {
-          cOrganism* organism = pop->GetCell(cell_num).GetOrganism();
-          if(organism->GetNumParasites() > 0)
-          {
-            cPhenotype& test_phenotype = organism->GetPhenotype();
-            
-            for (int k = 0; k < num_tasks; k++) {
-              if (test_phenotype.GetLastParasiteTaskCount()[k] > 0) task_sum += static_cast<int>(pow(2.0, k));
-            }
-            
-          }
-          else { task_sum = -1; }
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<int> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      int task_sum = -1;
+      if (pop.GetCell(cell_id).IsOccupied() == true && pop.GetCell(cell_id).GetOrganism()->GetNumParasites() > 0) {
+        task_sum = 0;
+        cPhenotype& test_phenotype = pop.GetCell(cell_id).GetOrganism()->GetPhenotype();
+        for (int k = 0; k < num_tasks; k++) {
+          if (test_phenotype.GetLastParasiteTaskCount()[k] > 0) task_sum += static_cast<int>(pow(2.0, k));
         }
-        else { task_sum = -1; }
-        fp << task_sum << " ";
       }
-      fp << endl;
+      grid[cell_id] = task_sum;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -4119,43 +4184,33 @@ class cActionDumpParasiteVirulenceGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpParasiteVirulenceGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpParasiteVirulenceGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_virulence.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    cPopulation* pop = &m_world->GetPopulation();
-    
-    for (int j = 0; j < pop->GetWorldY(); j++) {
-      for (int i = 0; i < pop->GetWorldX(); i++) {
-        double virulence = 0;
-        int cell_num = j * pop->GetWorldX() + i;
-        if (pop->GetCell(cell_num).IsOccupied() == true) {
-          cOrganism* organism = pop->GetCell(cell_num).GetOrganism();
-          if(organism->GetNumParasites() > 0)
-          {
-            Apto::Array<Systematics::UnitPtr> parasites = organism->GetParasites();
-            Apto::SmartPtr<cParasite, Apto::InternalRCObject> parasite;
-            parasite.DynamicCastFrom(parasites[0]);
-            virulence = parasite->GetVirulence();
-          }
-          else { virulence = -1; }
-        }
-        else { virulence = -1; }
-        fp << virulence << " ";
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<double> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      double virulence = -1;
+      if (pop.GetCell(cell_id).IsOccupied() == true && pop.GetCell(cell_id).GetOrganism()->GetNumParasites() > 0) {
+        Apto::Array<Systematics::UnitPtr> parasites = pop.GetCell(cell_id).GetOrganism()->GetParasites();
+        Apto::SmartPtr<cParasite, Apto::InternalRCObject> parasite;
+        parasite.DynamicCastFrom(parasites[0]);
+        virulence = parasite->GetVirulence();
       }
-      fp << endl;
+      grid[cell_id] = virulence;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -4235,42 +4290,36 @@ class cActionDumpReactionGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpReactionGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpReactionGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_reactions.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    cPopulation* pop = &m_world->GetPopulation();
-    
     const int num_tasks = m_world->GetEnvironment().GetNumTasks();
     
-    for (int j = 0; j < pop->GetWorldY(); j++) {
-      for (int i = 0; i < pop->GetWorldX(); i++) {
-        int task_sum = 0;
-        int cell_num = j * pop->GetWorldX() + i;
-        if (pop->GetCell(cell_num).IsOccupied() == true) {
-          cOrganism* organism = pop->GetCell(cell_num).GetOrganism();
-          
-          cPhenotype& test_phenotype = organism->GetPhenotype();
-          for (int k = 0; k < num_tasks; k++) {
-            if (test_phenotype.GetLastReactionCount()[k] > 0) task_sum += static_cast<int>(pow(2.0, k));
-          }
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<int> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      int task_sum = -1;
+      if (pop.GetCell(cell_id).IsOccupied() == true) {
+        task_sum = 0;
+        cPhenotype& test_phenotype = pop.GetCell(cell_id).GetOrganism()->GetPhenotype();
+        for (int k = 0; k < num_tasks; k++) {
+          if (test_phenotype.GetLastReactionCount()[k] > 0) task_sum += static_cast<int>(pow(2.0, k));
         }
-        else {task_sum = -1;}
-        fp << task_sum << " ";
       }
-      fp << endl;
+      grid[cell_id] = task_sum;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -4576,29 +4625,27 @@ class cActionDumpDonorGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpDonorGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpDonorGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_donor.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
-      for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
-        cPopulationCell& cell = m_world->GetPopulation().GetCell(j * m_world->GetPopulation().GetWorldX() + i);
-        int donor = (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().IsDonorLast() : -1;
-        fp << donor << " ";
-      }
-      fp << endl;
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<int> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      cPopulationCell& cell = pop.GetCell(cell_id);
+      grid[cell_id] = (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().IsDonorLast() : -1;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -4606,29 +4653,27 @@ class cActionDumpReceiverGrid : public cAction
 {
 private:
   cString m_filename;
+  cGridDump::eFormat m_format;
   
 public:
-  cActionDumpReceiverGrid(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  cActionDumpReceiverGrid(cWorld* world, const cString& args, Feedback& feedback) : cAction(world, args), m_filename(""), m_format(cGridDump::FORMAT_TEXT)
   {
     cString largs(args);
+    m_format = popGridDumpFormat(largs, feedback);
     if (largs.GetSize()) m_filename = largs.PopWord();
   }
-  static const cString GetDescription() { return "Arguments: [string fname='']"; }
+  static const cString GetDescription() { return "Arguments: [string fname=''] [format=text]"; }
   void Process(cAvidaContext&)
   {
     cString filename(m_filename);
     if (filename == "") filename.Set("grid_receiver.%d.dat", m_world->GetStats().GetUpdate());
-    Avida::Output::FilePtr df = Avida::Output::File::CreateWithPath(m_world->GetNewWorld(), (const char*)filename);
-    ofstream& fp = df->OFStream();
-    
-    for (int j = 0; j < m_world->GetPopulation().GetWorldY(); j++) {
-      for (int i = 0; i < m_world->GetPopulation().GetWorldX(); i++) {
-        cPopulationCell& cell = m_world->GetPopulation().GetCell(j * m_world->GetPopulation().GetWorldX() + i);
-        int recv = (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().IsReceiver() : -1;
-        fp << recv << " ";
-      }
-      fp << endl;
+    cPopulation& pop = m_world->GetPopulation();
+    Apto::Array<int> grid(pop.GetWorldX() * pop.GetWorldY());
+    for (int cell_id = 0; cell_id < grid.GetSize(); cell_id++) {
+      cPopulationCell& cell = pop.GetCell(cell_id);
+      grid[cell_id] = (cell.IsOccupied()) ? cell.GetOrganism()->GetPhenotype().IsReceiver() : -1;
     }
+    writeGridDump(m_world, filename, m_format, grid);
   }
 };
 
@@ -4857,6 +4902,80 @@ public:
   }
 };
 
+class cActionPrintOrganismMemoryUsage : public cAction
+{
+private:
+  cString m_filename;
+  
+  enum { MEM_ORGANISM = 0, MEM_PHENOTYPE, MEM_PHEN_ARRAYS, MEM_HARDWARE, MEM_GENOME, MEM_TOTAL, NUM_MEM_COMPONENTS };
+  
+public:
+  cActionPrintOrganismMemoryUsage(cWorld* world, const cString& args, Feedback&) : cAction(world, args), m_filename("")
+  {
+    cString largs(args);
+    if (largs.GetSize()) m_filename = largs.PopWord();
+    if (m_filename == "") m_filename = "organism_memory.dat";
+  }
+  static const cString GetDescription() { return "Arguments: [string fname=\"organism_memory.dat\"]"; }
+  
+  void Process(cAvidaContext&)
+  {
+    // Accumulate per hardware type, approximate bytes per organism broken down by owner
+    Apto::Array<int> org_counts;
+    Apto::Array<Apto::Array<double> > totals;
+    
+    const Apto::Array<cOrganism*, Apto::Smart>& live_orgs = m_world->GetPopulation().GetLiveOrgList();
+    for (int i = 0; i < live_orgs.GetSize(); i++) {
+      const cOrganism* org = live_orgs[i];
+      const int hw_type = org->GetHardware().GetType();
+      if (hw_type >= org_counts.GetSize()) {
+        int old_size = org_counts.GetSize();
+        org_counts.Resize(hw_type + 1, 0);
+        totals.Resize(hw_type + 1);
+        for (int t = old_size; t < totals.GetSize(); t++) totals[t].Resize(NUM_MEM_COMPONENTS, 0.0);
+      }
+      
+      int genome_bytes = 0;
+      ConstInstructionSequencePtr seq;
+      seq.DynamicCastFrom(org->GetGenome().Representation());
+      if (seq) genome_bytes += seq->GetSize() * sizeof(Instruction);
+      seq.DynamicCastFrom(org->OffspringGenome().Representation());
+      if (seq) genome_bytes += seq->GetSize() * sizeof(Instruction);
+      
+      double bytes[NUM_MEM_COMPONENTS];
+      bytes[MEM_ORGANISM] = sizeof(cOrganism) - sizeof(cPhenotype);
+      bytes[MEM_PHENOTYPE] = sizeof(cPhenotype);
+      bytes[MEM_PHEN_ARRAYS] = org->GetPhenotype().GetHeapSize();
+      bytes[MEM_HARDWARE] = org->GetHardware().GetMemoryFootprint();
+      bytes[MEM_GENOME] = genome_bytes;
+      bytes[MEM_TOTAL] = 0.0;
+      for (int c = 0; c < MEM_TOTAL; c++) bytes[MEM_TOTAL] += bytes[c];
+      
+      org_counts[hw_type]++;
+      for (int c = 0; c < NUM_MEM_COMPONENTS; c++) totals[hw_type][c] += bytes[c];
+    }
+    
+    Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)m_filename);
+    df->WriteComment("Approximate memory held per organism (bytes, averaged over organisms of each hardware type)");
+    df->WriteComment("Phenotype arrays and hardware include heap allocations; genome counts initial and offspring sequences");
+    df->WriteTimeStamp();
+    
+    for (int t = 0; t < org_counts.GetSize(); t++) {
+      if (org_counts[t] == 0) continue;
+      df->Write(m_world->GetStats().GetUpdate(), "Update");
+      df->Write(t, "Hardware Type");
+      df->Write(org_counts[t], "Organisms");
+      df->Write(totals[t][MEM_ORGANISM] / org_counts[t], "Organism Object");
+      df->Write(totals[t][MEM_PHENOTYPE] / org_counts[t], "Phenotype Object");
+      df->Write(totals[t][MEM_PHEN_ARRAYS] / org_counts[t], "Phenotype Arrays");
+      df->Write(totals[t][MEM_HARDWARE] / org_counts[t], "Hardware");
+      df->Write(totals[t][MEM_GENOME] / org_counts[t], "Genome");
+      df->Write(totals[t][MEM_TOTAL] / org_counts[t], "Total");
+      df->Endl();
+    }
+  }
+};
+
 class cActionPrintDonationStats : public cAction
 {
 public:
@@ -5504,6 +5623,7 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   action_lib->Register<cActionPrintAttacks>("PrintAttacks");
   
   action_lib->Register<cActionPrintFromMessageInstructionData>("PrintFromMessageInstructionData");
+  action_lib->Register<cActionPrintOrganismMemoryUsage>("PrintOrganismMemoryUsage");
   
   action_lib->Register<cActionPrintMaleInstructionData>("PrintMaleInstructionData");
   action_lib->Register<cActionPrintFemaleInstructionData>("PrintFemaleInstructionData");
@@ -5661,6 +5781,7 @@ void RegisterPrintActions(cActionLibrary* action_lib)
   // Grid Information Dumps
   action_lib->Register<cActionDumpClassificationIDGrid>("DumpClassificationIDGrid");
   action_lib->Register<cActionDumpFitnessGrid>("DumpFitnessGrid");
+  action_lib->Register<cActionDumpPopulationGrid>("DumpPopulationGrid");
   action_lib->Register<cActionDumpGenotypeColorGrid>("DumpGenotypeColorGrid");
   action_lib->Register<cActionDumpPhenotypeIDGrid>("DumpPhenotypeIDGrid");
   action_lib->Register<cActionDumpIDGrid>("DumpIDGrid");
@@ -47,6 +47,7 @@
 #include "cAnalyzeTreeStats_Gamma.h"
 #include "cAvidaContext.h"
 #include "cCPUTestInfo.h"
+#include "cDetailFileReader.h"
 #include "cEnvironment.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
@@ -57,6 +58,7 @@
 #include "cModularityAnalysis.h"
 #include "cPhenotype.h"
 #include "cPhenPlastGenotype.h"
+#include "cPhylogenyIndex.h"
 #include "cPlasticPhenotype.h"
 #include "cReaction.h"
 #include "cReactionProcess.h"
@@ -284,7 +286,7 @@ double cAnalyze::AnalyzeEntropy(cAnalyzeGenotype* genotype, double mu)
   mod_seq_p.DynamicCastFrom(mod_rep_p);
   InstructionSequence& seq = *mod_seq_p;
 
-  const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
+  const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome).GetSize();
   const int num_lines = base_seq.GetSize();
   double base_fitness = genotype->GetFitness();
   
@@ -373,7 +375,7 @@ tMatrix< double > cAnalyze::AnalyzeEntropyPairs(cAnalyzeGenotype * genotype, dou
   mod_seq_p.DynamicCastFrom(mod_rep_p);
   InstructionSequence& mod_seq = *mod_seq_p;
 
-  const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
+  const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome).GetSize();
   const int num_lines = base_seq.GetSize();
   double base_fitness = genotype->GetFitness();
   
@@ -510,7 +512,7 @@ double cAnalyze::AnalyzeEntropyGivenParent(cAnalyzeGenotype * genotype,
   mod_seq_p.DynamicCastFrom(mod_rep_p);
   InstructionSequence& seq = *mod_seq_p;
   
-  const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
+  const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome).GetSize();
   const int num_lines = base_seq.GetSize();
   
   // Loop through all the lines of code, testing all mutations ...
@@ -616,7 +618,7 @@ double cAnalyze::IncreasedInfo(cAnalyzeGenotype * genotype1,
   genotype1_mod_seq_p.DynamicCastFrom(genotype1_mod_rep_p);
   InstructionSequence& genotype1_mod_seq = *genotype1_mod_seq_p;
   
-  const int num_insts = m_world->GetHardwareManager().GetInstSet(genotype1_base_genome.Properties().Get("instset").StringValue()).GetSize();
+  const int num_insts = m_world->GetHardwareManager().GetInstSet(genotype1_base_genome).GetSize();
   const int num_lines = genotype1_base_seq.GetSize();
   double genotype1_base_fitness = genotype1->GetFitness();
   vector<double> genotype1_info(num_lines, 0.0);
@@ -775,16 +777,16 @@ void cAnalyze::LoadFile(cString cur_string)
   
   cout << "Loading: " << filename << endl;
   
-  cInitFile input_file(filename, m_world->GetWorkingDir());
+  cUserFeedback load_feedback;
+  cDetailFileReader input_file(filename, m_world->GetWorkingDir(), load_feedback, m_world->GetConfig().MAX_CONCURRENCY.Get());
   if (!input_file.WasOpened()) {
-    const cUserFeedback& feedback = input_file.GetFeedback();
-    for (int i = 0; i < feedback.GetNumMessages(); i++) {
-      switch (feedback.GetMessageType(i)) {
+    for (int i = 0; i < load_feedback.GetNumMessages(); i++) {
+      switch (load_feedback.GetMessageType(i)) {
         case cUserFeedback::UF_ERROR:    cerr << "error: "; break;
         case cUserFeedback::UF_WARNING:  cerr << "warning: "; break;
         default: break;
       };
-      cerr << feedback.GetMessage(i) << endl;
+      cerr << load_feedback.GetMessage(i) << endl;
     }
     if (exit_on_error) exit(1);
   }
@@ -828,14 +830,14 @@ void cAnalyze::LoadFile(cString cur_string)
   int load_count = 0;
   
   for (int line_id = 0; line_id < input_file.GetNumLines(); line_id++) {
-    cString cur_line = input_file.GetLine(line_id);
-    
     cAnalyzeGenotype* genotype = new cAnalyzeGenotype(m_world, default_genome);
     
+    // Fields are read in place from the file; missing trailing fields are set from empty strings
+    cDetailFileReader::cLineTokenizer fields(input_file, line_id);
     output_it.Reset();
     tDataEntryCommand<cAnalyzeGenotype>* data_command = NULL;
     while ((data_command = output_it.Next()) != NULL) {
-      data_command->SetValue(genotype, cur_line.PopWord());
+      data_command->SetValue(genotype, (fields.Next()) ? fields.Field() : cString(""));
     }
     
     // Give this genotype a name.  Base it on the ID if possible.
@@ -1059,6 +1061,9 @@ void cAnalyze::FindLineage(cString cur_string)
   } else cout << "Performing lineage scan..." << endl;
   
   
+  // Index the batch before the tracked genotype is pulled out of it
+  const cPhylogenyIndex& phylogeny = batch[cur_batch].Phylogeny();
+  
   // Determine by lin_type which genotype we are tracking...
   cAnalyzeGenotype * found_gen = PopGenotype(lin_type, cur_batch);
   
@@ -1068,37 +1073,33 @@ void cAnalyze::FindLineage(cString cur_string)
     return;
   }
   
-  // Otherwise, trace back through the id numbers to mark all of those
+  // Otherwise, trace back through the parent links to mark all of those
   // in the ancestral lineage...
   
   // Construct a list of genotypes found...
   
   tListPlus<cAnalyzeGenotype> found_list;
   found_list.Push(found_gen);
-  int next_id = found_gen->GetParentID();
-  bool found = true;
-  while (found == true) {
-    found = false;
-    
-    tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-    while ((found_gen = batch_it.Next()) != NULL) {
-      if (found_gen->GetID() == next_id) {
-        batch_it.Remove();
-        found_list.Push(found_gen);
-        next_id = found_gen->GetParentID();
-        found = true;
-        break;
-      }
-    }
+  Apto::Array<bool> keep(phylogeny.GetSize());
+  keep.SetAll(false);
+  
+  Apto::Array<int> lineage;
+  phylogeny.FindLineage(phylogeny.FindPosition(found_gen->GetParentID()), lineage);
+  for (int i = 0; i < lineage.GetSize(); i++) {
+    cAnalyzeGenotype* ancestor = phylogeny.GetGenotype(lineage[i]);
+    if (ancestor == found_gen) break;
+    keep[lineage[i]] = true;
+    found_list.Push(ancestor);
   }
   
   // We now have all of the genotypes in this lineage, delete everything
   // else.
   
-  const int total_removed = batch[cur_batch].List().GetSize();
-  while (batch[cur_batch].List().GetSize() > 0) {
-    delete batch[cur_batch].List().Pop();
+  const int total_removed = phylogeny.GetSize() - found_list.GetSize();
+  for (int pos = 0; pos < phylogeny.GetSize(); pos++) {
+    if (!keep[pos] && phylogeny.GetGenotype(pos) != found_gen) delete phylogeny.GetGenotype(pos);
   }
+  batch[cur_batch].List().Clear();
   
   // And fill it back in with the good stuff.
   int total_kept = found_list.GetSize();
@@ -1285,6 +1286,9 @@ void cAnalyze::FindClade(cString cur_string)
   } else cout << "Performing clade scan..." << endl;
   
   
+  // Index the batch before the ancestral genotype is pulled out of it
+  const cPhylogenyIndex& phylogeny = batch[cur_batch].Phylogeny();
+  
   // Determine by clade_type which genotype we are tracking...
   cAnalyzeGenotype * found_gen = PopGenotype(clade_type, cur_batch);
   
@@ -1294,38 +1298,30 @@ void cAnalyze::FindClade(cString cur_string)
     return;
   }
   
-  // Do this the brute force way... scan for one step at a time.
+  // Locate the popped genotype in the index (a repeated id can only appear after the first one)
+  int clade_root = phylogeny.FindPosition(found_gen->GetID());
+  while (phylogeny.GetGenotype(clade_root) != found_gen) clade_root++;
   
   // Construct a list of genotypes found...
   
-  tListPlus<cAnalyzeGenotype> found_list; // Found and finished.
-  tListPlus<cAnalyzeGenotype> scan_list;  // Found, but need to scan for children.
-  scan_list.Push(found_gen);
+  tListPlus<cAnalyzeGenotype> found_list;
+  Apto::Array<bool> keep(phylogeny.GetSize());
+  keep.SetAll(false);
   
-  // Keep going as long as there is something in the scan list...
-  while (scan_list.GetSize() > 0) {
-    // Move the next genotype from the scan list to the found_list.
-    found_gen = scan_list.Pop();
-    int parent_id = found_gen->GetID();
-    found_list.Push(found_gen);
-    
-    // Seach for all of the children of this genotype...
-    tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
-    while ((found_gen = batch_it.Next()) != NULL) {
-      // If we found a child, place it into the scan list.
-      if (found_gen->GetParentID() == parent_id) {
-        batch_it.Remove();
-        scan_list.Push(found_gen);
-      }
-    }
+  Apto::Array<int> clade;
+  phylogeny.FindClade(clade_root, clade);
+  for (int i = 0; i < clade.GetSize(); i++) {
+    keep[clade[i]] = true;
+    found_list.Push(phylogeny.GetGenotype(clade[i]));
   }
   
   // We now have all of the genotypes in this clade, delete everything else.
   
-  const int total_removed = batch[cur_batch].List().GetSize();
-  while (batch[cur_batch].List().GetSize() > 0) {
-    delete batch[cur_batch].List().Pop();
+  const int total_removed = phylogeny.GetSize() - found_list.GetSize();
+  for (int pos = 0; pos < phylogeny.GetSize(); pos++) {
+    if (!keep[pos]) delete phylogeny.GetGenotype(pos);
   }
+  batch[cur_batch].List().Clear();
   
   // And fill it back in with the good stuff.
   int total_kept = found_list.GetSize();
@@ -1357,50 +1353,30 @@ void cAnalyze::FindLastCommonAncestor(cString)
     cout << "  Connecting genotypes to parents. " << endl;
   }
   
-  // Connect each genotype to its parent.
-  tListIterator<cAnalyzeGenotype> child_it(batch[cur_batch].List());
-  cAnalyzeGenotype * on_child = NULL;
-  while ((on_child = child_it.Next()) != NULL) {
-    tListIterator<cAnalyzeGenotype> parent_it(batch[cur_batch].List());
-    cAnalyzeGenotype * on_parent = NULL;
-    while ((on_parent = parent_it.Next()) != NULL) {
-      if (on_child->GetParentID() == on_parent->GetID()) {
-        on_child->LinkParent(on_parent);
-        break;
-      }
-    }
-  }
+  const cPhylogenyIndex& phylogeny = batch[cur_batch].Phylogeny();
 
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
     cout << "  Finding earliest genotype. " << endl;
   }
   
   // Find the genotype without a parent (there should only be one)
-  tListIterator<cAnalyzeGenotype> first_lca_it(batch[cur_batch].List());
-  cAnalyzeGenotype * lca = NULL;
-  cAnalyzeGenotype * test_lca = NULL;
-  while ((test_lca = first_lca_it.Next()) != NULL) {
-    if (!test_lca->GetParent()) {
-      // It is an error to get two genotypes without a parent
-      if (lca != NULL) {
-        cout << "Error: More than one genotype does not have a parent. " << endl;
-        cout << "Genotype 1: " << test_lca->GetID() << endl;
-        cout << "Genotype 2: " << lca->GetID() << endl;
-        return;
-      }
-      lca = test_lca;
-    }
+  const Apto::Array<int>& roots = phylogeny.GetRoots();
+  if (roots.GetSize() == 0) return;
+  if (roots.GetSize() > 1) {
+    // It is an error to get two genotypes without a parent
+    cout << "Error: More than one genotype does not have a parent. " << endl;
+    cout << "Genotype 1: " << phylogeny.GetGenotype(roots[1])->GetID() << endl;
+    cout << "Genotype 2: " << phylogeny.GetGenotype(roots[0])->GetID() << endl;
+    return;
   }
   
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
     cout << "  Following children to last common ancestor. " << endl;
   }
   
-  // Follow the children from this parent until we find a genotype with 
-  // more than one child. This is the last common ancestor.
-  while (lca->GetChildList().GetSize() == 1) {
-    lca = lca->GetChildList().Pop();
-  }
+  // The first genotype with more than one child is the common ancestor of every tip of the tree.
+  // This is the last common ancestor.
+  cAnalyzeGenotype* lca = phylogeny.GetGenotype(phylogeny.FindLeafLCA());
   
   // Delete everything else.
   tListIterator<cAnalyzeGenotype> delete_batch_it(batch[cur_batch].List());
@@ -2687,7 +2663,7 @@ void cAnalyze::CommandPrintDiversity(cString cur_string)
     tListIterator<cAnalyzeGenotype> batch_it(batch[cur_batch].List());
     cAnalyzeGenotype* genotype = NULL;
     while ((genotype = batch_it.Next()) != NULL) {
-      if (m_world->GetHardwareManager().GetInstSet(genotype->GetGenome().Properties().Get("instset").StringValue()).GetInstSetName() != is.GetInstSetName() || genotype->GetTaskCount(task_id) == 0) continue;
+      if (m_world->GetHardwareManager().GetInstSet(genotype->GetGenome()).GetInstSetName() != is.GetInstSetName() || genotype->GetTaskCount(task_id) == 0) continue;
       
       const Genome& genome_p = genotype->GetGenome();
       ConstInstructionSequencePtr seq_p;
@@ -3301,7 +3277,7 @@ void cAnalyze::CommandPrintTreeStats(cString cur_string)
   fp << endl;
   
   cAnalyzeTreeStats_CumulativeStemminess agts(m_world);
-  agts.AnalyzeBatchTree(batch[cur_batch].List());
+  agts.AnalyzeBatchTree(batch[cur_batch].Phylogeny());
 
   fp << agts.AverageStemminess();
   fp << endl;
@@ -3327,7 +3303,7 @@ void cAnalyze::CommandPrintCumulativeStemminess(cString cur_string)
   fp << endl;
   
   cAnalyzeTreeStats_CumulativeStemminess agts(m_world);
-  agts.AnalyzeBatchTree(batch[cur_batch].List());
+  agts.AnalyzeBatchTree(batch[cur_batch].Phylogeny());
   
   fp << agts.AverageStemminess();
   fp << endl;
@@ -3379,7 +3355,7 @@ void cAnalyze::CommandPrintGamma(cString cur_string)
   fp << endl;
   
   cAnalyzeTreeStats_Gamma atsg(m_world);
-  atsg.AnalyzeBatch(batch[cur_batch].List(), end_time, furcation_time_convention);
+  atsg.AnalyzeBatch(batch[cur_batch].Phylogeny(), end_time, furcation_time_convention);
   
   fp << atsg.Gamma();
   fp << endl;
@@ -3541,7 +3517,7 @@ void cAnalyze::AnalyzeCommunityComplexity(cString cur_string)
     mod_seq_p.DynamicCastFrom(mod_rep_p);
     InstructionSequence& seq = *mod_seq_p;
     
-    const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
+    const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome).GetSize();
     double base_fitness = genotype->GetFitness();
 
     tMatrix<double> prob(length_genome, num_insts);
@@ -3589,7 +3565,7 @@ void cAnalyze::AnalyzeCommunityComplexity(cString cur_string)
   double oo_conditional_entropy = 0.0;
   tMatrix<double> this_prob = point_mut.find(genotype->GetID())->second;
   const Genome& cur_genome = genotype->GetGenome();
-  const int num_insts = m_world->GetHardwareManager().GetInstSet(cur_genome.Properties().Get("instset").StringValue()).GetSize();
+  const int num_insts = m_world->GetHardwareManager().GetInstSet(cur_genome).GetSize();
   for (int line = 0; line < length_genome; ++ line) {
     double oneline_entropy = 0.0;
     for (int inst = 0; inst < num_insts; ++ inst) {
@@ -4275,7 +4251,7 @@ void cAnalyze::AnalyzeComplexityDelta(cString cur_string)
     mod_seq_p.DynamicCastFrom(mod_rep_p);
     InstructionSequence& mod_seq = *mod_seq_p;
     
-    const cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(mod_genome.Properties().Get("instset").StringValue());
+    const cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(mod_genome);
     
     if (copy_mut_prob == 0.0 &&
         ins_mut_prob == 0.0 &&
@@ -4520,7 +4496,7 @@ void cAnalyze::AnalyzeKnockouts(cString cur_string)
     mod_seq_p.DynamicCastFrom(mod_rep_p);
     InstructionSequence& mod_seq = *mod_seq_p;
     
-    Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
+    Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome).ActivateNullInst();
     
     // Loop through all the lines of code, testing the removal of each.
     // -2=lethal, -1=detrimental, 0=neutral, 1=beneficial
@@ -4654,7 +4630,7 @@ genotype_vector cAnalyze::GetSkeletons(cString cur_string, int max_knockouts=2)
     mod_seq_p.DynamicCastFrom(mod_rep_p);
     InstructionSequence& mod_seq = *mod_seq_p;
     
-    Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
+    Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome).ActivateNullInst();
     Apto::Array<int> ko_effect(max_line);
     // Loop through all the lines of code, testing the removal of each.
     for (int line_num = 0; line_num < max_line; line_num++) {
@@ -4840,7 +4816,7 @@ void cAnalyze::GetSkeletons_Batch(cString cur_string)
     mod_seq_p.DynamicCastFrom(mod_rep_p);
     InstructionSequence& mod_seq = *mod_seq_p;
     
-    Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
+    Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome).ActivateNullInst();
     Apto::Array<int> ko_effect(max_line);
     // Loop through all the lines of code, testing the removal of each.
     for (int line_num = 0; line_num < max_line; line_num++) {
@@ -5002,16 +4978,16 @@ genotype_vector cAnalyze::LoadDetailFileAsVector(cString cur_string)
   
   cout << "Loading: " << filename << endl;
   
-  cInitFile input_file(filename, m_world->GetWorkingDir());
+  cUserFeedback load_feedback;
+  cDetailFileReader input_file(filename, m_world->GetWorkingDir(), load_feedback, m_world->GetConfig().MAX_CONCURRENCY.Get());
   if (!input_file.WasOpened()) {
-    const cUserFeedback& feedback = input_file.GetFeedback();
-    for (int i = 0; i < feedback.GetNumMessages(); i++) {
-      switch (feedback.GetMessageType(i)) {
+    for (int i = 0; i < load_feedback.GetNumMessages(); i++) {
+      switch (load_feedback.GetMessageType(i)) {
         case cUserFeedback::UF_ERROR:    cerr << "error: "; break;
         case cUserFeedback::UF_WARNING:  cerr << "warning: "; break;
         default: break;
       };
-      cerr << feedback.GetMessage(i) << endl;
+      cerr << load_feedback.GetMessage(i) << endl;
     }
     if (exit_on_error) exit(1);
   }
@@ -5055,14 +5031,14 @@ genotype_vector cAnalyze::LoadDetailFileAsVector(cString cur_string)
   int load_count = 0;
   
   for (int line_id = 0; line_id < input_file.GetNumLines(); line_id++) {
-    cString cur_line = input_file.GetLine(line_id);
-    
     cAnalyzeGenotype* genotype = new cAnalyzeGenotype(m_world, default_genome);
     
+    // Fields are read in place from the file; missing trailing fields are set from empty strings
+    cDetailFileReader::cLineTokenizer fields(input_file, line_id);
     output_it.Reset();
     tDataEntryCommand<cAnalyzeGenotype>* data_command = NULL;
     while ((data_command = output_it.Next()) != NULL) {
-      data_command->SetValue(genotype, cur_line.PopWord());
+      data_command->SetValue(genotype, (fields.Next()) ? fields.Field() : cString(""));
     }
     
     // Give this genotype a name.  Base it on the ID if possible.
@@ -5437,7 +5413,7 @@ void cAnalyze::GetLargestSkeleton(cString cur_string){
     {
       int length = 0;
       const Genome& cur_genome = iter->GetGenome();
-      Instruction null_inst = m_world->GetHardwareManager().GetInstSet(cur_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
+      Instruction null_inst = m_world->GetHardwareManager().GetInstSet(cur_genome).ActivateNullInst();
       ConstInstructionSequencePtr cur_seq_p;
       ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
       cur_seq_p.DynamicCastFrom(cur_rep_p);
@@ -5755,7 +5731,7 @@ void cAnalyze::ComplexityDebugging(cString cur_string)
     {
       int length = 0;
       const Genome& cur_genome = iter->GetGenome();
-      Instruction null_inst = m_world->GetHardwareManager().GetInstSet(cur_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
+      Instruction null_inst = m_world->GetHardwareManager().GetInstSet(cur_genome).ActivateNullInst();
       ConstInstructionSequencePtr cur_seq_p;
       ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
       cur_seq_p.DynamicCastFrom(cur_rep_p);
@@ -6015,7 +5991,7 @@ void cAnalyze::AllComplexityBarriers(cString cur_string)
     {
       int length = 0;
       const Genome& cur_genome = iter->GetGenome();
-      Instruction null_inst = m_world->GetHardwareManager().GetInstSet(cur_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
+      Instruction null_inst = m_world->GetHardwareManager().GetInstSet(cur_genome).ActivateNullInst();
       ConstInstructionSequencePtr cur_seq_p;
       ConstGeneticRepresentationPtr cur_rep_p = cur_genome.Representation();
       cur_seq_p.DynamicCastFrom(cur_rep_p);
@@ -6266,7 +6242,7 @@ void cAnalyze::CommandMapTasks(cString cur_string)
       col_fail_count[i] = 0;
     }
     
-    cInstSet& is = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
+    cInstSet& is = m_world->GetHardwareManager().GetInstSet(base_genome);
     const Instruction null_inst = is.ActivateNullInst();
     
     // Loop through all the lines of code, testing the removal of each.
@@ -6513,7 +6489,7 @@ void cAnalyze::CommandAverageModularity(cString cur_string)
       mod_seq_p.DynamicCastFrom(mod_rep_p);
       InstructionSequence& mod_seq = *mod_seq_p;
       
-      Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
+      Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome).ActivateNullInst();
       
       // Create and initialize the modularity matrix
       tMatrix<int> mod_matrix(num_cols, max_line);
@@ -6762,7 +6738,7 @@ void cAnalyze::CommandAnalyzeModularity(cString cur_string)
     
     genotype->Recalculate(m_ctx);
     
-    const Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
+    const Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome).ActivateNullInst();
     
     tMatrix<bool> task_matrix(num_traits, base_length);
     Apto::Array<int> num_inst(num_traits);  // Number of instructions for each task
@@ -6927,7 +6903,7 @@ void cAnalyze::CommandAnalyzeRedundancyByInstFailure(cString cur_string)
     }
     
     const Genome& genome = genotype->GetGenome();
-    const cInstSet& original_inst_set = m_world->GetHardwareManager().GetInstSet(genome.Properties().Get("instset").StringValue());
+    const cInstSet& original_inst_set = m_world->GetHardwareManager().GetInstSet(genome);
     cInstSet* modify_inst_set = new cInstSet(original_inst_set);
     Apto::String isname = genotype->GetGenome().Properties().Get("instset").StringValue() + ":analyze_redundancy_by_inst_failure";
     if (!m_world->GetHardwareManager().RegisterInstSet(isname, modify_inst_set)) {
@@ -7059,7 +7035,7 @@ void cAnalyze::CommandMapMutations(cString cur_string)
     mod_seq_p.DynamicCastFrom(mod_rep_p);
     InstructionSequence& seq = *mod_seq_p;
     
-    const cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
+    const cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome);
     const int num_insts = inst_set.GetSize();
     
     // Headers...
@@ -7120,7 +7096,7 @@ void cAnalyze::CommandMapMutations(cString cur_string)
     Apto::Array<double> col_fitness(num_insts + 1);
     col_fitness.SetAll(0.0);
     
-    const Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
+    const Instruction null_inst = m_world->GetHardwareManager().GetInstSet(base_genome).ActivateNullInst();
     
     cString color_string;  // For coloring cells...
     
@@ -7815,7 +7791,7 @@ void cAnalyze::CommandMutagenize(cString)
     InstructionSequencePtr seq_p;
     seq_p.DynamicCastFrom(cur_genome.Representation());
     InstructionSequence& cur_seq = *seq_p;
-    const cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(cur_genome.Properties().Get("instset").StringValue());
+    const cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(cur_genome);
 
     int line_num = m_ctx.GetRandom().GetInt(cur_seq.GetSize());
 
@@ -8876,7 +8852,7 @@ void cAnalyze::AnalyzeComplexity(cString cur_string)
     mod_seq_p.DynamicCastFrom(mod_rep_p);
     InstructionSequence& seq = *mod_seq_p;
     
-    const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
+    const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome).GetSize();
     
     // Loop through all the lines of code, testing all mutations...
     Apto::Array<double> test_fitness(num_insts);
@@ -9062,7 +9038,7 @@ void cAnalyze::AnalyzeFitnessLandscapeTwoSites(cString cur_string)
     mod_seq_p.DynamicCastFrom(mod_rep_p);
     InstructionSequence& seq = *mod_seq_p;
     
-    const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
+    const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome).GetSize();
 
     // run throught sites in genome
     for (int site1 = 0; site1 < max_line; site1++) {
@@ -9191,7 +9167,7 @@ void cAnalyze::AnalyzeLineageComplexitySitesN(cString cur_string)
     Genome mod_genome(base_genome);
     InstructionSequencePtr seq_p;
     seq_p.DynamicCastFrom(mod_genome.Representation());
-    const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset")).GetSize();
+    const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome).GetSize();
 
     //Initialize variables needed for complexity calculations
     int posneutmut = 0; //number of positive and nuetral mutations
@@ -9477,7 +9453,7 @@ void cAnalyze::AnalyzeComplexityTwoSites(cString cur_string)
     mod_seq_p.DynamicCastFrom(mod_rep_p);
     InstructionSequence& seq = *mod_seq_p;
     
-    const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
+    const int num_insts = m_world->GetHardwareManager().GetInstSet(base_genome).GetSize();
     /*
      * 
      *  ONE SITE CALCULATIONS
@@ -9886,7 +9862,7 @@ void cAnalyze::AnalyzePopComplexity(cString cur_string)
   
   if (genotype == NULL) return;
   int seq_length = genotype->GetLength();
-  const int num_insts = m_world->GetHardwareManager().GetInstSet(genotype->GetGenome().Properties().Get("instset").StringValue()).GetSize();
+  const int num_insts = m_world->GetHardwareManager().GetInstSet(genotype->GetGenome()).GetSize();
   tMatrix<int> inst_stat(seq_length, num_insts);
   
   // Initializing inst_stat ...
@@ -10650,7 +10626,7 @@ void cAnalyze::BatchCompete(cString cur_string)
     child_seq_p.DynamicCastFrom(child_rep_p);
     InstructionSequence& child_seq = *child_seq_p;
     
-    const cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(child_genome.Properties().Get("instset").StringValue());
+    const cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(child_genome);
     
     if (copy_mut_prob > 0.0) {
       for (int n = 0; n < child_seq.GetSize(); n++) {
@@ -401,7 +401,7 @@ void cAnalyzeGenotype::CalcKnockouts(bool check_pairs, bool check_chart) const
   Genome mod_genome(m_genome);
   
   // Setup a NULL instruction needed for testing
-  const Instruction null_inst = m_world->GetHardwareManager().GetInstSet(mod_genome.Properties().Get("instset").StringValue()).ActivateNullInst();
+  const Instruction null_inst = m_world->GetHardwareManager().GetInstSet(mod_genome).ActivateNullInst();
   
   // If we are keeping track of the specific effects on tasks from the
   // knockouts, setup the matrix.
@@ -737,7 +737,7 @@ cString cAnalyzeGenotype::DescInstExe(int _inst_id) const
   if(_inst_id > inst_executed_counts.GetSize() || _inst_id < 0) return "";
   
   cString desc("# Times ");
-  desc += m_world->GetHardwareManager().GetInstSet(m_genome.Properties().Get("instset").StringValue()).GetName(_inst_id);
+  desc += m_world->GetHardwareManager().GetInstSet(m_genome).GetName(_inst_id);
   desc += " Executed";
   return desc;
 }
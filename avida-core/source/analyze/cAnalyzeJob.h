@@ -28,14 +28,25 @@ class cAnalyzeJob
 {
 private:
   int m_id;
+  int m_seed;         // RNG seed, fixed when the job is queued
+  int m_worker;       // index of the worker executing this job, -1 if none
+  int m_subjobs;      // count of sub-jobs spawned, used to derive their seeds
   
 public:
-  cAnalyzeJob() : m_id(0) { ; }
+  cAnalyzeJob() : m_id(0), m_seed(0), m_worker(-1), m_subjobs(0) { ; }
   virtual ~cAnalyzeJob() { ; }
   
   void SetID(int newid) { m_id = newid; }
   int GetID() { return m_id; }
   
+  void SetSeed(int seed) { m_seed = seed; }
+  int GetSeed() const { return m_seed; }
+  
+  void SetWorker(int worker) { m_worker = worker; }
+  int GetWorker() const { return m_worker; }
+  
+  int NextSubJobIndex() { return m_subjobs++; }
+  
   virtual void Run(cAvidaContext& ctx) = 0;
 };
 
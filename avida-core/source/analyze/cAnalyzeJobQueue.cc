@@ -27,6 +27,8 @@
 #include "avida/core/WorldDriver.h"
 
 #include "cAnalyzeJobWorker.h"
+#include "cAvidaContext.h"
+#include "cPhiloxRandom.h"
 #include "cWorld.h"
 
 
@@ -38,18 +40,19 @@ using namespace Avida;
 
 
 cAnalyzeJobQueue::cAnalyzeJobQueue(cWorld* world)
-: m_world(world), m_last_jobid(0), m_jobs(0), m_pending(0), m_workers(Apto::Platform::AvailableCPUs())
+: m_world(world), m_last_jobid(0), m_num_top_jobs(0), m_next_worker(0), m_outstanding(0), m_submitted(0), m_shutdown(false)
+, m_workers(Apto::Platform::AvailableCPUs())
 {
   const int max_workers = world->GetConfig().MAX_CONCURRENCY.Get();
   if (max_workers > 0 && max_workers < m_workers.GetSize()) m_workers.Resize(max_workers);
   
-  m_job_seed_rng = new Apto::RNG::AvidaRNG(world->GetRandom().GetInt(world->GetRandom().MaxSeed()));
+  m_max_seed = world->GetRandom().MaxSeed();
+  m_base_seed = world->GetRandom().GetInt(m_max_seed);
   
   if (m_workers.GetSize() > 1) {
-    for (int i = 0; i < m_workers.GetSize(); i++) {
-      m_workers[i] = new cAnalyzeJobWorker(this);
-      m_workers[i]->Start();
-    }
+    // Construct all workers before starting any of them, since running workers steal from every deque
+    for (int i = 0; i < m_workers.GetSize(); i++) m_workers[i] = new cAnalyzeJobWorker(this, i);
+    for (int i = 0; i < m_workers.GetSize(); i++) m_workers[i]->Start();
   } else {
     m_workers.Resize(0);
   }
@@ -60,49 +63,164 @@ cAnalyzeJobQueue::~cAnalyzeJobQueue()
   const int num_workers = m_workers.GetSize();
   
   m_mutex.Lock();
-  
-  // Clean out any waiting jobs
-  cAnalyzeJob* job;
-  while ((job = m_queue.Pop())) delete job;
-  
-  // Set job count so that all workers receive NULL jobs
-  m_jobs = num_workers;
-  
+  m_shutdown = true;
   m_mutex.Unlock();
   
-  // Signal all workers to check job queue
+  // Signal all workers to check for shutdown
   m_cond.Broadcast();
   
+  for (int i = 0; i < num_workers; i++) m_workers[i]->Join();
+  
+  // Clean out any waiting jobs
   for (int i = 0; i < num_workers; i++) {
-    m_workers[i]->Join();
+    cAnalyzeJob* job;
+    while ((job = m_workers[i]->m_deque.Pop())) delete job;
     delete m_workers[i];
   }
-  
-  delete m_job_seed_rng;
 }
 
-inline void cAnalyzeJobQueue::queueJob(cAnalyzeJob* job)
+
+int cAnalyzeJobQueue::deriveSeed(int seed, int index) const
+{
+  // SplitMix64 finalizer over the (seed, index) pair
+  unsigned long long z = ((unsigned long long)(unsigned int)seed << 32) | (unsigned int)index;
+  z += 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z ^= (z >> 31);
+  return (int)(z % (unsigned long long)m_max_seed);
+}
+
+Apto::Random* cAnalyzeJobQueue::newJobRandom(cAnalyzeJob* job) const
+{
+  // The seed already identifies the job, job ids are handed out in whatever order workers reach the queue
+  if (m_world->UsesRandomStreams()) return new cPhiloxRandom(job->GetSeed(), RANDOM_STREAM_ANALYZE_JOB);
+  return new Apto::RNG::AvidaRNG(job->GetSeed());
+}
+
+
+void cAnalyzeJobQueue::queueJob(cAnalyzeJob* job, int worker)
 {
-  if (m_workers.GetSize()) m_queue.PushRear(job);
-  else singleThreadedJobExecution(job);
+  if (!m_workers.GetSize()) {
+    singleThreadedJobExecution(job);
+    return;
+  }
+  
+  cAnalyzeJobWorker* target = m_workers[worker];
+  target->m_deque_mutex.Lock();
+  target->m_deque.PushRear(job);
+  target->m_deque_mutex.Unlock();
+  
+  // Only count the submission once the job can actually be found, otherwise an idle worker could wake, find nothing,
+  // and go back to sleep having already seen the new submission count
+  m_mutex.Lock();
+  m_submitted++;
+  m_cond.Signal();
+  m_mutex.Unlock();
 }
 
 void cAnalyzeJobQueue::AddJob(cAnalyzeJob* job)
 {
-  Apto::MutexAutoLock lock(m_mutex);
+  m_mutex.Lock();
   job->SetID(m_last_jobid++);
-  queueJob(job);
-  m_jobs++;
+  job->SetSeed(deriveSeed(m_base_seed, m_num_top_jobs++));
+  m_outstanding++;
+  
+  int worker = 0;
+  if (m_workers.GetSize()) {
+    worker = m_next_worker;
+    m_next_worker = (m_next_worker + 1) % m_workers.GetSize();
+  }
+  m_mutex.Unlock(); // must unlock prior to queuing, single threaded execution may spawn sub-jobs
+  
+  queueJob(job, worker);
 }
 
 void cAnalyzeJobQueue::AddJobImmediate(cAnalyzeJob* job)
 {
+  AddJob(job);
+}
+
+void cAnalyzeJobQueue::AddSubJob(cAvidaContext& ctx, cAnalyzeJob* job)
+{
+  cAnalyzeJob* parent = ctx.GetAnalyzeJob();
+  if (!parent) {
+    AddJobImmediate(job);
+    return;
+  }
+  
+  // Sub-job seeds depend only on the parent's seed and spawn order, which is fixed by the (single threaded) parent
+  job->SetSeed(deriveSeed(parent->GetSeed(), parent->NextSubJobIndex()));
+  
   m_mutex.Lock();
   job->SetID(m_last_jobid++);
-  queueJob(job);
-  m_jobs++;
-  m_mutex.Unlock(); // should unlock prior to signaling condition variable
-  m_cond.Signal();
+  m_outstanding++;
+  m_mutex.Unlock();
+  
+  queueJob(job, (parent->GetWorker() >= 0) ? parent->GetWorker() : 0);
+}
+
+
+cAnalyzeJob* cAnalyzeJobQueue::nextJob(int worker)
+{
+  const int num_workers = m_workers.GetSize();
+  cAnalyzeJob* job = NULL;
+  
+  // Check the local deque first, most recently queued jobs keep nested work close to its parent
+  cAnalyzeJobWorker* local = m_workers[worker];
+  local->m_deque_mutex.Lock();
+  job = local->m_deque.PopRear();
+  local->m_deque_mutex.Unlock();
+  if (job) return job;
+  
+  // Steal the oldest job from another worker
+  for (int i = 1; i < num_workers; i++) {
+    cAnalyzeJobWorker* victim = m_workers[(worker + i) % num_workers];
+    victim->m_deque_mutex.Lock();
+    job = victim->m_deque.Pop();
+    victim->m_deque_mutex.Unlock();
+    if (job) return job;
+  }
+  
+  return NULL;
+}
+
+void cAnalyzeJobQueue::runJob(cAnalyzeJob* job, int worker)
+{
+  // Each job executes with its own RNG, seeded at queue time, and its own context so that nested execution (see
+  // ExecutePendingJob) leaves the context of the waiting job untouched
+  Apto::SmartPtr<Apto::Random> rng(newJobRandom(job));
+  cAvidaContext ctx(&m_world->GetDriver(), *rng);
+  ctx.SetAnalyzeMode();
+  ctx.SetAnalyzeJob(job);
+  
+  job->SetWorker(worker);
+  job->Run(ctx);
+  delete job;
+  
+  jobComplete();
+}
+
+void cAnalyzeJobQueue::jobComplete()
+{
+  m_mutex.Lock();
+  int outstanding = --m_outstanding;
+  m_mutex.Unlock();
+  if (!outstanding) m_term_cond.Broadcast();
+}
+
+bool cAnalyzeJobQueue::ExecutePendingJob(cAvidaContext& ctx)
+{
+  if (!m_workers.GetSize()) return false;
+  
+  cAnalyzeJob* parent = ctx.GetAnalyzeJob();
+  const int worker = (parent && parent->GetWorker() >= 0) ? parent->GetWorker() : 0;
+  
+  cAnalyzeJob* job = nextJob(worker);
+  if (!job) return false;
+  
+  runJob(job, worker);
+  return true;
 }
 
 
@@ -124,7 +242,7 @@ void cAnalyzeJobQueue::Execute()
   
   // Wait for term signal
   m_mutex.Lock();
-  while (m_jobs > 0 || m_pending > 0) {
+  while (m_outstanding > 0) {
     m_term_cond.Wait(m_mutex);
   }
   m_mutex.Unlock();
@@ -135,9 +253,11 @@ void cAnalyzeJobQueue::Execute()
 
 void cAnalyzeJobQueue::singleThreadedJobExecution(cAnalyzeJob* job)
 {
-  Apto::RNG::AvidaRNG rng(GetSeedForJob(job->GetID()));
-  cAvidaContext ctx(&m_world->GetDriver(), rng);
+  Apto::SmartPtr<Apto::Random> rng(newJobRandom(job));
+  cAvidaContext ctx(&m_world->GetDriver(), *rng);
+  ctx.SetAnalyzeJob(job);
   job->Run(ctx);
   delete job;
+  
+  jobComplete();
 }
-
@@ -26,9 +26,9 @@
 #include "apto/platform.h"
 
 #include "cAnalyzeJob.h"
-#include "tList.h"
 
 class cAnalyzeJobWorker;
+class cAvidaContext;
 class cWorld;
 
 #if APTO_PLATFORM(WINDOWS) && defined(AddJob)
@@ -39,27 +39,40 @@ class cWorld;
 const int MT_RANDOM_INDEX_MASK = 0x7F;
 
 
+// Jobs are distributed over per-worker deques.  A worker pops its own deque from the rear (most recently queued first)
+// and, when it runs dry, steals from the front of the other workers' deques.  Each job receives its RNG seed when it is
+// queued, derived solely from the queue's base seed and the job's position in the submission tree, so that results do
+// not depend upon the number of workers or the order in which they happen to pick up jobs.
 class cAnalyzeJobQueue
 {
   friend class cAnalyzeJobWorker;
   
 private:
   cWorld* m_world;
-  tList<cAnalyzeJob> m_queue;
   int m_last_jobid;
-  Apto::Random* m_job_seed_rng;
+  int m_num_top_jobs;       // top level jobs queued so far, numbers their seeds
+  int m_base_seed;
+  int m_max_seed;
+  int m_next_worker;        // round-robin target for top level jobs
   Apto::Mutex m_mutex;
   Apto::ConditionVariable m_cond;
   Apto::ConditionVariable m_term_cond;
   
-  volatile int m_jobs;      // count of waiting jobs, used in condition variable constructs
-  volatile int m_pending;   // count of currently executing jobs
+  volatile int m_outstanding; // count of jobs queued or currently executing
+  volatile int m_submitted;   // submission counter, lets idle workers detect new work before sleeping
+  volatile bool m_shutdown;
   
   Apto::Array<cAnalyzeJobWorker*> m_workers;
 
 
   void singleThreadedJobExecution(cAnalyzeJob* job);
-  inline void queueJob(cAnalyzeJob* job);
+  void queueJob(cAnalyzeJob* job, int worker);
+  int deriveSeed(int seed, int index) const;
+  Apto::Random* newJobRandom(cAnalyzeJob* job) const;
+  
+  cAnalyzeJob* nextJob(int worker);
+  void runJob(cAnalyzeJob* job, int worker);
+  void jobComplete();
 
   
   cAnalyzeJobQueue(); // @not_implemented
@@ -73,11 +86,19 @@ public:
 
   void AddJob(cAnalyzeJob* job);
   void AddJobImmediate(cAnalyzeJob* job);
+  
+  // Queue a job spawned by the job currently executing in ctx (if any).  Sub-jobs are placed on the spawning worker's
+  // deque and seeded from the parent's seed, keeping nested submission deterministic.
+  void AddSubJob(cAvidaContext& ctx, cAnalyzeJob* job);
+  
+  // Execute a single queued job on the worker running the job in ctx, returning false if no work was available.  Used by
+  // jobs that wait on their own sub-jobs, so that the waiting worker keeps processing rather than idling.
+  bool ExecutePendingJob(cAvidaContext& ctx);
 
   void Start();
   void Execute();
   
-  int GetSeedForJob(int jobid) { Apto::MutexAutoLock lock(m_mutex); return m_job_seed_rng->GetInt(m_job_seed_rng->MaxSeed()); }
+  int GetNumWorkers() const { return m_workers.GetSize(); }
 };
 
 #endif
@@ -22,44 +22,31 @@
 #include "cAnalyzeJobWorker.h"
 
 #include "cAnalyzeJobQueue.h"
-#include "cAvidaContext.h"
-#include "cWorld.h"
 
 
 void cAnalyzeJobWorker::Run()
 {
-  Apto::RNG::AvidaRNG rng;
-  cAvidaContext ctx(&m_queue->m_world->GetDriver(), rng);
-  ctx.SetAnalyzeMode();
-  
-  cAnalyzeJob* job = NULL;
+  m_queue->m_mutex.Lock();
+  int submitted = m_queue->m_submitted;
+  m_queue->m_mutex.Unlock();
   
   while (1) {
+    cAnalyzeJob* job = m_queue->nextJob(m_id);
+    if (job) {
+      m_queue->runJob(job, m_id);
+      continue;
+    }
+    
+    // No work found in any deque, sleep unless new jobs were submitted since the last check
     m_queue->m_mutex.Lock();
-    while (m_queue->m_jobs == 0) {
+    while (!m_queue->m_shutdown && submitted == m_queue->m_submitted) {
       m_queue->m_cond.Wait(m_queue->m_mutex);
     }
-    job = m_queue->m_queue.Pop();
-    m_queue->m_jobs--;
-    m_queue->m_pending++; 
+    submitted = m_queue->m_submitted;
+    bool shutdown = m_queue->m_shutdown;
     m_queue->m_mutex.Unlock();
     
-    if (job) {
-      // Set RNG from the waiting pool and execute the job
-      rng.ResetSeed(m_queue->GetSeedForJob(job->GetID()));
-      job->Run(ctx);
-      delete job;
-      m_queue->m_mutex.Lock();
-      int pending = --m_queue->m_pending;
-      m_queue->m_mutex.Unlock();
-      if (!pending) m_queue->m_term_cond.Signal();
-    } else {
-      // Terminate worker on NULL job receipt
-      m_queue->m_mutex.Lock();
-      int pending = --m_queue->m_pending;
-      m_queue->m_mutex.Unlock();
-      if (!pending) m_queue->m_term_cond.Signal();
-      break;
-    }
+    // Terminate worker on shutdown
+    if (shutdown) break;
   }
 }
@@ -24,18 +24,27 @@
 
 #include "apto/core/Thread.h"
 
+#include "cAnalyzeJob.h"
+#include "tList.h"
+
 class cAnalyzeJobQueue;
 
 
 class cAnalyzeJobWorker : public Apto::Thread
 {
+  friend class cAnalyzeJobQueue;
+  
 private:
   cAnalyzeJobQueue* m_queue;
+  int m_id;
+  
+  Apto::Mutex m_deque_mutex;
+  tList<cAnalyzeJob> m_deque;   // owner works from the rear, thieves take from the front
   
   void Run();
 
 public:
-  cAnalyzeJobWorker(cAnalyzeJobQueue* queue) : m_queue(queue) { ; }  
+  cAnalyzeJobWorker(cAnalyzeJobQueue* queue, int worker_id) : m_queue(queue), m_id(worker_id) { ; }
 };
 
 #endif
@@ -21,6 +21,7 @@
 #include "cAnalyzeTreeStats_CumulativeStemminess.h"
 
 #include "cAnalyzeGenotype.h"
+#include "cPhylogenyIndex.h"
 #include "cWorld.h"
 
 
@@ -74,148 +75,63 @@ void cAnalyzeTreeStats_CumulativeStemminess::PrintAGLData(Apto::Array<cAGLData>
   }
 }
 
-void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(tList<cAnalyzeGenotype> &genotype_list){
-  cAnalyzeGenotype * genotype = NULL;
-  tListIterator<cAnalyzeGenotype> batch_it(genotype_list);
-  const int num_gens = genotype_list.GetSize();
+void cAnalyzeTreeStats_CumulativeStemminess::AnalyzeBatchTree(const cPhylogenyIndex& phylogeny){
+  const int num_gens = phylogeny.GetSize();
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
     cout << "Number of genotypes: " << num_gens << endl;
   }
 
-
-  int array_pos = 0;
-
-  /*
-  Put all of the genotypes in an array for easy reference and collect other
-  information on them as we process them. {{{4
-  */
-  if (m_world->GetVerbosity() >= VERBOSE_ON) {
-    cout << "Scanning genotypes..." << endl;
-  }
-  Apto::Array<cAnalyzeGenotype *> gen_array(num_gens);
-  Apto::Map<int, int> id_hash;  // Store array pos for each id.
-  Apto::Array<int> id_array(num_gens), pid_array(num_gens);
-  Apto::Array<int> depth_array(num_gens), birth_array(num_gens);
-
-  array_pos = 0;
-  batch_it.Reset();
-  while ((genotype = batch_it.Next()) != NULL) {
-    id_hash.Set(genotype->GetID(), array_pos);
-    array_pos++;
-  }
-
-  m_agl.Resize(num_gens);
-  array_pos = 0;
-  batch_it.Reset();
-  while ((genotype = batch_it.Next()) != NULL) {
-    // Put the genotype in an array.
-    m_agl[array_pos].genotype = genotype;
-    m_agl[array_pos].id = genotype->GetID();
-    m_agl[array_pos].pid = genotype->GetParentID();
-    m_agl[array_pos].depth = genotype->GetDepth();
-    m_agl[array_pos].birth = genotype->GetUpdateBorn();
-    array_pos++;
-  }
-
-  //// Now collect information about the offspring of each individual. {{{4
-  Apto::Array<int> ppos_array(num_gens), offspring_count(num_gens);
-  offspring_count.SetAll(0);
-
-  // For each genotype, figure out how far back you need to go to get to a branch point. {{{4
-  Apto::Array<int> anc_branch_dist_array(num_gens);
-  Apto::Array<int> anc_branch_pos_array(num_gens);
-  anc_branch_dist_array.SetAll(-1);
-  anc_branch_pos_array.SetAll(-1);
-  bool found = true;
-  int loop_count = 0;
-
-  /*
-  Link each offspring to its parent. {{{4
-  */
-  if (m_world->GetVerbosity() >= VERBOSE_ON) {
-    cout << "Assembling tree..." << endl;
-  }
-  for (int pos = 0; pos < num_gens; pos++) {
-    //cAnalyzeGenotype * genotype = gen_array[pos];
-    cAnalyzeGenotype * genotype = m_agl[pos].genotype;
-    int parent_id = genotype->GetParentID();
-    if (-1 != parent_id){
-      bool found_parent = id_hash.Get(parent_id, m_agl[pos].ppos);
-      if (found_parent){
-        int parent_position = m_agl[pos].ppos;
-        m_agl[parent_position].offspring_positions.Push(pos);
-        ///* XXX I think I'll be able to remove this. */
-        //cAnalyzeGenotype * parent_genotype = m_agl[parent_position].genotype;
-        //genotype->LinkParent(parent_genotype);
-      } else {
-        if (m_world->GetVerbosity() >= VERBOSE_ON) {
-          cerr << "Error: the parent of a non-root tree node is missing - " << endl;
-        }
-        return;
-      }
+  if (phylogeny.GetNumOrphans() > 0) {
+    if (m_world->GetVerbosity() >= VERBOSE_ON) {
+      cerr << "Error: the parent of a non-root tree node is missing - " << endl;
     }
+    return;
   }
 
   /*
-  Count offspring of each parent. {{{4
+  Collect information on each genotype, with parent and offspring positions
+  taken from the batch phylogeny. {{{4
   */
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
-    cout << "Loading offspring counts..." << endl;
+    cout << "Scanning genotypes..." << endl;
   }
+  m_agl.Resize(num_gens);
   for (int pos = 0; pos < num_gens; pos++) {
-    m_agl[pos].offspring_count = m_agl[pos].offspring_positions.GetSize();
+    cAnalyzeGenotype* genotype = phylogeny.GetGenotype(pos);
+    m_agl[pos].genotype = genotype;
+    m_agl[pos].id = genotype->GetID();
+    m_agl[pos].pid = genotype->GetParentID();
+    m_agl[pos].depth = genotype->GetDepth();
+    m_agl[pos].birth = genotype->GetUpdateBorn();
+    m_agl[pos].ppos = phylogeny.GetParent(pos);
+    m_agl[pos].offspring_count = phylogeny.GetNumChildren(pos);
+    m_agl[pos].offspring_positions.Resize(m_agl[pos].offspring_count);
+    for (int i = 0; i < m_agl[pos].offspring_count; i++) m_agl[pos].offspring_positions[i] = phylogeny.GetChild(pos, i);
   }
 
 
   /*
   For each genotype, figure out how far back you need to go to get to a branch point. {{{4
+  Parents are visited before their offspring, so a single pass suffices.
   */
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
     cout << "Finding branch points..." << endl;
   }
-  found = true;
-  loop_count = 0;
-  while (found == true) {
-    if (false && m_world->GetVerbosity() >= VERBOSE_ON) {
-      cout << endl << "  wave " << loop_count << "...";
-    }
-    found = false;
-
-    int genotypes_already_set = 0;
-    int genotypes_identified_as_root = 0;
-    int genotypes_with_branching_parent = 0;
-    int genotypes_with_calced_parent = 0;
-    int genotypes_not_ready = 0;
-
-    for (int pos = 0; pos < num_gens; pos++) {
-      if (m_agl[pos].anc_branch_dist > -1){
-        genotypes_already_set++;
-        continue; // continue if its set.
-      }
-      found = true;
-      int parent_pos = m_agl[pos].ppos;
-      if (parent_pos == -1) {
-        genotypes_identified_as_root++;
-        m_agl[pos].anc_branch_dist = 0;  // Org is root.
-      } else if (m_agl[parent_pos].offspring_count > 1) {        // Parent is branch.
-        genotypes_with_branching_parent++;
-        m_agl[pos].anc_branch_dist = 1;
-        m_agl[pos].anc_branch_id = m_agl[parent_pos].id;
-        m_agl[pos].anc_branch_pos = parent_pos;
-      } else if (m_agl[parent_pos].anc_branch_dist > -1) {     // Parent calculated.
-        genotypes_with_calced_parent++;
-        m_agl[pos].anc_branch_dist = m_agl[parent_pos].anc_branch_dist + 1;
-        m_agl[pos].anc_branch_id = m_agl[parent_pos].anc_branch_id;
-        m_agl[pos].anc_branch_pos = m_agl[parent_pos].anc_branch_pos;
-      } else {
-        genotypes_not_ready++;
-        // Otherwise, we are not yet ready to calculate this entry.
-      }
-    }
-    if (false && m_world->GetVerbosity() >= VERBOSE_ON) {
-      cout << " (" << genotypes_already_set << "," << genotypes_identified_as_root << "," << genotypes_with_branching_parent << "," << genotypes_with_calced_parent << "," << genotypes_not_ready << ")" << endl;
+  const Apto::Array<int>& preorder = phylogeny.GetPreorder();
+  for (int i = 0; i < preorder.GetSize(); i++) {
+    const int pos = preorder[i];
+    const int parent_pos = m_agl[pos].ppos;
+    if (parent_pos == -1) {
+      m_agl[pos].anc_branch_dist = 0;  // Org is root.
+    } else if (m_agl[parent_pos].offspring_count > 1) {        // Parent is branch.
+      m_agl[pos].anc_branch_dist = 1;
+      m_agl[pos].anc_branch_id = m_agl[parent_pos].id;
+      m_agl[pos].anc_branch_pos = parent_pos;
+    } else {                                                    // Parent calculated.
+      m_agl[pos].anc_branch_dist = m_agl[parent_pos].anc_branch_dist + 1;
+      m_agl[pos].anc_branch_id = m_agl[parent_pos].anc_branch_id;
+      m_agl[pos].anc_branch_pos = m_agl[parent_pos].anc_branch_pos;
     }
-    loop_count++;
   }
 
   if (m_world->GetVerbosity() >= VERBOSE_ON) {
@@ -25,6 +25,7 @@
 #include "tList.h"
 
 class cAnalyzeGenotype;
+class cPhylogenyIndex;
 class cWorld;
 
 
@@ -87,7 +88,7 @@ public:
   void PrintAGLData(Apto::Array<cAGLData> &agl);
 
   // Commands.
-  void AnalyzeBatchTree(tList<cAnalyzeGenotype> &genotype_list);
+  void AnalyzeBatchTree(const cPhylogenyIndex& phylogeny);
 };
 
 #endif
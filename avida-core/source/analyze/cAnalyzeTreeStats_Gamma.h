@@ -26,6 +26,7 @@
 #include "tList.h"
 
 class cAnalyzeGenotype;
+class cPhylogenyIndex;
 class cWorld;
 
 // Comparison functions for qsort.
@@ -65,16 +66,13 @@ public:
 public:
   cAnalyzeTreeStats_Gamma(cWorld* world);
   
-  void LoadGenotypes(tList<cAnalyzeGenotype> &genotype_list);
-  void MapIDToGenotypePos(Apto::Array<cAnalyzeGenotype *>&lineage, Apto::Map<int, int>& out_mapping);
-  void Unlink(Apto::Array<cAnalyzeGenotype *>& lineage);
-  void EstablishLinks(Apto::Array<cAnalyzeGenotype *>& lineage, Apto::Map<int, int>& out_mapping);
+  void LoadGenotypes(const cPhylogenyIndex& phylogeny);
   void FindFurcations(
-    Apto::Array<cAnalyzeGenotype *> &lineage,
+    const cPhylogenyIndex& phylogeny,
     Apto::Array<cAnalyzeLineageFurcation> &out_furcations
   );
   void FindFurcationTimes(
-    Apto::Array<cAnalyzeGenotype *> &lineage,
+    const cPhylogenyIndex& phylogeny,
     int (*furcation_time_policy)(cAnalyzeLineageFurcation &furcation),
     Apto::Array<int> &out_furcation_times
   );
@@ -92,7 +90,7 @@ public:
   
   // Commands.
   void AnalyzeBatch(
-    tList<cAnalyzeGenotype> &genotype_list,
+    const cPhylogenyIndex& phylogeny,
     int end_time,
     int furcation_time_convention
   );    
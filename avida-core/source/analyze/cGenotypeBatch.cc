@@ -22,9 +22,11 @@
 #include "cGenotypeBatch.h"
 
 #include "cAnalyzeGenotype.h"
+#include "cPhylogenyIndex.h"
 
 
-cGenotypeBatch::cGenotypeBatch(const cGenotypeBatch& rhs) : m_list(rhs.m_list), m_name(rhs.m_name), m_is_lineage(rhs.m_is_lineage), m_is_aligned(rhs.m_is_aligned)
+cGenotypeBatch::cGenotypeBatch(const cGenotypeBatch& rhs)
+  : m_list(rhs.m_list), m_name(rhs.m_name), m_is_lineage(rhs.m_is_lineage), m_is_aligned(rhs.m_is_aligned), m_phylogeny(NULL)
 {
   if (rhs.m_lineage_head) {
     m_lineage_head = new cAnalyzeGenotype(*(rhs.m_lineage_head));
@@ -43,6 +45,7 @@ cGenotypeBatch::~cGenotypeBatch()
   
   delete m_lineage_head;
   delete m_clade_head;
+  delete m_phylogeny;
 }
 
 cGenotypeBatch& cGenotypeBatch::operator=(const cGenotypeBatch& rhs)
@@ -57,6 +60,9 @@ cGenotypeBatch& cGenotypeBatch::operator=(const cGenotypeBatch& rhs)
   m_is_aligned = rhs.m_is_aligned;
 
   // pointery bits
+  delete m_phylogeny;
+  m_phylogeny = NULL;
+
   delete m_lineage_head;
   if (rhs.m_lineage_head) {
     m_lineage_head = new cAnalyzeGenotype(*(rhs.m_lineage_head));
@@ -71,6 +77,16 @@ cGenotypeBatch& cGenotypeBatch::operator=(const cGenotypeBatch& rhs)
 }
 
 
+const cPhylogenyIndex& cGenotypeBatch::Phylogeny() const
+{
+  if (!m_phylogeny || !m_phylogeny->Matches(m_list)) {
+    delete m_phylogeny;
+    m_phylogeny = new cPhylogenyIndex(m_list);
+  }
+  return *m_phylogeny;
+}
+
+
 cAnalyzeGenotype* cGenotypeBatch::FindGenotypeNumCPUs() const
 {
   return new cAnalyzeGenotype(*(m_list.FindMax(&cAnalyzeGenotype::GetNumCPUs)));
@@ -183,40 +199,15 @@ cAnalyzeGenotype* cGenotypeBatch::FindLastCommonAncestor()
   // Finds the last common ancestor among all current organisms that are still alive,
   // i.e. have an update_died of -1.
   
-  // Connect each genotype to its parent.
-  tListIterator<cAnalyzeGenotype> it(m_list);
-  tListIterator<cAnalyzeGenotype> parent_it(m_list);
-  cAnalyzeGenotype* on_child = NULL;
-  while ((on_child = it.Next())) {
-    parent_it.Reset();
-    cAnalyzeGenotype* on_parent = NULL;
-    while ((on_parent = parent_it.Next())) {
-      if (on_child->GetParentID() == on_parent->GetID()) {
-        on_child->LinkParent(on_parent);
-        break;
-      }
-    }
-  }
-    
-  // Find the genotype without a parent (there should only be one)
-  it.Reset();
-  cAnalyzeGenotype* lca = NULL;
-  cAnalyzeGenotype* test_lca = NULL;
-  while ((test_lca = it.Next())) {
-    if (!test_lca->GetParent()) {
-      // It is an error to get two genotypes without a parent
-      if (lca) return NULL;
-      lca = test_lca;
-    }
-  }
+  // It is an error to get two genotypes without a parent
+  const cPhylogenyIndex& phylogeny = Phylogeny();
+  if (phylogeny.GetRoots().GetSize() != 1) return NULL;
   
-  // Follow the children from this parent until we find a genotype with more than one child.
-  // This is the last common ancestor.
-  while (lca->GetChildList().GetSize() == 1) {
-    lca = lca->GetChildList().Pop();
-  }
+  // The last common ancestor is where the tree first branches, the common ancestor of all of its tips
+  const int lca = phylogeny.FindLeafLCA();
+  if (lca < 0) return NULL;
   
-  return new cAnalyzeGenotype(*lca);
+  return new cAnalyzeGenotype(*phylogeny.GetGenotype(lca));
 }
 
 
@@ -231,12 +222,14 @@ cGenotypeBatch* cGenotypeBatch::FindLineage(cAnalyzeGenotype* end_genotype) cons
 cGenotypeBatch* cGenotypeBatch::FindLineage(int end_genotype_id) const
 {
   cGenotypeBatch* batch = new cGenotypeBatch;
-  cAnalyzeGenotype* found_gen = FindGenotypeID(end_genotype_id);
+  const cPhylogenyIndex& phylogeny = Phylogeny();
+  Apto::Array<int> lineage;
+  phylogeny.FindLineage(phylogeny.FindPosition(end_genotype_id), lineage);
   
-  while ((found_gen)) {
+  for (int i = 0; i < lineage.GetSize(); i++) {
+    cAnalyzeGenotype* found_gen = new cAnalyzeGenotype(*phylogeny.GetGenotype(lineage[i]));
     batch->m_list.Push(found_gen);
     batch->m_lineage_head = found_gen;
-    found_gen = FindGenotypeID(found_gen->GetParentID());
   }
     
   return batch;
@@ -355,28 +348,15 @@ cGenotypeBatch* cGenotypeBatch::FindClade(cAnalyzeGenotype* start_genotype) cons
 cGenotypeBatch* cGenotypeBatch::FindClade(int start_genotype_id) const
 {
   cGenotypeBatch* batch = new cGenotypeBatch;
-  tList<cAnalyzeGenotype> list(m_list);
-  Apto::Array<int, Apto::Smart> scan_list;
-  cAnalyzeGenotype* found_gen = FindGenotypeID(start_genotype_id);
- 
-  if ((found_gen)) {
-    batch->m_list.Push(found_gen);
-    batch->m_clade_head = found_gen;
-    scan_list.Push(found_gen->GetID());
-  }
+  const cPhylogenyIndex& phylogeny = Phylogeny();
+  Apto::Array<int> clade;
+  phylogeny.FindClade(phylogeny.FindPosition(start_genotype_id), clade, true);
   
-  while (scan_list.GetSize()) {
-    int parent_id = scan_list.Pop();
-    
-    // Seach for all of the offspring of this genotype...
-    tListIterator<cAnalyzeGenotype> it(list);
-    while ((found_gen = it.Next()) != NULL) {
-      if (found_gen->GetParentID() == parent_id) {
-        it.Remove();
-        scan_list.Push(found_gen->GetID());
-        batch->m_list.Push(new cAnalyzeGenotype(*found_gen));
-      }
-    }
+  // Genotypes are pushed onto the front of the batch as the scan finds them, so the clade head ends up last
+  for (int i = 0; i < clade.GetSize(); i++) {
+    cAnalyzeGenotype* found_gen = new cAnalyzeGenotype(*phylogeny.GetGenotype(clade[i]));
+    batch->m_list.Push(found_gen);
+    if (i == 0) batch->m_clade_head = found_gen;
   }
 
   return batch;
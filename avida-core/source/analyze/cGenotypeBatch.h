@@ -33,6 +33,7 @@
 // cGenotypeBatch      : Collection of cAnalyzeGenotypes
 
 class cAnalyzeGenotype;
+class cPhylogenyIndex;
 
 
 class cGenotypeBatch
@@ -44,9 +45,11 @@ private:
   cAnalyzeGenotype* m_clade_head;
   bool m_is_lineage;
   bool m_is_aligned;
+  mutable cPhylogenyIndex* m_phylogeny;
   
 public:
-  cGenotypeBatch() : m_name(""), m_lineage_head(NULL), m_clade_head(NULL), m_is_lineage(false), m_is_aligned(false) { ; }
+  cGenotypeBatch()
+    : m_name(""), m_lineage_head(NULL), m_clade_head(NULL), m_is_lineage(false), m_is_aligned(false), m_phylogeny(NULL) { ; }
   cGenotypeBatch(const cGenotypeBatch&);
   ~cGenotypeBatch();
 
@@ -67,6 +70,9 @@ public:
   
   void MergeWith(cGenotypeBatch* batch) { m_list.Append(batch->m_list); }
   
+  // Parent/child index of the current list.  Kept between calls and rebuilt only once the list has changed.
+  const cPhylogenyIndex& Phylogeny() const;
+  
   cAnalyzeGenotype* FindGenotypeNumCPUs() const;
   cAnalyzeGenotype* PopGenotypeNumCPUs();
   cAnalyzeGenotype* FindGenotypeTotalCPUs() const;
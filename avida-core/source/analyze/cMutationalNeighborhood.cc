@@ -41,7 +41,7 @@ using namespace std;
 
 cMutationalNeighborhood::cMutationalNeighborhood(cWorld* world, const Genome& genome, int target)
   : m_world(world), m_initialized(false)
-  , m_inst_set(m_world->GetHardwareManager().GetInstSet(genome.Properties().Get("instset").StringValue()))
+  , m_inst_set(m_world->GetHardwareManager().GetInstSet(genome))
   , m_target(target), m_base_genome(genome)
 {
   InstructionSequencePtr seq;
@@ -206,10 +206,10 @@ void cMutationalNeighborhood::ProcessInitialize(cAvidaContext& ctx)
   //  - will allow workers to begin processing if job queue already active
   m_mutex.Unlock();
   
-  // Load enough jobs to process all sites
+  // Load enough jobs to process all sites, as sub-jobs of the initializing job (if any)
   cAnalyzeJobQueue& jobqueue = m_world->GetAnalyze().GetJobQueue();
   for (int i = 0; i < m_base_genome_size; i++)
-    jobqueue.AddJob(new tAnalyzeJob<cMutationalNeighborhood>(this, &cMutationalNeighborhood::Process));
+    jobqueue.AddSubJob(ctx, new tAnalyzeJob<cMutationalNeighborhood>(this, &cMutationalNeighborhood::Process));
   
   jobqueue.Start();
 }
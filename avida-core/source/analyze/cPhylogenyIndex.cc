@@ -0,0 +1,205 @@
+/*
+ *  cPhylogenyIndex.cc
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPhylogenyIndex.h"
+
+#include "cAnalyzeGenotype.h"
+
+
+cPhylogenyIndex::cPhylogenyIndex(const tList<cAnalyzeGenotype>& genotype_list) : m_num_orphans(0)
+{
+  const int num_gens = genotype_list.GetSize();
+  m_genotypes.Resize(num_gens);
+  m_ids.Resize(num_gens);
+  m_parent_ids.Resize(num_gens);
+
+  tConstListIterator<cAnalyzeGenotype> it(genotype_list);
+  cAnalyzeGenotype* genotype = NULL;
+  for (int pos = 0; (genotype = it.Next()); pos++) {
+    m_genotypes[pos] = genotype;
+    m_ids[pos] = genotype->GetID();
+    m_parent_ids[pos] = genotype->GetParentID();
+    if (!m_id_pos.Has(m_ids[pos])) m_id_pos.Set(m_ids[pos], pos);
+  }
+
+  // Resolve parents and count children
+  m_parent.Resize(num_gens, -1);
+  m_child_start.Resize(num_gens + 1, 0);
+  for (int pos = 0; pos < num_gens; pos++) {
+    int parent_pos = -1;
+    if (m_id_pos.Get(m_parent_ids[pos], parent_pos) && parent_pos != pos) {
+      m_parent[pos] = parent_pos;
+      m_child_start[parent_pos + 1]++;
+    } else {
+      m_roots.Push(pos);
+      if (m_parent_ids[pos] >= 0) m_num_orphans++;
+    }
+  }
+
+  // Lay the children out contiguously, each parent's children in list order
+  for (int pos = 0; pos < num_gens; pos++) m_child_start[pos + 1] += m_child_start[pos];
+  m_children.Resize(m_child_start[num_gens]);
+  Apto::Array<int> fill(num_gens);
+  for (int pos = 0; pos < num_gens; pos++) fill[pos] = m_child_start[pos];
+  for (int pos = 0; pos < num_gens; pos++) {
+    if (m_parent[pos] >= 0) m_children[fill[m_parent[pos]]++] = pos;
+  }
+
+  // Depth-first visit from each root.  Genotypes caught in a parent cycle are never reached and keep a visit of -1.
+  m_visit.Resize(num_gens, -1);
+  m_depth.Resize(num_gens, -1);
+  Apto::Array<int, Apto::Smart> stack;
+  for (int r = 0; r < m_roots.GetSize(); r++) {
+    m_depth[m_roots[r]] = 0;
+    stack.Push(m_roots[r]);
+    while (stack.GetSize()) {
+      const int pos = stack.Pop();
+      m_visit[pos] = m_preorder.GetSize();
+      m_preorder.Push(pos);
+      for (int i = GetNumChildren(pos) - 1; i >= 0; i--) {
+        const int child = GetChild(pos, i);
+        m_depth[child] = m_depth[pos] + 1;
+        stack.Push(child);
+      }
+    }
+  }
+}
+
+
+bool cPhylogenyIndex::Matches(const tList<cAnalyzeGenotype>& genotype_list) const
+{
+  if (genotype_list.GetSize() != m_genotypes.GetSize()) return false;
+
+  tConstListIterator<cAnalyzeGenotype> it(genotype_list);
+  cAnalyzeGenotype* genotype = NULL;
+  for (int pos = 0; (genotype = it.Next()); pos++) {
+    if (genotype != m_genotypes[pos] || genotype->GetID() != m_ids[pos] || genotype->GetParentID() != m_parent_ids[pos]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+int cPhylogenyIndex::FindPosition(int id) const
+{
+  int pos = -1;
+  if (m_id_pos.Get(id, pos)) return pos;
+  return -1;
+}
+
+
+void cPhylogenyIndex::FindLineage(int pos, Apto::Array<int>& lineage) const
+{
+  lineage.Resize(0);
+
+  // A parent cycle has no root, so bound the walk by the batch size
+  for (int steps = 0; pos >= 0 && steps < m_genotypes.GetSize(); steps++) {
+    lineage.Push(pos);
+    pos = m_parent[pos];
+  }
+}
+
+
+void cPhylogenyIndex::FindClade(int pos, Apto::Array<int>& clade, bool discovery_order) const
+{
+  clade.Resize(0);
+  if (pos < 0) return;
+
+  // Mirrors a scan that pushes each genotype's children, in list order, onto the front of a work list
+  Apto::Array<bool> seen(m_genotypes.GetSize());
+  seen.SetAll(false);
+  Apto::Array<int, Apto::Smart> stack;
+  stack.Push(pos);
+  seen[pos] = true;
+  if (discovery_order) clade.Push(pos);
+  while (stack.GetSize()) {
+    const int cur = stack.Pop();
+    if (!discovery_order) clade.Push(cur);
+    for (int i = 0; i < GetNumChildren(cur); i++) {
+      const int child = GetChild(cur, i);
+      if (seen[child]) continue;
+      seen[child] = true;
+      stack.Push(child);
+      if (discovery_order) clade.Push(child);
+    }
+  }
+}
+
+
+int cPhylogenyIndex::FindLCA(int pos1, int pos2) const
+{
+  if (pos1 == pos2) return pos1;
+  if (m_visit[pos1] < 0 || m_visit[pos2] < 0) return -1;
+
+  if (m_lca_table.GetSize() == 0) buildLCATable();
+
+  // The shallowest genotype visited after the first position, up to and including the second, is the child of the
+  // common ancestor on the path to the second.  Crossing into another tree finds that tree's root instead.
+  int begin = m_visit[pos1];
+  int end = m_visit[pos2];
+  if (begin > end) { int tmp = begin; begin = end; end = tmp; }
+  begin++;
+
+  int level = 0;
+  while ((2 << level) <= end - begin + 1) level++;
+  const int lhs = m_lca_table[level][begin];
+  const int rhs = m_lca_table[level][end - (1 << level) + 1];
+  const int shallowest = (m_depth[lhs] <= m_depth[rhs]) ? lhs : rhs;
+
+  return m_parent[shallowest];
+}
+
+
+int cPhylogenyIndex::FindLeafLCA() const
+{
+  int lca = -1;
+  for (int i = 0; i < m_preorder.GetSize(); i++) {
+    const int pos = m_preorder[i];
+    if (GetNumChildren(pos)) continue;
+    lca = (lca < 0) ? pos : FindLCA(lca, pos);
+    if (lca < 0) break;
+  }
+  return lca;
+}
+
+
+void cPhylogenyIndex::buildLCATable() const
+{
+  // m_lca_table[k][i] holds the shallowest position among the 2^k visits starting at visit i
+  const int num_visits = m_preorder.GetSize();
+  int num_levels = 1;
+  while ((1 << num_levels) <= num_visits) num_levels++;
+
+  m_lca_table.Resize(num_levels);
+  m_lca_table[0] = m_preorder;
+  for (int k = 1; k < num_levels; k++) {
+    const int half = 1 << (k - 1);
+    const int count = num_visits - (1 << k) + 1;
+    const Apto::Array<int>& prev = m_lca_table[k - 1];
+    Apto::Array<int>& cur = m_lca_table[k];
+    cur.Resize(count);
+    for (int i = 0; i < count; i++) {
+      const int lhs = prev[i];
+      const int rhs = prev[i + half];
+      cur[i] = (m_depth[lhs] <= m_depth[rhs]) ? lhs : rhs;
+    }
+  }
+}
@@ -0,0 +1,97 @@
+/*
+ *  cPhylogenyIndex.h
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cPhylogenyIndex_h
+#define cPhylogenyIndex_h
+
+#include "apto/core.h"
+
+#include "tList.h"
+
+class cAnalyzeGenotype;
+
+
+// cPhylogenyIndex     : Parent/child structure of the genotypes in a batch
+//
+// Genotypes are addressed by their position in the batch list.  Parents are resolved once through an id hash (the
+// first genotype carrying an id wins, as with a list scan) and the children of every genotype are stored contiguously
+// in list order.  A genotype whose parent is not in the batch is a root.  Lowest common ancestor queries use a sparse
+// table over the depth-first visit order, built the first time one is asked for.
+
+class cPhylogenyIndex
+{
+private:
+  Apto::Array<cAnalyzeGenotype*> m_genotypes;
+  Apto::Array<int> m_ids;
+  Apto::Array<int> m_parent_ids;
+  Apto::Map<int, int> m_id_pos;
+
+  Apto::Array<int> m_parent;        // Position of the parent, -1 for roots
+  Apto::Array<int> m_child_start;   // Children of pos are m_children[m_child_start[pos]..m_child_start[pos + 1])
+  Apto::Array<int> m_children;
+  Apto::Array<int> m_roots;
+  int m_num_orphans;                // Roots whose parent id is set but not present in the batch
+
+  Apto::Array<int> m_preorder;      // Depth-first visit order, parents before children
+  Apto::Array<int> m_visit;         // Index of each position in m_preorder, -1 if unreachable from a root
+  Apto::Array<int> m_depth;         // Distance from the root
+
+  mutable Apto::Array<Apto::Array<int> > m_lca_table;
+
+
+  cPhylogenyIndex(const cPhylogenyIndex&); // @not_implemented
+  cPhylogenyIndex& operator=(const cPhylogenyIndex&); // @not_implemented
+
+public:
+  cPhylogenyIndex(const tList<cAnalyzeGenotype>& genotype_list);
+  ~cPhylogenyIndex() { ; }
+
+  // True if genotype_list still holds the genotypes, ids and parent ids this index was built from
+  bool Matches(const tList<cAnalyzeGenotype>& genotype_list) const;
+
+  inline int GetSize() const { return m_genotypes.GetSize(); }
+  inline cAnalyzeGenotype* GetGenotype(int pos) const { return m_genotypes[pos]; }
+  int FindPosition(int id) const;
+
+  inline int GetParent(int pos) const { return m_parent[pos]; }
+  inline int GetNumChildren(int pos) const { return m_child_start[pos + 1] - m_child_start[pos]; }
+  inline int GetChild(int pos, int idx) const { return m_children[m_child_start[pos] + idx]; }
+  inline int GetDepth(int pos) const { return m_depth[pos]; }
+
+  inline const Apto::Array<int>& GetRoots() const { return m_roots; }
+  inline int GetNumOrphans() const { return m_num_orphans; }
+  inline const Apto::Array<int>& GetPreorder() const { return m_preorder; }
+
+  // Positions from pos back to its root, pos first
+  void FindLineage(int pos, Apto::Array<int>& lineage) const;
+  // Positions of pos and all of its descendants.  A scan from pos that stacks each genotype's children in list order
+  // expands them in the returned order; with discovery_order set, they are returned in the order the scan finds them.
+  void FindClade(int pos, Apto::Array<int>& clade, bool discovery_order = false) const;
+  // Lowest common ancestor of two positions, -1 if they do not share a root
+  int FindLCA(int pos1, int pos2) const;
+  // Lowest common ancestor of all leaves reachable from the roots, -1 if the batch is empty or not a single tree
+  int FindLeafLCA() const;
+
+
+private:
+  void buildLCATable() const;
+};
+
+#endif
@@ -43,6 +43,7 @@ protected:
   
 protected:
   cAnalyzeJobQueue& m_queue;
+  cAvidaContext* m_ctx;   // context of the spawning job for nested batches, NULL for top level batches
   
   int m_jobs;
   
@@ -51,14 +52,16 @@ protected:
   
   
 public:
-  tAnalyzeJobBatch(cAnalyzeJobQueue& queue) : m_queue(queue), m_jobs(0) { ; }
+  tAnalyzeJobBatch(cAnalyzeJobQueue& queue) : m_queue(queue), m_ctx(NULL), m_jobs(0) { ; }
+  tAnalyzeJobBatch(cAnalyzeJobQueue& queue, cAvidaContext& ctx) : m_queue(queue), m_ctx(&ctx), m_jobs(0) { ; }
   
   void AddJob(JobClass* target, void (JobClass::*funJ)(cAvidaContext&))
   {
     m_mutex.Lock();
     m_jobs++;
     m_mutex.Unlock();
-    m_queue.AddJob(new tAnalyzeBatchJob<JobClass>(this, target, funJ));
+    if (m_ctx) m_queue.AddSubJob(*m_ctx, new tAnalyzeBatchJob<JobClass>(this, target, funJ));
+    else m_queue.AddJob(new tAnalyzeBatchJob<JobClass>(this, target, funJ));
   }
   
   void RunBatch()
@@ -66,7 +69,14 @@ public:
     m_queue.Start();
     m_mutex.Lock();
     while (m_jobs > 0) {
-      m_cond.Wait(m_mutex);
+      if (m_ctx) {
+        // Nested batch, help process queued jobs rather than blocking the worker that is waiting on this batch
+        m_mutex.Unlock();
+        bool executed = m_queue.ExecutePendingJob(*m_ctx);
+        m_mutex.Lock();
+        if (executed) continue;
+      }
+      if (m_jobs > 0) m_cond.Wait(m_mutex);
     }
     m_mutex.Unlock();
   }
@@ -24,6 +24,7 @@
 
 #include "avida/core/Genome.h"
 
+#include "apto/core/Mutex.h"
 #include "apto/core/Set.h"
 #include "avida/core/Feedback.h"
 #include "avida/core/InstructionSequence.h"
@@ -38,6 +39,10 @@
 static Apto::BasicString<Apto::ThreadSafe> s_prop_id_instset("instset");
 static PropertyDescriptionMap s_prop_desc_map;
 
+// Instruction set names interned for the life of the process; IDs are never reused
+static Apto::Mutex s_inst_set_name_mutex;
+static Apto::Map<Apto::String, int> s_inst_set_name_ids;
+
 void cHardwareManager::Initialize()
 {
   s_prop_desc_map.Set(s_prop_id_instset, "Instruction Set");
@@ -48,6 +53,17 @@ void cHardwareManager::SetupPropertyMap(PropertyMap& props, const Apto::String&
   props.Define(PropertyPtr(new StringProperty(s_prop_id_instset, s_prop_desc_map, instset)));
 }
 
+int cHardwareManager::InstSetNameID(const Apto::String& name)
+{
+  Apto::MutexAutoLock lock(s_inst_set_name_mutex);
+  int name_id = -1;
+  if (!s_inst_set_name_ids.Get(name, name_id)) {
+    name_id = s_inst_set_name_ids.GetSize();
+    s_inst_set_name_ids.Set(name.Clone(), name_id);
+  }
+  return name_id;
+}
+
 
 
 Avida::Genome::Genome() : m_hw_type(-1) { ; }
@@ -57,8 +73,22 @@ Avida::Genome::Genome(HardwareTypeID hw, const PropertyMap& props, GeneticRepres
 {
   assert(rep);
   
-  // Copy over properties
-  m_props.SetValue(s_prop_id_instset, props.Get(s_prop_id_instset).StringValue());
+  // Copy over properties, carrying the interned inst set ID along when the source is another genome's map
+  const InstSetPropertyMap* is_props = dynamic_cast<const InstSetPropertyMap*>(&props);
+  if (is_props && is_props->InstSetID() >= 0) {
+    m_props.SetInstSet(props.Get(s_prop_id_instset).StringValue().Clone(), is_props->InstSetID());
+  } else {
+    m_props.SetValue(s_prop_id_instset, props.Get(s_prop_id_instset).StringValue());
+  }
+}
+
+Avida::Genome::Genome(HardwareTypeID hw, const Apto::String& inst_set, int inst_set_id, GeneticRepresentationPtr rep)
+  : m_hw_type(hw), m_representation(rep)
+{
+  assert(rep);
+  
+  if (inst_set_id >= 0) m_props.SetInstSet(inst_set, inst_set_id);
+  else m_props.SetValue(s_prop_id_instset, inst_set);
 }
 
 Avida::Genome::Genome(const Apto::String& genome_str)
@@ -73,7 +103,7 @@ Avida::Genome::Genome(const Apto::String& genome_str)
 Avida::Genome::Genome(const Genome& genome)
 : m_hw_type(genome.m_hw_type), m_representation(genome.m_representation->Clone())
 {
-  m_props.SetValue(s_prop_id_instset, genome.m_props.Get(s_prop_id_instset).StringValue().Clone());
+  m_props.SetInstSet(genome.m_props.Get(s_prop_id_instset).StringValue().Clone(), genome.InstSetID());
 }
 
 
@@ -101,7 +131,7 @@ Avida::Genome& Avida::Genome::operator=(const Genome& genome)
 {
   m_hw_type = genome.m_hw_type;
   
-  m_props.SetValue(s_prop_id_instset, genome.m_props.Get(s_prop_id_instset).StringValue());
+  m_props.SetInstSet(genome.m_props.Get(s_prop_id_instset).StringValue(), genome.InstSetID());
 
   m_representation = genome.m_representation->Clone();
   
@@ -133,9 +163,16 @@ bool Avida::Genome::LegacySave(void* dfp) const
 
 
 
-Avida::Genome::InstSetPropertyMap::InstSetPropertyMap() : m_inst_set(s_prop_id_instset, s_prop_desc_map, Apto::String("")) { ; }
+Avida::Genome::InstSetPropertyMap::InstSetPropertyMap()
+  : m_inst_set(s_prop_id_instset, s_prop_desc_map, Apto::String("")), m_inst_set_id(-1) { ; }
 Avida::Genome::InstSetPropertyMap::~InstSetPropertyMap() { ; }
 
+void Avida::Genome::InstSetPropertyMap::SetInstSet(const Apto::String& name, int name_id)
+{
+  m_inst_set.SetValue(name);
+  m_inst_set_id = name_id;
+}
+
 int Avida::Genome::InstSetPropertyMap::GetSize() const { return 1; }
 bool Avida::Genome::InstSetPropertyMap::Has(const PropertyID& p_id) const { return (p_id == s_prop_id_instset); }
 
@@ -151,7 +188,9 @@ const Avida::Property& Avida::Genome::InstSetPropertyMap::Get(const PropertyID&
 bool Avida::Genome::InstSetPropertyMap::SetValue(const PropertyID& p_id, const Apto::String& prop_value)
 {
   if (p_id == s_prop_id_instset) {
-    return m_inst_set.SetValue(prop_value);
+    if (!m_inst_set.SetValue(prop_value)) return false;
+    m_inst_set_id = cHardwareManager::InstSetNameID(prop_value);
+    return true;
   }
   return false;
 }
@@ -35,14 +35,14 @@ const double MEMORY_SHRINK_TEST_FACTOR = 4.0;
 
 
 Avida::InstructionSequence::InstructionSequence(const InstructionSequence& seq)
-: GeneticRepresentation(seq), m_seq(seq.GetSize()), m_active_size(seq.GetSize())
+: GeneticRepresentation(seq), m_storage(seq.m_storage), m_active_size(seq.GetSize())
 {
-  for (int i = 0; i < m_active_size; i++)  m_seq[i] = seq[i];
 }
 
-Avida::InstructionSequence::InstructionSequence(const Apto::String& str)
+Avida::InstructionSequence::InstructionSequence(const Apto::String& str) : m_storage(new Storage)
 {
-  m_seq.ResizeClear(str.GetSize());
+  Apto::Array<Instruction>& data = m_storage->seq;
+  data.ResizeClear(str.GetSize());
   int size = 0;
   for (int i = 0; i < str.GetSize(); i++) {
     if (str[i] == '_') continue;
@@ -51,16 +51,16 @@ Avida::InstructionSequence::InstructionSequence(const Apto::String& str)
       case '-':
       case '~':
       case '?':
-        if (!m_seq[size].SetSymbol(str.Substring(i, 2))) continue;
+        if (!data[size].SetSymbol(str.Substring(i, 2))) continue;
         i++;
         break;
       default:
-        if (!m_seq[size].SetSymbol(str.Substring(i, 1))) continue;
+        if (!data[size].SetSymbol(str.Substring(i, 1))) continue;
     }
     size++;
   }
   m_active_size = size;
-  m_seq.Resize(size);
+  data.Resize(size);
 }
 
 Avida::InstructionSequence::~InstructionSequence() { ; }
@@ -149,6 +149,12 @@ bool Avida::Instruction::SetSymbol(const Apto::String& symbol)
 
 
 
+void Avida::InstructionSequence::copyStorage()
+{
+  m_storage = StoragePtr(new Storage(*m_storage));
+}
+
+
 void Avida::InstructionSequence::adjustCapacity(int new_size)
 {
   assert(new_size > 0);
@@ -156,14 +162,14 @@ void Avida::InstructionSequence::adjustCapacity(int new_size)
   // Make sure we're really changing the size...
   if (new_size == m_active_size) return;
   
-  const int array_size = m_seq.GetSize();
+  const int array_size = seq().GetSize();
   
   // Determine if we need to adjust the allocated array sizes...
   if (new_size > array_size || new_size * MEMORY_SHRINK_TEST_FACTOR < array_size) {
     int new_array_size = (int) (new_size * MEMORY_INCREASE_FACTOR);
     const int new_array_min = new_size + MEMORY_INCREASE_MINIMUM;
 		if (new_array_min > new_array_size) new_array_size = new_array_min;
-    m_seq.Resize(new_array_size);
+    mutableSeq().Resize(new_array_size);
   }
   
   // And just change the m_active_size once we're sure it will be in range.
@@ -181,7 +187,8 @@ void Avida::InstructionSequence::prepareInsert(int pos, int num_sites)
   adjustCapacity(new_size);
   
   // Shift any sites needed...
-  for (int i = old_size - 1; i >= pos; i--) m_seq[i + num_sites] = m_seq[i];
+  Apto::Array<Instruction>& data = mutableSeq();
+  for (int i = old_size - 1; i >= pos; i--) data[i + num_sites] = data[i];
 }
 
 
@@ -189,7 +196,8 @@ void Avida::InstructionSequence::Copy(int to, int from)
 {
   assert(to   >= 0   && to   < m_active_size);
   assert(from >= 0   && from < m_active_size);
-  m_seq[to] = m_seq[from];
+  Apto::Array<Instruction>& data = mutableSeq();
+  data[to] = data[from];
 }
  
 
@@ -197,7 +205,7 @@ void Avida::InstructionSequence::Copy(int to, int from)
 Apto::String Avida::InstructionSequence::AsString() const
 {
   Apto::StringBuffer out_string;
-  for (int i = 0; i < m_active_size; i++) out_string += m_seq[i].GetSymbol();
+  for (int i = 0; i < m_active_size; i++) out_string += seq()[i].GetSymbol();
 
   return Apto::String(out_string);
 }
@@ -223,25 +231,32 @@ void Avida::InstructionSequence::Resize(int new_size)
   const int old_size = m_active_size;
   adjustCapacity(new_size);
   
-  for (int i = old_size; i < new_size; i++) m_seq[i].SetOp(0);
+  if (new_size > old_size) {
+    Apto::Array<Instruction>& data = mutableSeq();
+    for (int i = old_size; i < new_size; i++) data[i].SetOp(0);
+  }
 }
 
 void Avida::InstructionSequence::Insert(int pos, const Instruction& inst)
 {
   assert(pos >= 0);
-  assert(pos <= m_seq.GetSize());
+  assert(pos <= m_active_size);
   
   prepareInsert(pos, 1);
-  m_seq[pos] = inst;
+  mutableSeq()[pos] = inst;
 }
 
-void Avida::InstructionSequence::Insert(int pos, const InstructionSequence& seq)
+void Avida::InstructionSequence::Insert(int pos, const InstructionSequence& in_seq)
 {
   assert(pos >= 0);
-  assert(pos <= m_seq.GetSize());
-  
-  prepareInsert(pos, seq.GetSize());
-  for (int i = 0; i < seq.GetSize(); i++) m_seq[i + pos] = seq[i];
+  assert(pos <= m_active_size);
+  
+  // Take a reference first, in_seq may be this sequence
+  const StoragePtr in_storage(in_seq.m_storage);
+  const int in_size = in_seq.GetSize();
+  prepareInsert(pos, in_size);
+  Apto::Array<Instruction>& data = mutableSeq();
+  for (int i = 0; i < in_size; i++) data[i + pos] = in_storage->seq[i];
 }
 
 void Avida::InstructionSequence::Remove(int pos, int num_sites)
@@ -251,24 +266,28 @@ void Avida::InstructionSequence::Remove(int pos, int num_sites)
   assert(pos + num_sites <= m_active_size); // Cannot extend past end of sequence
   
   const int new_size = m_active_size - num_sites;
-  for (int i = pos; i < new_size; i++) m_seq[i] = m_seq[i + num_sites];
+  Apto::Array<Instruction>& data = mutableSeq();
+  for (int i = pos; i < new_size; i++) data[i] = data[i + num_sites];
   adjustCapacity(new_size);
 }
 
-void Avida::InstructionSequence::Replace(int pos, int num_sites, const InstructionSequence& seq)
+void Avida::InstructionSequence::Replace(int pos, int num_sites, const InstructionSequence& in_seq)
 {
   assert(pos >= 0);                         // Replace must be in sequence
   assert(num_sites >= 0);                   // Cannot replace negative
   assert(pos + num_sites <= m_active_size); // Cannot extend past end!
   
-  const int size_change = seq.GetSize() - num_sites;
+  const StoragePtr in_storage(in_seq.m_storage);
+  const int in_size = in_seq.GetSize();
+  const int size_change = in_size - num_sites;
   
   // First, get the size right
   if (size_change > 0) prepareInsert(pos, size_change);
   else if (size_change < 0) Remove(pos, -size_change);
   
   // Now just copy everything over!
-  for (int i = 0; i < seq.GetSize(); i++) m_seq[i + pos] = seq[i];
+  Apto::Array<Instruction>& data = mutableSeq();
+  for (int i = 0; i < in_size; i++) data[i + pos] = in_storage->seq[i];
 }
 
 
@@ -345,25 +364,27 @@ void Avida::InstructionSequence::Rotate(int n)
 
 void Avida::InstructionSequence::operator=(const InstructionSequence& other_seq)
 {
+  // Share the other sequence's storage; either side copies it on its next write
+  m_storage = other_seq.m_storage;
   m_active_size = other_seq.m_active_size;
-  m_seq.ResizeClear(m_active_size);
-  
-  // Now that both code arrays are the same size, copy the other one over
-  for (int i = 0; i < m_active_size; i++) m_seq[i] = other_seq[i];
 }
 
 
 bool Avida::InstructionSequence::operator==(const GeneticRepresentation& other_seq) const
 {
-  const InstructionSequence* seq = dynamic_cast<const InstructionSequence*>(&other_seq);
-  if (!seq) return false;
+  const InstructionSequence* other = dynamic_cast<const InstructionSequence*>(&other_seq);
+  if (!other) return false;
   
   // Make sure the sizes are the same.
-  if (m_active_size != seq->m_active_size) return false;
+  if (m_active_size != other->m_active_size) return false;
+  
+  // Copies that share storage have not been written since they were made
+  if (&seq() == &other->seq()) return true;
   
   // Then go through line by line.
+  const Apto::Array<Instruction>& data = seq();
   for (int i = 0; i < m_active_size; i++)
-    if (m_seq[i] != (*seq)[i]) return false;
+    if (data[i] != (*other)[i]) return false;
   
   return true;
 }
@@ -373,7 +394,7 @@ int Avida::InstructionSequence::FindInst(const Instruction& inst, int start_inde
 {
   assert(start_index < m_active_size);  // Starting search after sequence end.
   
-  for(int i = start_index; i < m_active_size; i++) if (m_seq[i] == inst) return i;
+  for(int i = start_index; i < m_active_size; i++) if (seq()[i] == inst) return i;
   
   // Search failed
   return -1;  
@@ -383,7 +404,7 @@ int Avida::InstructionSequence::FindInst(const Instruction& inst, int start_inde
 int Avida::InstructionSequence::CountInst(const Instruction& inst) const
 {
   int count = 0;
-  for (int i = 0; i < m_active_size; i++) if (m_seq[i] == inst) count++;
+  for (int i = 0; i < m_active_size; i++) if (seq()[i] == inst) count++;
   return count;  
 }
 
@@ -436,7 +457,7 @@ Avida::InstructionSequence Avida::InstructionSequence::Crop(int start, int end)
   
   const int out_length = end - start;
   InstructionSequence out_seq(out_length);
-  for (int i = 0; i < out_length; i++) out_seq[i] = m_seq[i+start];
+  for (int i = 0; i < out_length; i++) out_seq[i] = seq()[i+start];
   
   return out_seq;
 }
@@ -454,8 +475,8 @@ Avida::InstructionSequence Avida::InstructionSequence::Cut(int start, int end) c
   assert(out_length > 0);             // Can't cut everything!
   
   InstructionSequence out_seq(out_length);
-  for (int i = 0; i < start; i++) out_seq[i] = m_seq[i];
-  for (int i = start; i < out_length; i++) out_seq[i] = m_seq[i + cut_length];
+  for (int i = 0; i < start; i++) out_seq[i] = seq()[i];
+  for (int i = start; i < out_length; i++) out_seq[i] = seq()[i + cut_length];
   
   return out_seq;
 }  
@@ -22,19 +22,24 @@
 
 #include "cCPUMemory.h"
 
+#include "cInstSet.h"
+
 using namespace std;
 using namespace Avida;
 
-cCPUMemory::cCPUMemory(const cCPUMemory& in_memory) : InstructionSequence(in_memory), m_flag_array(in_memory.GetSize())
+cCPUMemory::cCPUMemory(const cCPUMemory& in_memory)
+  : InstructionSequence(in_memory), m_flag_array(in_memory.m_flag_array), m_track_touches(false), m_touched_all(false)
+  , m_generation(0), m_index_generation(0), m_index_inst_set(NULL)
 {
-  for (int i = 0; i < m_flag_array.GetSize(); i++) m_flag_array[i] = in_memory.m_flag_array[i];
 }
 
 
 void cCPUMemory::adjustCapacity(int new_size)
 {
+  // Every resize shifts or drops sites, so the label index must be rebuilt
+  m_generation++;
   InstructionSequence::adjustCapacity(new_size);
-  if (m_seq.GetSize() != m_flag_array.GetSize()) m_flag_array.Resize(m_seq.GetSize()); 
+  if (seq().GetSize() != m_flag_array.GetSize()) m_flag_array.Resize(seq().GetSize());
 }
 
 
@@ -43,13 +48,17 @@ void cCPUMemory::prepareInsert(int pos, int num_sites)
   assert(pos >= 0 && pos <= m_active_size); // Must insert at a legal position!
   assert(num_sites > 0); // Must insert positive number of lines!
   
+  // Shifting sites changes what every later position refers to
+  TouchAll();
+  
   // Re-adjust the size...
   const int old_size = m_active_size;
   const int new_size = m_active_size + num_sites;
   adjustCapacity(new_size);
   
   // Shift any sites needed...
-  for (int i = old_size - 1; i >= pos; i--) m_seq[i + num_sites] = m_seq[i];
+  Apto::Array<Instruction>& data = mutableSeq();
+  for (int i = old_size - 1; i >= pos; i--) data[i + num_sites] = data[i];
   for (int i = old_size - 1; i >= pos; i--) m_flag_array[i + num_sites] = m_flag_array[i];
 }
 
@@ -70,9 +79,12 @@ void cCPUMemory::Resize(int new_size)
   const int old_size = m_active_size;
   adjustCapacity(new_size);
   
-  for (int i = old_size; i < new_size; i++) {
-    m_seq[i].SetOp(0);
-    m_flag_array[i] = 0;
+  if (new_size > old_size) {
+    Apto::Array<Instruction>& data = mutableSeq();
+    for (int i = old_size; i < new_size; i++) {
+      data[i].SetOp(0);
+      m_flag_array[i] = 0;
+    }
   }
 }
 
@@ -91,33 +103,57 @@ void cCPUMemory::ResizeOld(int new_size)
 void cCPUMemory::Copy(int to, int from)
 {
   assert(to >= 0);
-  assert(to < m_seq.GetSize());
+  assert(to < m_active_size);
   assert(from >= 0);
-  assert(from < m_seq.GetSize());
+  assert(from < m_active_size);
   
-  m_seq[to] = m_seq[from];
+  TouchSite(from);
+  TouchSite(to);
+  SetInst(to, seq()[from]);
   m_flag_array[to] = m_flag_array[from];
 }
 
 
+void cCPUMemory::SetInst(int pos, const Instruction& inst)
+{
+  assert(pos >= 0 && pos < m_active_size);
+  
+  // Overwriting a site with one of the same nop/label class (the common case while copying) keeps the index valid
+  if (m_index_inst_set != NULL && m_index_generation == m_generation) {
+    const cInstSet& inst_set = *m_index_inst_set;
+    const Instruction& old_inst = seq()[pos];
+    if ((inst_set.IsNop(old_inst) != 0) != (inst_set.IsNop(inst) != 0) ||
+        inst_set.IsLabel(old_inst) != inst_set.IsLabel(inst)) {
+      m_generation++;
+    }
+  } else {
+    m_generation++;
+  }
+  mutableSeq()[pos] = inst;
+}
+
+
 void cCPUMemory::Insert(int pos, const Instruction& inst)
 {
   assert(pos >= 0);
-  assert(pos <= m_seq.GetSize());
+  assert(pos <= m_active_size);
 
   prepareInsert(pos, 1);
-  m_seq[pos] = inst;
+  mutableSeq()[pos] = inst;
   m_flag_array[pos] = 0;
 }
 
 void cCPUMemory::Insert(int pos, const InstructionSequence& genome)
 {
   assert(pos >= 0);
-  assert(pos <= m_seq.GetSize());
-
-  prepareInsert(pos, genome.GetSize());
-  for (int i = 0; i < genome.GetSize(); i++) {
-    m_seq[i + pos] = genome[i];
+  assert(pos <= m_active_size);
+
+  // Take a reference first, genome may be this memory
+  const InstructionSequence in_genome(genome);
+  prepareInsert(pos, in_genome.GetSize());
+  Apto::Array<Instruction>& data = mutableSeq();
+  for (int i = 0; i < in_genome.GetSize(); i++) {
+    data[i + pos] = in_genome[i];
     m_flag_array[i + pos] = 0;
   }
 }
@@ -128,9 +164,11 @@ void cCPUMemory::Remove(int pos, int num_sites)
   assert(pos >= 0);                         // Removal must be in genome.
   assert(pos + num_sites <= m_active_size); // Cannot extend past end of genome.
 
+  TouchAll();
   const int new_size = m_active_size - num_sites;
+  Apto::Array<Instruction>& data = mutableSeq();
   for (int i = pos; i < new_size; i++) {
-    m_seq[i] = m_seq[i + num_sites];
+    data[i] = data[i + num_sites];
     m_flag_array[i] = m_flag_array[i + num_sites];
   }
   adjustCapacity(new_size);
@@ -142,40 +180,117 @@ void cCPUMemory::Replace(int pos, int num_sites, const InstructionSequence& geno
   assert(num_sites >= 0);                   // Cannot replace negative
   assert(pos + num_sites <= m_active_size); // Cannot extend past end!
   
-  const int size_change = genome.GetSize() - num_sites;
+  TouchRange(pos, pos + num_sites);
+  m_generation++;
+  const InstructionSequence in_genome(genome);
+  const int size_change = in_genome.GetSize() - num_sites;
   
   // First, get the size right
   if (size_change > 0) prepareInsert(pos, size_change);
   else if (size_change < 0) Remove(pos, -size_change);
   
   // Now just copy everything over!
-  for (int i = 0; i < genome.GetSize(); i++) {
-    m_seq[i + pos] = genome[i];
+  Apto::Array<Instruction>& data = mutableSeq();
+  for (int i = 0; i < in_genome.GetSize(); i++) {
+    data[i + pos] = in_genome[i];
     m_flag_array[i + pos] = 0;
   }
 }
 
 
-void cCPUMemory::operator=(const cCPUMemory& other_memory)
+void cCPUMemory::buildLabelIndex(const cInstSet& inst_set) const
 {
-  adjustCapacity(other_memory.m_active_size);
+  m_nop_runs.Resize(0);
+  m_label_sites.Resize(0);
   
-  // Fill in the new information...
+  sNopRun run;
+  run.start = -1;
   for (int i = 0; i < m_active_size; i++) {
-    m_seq[i] = other_memory.m_seq[i];
-    m_flag_array[i] = other_memory.m_flag_array[i];
+    if (inst_set.IsNop(seq()[i])) {
+      if (run.start < 0) run.start = i;
+    } else if (run.start >= 0) {
+      run.end = i;
+      m_nop_runs.Push(run);
+      run.start = -1;
+    }
+    if (inst_set.IsLabel(seq()[i])) m_label_sites.Push(i);
+  }
+  if (run.start >= 0) {
+    run.end = m_active_size;
+    m_nop_runs.Push(run);
   }
+  
+  m_index_inst_set = &inst_set;
+  m_index_generation = m_generation;
 }
 
 
-void cCPUMemory::operator=(const InstructionSequence& other_genome)
+int cCPUMemory::FindNopRun(const cInstSet& inst_set, int pos) const
 {
-  adjustCapacity(other_genome.GetSize());
-  
-  // Fill in the new information...
-  for (int i = 0; i < m_active_size; i++) {
-    m_seq[i] = other_genome[i];
-    m_flag_array[i] = 0;
+  validateLabelIndex(inst_set);
+  int lo = 0;
+  int hi = m_nop_runs.GetSize();
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (m_nop_runs[mid].end > pos) hi = mid;
+    else lo = mid + 1;
+  }
+  return lo;
+}
+
+
+int cCPUMemory::NextNopSite(const cInstSet& inst_set, int pos) const
+{
+  const int run = FindNopRun(inst_set, pos);
+  if (run >= m_nop_runs.GetSize()) return -1;
+  return (m_nop_runs[run].start > pos) ? m_nop_runs[run].start : pos;
+}
+
+
+int cCPUMemory::NextLabelSite(const cInstSet& inst_set, int pos) const
+{
+  validateLabelIndex(inst_set);
+  int lo = 0;
+  int hi = m_label_sites.GetSize();
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (m_label_sites[mid] >= pos) hi = mid;
+    else lo = mid + 1;
   }
+  return (lo < m_label_sites.GetSize()) ? m_label_sites[lo] : -1;
+}
+
+
+void cCPUMemory::StartTouchTracking()
+{
+  for (int i = 0; i < m_active_size; i++) m_flag_array[i] &= ~MASK_TOUCHED;
+  m_track_touches = true;
+  m_touched_all = false;
+}
+
+
+void cCPUMemory::TouchRange(int begin, int end)
+{
+  if (!m_track_touches) return;
+  if (begin < 0) begin = 0;
+  if (end > m_active_size) end = m_active_size;
+  for (int i = begin; i < end; i++) m_flag_array[i] |= MASK_TOUCHED;
+}
+
+
+void cCPUMemory::operator=(const cCPUMemory& other_memory)
+{
+  m_generation++;
+  InstructionSequence::operator=(other_memory);
+  m_flag_array = other_memory.m_flag_array;
+}
+
+
+void cCPUMemory::operator=(const InstructionSequence& other_genome)
+{
+  m_generation++;
+  InstructionSequence::operator=(other_genome);
+  m_flag_array.ResizeClear(seq().GetSize());
+  ClearFlags();
 }
 
@@ -25,6 +25,8 @@
 
 #include "avida/core/InstructionSequence.h"
 
+class cInstSet;
+
 
 class cCPUMemory : public Avida::InstructionSequence
 {
@@ -35,21 +37,50 @@ private:
 	static const unsigned char MASK_POINTMUT = 0x08;
 	static const unsigned char MASK_COPYMUT  = 0x10;
 	static const unsigned char MASK_INJECTED = 0x20;
-	static const unsigned char MASK_UNUSED1  = 0x40; // unused bit
+	static const unsigned char MASK_TOUCHED  = 0x40; // observed while touch tracking is active
 	static const unsigned char MASK_UNUSED2  = 0x80; // unused bit
   
   Apto::Array<unsigned char> m_flag_array;
+  bool m_track_touches;
+  bool m_touched_all;
+
+public:
+  struct sNopRun { int start; int end; }; // maximal run of nops, [start, end)
+  
+private:
+  // Label index, built on demand for a single instruction set.  Any write that may change which sites are nops or
+  // labels bumps m_generation, which lazily invalidates the index.
+  unsigned int m_generation;
+  mutable unsigned int m_index_generation;
+  mutable const cInstSet* m_index_inst_set;
+  mutable Apto::Array<sNopRun> m_nop_runs;
+  mutable Apto::Array<int> m_label_sites;
 
   void adjustCapacity(int new_size);
   void prepareInsert(int pos, int num_sites);
+  void buildLabelIndex(const cInstSet& inst_set) const;
+  inline void validateLabelIndex(const cInstSet& inst_set) const
+    { if (m_index_inst_set != &inst_set || m_index_generation != m_generation) buildLabelIndex(inst_set); }
 
 public:
   cCPUMemory(const cCPUMemory& in_memory);
-  cCPUMemory(const InstructionSequence& in_genome) : InstructionSequence(in_genome), m_flag_array(in_genome.GetSize()) { ; }
-  explicit cCPUMemory(int size = 1)  : InstructionSequence(size), m_flag_array(size) { ClearFlags(); }
-  cCPUMemory(const Apto::String& in_string) : InstructionSequence(in_string), m_flag_array(in_string.GetSize()) { ; }
+  // Instructions are shared with in_genome until either side writes; the flag array always belongs to this memory
+  cCPUMemory(const InstructionSequence& in_genome)
+    : InstructionSequence(in_genome), m_flag_array(seq().GetSize()), m_track_touches(false), m_touched_all(false)
+    , m_generation(0), m_index_generation(0), m_index_inst_set(NULL) { ClearFlags(); }
+  explicit cCPUMemory(int size = 1)
+    : InstructionSequence(size), m_flag_array(size), m_track_touches(false), m_touched_all(false)
+    , m_generation(0), m_index_generation(0), m_index_inst_set(NULL) { ClearFlags(); }
+  cCPUMemory(const Apto::String& in_string)
+    : InstructionSequence(in_string), m_flag_array(seq().GetSize()), m_track_touches(false), m_touched_all(false)
+    , m_generation(0), m_index_generation(0), m_index_inst_set(NULL) { ClearFlags(); }
   ~cCPUMemory() { ; }
 
+  // Indexing is read-only (hiding the mutable base accessor), so reads neither copy shared storage nor invalidate the
+  // label index; writes go through SetInst.
+  inline const Avida::Instruction& operator[](int idx) const { return InstructionSequence::operator[](idx); }
+  void SetInst(int pos, const Avida::Instruction& inst);
+
   inline bool FlagCopied(int pos) const     { return (MASK_COPIED   & m_flag_array[pos]) != 0; }
   inline bool FlagMutated(int pos) const    { return (MASK_MUTATED  & m_flag_array[pos]) != 0; }
   inline bool FlagExecuted(int pos) const   { return (MASK_EXECUTED & m_flag_array[pos]) != 0; }
@@ -71,11 +102,31 @@ public:
 	inline void ClearFlagCopyMut(int pos)    { m_flag_array[pos] &= ~MASK_COPYMUT;  }
   inline void ClearFlagInjected(int pos)   { m_flag_array[pos] &= ~MASK_INJECTED; }
   
+  // Touch tracking records every site the hardware observes (reads, writes, or shifts), so that the test CPU
+  // can tell which sites a prefix of execution depended upon.  Off by default; the checks are a single branch.
+  void StartTouchTracking();
+  inline void StopTouchTracking() { m_track_touches = false; }
+  inline bool IsTrackingTouches() const { return m_track_touches; }
+  inline bool FlagTouched(int pos) const { return (MASK_TOUCHED & m_flag_array[pos]) != 0; }
+  inline bool TouchedAll() const { return m_touched_all; }
+  inline void TouchSite(int pos) { if (m_track_touches && pos >= 0 && pos < m_active_size) m_flag_array[pos] |= MASK_TOUCHED; }
+  void TouchRange(int begin, int end);
+  inline void TouchAll() { if (m_track_touches) m_touched_all = true; }
+  
+  // Label index queries.  Runs and label sites are kept in ascending order; lookups are binary searches.
+  inline unsigned int GetGeneration() const { return m_generation; }
+  const Apto::Array<sNopRun>& GetNopRuns(const cInstSet& inst_set) const { validateLabelIndex(inst_set); return m_nop_runs; }
+  int FindNopRun(const cInstSet& inst_set, int pos) const;   // index of the first run ending after pos
+  int NextNopSite(const cInstSet& inst_set, int pos) const;  // first nop at or after pos, -1 if none
+  int NextLabelSite(const cInstSet& inst_set, int pos) const;  // first label instruction at or after pos, -1 if none
+  
   
   void Clear()
 	{
+    m_generation++;
+    Apto::Array<Avida::Instruction>& data = mutableSeq();
 		for (int i = 0; i < m_active_size; i++) {
-			m_seq[i].SetOp(0);
+			data[i].SetOp(0);
 			m_flag_array[i] = 0;
 		}
 	}
@@ -93,6 +144,14 @@ public:
 
   void operator=(const cCPUMemory& other_memory);
   void operator=(const InstructionSequence& other_genome);
+  
+  // Bytes allocated for the sequence, flags and label index (capacity, not just the active size).  Shared instruction
+  // storage is split evenly between the sequences holding it.
+  inline int GetHeapSize() const
+  {
+    return seq().GetSize() * sizeof(Avida::Instruction) / GetShareCount() + m_flag_array.GetSize() * sizeof(unsigned char) +
+      m_nop_runs.GetSize() * sizeof(sNopRun) + m_label_sites.GetSize() * sizeof(int);
+  }
 };
 
 #endif
@@ -122,12 +122,12 @@ private:
     
     inline void Advance() { m_pos++; Adjust(); }
     
-    inline const Instruction& GetInst() { return GetMemory()[m_pos]; }
-    inline const Instruction& GetInst(int offset) { return GetMemory()[m_pos + offset]; }
+    inline const Instruction& GetInst() { const cCPUMemory& mem = GetMemory(); return mem[m_pos]; }
+    inline const Instruction& GetInst(int offset) { const cCPUMemory& mem = GetMemory(); return mem[m_pos + offset]; }
     inline Instruction NextInst();
     inline Instruction PrevInst();
     
-    inline void SetInst(const Instruction& value) { GetMemory()[m_pos] = value; }
+    inline void SetInst(const Instruction& value) { GetMemory().SetInst(m_pos, value); }
     inline void InsertInst(const Instruction& inst) { GetMemory().Insert(m_pos, inst); }
     inline void RemoveInst() { GetMemory().Remove(m_pos); }
     
@@ -300,6 +300,7 @@ public:
   // --------  Helper Methods  --------
   int GetType() const { return HARDWARE_TYPE_CPU_BCR; }
   bool SupportsSpeculative() const { return true; }
+  int GetMemoryFootprint() const;
   void PrintStatus(std::ostream& fp);
   void SetupMiniTraceFileHeader(Avida::Output::File& df, const int gen_id, const Apto::String& genotype);
   void PrintMiniTraceStatus(cAvidaContext& ctx, std::ostream& fp);
@@ -703,12 +704,14 @@ inline bool cHardwareBCR::Head::operator==(const Head& rhs) const
 
 inline Instruction cHardwareBCR::Head::PrevInst()
 {
-  return (AtFront()) ? GetMemory()[GetMemory().GetSize() - 1] : GetMemory()[m_pos - 1];
+  const cCPUMemory& mem = GetMemory();
+  return (AtFront()) ? mem[mem.GetSize() - 1] : mem[m_pos - 1];
 }
 
 inline Instruction cHardwareBCR::Head::NextInst()
 {
-  return (AtEnd()) ? m_hw->GetInstSet().GetInstError() : GetMemory()[m_pos + 1];
+  const cCPUMemory& mem = GetMemory();
+  return (AtEnd()) ? m_hw->GetInstSet().GetInstError() : mem[m_pos + 1];
 }
 
 
@@ -127,6 +127,55 @@ void cHardwareBase::ResizeCostArrays(int new_size)
   m_active_thread_post_costs.SetAll(0);
 }
 
+int cHardwareBase::baseHeapSize() const
+{
+  int bytes = 0;
+  bytes += m_microtracer.GetSize() * sizeof(char);
+  bytes += (m_navtraceloc.GetSize() + m_navtracefacing.GetSize() + m_navtraceupdate.GetSize()) * sizeof(int);
+  bytes += (m_inst_ft_cost.GetSize() + m_thread_inst_cost.GetSize() + m_thread_inst_post_cost.GetSize()) * sizeof(int);
+  bytes += (m_active_thread_costs.GetSize() + m_active_thread_post_costs.GetSize()) * sizeof(int);
+  bytes += (m_inst_energy_cost.GetSize() + m_inst_res_cost.GetSize() + m_inst_fem_res_cost.GetSize()) * sizeof(double);
+  bytes += m_inst_bonus_cost.GetSize() * sizeof(double);
+  bytes += m_ext_mem.GetSize() * sizeof(int);
+  return bytes;
+}
+
+void cHardwareBase::saveBaseCheckpoint(cHardwareCheckpoint& checkpoint) const
+{
+  checkpoint.m_hw_type = GetType();
+  checkpoint.m_inst_cost = m_inst_cost;
+  checkpoint.m_female_cost = m_female_cost;
+  checkpoint.m_inst_ft_cost = m_inst_ft_cost;
+  checkpoint.m_inst_energy_cost = m_inst_energy_cost;
+  checkpoint.m_inst_res_cost = m_inst_res_cost;
+  checkpoint.m_inst_fem_res_cost = m_inst_fem_res_cost;
+  checkpoint.m_inst_bonus_cost = m_inst_bonus_cost;
+  checkpoint.m_thread_inst_cost = m_thread_inst_cost;
+  checkpoint.m_thread_inst_post_cost = m_thread_inst_post_cost;
+  checkpoint.m_active_thread_costs = m_active_thread_costs;
+  checkpoint.m_active_thread_post_costs = m_active_thread_post_costs;
+  checkpoint.m_ext_mem = m_ext_mem;
+  checkpoint.m_implicit_repro_active = m_implicit_repro_active;
+}
+
+void cHardwareBase::restoreBaseCheckpoint(const cHardwareCheckpoint& checkpoint)
+{
+  assert(checkpoint.m_hw_type == GetType());
+  m_inst_cost = checkpoint.m_inst_cost;
+  m_female_cost = checkpoint.m_female_cost;
+  m_inst_ft_cost = checkpoint.m_inst_ft_cost;
+  m_inst_energy_cost = checkpoint.m_inst_energy_cost;
+  m_inst_res_cost = checkpoint.m_inst_res_cost;
+  m_inst_fem_res_cost = checkpoint.m_inst_fem_res_cost;
+  m_inst_bonus_cost = checkpoint.m_inst_bonus_cost;
+  m_thread_inst_cost = checkpoint.m_thread_inst_cost;
+  m_thread_inst_post_cost = checkpoint.m_thread_inst_post_cost;
+  m_active_thread_costs = checkpoint.m_active_thread_costs;
+  m_active_thread_post_costs = checkpoint.m_active_thread_post_costs;
+  m_ext_mem = checkpoint.m_ext_mem;
+  m_implicit_repro_active = checkpoint.m_implicit_repro_active;
+}
+
 int cHardwareBase::calcExecutedSize(const int parent_size)
 {
   int executed_size = 0;
@@ -514,7 +563,7 @@ int cHardwareBase::Divide_DoMutations(cAvidaContext& ctx, double mut_multiplier,
     if (num_mut > 0) {
       for (int i = 0; i < num_mut && totalMutations < maxmut; i++) {
         int site = ctx.GetRandom().GetUInt(memory.GetSize());
-        memory[site] = m_inst_set->GetRandomInst(ctx);
+        memory.SetInst(site, m_inst_set->GetRandomInst(ctx));
         totalMutations++;
       }
     }
@@ -815,6 +864,56 @@ void cHardwareBase::doLGTMutation(cAvidaContext& ctx, InstructionSequence& genom
 }
 
 
+// Search memory for a run of nops matching 'label', optionally required to follow a label instruction.  Candidate
+// sites come from the memory's label index, so the cost follows the number of labels/nop runs rather than the
+// genome length.  Visits candidates exactly as a site-by-site scan would: linearly from 'base' when not wrapping, or
+// circularly from just after 'base' (stopping short of it) when wrapping.  On success match_start holds the position
+// of the label instruction (or first nop) of the match.
+bool cHardwareBase::findLabelSequence(const cCPUMemory& memory, const cCodeLabel& label, bool label_inst, int base,
+                                      bool wrap, int& match_start) const
+{
+  const int size = memory.GetSize();
+  const int label_size = label.GetSize();
+  if (!wrap) base = 0;
+  
+  int offset = wrap ? 1 : 0;
+  while (offset < size) {
+    // Jump to the next candidate site at or after this offset
+    const int pos = (base + offset) % size;
+    int site = label_inst ? memory.NextLabelSite(*m_inst_set, pos) : memory.NextNopSite(*m_inst_set, pos);
+    if (wrap) {
+      if (site >= 0 && pos < base && site >= base) site = -1;
+      if (site < 0 && pos > base) {
+        site = label_inst ? memory.NextLabelSite(*m_inst_set, 0) : memory.NextNopSite(*m_inst_set, 0);
+        if (site >= base) site = -1;
+      }
+    }
+    if (site < 0) return false;
+    offset = (site - base + size) % size;
+    
+    // Match the nops that follow (for labels) or start at (for nop sequences) the candidate
+    int cur = offset + (label_inst ? 1 : 0);
+    int size_matched = 0;
+    while (size_matched < label_size && cur < size) {
+      const Instruction& inst = memory[(base + cur) % size];
+      if (!m_inst_set->IsNop(inst) || label[size_matched] != m_inst_set->GetNopMod(inst)) break;
+      size_matched++;
+      cur++;
+    }
+    
+    if (size_matched == label_size) {
+      match_start = site;
+      return true;
+    }
+    
+    // Labels resume at the mismatched site (it may itself be a label), nop sequences just past it
+    offset = label_inst ? cur : cur + 1;
+  }
+  
+  return false;
+}
+
+
 
 
 /*
@@ -1090,6 +1189,7 @@ int cHardwareBase::PointMutate(cAvidaContext& ctx, double override_mut_rate)
   const int min_genome_size = m_world->GetConfig().MIN_GENOME_SIZE.Get();
   
   cCPUMemory& memory = GetMemory();
+  memory.TouchAll();
   int totalMutations = 0;
   
 //  const int num_muts = ctx.GetRandom().GetRandBinomial(memory.GetSize(), mut_rate);
@@ -1111,7 +1211,7 @@ int cHardwareBase::PointMutate(cAvidaContext& ctx, double override_mut_rate)
     if (num_mut > 0) {
       for (int i = 0; i < num_mut; i++) {
         int site = ctx.GetRandom().GetUInt(memory.GetSize());
-        memory[site] = m_inst_set->GetRandomInst(ctx);
+        memory.SetInst(site, m_inst_set->GetRandomInst(ctx));
         totalMutations++;
       }
     }
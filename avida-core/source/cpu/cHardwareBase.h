@@ -48,6 +48,35 @@ using namespace std;
 using namespace Avida;
 
 
+// Saved execution state of a hardware instance (see cHardwareBase::SaveCheckpoint).  The base portion holds the
+// instruction cost bookkeeping; hardware types that support checkpointing extend it with their own state.
+class cHardwareCheckpoint
+{
+  friend class cHardwareBase;
+private:
+  int m_hw_type;
+  int m_inst_cost;
+  int m_female_cost;
+  Apto::Array<int> m_inst_ft_cost;
+  Apto::Array<double> m_inst_energy_cost;
+  Apto::Array<double> m_inst_res_cost;
+  Apto::Array<double> m_inst_fem_res_cost;
+  Apto::Array<double> m_inst_bonus_cost;
+  Apto::Array<int> m_thread_inst_cost;
+  Apto::Array<int> m_thread_inst_post_cost;
+  Apto::Array<int> m_active_thread_costs;
+  Apto::Array<int> m_active_thread_post_costs;
+  Apto::Array<int, Apto::Smart> m_ext_mem;
+  bool m_implicit_repro_active;
+
+public:
+  cHardwareCheckpoint() : m_hw_type(-1), m_inst_cost(0), m_female_cost(0), m_implicit_repro_active(false) { ; }
+  virtual ~cHardwareCheckpoint() { ; }
+  
+  int GetHardwareType() const { return m_hw_type; }
+};
+
+
 class cHardwareBase
 {
 protected:
@@ -146,6 +175,7 @@ public:
   virtual void PrintMiniTraceStatus(cAvidaContext& ctx, std::ostream& fp) = 0;
   virtual void PrintMiniTraceSuccess(std::ostream& fp, const int exec_success) = 0;
   void SetTrace(HardwareTracerPtr tracer) { m_tracer = tracer; }
+  bool IsTraced() const { return (m_tracer) ? true : false; }
   void SetMiniTrace(const cString& filename);
   void SetMicroTrace() { m_microtrace = true; } 
   void SetTopNavTrace(bool nav_trace) { m_topnavtrace = nav_trace; }
@@ -228,6 +258,18 @@ public:
   virtual void InheritState(cHardwareBase&) { ; }
   
   
+  // --------  Checkpointing  --------
+  // Hardware types that can snapshot their execution state return a new checkpoint (owned by the caller), NULL
+  // otherwise.  Restoring is only valid into hardware of the same type running an organism of equal genome length.
+  virtual cHardwareCheckpoint* SaveCheckpoint() const { return NULL; }
+  virtual bool RestoreCheckpoint(const cHardwareCheckpoint&) { return false; }
+  
+  
+  // --------  Memory Accounting  --------
+  // Approximate bytes held by this hardware, its object plus the memory spaces, threads and cost arrays it allocates
+  virtual int GetMemoryFootprint() const = 0;
+  
+  
   // --------  Alarm  --------
   virtual bool Jump_To_Alarm_Label(int) { return false; }
   
@@ -244,6 +286,11 @@ public:
   
 protected:
   void ResizeCostArrays(int new_size);
+  
+  int baseHeapSize() const;
+  
+  void saveBaseCheckpoint(cHardwareCheckpoint& checkpoint) const;
+  void restoreBaseCheckpoint(const cHardwareCheckpoint& checkpoint);
 
   // --------  Core Execution Methods  --------
   bool SingleProcess_PayPreCosts(cAvidaContext& ctx, const Instruction& cur_inst, const int thread_id);
@@ -279,6 +326,11 @@ protected:
   void doLGTMutation(cAvidaContext& ctx, InstructionSequence& genome);
   
 
+  // --------  Label Search Helper Methods  --------
+  bool findLabelSequence(const cCPUMemory& memory, const cCodeLabel& label, bool label_inst, int base, bool wrap,
+                         int& match_start) const;
+  
+
   // --------  Organism Execution Property Calculation  --------
   virtual int calcExecutedSize(const int parent_size);
   virtual int calcCopiedSize(const int parent_size, const int child_size) = 0;  
@@ -82,9 +82,9 @@ tInstLib<cHardwareCPU::tMethod>* cHardwareCPU::initInstLib(void)
      in the same order in tInstLibEntry<tMethod> s_f_array, and these entries must
      be the first elements of s_f_array.
      */
-    tInstLibEntry<tMethod>("nop-A", &cHardwareCPU::Inst_Nop, INST_CLASS_NOP, (nInstFlag::DEFAULT | nInstFlag::NOP), "No-operation instruction; modifies other instructions"),
-    tInstLibEntry<tMethod>("nop-B", &cHardwareCPU::Inst_Nop, INST_CLASS_NOP, (nInstFlag::DEFAULT | nInstFlag::NOP), "No-operation instruction; modifies other instructions"),
-    tInstLibEntry<tMethod>("nop-C", &cHardwareCPU::Inst_Nop, INST_CLASS_NOP, (nInstFlag::DEFAULT | nInstFlag::NOP), "No-operation instruction; modifies other instructions"),
+    tInstLibEntry<tMethod>("nop-A", &cHardwareCPU::Inst_Nop, INST_CLASS_NOP, (nInstFlag::DEFAULT | nInstFlag::NOP | nInstFlag::ISOLATED), "No-operation instruction; modifies other instructions"),
+    tInstLibEntry<tMethod>("nop-B", &cHardwareCPU::Inst_Nop, INST_CLASS_NOP, (nInstFlag::DEFAULT | nInstFlag::NOP | nInstFlag::ISOLATED), "No-operation instruction; modifies other instructions"),
+    tInstLibEntry<tMethod>("nop-C", &cHardwareCPU::Inst_Nop, INST_CLASS_NOP, (nInstFlag::DEFAULT | nInstFlag::NOP | nInstFlag::ISOLATED), "No-operation instruction; modifies other instructions"),
     
     tInstLibEntry<tMethod>("nop-X", &cHardwareCPU::Inst_Nop, INST_CLASS_NOP, 0, "True no-operation instruction: does nothing"),
     tInstLibEntry<tMethod>("nop-Y", &cHardwareCPU::Inst_Nop, INST_CLASS_NOP, 0, "True no-operation instruction: does nothing"),
@@ -92,14 +92,14 @@ tInstLib<cHardwareCPU::tMethod>* cHardwareCPU::initInstLib(void)
     tInstLibEntry<tMethod>("if-not-0", &cHardwareCPU::Inst_IfNot0, INST_CLASS_CONDITIONAL, 0, "Execute next instruction if ?BX?!=0, else skip it"),
     tInstLibEntry<tMethod>("if-equ-0-defaultAX", &cHardwareCPU::Inst_If0_defaultAX, INST_CLASS_CONDITIONAL, 0, "Execute next instruction if ?AX?==0, else skip it"),
     tInstLibEntry<tMethod>("if-not-0-defaultAX", &cHardwareCPU::Inst_IfNot0_defaultAX, INST_CLASS_CONDITIONAL, 0, "Execute next instruction if ?AX?!=0, else skip it"),
-    tInstLibEntry<tMethod>("if-n-equ", &cHardwareCPU::Inst_IfNEqu, INST_CLASS_CONDITIONAL, nInstFlag::DEFAULT, "Execute next instruction if ?BX?!=?CX?, else skip it"),
+    tInstLibEntry<tMethod>("if-n-equ", &cHardwareCPU::Inst_IfNEqu, INST_CLASS_CONDITIONAL, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Execute next instruction if ?BX?!=?CX?, else skip it"),
     tInstLibEntry<tMethod>("if-equ", &cHardwareCPU::Inst_IfEqu, INST_CLASS_CONDITIONAL, 0, "Execute next instruction if ?BX?==?CX?, else skip it"),
     tInstLibEntry<tMethod>("if-grt-0", &cHardwareCPU::Inst_IfGr0, INST_CLASS_CONDITIONAL),
     tInstLibEntry<tMethod>("if-grt", &cHardwareCPU::Inst_IfGr, INST_CLASS_CONDITIONAL),
     tInstLibEntry<tMethod>("if->=-0", &cHardwareCPU::Inst_IfGrEqu0, INST_CLASS_CONDITIONAL),
     tInstLibEntry<tMethod>("if->=", &cHardwareCPU::Inst_IfGrEqu, INST_CLASS_CONDITIONAL),
     tInstLibEntry<tMethod>("if-les-0", &cHardwareCPU::Inst_IfLess0, INST_CLASS_CONDITIONAL),
-    tInstLibEntry<tMethod>("if-less", &cHardwareCPU::Inst_IfLess, INST_CLASS_CONDITIONAL, nInstFlag::DEFAULT, "Execute next instruction if ?BX? < ?CX?, else skip it"),
+    tInstLibEntry<tMethod>("if-less", &cHardwareCPU::Inst_IfLess, INST_CLASS_CONDITIONAL, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Execute next instruction if ?BX? < ?CX?, else skip it"),
     tInstLibEntry<tMethod>("if-<=-0", &cHardwareCPU::Inst_IfLsEqu0, INST_CLASS_CONDITIONAL),
     tInstLibEntry<tMethod>("if-<=", &cHardwareCPU::Inst_IfLsEqu, INST_CLASS_CONDITIONAL),
     tInstLibEntry<tMethod>("if-A!=B", &cHardwareCPU::Inst_IfANotEqB, INST_CLASS_CONDITIONAL),
@@ -146,11 +146,11 @@ tInstLib<cHardwareCPU::tMethod>* cHardwareCPU::initInstLib(void)
     tInstLibEntry<tMethod>("goto-if!=0", &cHardwareCPU::Inst_GotoIfNot0, INST_CLASS_FLOW_CONTROL),
     tInstLibEntry<tMethod>("label", &cHardwareCPU::Inst_Label, INST_CLASS_FLOW_CONTROL),
     
-    tInstLibEntry<tMethod>("pop", &cHardwareCPU::Inst_Pop, INST_CLASS_DATA, nInstFlag::DEFAULT, "Remove top number from stack and place into ?BX?"),
-    tInstLibEntry<tMethod>("push", &cHardwareCPU::Inst_Push, INST_CLASS_DATA, nInstFlag::DEFAULT, "Copy number from ?BX? and place it into the stack"),
-    tInstLibEntry<tMethod>("swap-stk", &cHardwareCPU::Inst_SwitchStack, INST_CLASS_DATA, nInstFlag::DEFAULT, "Toggle which stack is currently being used"),
+    tInstLibEntry<tMethod>("pop", &cHardwareCPU::Inst_Pop, INST_CLASS_DATA, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Remove top number from stack and place into ?BX?"),
+    tInstLibEntry<tMethod>("push", &cHardwareCPU::Inst_Push, INST_CLASS_DATA, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Copy number from ?BX? and place it into the stack"),
+    tInstLibEntry<tMethod>("swap-stk", &cHardwareCPU::Inst_SwitchStack, INST_CLASS_DATA, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Toggle which stack is currently being used"),
     tInstLibEntry<tMethod>("flip-stk", &cHardwareCPU::Inst_FlipStack, INST_CLASS_DATA),
-    tInstLibEntry<tMethod>("swap", &cHardwareCPU::Inst_Swap, INST_CLASS_DATA, nInstFlag::DEFAULT, "Swap the contents of ?BX? with ?CX?"),
+    tInstLibEntry<tMethod>("swap", &cHardwareCPU::Inst_Swap, INST_CLASS_DATA, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Swap the contents of ?BX? with ?CX?"),
     tInstLibEntry<tMethod>("swap-AB", &cHardwareCPU::Inst_SwapAB, INST_CLASS_DATA),
     tInstLibEntry<tMethod>("swap-BC", &cHardwareCPU::Inst_SwapBC, INST_CLASS_DATA),
     tInstLibEntry<tMethod>("swap-AC", &cHardwareCPU::Inst_SwapAC, INST_CLASS_DATA),
@@ -170,8 +170,8 @@ tInstLib<cHardwareCPU::tMethod>* cHardwareCPU::initInstLib(void)
     tInstLibEntry<tMethod>("push-B", &cHardwareCPU::Inst_PushB, INST_CLASS_DATA),
     tInstLibEntry<tMethod>("push-C", &cHardwareCPU::Inst_PushC, INST_CLASS_DATA),
     
-    tInstLibEntry<tMethod>("shift-r", &cHardwareCPU::Inst_ShiftR, INST_CLASS_ARITHMETIC_LOGIC, nInstFlag::DEFAULT, "Shift bits in ?BX? right by one (divide by two)"),
-    tInstLibEntry<tMethod>("shift-l", &cHardwareCPU::Inst_ShiftL, INST_CLASS_ARITHMETIC_LOGIC, nInstFlag::DEFAULT, "Shift bits in ?BX? left by one (multiply by two)"),
+    tInstLibEntry<tMethod>("shift-r", &cHardwareCPU::Inst_ShiftR, INST_CLASS_ARITHMETIC_LOGIC, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Shift bits in ?BX? right by one (divide by two)"),
+    tInstLibEntry<tMethod>("shift-l", &cHardwareCPU::Inst_ShiftL, INST_CLASS_ARITHMETIC_LOGIC, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Shift bits in ?BX? left by one (multiply by two)"),
     tInstLibEntry<tMethod>("bit-1", &cHardwareCPU::Inst_Bit1, INST_CLASS_ARITHMETIC_LOGIC),
     tInstLibEntry<tMethod>("set-num", &cHardwareCPU::Inst_SetNum, INST_CLASS_ARITHMETIC_LOGIC),
     tInstLibEntry<tMethod>("val-grey", &cHardwareCPU::Inst_ValGrey, INST_CLASS_ARITHMETIC_LOGIC),
@@ -179,8 +179,8 @@ tInstLib<cHardwareCPU::tMethod>* cHardwareCPU::initInstLib(void)
     tInstLibEntry<tMethod>("val-add-p", &cHardwareCPU::Inst_ValAddP, INST_CLASS_ARITHMETIC_LOGIC),
     tInstLibEntry<tMethod>("val-fib", &cHardwareCPU::Inst_ValFib, INST_CLASS_ARITHMETIC_LOGIC),
     tInstLibEntry<tMethod>("val-poly-c", &cHardwareCPU::Inst_ValPolyC, INST_CLASS_ARITHMETIC_LOGIC),
-    tInstLibEntry<tMethod>("inc", &cHardwareCPU::Inst_Inc, INST_CLASS_ARITHMETIC_LOGIC, nInstFlag::DEFAULT, "Increment ?BX? by one"),
-    tInstLibEntry<tMethod>("dec", &cHardwareCPU::Inst_Dec, INST_CLASS_ARITHMETIC_LOGIC, nInstFlag::DEFAULT, "Decrement ?BX? by one"),
+    tInstLibEntry<tMethod>("inc", &cHardwareCPU::Inst_Inc, INST_CLASS_ARITHMETIC_LOGIC, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Increment ?BX? by one"),
+    tInstLibEntry<tMethod>("dec", &cHardwareCPU::Inst_Dec, INST_CLASS_ARITHMETIC_LOGIC, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Decrement ?BX? by one"),
     tInstLibEntry<tMethod>("zero", &cHardwareCPU::Inst_Zero, INST_CLASS_ARITHMETIC_LOGIC, 0, "Set ?BX? to zero"),
     tInstLibEntry<tMethod>("one", &cHardwareCPU::Inst_One, INST_CLASS_ARITHMETIC_LOGIC, 0, "Set ?BX? to one"),
     tInstLibEntry<tMethod>("all1s", &cHardwareCPU::Inst_All1s, INST_CLASS_ARITHMETIC_LOGIC, 0, "Set ?BX? to all 1s in bitstring"),
@@ -189,12 +189,12 @@ tInstLib<cHardwareCPU::tMethod>* cHardwareCPU::initInstLib(void)
     tInstLibEntry<tMethod>("sqrt", &cHardwareCPU::Inst_Sqrt, INST_CLASS_ARITHMETIC_LOGIC),
     tInstLibEntry<tMethod>("not", &cHardwareCPU::Inst_Not, INST_CLASS_ARITHMETIC_LOGIC),
     
-    tInstLibEntry<tMethod>("add", &cHardwareCPU::Inst_Add, INST_CLASS_ARITHMETIC_LOGIC, nInstFlag::DEFAULT, "Add BX to CX and place the result in ?BX?"),
-    tInstLibEntry<tMethod>("sub", &cHardwareCPU::Inst_Sub, INST_CLASS_ARITHMETIC_LOGIC, nInstFlag::DEFAULT, "Subtract CX from BX and place the result in ?BX?"),
+    tInstLibEntry<tMethod>("add", &cHardwareCPU::Inst_Add, INST_CLASS_ARITHMETIC_LOGIC, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Add BX to CX and place the result in ?BX?"),
+    tInstLibEntry<tMethod>("sub", &cHardwareCPU::Inst_Sub, INST_CLASS_ARITHMETIC_LOGIC, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Subtract CX from BX and place the result in ?BX?"),
     tInstLibEntry<tMethod>("mult", &cHardwareCPU::Inst_Mult, INST_CLASS_ARITHMETIC_LOGIC, 0, "Multiple BX by CX and place the result in ?BX?"),
     tInstLibEntry<tMethod>("div", &cHardwareCPU::Inst_Div, INST_CLASS_ARITHMETIC_LOGIC, 0, "Divide BX by CX and place the result in ?BX?"),
     tInstLibEntry<tMethod>("mod", &cHardwareCPU::Inst_Mod, INST_CLASS_ARITHMETIC_LOGIC),
-    tInstLibEntry<tMethod>("nand", &cHardwareCPU::Inst_Nand, INST_CLASS_ARITHMETIC_LOGIC, nInstFlag::DEFAULT, "Nand BX by CX and place the result in ?BX?"),
+    tInstLibEntry<tMethod>("nand", &cHardwareCPU::Inst_Nand, INST_CLASS_ARITHMETIC_LOGIC, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Nand BX by CX and place the result in ?BX?"),
     tInstLibEntry<tMethod>("or", &cHardwareCPU::Inst_Or, INST_CLASS_ARITHMETIC_LOGIC),
     tInstLibEntry<tMethod>("nor", &cHardwareCPU::Inst_Nor, INST_CLASS_ARITHMETIC_LOGIC),
     tInstLibEntry<tMethod>("and", &cHardwareCPU::Inst_And, INST_CLASS_ARITHMETIC_LOGIC),
@@ -351,7 +351,7 @@ tInstLib<cHardwareCPU::tMethod>* cHardwareCPU::initInstLib(void)
     tInstLibEntry<tMethod>("id-th", &cHardwareCPU::Inst_ThreadID),
     
     // Head-based instructions
-    tInstLibEntry<tMethod>("h-alloc", &cHardwareCPU::Inst_MaxAlloc, INST_CLASS_LIFECYCLE, nInstFlag::DEFAULT, "Allocate maximum allowed space"),
+    tInstLibEntry<tMethod>("h-alloc", &cHardwareCPU::Inst_MaxAlloc, INST_CLASS_LIFECYCLE, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Allocate maximum allowed space"),
     tInstLibEntry<tMethod>("h-alloc-mw", &cHardwareCPU::Inst_MaxAllocMoveWriteHead),
     tInstLibEntry<tMethod>("h-divide", &cHardwareCPU::Inst_HeadDivide, INST_CLASS_LIFECYCLE, nInstFlag::DEFAULT | nInstFlag::STALL, "Divide code between read and write heads."),
     tInstLibEntry<tMethod>("h-divide1RS", &cHardwareCPU::Inst_HeadDivide1RS, INST_CLASS_LIFECYCLE, nInstFlag::STALL, "Divide code between read and write heads, at most one mutation on divide, resample if reverted."),
@@ -359,20 +359,20 @@ tInstLib<cHardwareCPU::tMethod>* cHardwareCPU::initInstLib(void)
     tInstLibEntry<tMethod>("h-divideRS", &cHardwareCPU::Inst_HeadDivideRS, INST_CLASS_LIFECYCLE, nInstFlag::STALL, "Divide code between read and write heads, resample if reverted."),
     tInstLibEntry<tMethod>("h-read", &cHardwareCPU::Inst_HeadRead, INST_CLASS_LIFECYCLE),
     tInstLibEntry<tMethod>("h-write", &cHardwareCPU::Inst_HeadWrite, INST_CLASS_LIFECYCLE),
-    tInstLibEntry<tMethod>("h-copy", &cHardwareCPU::Inst_HeadCopy, INST_CLASS_LIFECYCLE, nInstFlag::DEFAULT, "Copy from read-head to write-head; advance both"),
-    tInstLibEntry<tMethod>("h-search", &cHardwareCPU::Inst_HeadSearch, INST_CLASS_FLOW_CONTROL, nInstFlag::DEFAULT, "Find complement template and make with flow head"),
+    tInstLibEntry<tMethod>("h-copy", &cHardwareCPU::Inst_HeadCopy, INST_CLASS_LIFECYCLE, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Copy from read-head to write-head; advance both"),
+    tInstLibEntry<tMethod>("h-search", &cHardwareCPU::Inst_HeadSearch, INST_CLASS_FLOW_CONTROL, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Find complement template and make with flow head"),
     tInstLibEntry<tMethod>("h-search-direct", &cHardwareCPU::Inst_HeadSearchDirect, INST_CLASS_FLOW_CONTROL, 0, "Find direct template and move the flow head"),
     tInstLibEntry<tMethod>("h-push", &cHardwareCPU::Inst_HeadPush, INST_CLASS_FLOW_CONTROL),
     tInstLibEntry<tMethod>("h-pop", &cHardwareCPU::Inst_HeadPop, INST_CLASS_FLOW_CONTROL),
     tInstLibEntry<tMethod>("set-head", &cHardwareCPU::Inst_SetHead, INST_CLASS_FLOW_CONTROL),
     tInstLibEntry<tMethod>("adv-head", &cHardwareCPU::Inst_AdvanceHead, INST_CLASS_FLOW_CONTROL),
-    tInstLibEntry<tMethod>("mov-head", &cHardwareCPU::Inst_MoveHead, INST_CLASS_FLOW_CONTROL, nInstFlag::DEFAULT, "Move head ?IP? to the flow head"),
-    tInstLibEntry<tMethod>("jmp-head", &cHardwareCPU::Inst_JumpHead, INST_CLASS_FLOW_CONTROL, nInstFlag::DEFAULT, "Move head ?IP? by amount in CX register; CX = old pos."),
-    tInstLibEntry<tMethod>("get-head", &cHardwareCPU::Inst_GetHead, INST_CLASS_FLOW_CONTROL, nInstFlag::DEFAULT, "Copy the position of the ?IP? head into CX"),
-    tInstLibEntry<tMethod>("if-label", &cHardwareCPU::Inst_IfLabel, INST_CLASS_CONDITIONAL, nInstFlag::DEFAULT, "Execute next if we copied complement of attached label"),
+    tInstLibEntry<tMethod>("mov-head", &cHardwareCPU::Inst_MoveHead, INST_CLASS_FLOW_CONTROL, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Move head ?IP? to the flow head"),
+    tInstLibEntry<tMethod>("jmp-head", &cHardwareCPU::Inst_JumpHead, INST_CLASS_FLOW_CONTROL, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Move head ?IP? by amount in CX register; CX = old pos."),
+    tInstLibEntry<tMethod>("get-head", &cHardwareCPU::Inst_GetHead, INST_CLASS_FLOW_CONTROL, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Copy the position of the ?IP? head into CX"),
+    tInstLibEntry<tMethod>("if-label", &cHardwareCPU::Inst_IfLabel, INST_CLASS_CONDITIONAL, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Execute next if we copied complement of attached label"),
     tInstLibEntry<tMethod>("if-label-direct", &cHardwareCPU::Inst_IfLabelDirect, INST_CLASS_CONDITIONAL, nInstFlag::DEFAULT, "Execute next if we copied direct match of the attached label"),
     tInstLibEntry<tMethod>("if-label2", &cHardwareCPU::Inst_IfLabel2, INST_CLASS_CONDITIONAL, 0, "If copied label compl., exec next inst; else SKIP W/NOPS"),
-    tInstLibEntry<tMethod>("set-flow", &cHardwareCPU::Inst_SetFlow, INST_CLASS_FLOW_CONTROL, nInstFlag::DEFAULT, "Set flow-head to position in ?CX?"),
+    tInstLibEntry<tMethod>("set-flow", &cHardwareCPU::Inst_SetFlow, INST_CLASS_FLOW_CONTROL, (nInstFlag::DEFAULT | nInstFlag::ISOLATED), "Set flow-head to position in ?CX?"),
     
     tInstLibEntry<tMethod>("res-mov-head", &cHardwareCPU::Inst_ResMoveHead, INST_CLASS_FLOW_CONTROL, nInstFlag::STALL, "Move head ?IP? to the flow head depending on resource level"),
     tInstLibEntry<tMethod>("res-jmp-head", &cHardwareCPU::Inst_ResJumpHead, INST_CLASS_FLOW_CONTROL, nInstFlag::STALL, "Move head ?IP? by amount in CX register depending on resource level; CX = old pos."),
@@ -879,6 +879,21 @@ void cHardwareCPU::cLocalThread::operator=(const cLocalThread& in_thread)
   m_messageTriggerType = in_thread.m_messageTriggerType;
 }
 
+// Unlike operator=, copies every field; used for checkpointing
+void cHardwareCPU::cLocalThread::CopyState(const cLocalThread& in_thread)
+{
+  m_id = in_thread.m_id;
+  m_promoter_inst_executed = in_thread.m_promoter_inst_executed;
+  m_messageTriggerType = in_thread.m_messageTriggerType;
+  for (int i = 0; i < NUM_REGISTERS; i++) reg[i] = in_thread.reg[i];
+  for (int i = 0; i < NUM_HEADS; i++) heads[i] = in_thread.heads[i];
+  stack = in_thread.stack;
+  cur_stack = in_thread.cur_stack;
+  cur_head = in_thread.cur_head;
+  read_label = in_thread.read_label;
+  next_label = in_thread.next_label;
+}
+
 void cHardwareCPU::cLocalThread::Reset(cHardwareBase* in_hardware, int in_id)
 {
   m_id = in_id;
@@ -902,6 +917,76 @@ void cHardwareCPU::cLocalThread::Reset(cHardwareBase* in_hardware, int in_id)
 void cHardwareCPU::SetupMiniTraceFileHeader(Avida::Output::File& df, const int gen_id, const Apto::String& genotype) { (void)df, (void)gen_id, (void)genotype; }
 
 
+cHardwareCheckpoint* cHardwareCPU::SaveCheckpoint() const
+{
+  // Promoter positions and codes are computed from the whole genome at reset, so a checkpoint could not be
+  // applied to a different genome without redoing that scan.
+  if (m_promoters_enabled) return NULL;
+  
+  cCheckpoint* checkpoint = new cCheckpoint;
+  saveBaseCheckpoint(*checkpoint);
+  
+  checkpoint->memory = m_memory;
+  checkpoint->global_stack = m_global_stack;
+  checkpoint->threads.Resize(m_threads.GetSize());
+  for (int i = 0; i < m_threads.GetSize(); i++) checkpoint->threads[i].CopyState(m_threads[i]);
+  checkpoint->thread_id_chart = m_thread_id_chart;
+  checkpoint->cur_thread = m_cur_thread;
+  checkpoint->mal_active = m_mal_active;
+  checkpoint->advance_ip = m_advance_ip;
+  checkpoint->executedmatchstrings = m_executedmatchstrings;
+  checkpoint->spec_die = m_spec_die;
+  checkpoint->epigenetic_state = m_epigenetic_state;
+  for (int i = 0; i < NUM_REGISTERS; i++) checkpoint->epigenetic_saved_reg[i] = m_epigenetic_saved_reg[i];
+  checkpoint->epigenetic_saved_stack = m_epigenetic_saved_stack;
+  checkpoint->last_cell_data = m_last_cell_data;
+  checkpoint->flash_info = m_flash_info;
+  checkpoint->cycle_counter = m_cycle_counter;
+  
+  return checkpoint;
+}
+
+bool cHardwareCPU::RestoreCheckpoint(const cHardwareCheckpoint& in_checkpoint)
+{
+  if (in_checkpoint.GetHardwareType() != GetType() || m_promoters_enabled) return false;
+  const cCheckpoint& checkpoint = static_cast<const cCheckpoint&>(in_checkpoint);
+  if (checkpoint.threads.GetSize() == 0) return false;
+  
+  restoreBaseCheckpoint(checkpoint);
+  
+  m_memory = checkpoint.memory;
+  m_global_stack = checkpoint.global_stack;
+  m_threads.Resize(checkpoint.threads.GetSize());
+  for (int i = 0; i < m_threads.GetSize(); i++) {
+    m_threads[i].CopyState(checkpoint.threads[i]);
+    for (int j = 0; j < NUM_HEADS; j++) m_threads[i].heads[j].Rebind(this);
+  }
+  m_thread_id_chart = checkpoint.thread_id_chart;
+  m_cur_thread = checkpoint.cur_thread;
+  m_mal_active = checkpoint.mal_active;
+  m_advance_ip = checkpoint.advance_ip;
+  m_executedmatchstrings = checkpoint.executedmatchstrings;
+  m_spec_die = checkpoint.spec_die;
+  m_epigenetic_state = checkpoint.epigenetic_state;
+  for (int i = 0; i < NUM_REGISTERS; i++) m_epigenetic_saved_reg[i] = checkpoint.epigenetic_saved_reg[i];
+  m_epigenetic_saved_stack = checkpoint.epigenetic_saved_stack;
+  m_last_cell_data = checkpoint.last_cell_data;
+  m_flash_info = checkpoint.flash_info;
+  m_cycle_counter = checkpoint.cycle_counter;
+  
+  return true;
+}
+
+
+int cHardwareCPU::GetMemoryFootprint() const
+{
+  int bytes = sizeof(cHardwareCPU) + baseHeapSize() + m_memory.GetHeapSize();
+  bytes += m_threads.GetSize() * sizeof(cLocalThread);
+  bytes += m_promoters.GetSize() * sizeof(cPromoter);
+  return bytes;
+}
+
+
 // This function processes the very next command in the genome, and is made
 // to be as optimized as possible.  This is the heart of avida.
 
@@ -957,8 +1042,9 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
     
     // Find the instruction to be executed
     const Instruction cur_inst = ip.GetInst();
+    const cInstSet::sInstDispatch& cur_info = m_inst_set->GetDispatch(cur_inst);
     
-    if (speculative && (m_spec_die || m_inst_set->ShouldStall(cur_inst))) {
+    if (speculative && (m_spec_die || (cur_info.flags & nInstFlag::STALL))) {
       // Speculative instruction reject, flush and return
       m_cur_thread = last_thread;
       phenotype.DecCPUCyclesUsed();
@@ -982,11 +1068,11 @@ bool cHardwareCPU::SingleProcess(cAvidaContext& ctx, bool speculative)
       // NOTE: This call based on the cur_inst must occur prior to instruction
       //       execution, because this instruction reference may be invalid after
       //       certain classes of instructions (namely divide instructions) @DMB
-      const int time_cost = m_inst_set->GetAddlTimeCost(cur_inst);
+      const int time_cost = cur_info.addl_time_cost;
       
       // Prob of exec (moved from SingleProcess_PayCosts so that we advance IP after a fail)
-      if (m_inst_set->GetProbFail(cur_inst) > 0.0) {
-        exec = !( ctx.GetRandom().P(m_inst_set->GetProbFail(cur_inst)) );
+      if (cur_info.prob_fail > 0.0) {
+        exec = !( ctx.GetRandom().P(cur_info.prob_fail) );
       }
       
       // Flag instruction as executed even if it failed (moved from SingleProcess_ExecuteInst)
@@ -1192,16 +1278,19 @@ cHeadCPU cHardwareCPU::FindLabel(int direction)
   int found_pos = 0;
   if ( direction < 0 ) {
     found_pos = FindLabel_Backward(search_label, m_memory, inst_ptr.GetPosition() - search_label.GetSize());
+    m_memory.TouchRange(0, inst_ptr.GetPosition() + 1);
   }
   
   // Jump forward.
   else if (direction > 0) {
     found_pos = FindLabel_Forward(search_label, m_memory, inst_ptr.GetPosition());
+    m_memory.TouchRange(0, (found_pos >= 0) ? found_pos + 1 : m_memory.GetSize());
   }
   
   // Jump forward from the very beginning.
   else {
     found_pos = FindLabel_Forward(search_label, m_memory, 0);
+    m_memory.TouchRange(0, (found_pos >= 0) ? found_pos + 1 : m_memory.GetSize());
   }
   
   // Return the last line of the found label, if it was found.
@@ -1215,83 +1304,65 @@ cHeadCPU cHardwareCPU::FindLabel(int direction)
 // Search forwards for search_label from _after_ position pos in the
 // memory.  Return the first line _after_ the the found label.  It is okay
 // to find search label's match inside another label.
+//
+// The search probes every label_size sites and only examines the nop runs
+// that a probe lands in.  The memory's nop run index lets us step straight
+// from run to run, visiting exactly the runs the site-by-site scan would.
 
 int cHardwareCPU::FindLabel_Forward(const cCodeLabel & search_label,
-                                    const InstructionSequence & search_genome, int pos)
+                                    const cCPUMemory & search_genome, int pos)
 {
   assert (pos < search_genome.GetSize() && pos >= 0);
   
-  int search_start = pos;
-  int label_size = search_label.GetSize();
-  bool found_label = false;
+  const int search_start = pos;
+  const int label_size = search_label.GetSize();
+  const Apto::Array<cCPUMemory::sNopRun>& runs = search_genome.GetNopRuns(*m_inst_set);
   
   // Move off the template we are on.
   pos += label_size;
   
+  int run = search_genome.FindNopRun(*m_inst_set, pos);
+  
   // Search until we find the complement or exit the memory.
-  while (pos < search_genome.GetSize()) {
-    
-    // If we are within a label, rewind to the beginning of it and see if
-    // it has the proper sub-label that we're looking for.
+  while (pos < search_genome.GetSize() && run < runs.GetSize()) {
+    // Runs are never rewound past the search start.
+    const int start_pos = Apto::Max(runs[run].start, search_start);
+    const int end_pos = runs[run].end;
+    
+    // Advance to the first probe that could land in this run.
+    if (pos < start_pos) pos += ((start_pos - pos + label_size - 1) / label_size) * label_size;
+    if (pos >= end_pos) {
+      // Probes step over this run entirely; move on to the run holding the next probe.
+      while (run < runs.GetSize() && runs[run].end <= pos) run++;
+      continue;
+    }
     
-    if (m_inst_set->IsNop(search_genome[pos])) {
-      // Find the start and end of the label we're in the middle of.
-      
-      int start_pos = pos;
-      int end_pos = pos + 1;
-      while (start_pos > search_start &&
-             m_inst_set->IsNop( search_genome[start_pos - 1] )) {
-        start_pos--;
-      }
-      while (end_pos < search_genome.GetSize() &&
-             m_inst_set->IsNop( search_genome[end_pos] )) {
-        end_pos++;
-      }
-      int test_size = end_pos - start_pos;
+    // See if this label has the proper sub-label within it.
+    int test_size = end_pos - start_pos;
+    int max_offset = test_size - label_size + 1;
+    for (int offset = start_pos; offset < start_pos + max_offset; offset++) {
       
-      // See if this label has the proper sub-label within it.
-      int max_offset = test_size - label_size + 1;
-      int offset = start_pos;
-      for (offset = start_pos; offset < start_pos + max_offset; offset++) {
-        
-        // Test the number of matches for this offset.
-        int matches;
-        for (matches = 0; matches < label_size; matches++) {
-          if (search_label[matches] !=
-              m_inst_set->GetNopMod( search_genome[offset + matches] )) {
-            break;
-          }
-        }
-        
-        // If we have found it, break out of this loop!
-        if (matches == label_size) {
-          found_label = true;
+      // Test the number of matches for this offset.
+      int matches;
+      for (matches = 0; matches < label_size; matches++) {
+        if (search_label[matches] !=
+            m_inst_set->GetNopMod( search_genome[offset + matches] )) {
           break;
         }
       }
       
-      // If we've found the complement label, set the position to the end of
-      // the label we found it in, and break out.
-      
-      if (found_label == true) {
-        // pos = end_pos;
-        pos = label_size + offset;
-        break;
-      }
-      
-      // We haven't found it; jump pos to just after the current label being
-      // checked.
-      pos = end_pos;
+      // If we have found it, return the position just after it.
+      if (matches == label_size) return label_size + offset;
     }
     
-    // Jump up a block to the next possible point to find a label,
-    pos += label_size;
+    // We haven't found it; jump pos to just after the current label being
+    // checked, then up a block to the next possible point to find a label.
+    pos = end_pos + label_size;
+    while (run < runs.GetSize() && runs[run].end <= pos) run++;
   }
   
-  // If the label was not found return a -1.
-  if (found_label == false) pos = -1;
-  
-  return pos;
+  // The label was not found.
+  return -1;
 }
 
 // Search backwards for search_label from _before_ position pos in the
@@ -1299,77 +1370,57 @@ int cHardwareCPU::FindLabel_Forward(const cCodeLabel & search_label,
 // to find search label's match inside another label.
 
 int cHardwareCPU::FindLabel_Backward(const cCodeLabel & search_label,
-                                     const InstructionSequence & search_genome, int pos)
+                                     const cCPUMemory & search_genome, int pos)
 {
   assert (pos < search_genome.GetSize());
   
-  int search_start = pos;
-  int label_size = search_label.GetSize();
-  bool found_label = false;
+  const int search_start = pos;
+  const int label_size = search_label.GetSize();
+  const Apto::Array<cCPUMemory::sNopRun>& runs = search_genome.GetNopRuns(*m_inst_set);
   
   // Move off the template we are on.
   pos -= label_size;
   
   // Search until we find the complement or exit the memory.
   while (pos >= 0) {
-    // If we are within a label, rewind to the beginning of it and see if
-    // it has the proper sub-label that we're looking for.
-    
-    if (m_inst_set->IsNop( search_genome[pos] )) {
-      // Find the start and end of the label we're in the middle of.
-      
-      int start_pos = pos;
-      int end_pos = pos + 1;
-      while (start_pos > 0 && m_inst_set->IsNop(search_genome[start_pos - 1])) {
-        start_pos--;
-      }
-      while (end_pos < search_start &&
-             m_inst_set->IsNop(search_genome[end_pos])) {
-        end_pos++;
-      }
-      int test_size = end_pos - start_pos;
+    // Find the last run starting at or before the probe.
+    int run = search_genome.FindNopRun(*m_inst_set, pos);
+    if (run >= runs.GetSize() || runs[run].start > pos) run--;
+    if (run < 0) break;
+    
+    // Runs are never extended past the search start.
+    const int start_pos = runs[run].start;
+    const int end_pos = Apto::Min(runs[run].end, search_start);
+    
+    // Step back to the first probe that could land in this run.
+    if (pos >= end_pos) pos -= ((pos - end_pos) / label_size + 1) * label_size;
+    if (pos < start_pos) continue;
+    
+    // See if this label has the proper sub-label within it.
+    int test_size = end_pos - start_pos;
+    int max_offset = test_size - label_size + 1;
+    for (int offset = start_pos; offset < start_pos + max_offset; offset++) {
       
-      // See if this label has the proper sub-label within it.
-      int max_offset = test_size - label_size + 1;
-      for (int offset = start_pos; offset < start_pos + max_offset; offset++) {
-        
-        // Test the number of matches for this offset.
-        int matches;
-        for (matches = 0; matches < label_size; matches++) {
-          if (search_label[matches] !=
-              m_inst_set->GetNopMod(search_genome[offset + matches])) {
-            break;
-          }
-        }
-        
-        // If we have found it, break out of this loop!
-        if (matches == label_size) {
-          found_label = true;
+      // Test the number of matches for this offset.
+      int matches;
+      for (matches = 0; matches < label_size; matches++) {
+        if (search_label[matches] !=
+            m_inst_set->GetNopMod(search_genome[offset + matches])) {
           break;
         }
       }
       
-      // If we've found the complement label, set the position to the end of
-      // the label we found it in, and break out.
-      
-      if (found_label == true) {
-        pos = end_pos;
-        break;
-      }
-      
-      // We haven't found it; jump pos to just before the current label
-      // being checked.
-      pos = start_pos - 1;
+      // If we have found it, return the end of the label we found it in.
+      if (matches == label_size) return end_pos;
     }
     
-    // Jump up a block to the next possible point to find a label,
-    pos -= label_size;
+    // We haven't found it; jump pos to just before the current label
+    // being checked, then up a block to the next possible point.
+    pos = start_pos - 1 - label_size;
   }
   
-  // If the label was not found return a -1.
-  if (found_label == false) pos = -1;
-  
-  return pos;
+  // The label was not found.
+  return -1;
 }
 
 // Search for 'in_label' anywhere in the hardware.
@@ -1690,7 +1741,7 @@ bool cHardwareCPU::Allocate_Random(cAvidaContext& ctx, const int old_size, const
   m_memory.Resize(new_size);
   
   for (int i = old_size; i < new_size; i++) {
-    m_memory[i] = m_inst_set->GetRandomInst(ctx);
+    m_memory.SetInst(i, m_inst_set->GetRandomInst(ctx));
   }
   return true;
 }
@@ -1783,12 +1834,12 @@ bool cHardwareCPU::Divide_Main(cAvidaContext& ctx, const int div_point,
 	
   // Since the divide will now succeed, set up the information to be sent
   // to the new organism
+  m_memory.TouchRange(div_point, div_point + child_size);
   InstructionSequencePtr offspring_seq(new InstructionSequence(m_memory.Crop(div_point, div_point + child_size)));
-  HashPropertyMap props;
-  cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
-  Genome offspring(GetType(), props, offspring_seq);
+  Genome offspring(GetType(), (const char*)m_inst_set->GetInstSetName(), m_inst_set->GetInstSetNameID(), offspring_seq);
     
   // Make sure it is an exact copy at this point (before divide mutations) if required
+  m_memory.TouchAll();
   const Genome& base_genome = m_organism->GetGenome();
   ConstInstructionSequencePtr seq_p;
   seq_p.DynamicCastFrom(base_genome.Representation());
@@ -1862,10 +1913,9 @@ bool cHardwareCPU::Divide_MainRS(cAvidaContext& ctx, const int div_point,
   
   // Since the divide will now succeed, set up the information to be sent
   // to the new organism
+  m_memory.TouchRange(div_point, div_point + child_size);
   InstructionSequencePtr offspring_seq(new InstructionSequence(m_memory.Crop(div_point, div_point + child_size)));
-  HashPropertyMap props;
-  cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
-  Genome offspring(GetType(), props, offspring_seq);
+  Genome offspring(GetType(), (const char*)m_inst_set->GetInstSetName(), m_inst_set->GetInstSetNameID(), offspring_seq);
 
   m_organism->OffspringGenome() = offspring;
   
@@ -1961,10 +2011,9 @@ bool cHardwareCPU::Divide_Main1RS(cAvidaContext& ctx, const int div_point,
   
   // Since the divide will now succeed, set up the information to be sent
   // to the new organism
+  m_memory.TouchRange(div_point, div_point + child_size);
   InstructionSequencePtr offspring_seq(new InstructionSequence(m_memory.Crop(div_point, div_point + child_size)));
-  HashPropertyMap props;
-  cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
-  Genome offspring(GetType(), props, offspring_seq);
+  Genome offspring(GetType(), (const char*)m_inst_set->GetInstSetName(), m_inst_set->GetInstSetNameID(), offspring_seq);
 
   m_organism->OffspringGenome() = offspring;
   
@@ -2055,10 +2104,9 @@ bool cHardwareCPU::Divide_Main2RS(cAvidaContext& ctx, const int div_point,
   
   // Since the divide will now succeed, set up the information to be sent
   // to the new organism
+  m_memory.TouchRange(div_point, div_point + child_size);
   InstructionSequencePtr offspring_seq(new InstructionSequence(m_memory.Crop(div_point, div_point + child_size)));
-  HashPropertyMap props;
-  cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
-  Genome offspring(GetType(), props, offspring_seq);
+  Genome offspring(GetType(), (const char*)m_inst_set->GetInstSetName(), m_inst_set->GetInstSetNameID(), offspring_seq);
 
   m_organism->OffspringGenome() = offspring;
   
@@ -3336,6 +3384,7 @@ void cHardwareCPU::Divide_DoTransposons(cAvidaContext& ctx)
   // Count the number of transposons that are marked as executed
   int tr_count = 0;
   for (int i = 0; i < m_memory.GetSize(); i++) {
+    m_memory.TouchSite(i);
     if (m_memory.FlagExecuted(i) && (m_memory[i] == transposon_inst)) tr_count++;
   }
   
@@ -3372,6 +3421,7 @@ bool cHardwareCPU::Inst_Repro(cAvidaContext& ctx)
   }
   
   // Setup child
+  m_memory.TouchAll();
   m_organism->OffspringGenome() = m_organism->GetGenome();
   InstructionSequencePtr offspring_seq;
   offspring_seq.DynamicCastFrom(m_organism->OffspringGenome().Representation());
@@ -3491,6 +3541,7 @@ bool cHardwareCPU::Inst_SpawnDeme(cAvidaContext& ctx)
 
 bool cHardwareCPU::Inst_SenseQuorum(cAvidaContext& ctx) {
   int cellID = m_organism->GetCellID();
+  m_memory.TouchAll();
   Apto::String ref_genome = m_organism->GetGenome().Representation()->AsString();
   int radius = m_world->GetConfig().KABOOM_RADIUS.Get();
   int distance = m_world->GetConfig().KABOOM_HAMMING.Get();
@@ -3563,6 +3614,7 @@ bool cHardwareCPU::Inst_SenseQuorum(cAvidaContext& ctx) {
 
 bool cHardwareCPU::Inst_NoisyQuorum(cAvidaContext& ctx) {
   int cellID = m_organism->GetCellID();
+  m_memory.TouchAll();
   Apto::String ref_genome = m_organism->GetGenome().Representation()->AsString();
   int radius = m_world->GetConfig().KABOOM_RADIUS.Get();
   int distance = m_world->GetConfig().KABOOM_HAMMING.Get();
@@ -5109,6 +5161,7 @@ bool cHardwareCPU::Inst_DonateEditDist(cAvidaContext& ctx)
       neighbor = m_organism->GetNeighbor();
       int edit_dist = max_dist + 1;
       if (neighbor != NULL) {
+        m_memory.TouchAll();
         const Genome& org_genome = m_organism->GetGenome();
         ConstInstructionSequencePtr org_seq_p;
         org_seq_p.DynamicCastFrom(org_genome.Representation());
@@ -5125,6 +5178,7 @@ bool cHardwareCPU::Inst_DonateEditDist(cAvidaContext& ctx)
         found = true;
 				
         // Code to track the edit distance between edt donors and recipients
+        m_memory.TouchAll();
         const Genome& org_genome = m_organism->GetGenome();
         ConstInstructionSequencePtr org_seq_p;
         org_seq_p.DynamicCastFrom(org_genome.Representation());
@@ -5185,6 +5239,7 @@ bool cHardwareCPU::Inst_GetFacedEditDistance(cAvidaContext& ctx)
   cOrganism* target = NULL;
   target = m_organism->GetOrgInterface().GetNeighbor();
 
+  m_memory.TouchAll();
   const Genome& org_genome = m_organism->GetGenome();
   ConstInstructionSequencePtr org_seq_p;
   org_seq_p.DynamicCastFrom(org_genome.Representation());
@@ -5344,6 +5399,7 @@ bool cHardwareCPU::Inst_DonateShadedGreenBeard(cAvidaContext& ctx)
       //			if (neighbor_shade_of_gb >=  shade_of_gb) {
       if (neighbor_shade_of_gb ==  shade_of_gb) {	
         // Code to track the edit distance between shaded donors and recipients
+        m_memory.TouchAll();
         const Genome& org_genome = m_organism->GetGenome();
         ConstInstructionSequencePtr org_seq_p;
         org_seq_p.DynamicCastFrom(org_genome.Representation());
@@ -5538,6 +5594,7 @@ bool cHardwareCPU::Inst_DonateThreshGreenBeard(cAvidaContext& ctx)
       }
 			
       if (neighbor_thresh_of_gb >= m_world->GetConfig().MIN_GB_DONATE_THRESHOLD.Get() ) {
+        m_memory.TouchAll();
         const Genome& org_gen = m_organism->GetGenome();
         ConstInstructionSequencePtr org_seq_p;
         org_seq_p.DynamicCastFrom(org_gen.Representation());
@@ -6277,6 +6334,7 @@ bool cHardwareCPU::Inst_DonateSpecific(cAvidaContext& ctx)
       m_organism->GetPhenotype().SetIsDonorEdit();
       target->GetPhenotype().SetIsReceiverEdit();
       
+      m_memory.TouchAll();
       const Genome& org_genome = m_organism->GetGenome();
       ConstInstructionSequencePtr org_seq_p;
       org_seq_p.DynamicCastFrom(org_genome.Representation());
@@ -7118,6 +7176,7 @@ bool cHardwareCPU::Inst_HeadWrite(cAvidaContext& ctx)
   if (m_organism->TestCopyDel(ctx)) active_head.RemoveInst();
   if (m_organism->TestCopyUniform(ctx)) doUniformCopyMutation(ctx, active_head);
   if (!m_slip_read_head && m_organism->TestCopySlip(ctx)) {
+    m_memory.TouchAll();
     doSlipMutation(ctx, m_memory, active_head.GetPosition());
   }
   
@@ -7157,6 +7216,7 @@ bool cHardwareCPU::Inst_HeadCopy(cAvidaContext& ctx)
     if (m_slip_read_head) {
       read_head.Set(ctx.GetRandom().GetInt(m_memory.GetSize()));
     } else {
+      m_memory.TouchAll();
       doSlipMutation(ctx, m_memory, write_head.GetPosition());
     }
   }
@@ -7223,6 +7283,7 @@ bool cHardwareCPU::HeadCopy_ErrorCorrect(cAvidaContext& ctx, double reduction)
     if (m_slip_read_head) {
       read_head.Set(ctx.GetRandom().GetInt(m_memory.GetSize()));
     } else {
+      m_memory.TouchAll();
       doSlipMutation(ctx, m_memory, write_head.GetPosition());
     }
   }
@@ -8001,6 +8062,7 @@ int cHardwareCPU::Numberate(int _pos, int _dir, int _num_bits)
   assert(j >=0);
   assert(j < m_memory.GetSize());
   while (code_size < _num_bits) {
+    m_memory.TouchSite(j);
     unsigned int inst_code = (unsigned int) GetInstSet().GetInstructionCode(m_memory[j]);
     // shift bits in, one by one ... excuse the counter variable pun
     for (int code_on = 0; (code_size < _num_bits) && (code_on < m_world->GetConfig().INST_CODE_LENGTH.Get()); code_on++) {
@@ -85,6 +85,7 @@ protected:
     ~cLocalThread() { ; }
 
     void operator=(const cLocalThread& in_thread);
+    void CopyState(const cLocalThread& in_thread);
 
     void Reset(cHardwareBase* in_hardware, int in_id);
     int GetID() const { return m_id; }
@@ -152,6 +153,27 @@ protected:
   cCPUStack m_epigenetic_saved_stack;
   // Epigenetic State -->
 
+  // Complete execution state, as captured by SaveCheckpoint()
+  class cCheckpoint : public cHardwareCheckpoint
+  {
+  public:
+    cCPUMemory memory;
+    cCPUStack global_stack;
+    Apto::Array<cLocalThread> threads;
+    int thread_id_chart;
+    int cur_thread;
+    bool mal_active;
+    bool advance_ip;
+    bool executedmatchstrings;
+    bool spec_die;
+    bool epigenetic_state;
+    int epigenetic_saved_reg[NUM_REGISTERS];
+    cCPUStack epigenetic_saved_stack;
+    std::pair<bool, int> last_cell_data;
+    std::pair<unsigned int, unsigned int> flash_info;
+    unsigned int cycle_counter;
+  };
+
 
   bool SingleProcess_ExecuteInst(cAvidaContext& ctx, const Instruction& cur_inst);
   
@@ -173,8 +195,8 @@ protected:
   cCodeLabel& GetLabel() { return m_threads[m_cur_thread].next_label; }
   void ReadLabel(int max_size=cCodeLabel::MAX_LENGTH);
   cHeadCPU FindLabel(int direction);
-  int FindLabel_Forward(const cCodeLabel & search_label, const InstructionSequence& search_genome, int pos);
-  int FindLabel_Backward(const cCodeLabel & search_label, const InstructionSequence& search_genome, int pos);
+  int FindLabel_Forward(const cCodeLabel & search_label, const cCPUMemory& search_genome, int pos);
+  int FindLabel_Backward(const cCodeLabel & search_label, const cCPUMemory& search_genome, int pos);
   cHeadCPU FindLabel(const cCodeLabel & in_label, int direction);
   void FindLabelInMemory(const cCodeLabel& label, cHeadCPU& search_head);
 
@@ -248,6 +270,9 @@ public:
   // --------  Helper methods  --------
   int GetType() const { return HARDWARE_TYPE_CPU_ORIGINAL; }  
   bool SupportsSpeculative() const { return true; }
+  int GetMemoryFootprint() const;
+  cHardwareCheckpoint* SaveCheckpoint() const;
+  bool RestoreCheckpoint(const cHardwareCheckpoint& in_checkpoint);
   void PrintStatus(std::ostream& fp);
   void SetupMiniTraceFileHeader(Avida::Output::File& df, const int gen_id, const Apto::String& genotype);
   void PrintMiniTraceStatus(cAvidaContext& ctx, std::ostream& fp) { (void)ctx, (void)fp; }
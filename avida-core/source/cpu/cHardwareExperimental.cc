@@ -556,6 +556,15 @@ void cHardwareExperimental::cLocalThread::Reset(cHardwareExperimental* in_hardwa
 }
 
 
+int cHardwareExperimental::GetMemoryFootprint() const
+{
+  int bytes = sizeof(cHardwareExperimental) + baseHeapSize() + m_memory.GetHeapSize();
+  bytes += m_threads.GetSize() * (sizeof(cLocalThread*) + sizeof(cLocalThread));
+  bytes += m_promoters.GetSize() * (sizeof(cPromoter*) + sizeof(cPromoter));
+  return bytes;
+}
+
+
 // This function processes the very next command in the genome, and is made
 // to be as optimized as possible.  This is the heart of avida.
 
@@ -618,8 +627,9 @@ bool cHardwareExperimental::SingleProcess(cAvidaContext& ctx, bool speculative)
     
     // Find the instruction to be executed
     const Instruction cur_inst = ip.GetInst();
+    const cInstSet::sInstDispatch& cur_info = m_inst_set->GetDispatch(cur_inst);
     
-    if (speculative && (m_spec_die || m_inst_set->ShouldStall(cur_inst))) {
+    if (speculative && (m_spec_die || (cur_info.flags & nInstFlag::STALL))) {
       // Speculative instruction reject, flush and return
       m_cur_thread = last_thread;
       phenotype.DecCPUCyclesUsed();
@@ -655,11 +665,11 @@ bool cHardwareExperimental::SingleProcess(cAvidaContext& ctx, bool speculative)
       // NOTE: This call based on the cur_inst must occur prior to instruction
       //       execution, because this instruction reference may be invalid after
       //       certain classes of instructions (namely divide instructions) @DMB
-      const int addl_time_cost = m_inst_set->GetAddlTimeCost(cur_inst);
+      const int addl_time_cost = cur_info.addl_time_cost;
       
       // Prob of exec (moved from SingleProcess_PayCosts so that we advance IP after a fail)
-      if ( m_inst_set->GetProbFail(cur_inst) > 0.0 ) {
-        exec = !( ctx.GetRandom().P(m_inst_set->GetProbFail(cur_inst)) );
+      if ( cur_info.prob_fail > 0.0 ) {
+        exec = !( ctx.GetRandom().P(cur_info.prob_fail) );
         rand_fail = !exec;
       }
       
@@ -973,41 +983,21 @@ cHeadCPU cHardwareExperimental::FindLabelStart(bool mark_executed)
   if (search_label.GetSize() == 0) return ip;
   
   cCPUMemory& memory = m_memory;
-  int pos = 0;
   
-  while (pos < memory.GetSize()) {
-    if (m_inst_set->IsLabel(memory[pos])) { // starting label found
-      pos++;
-      
-      // Check for direct matched label pattern, can be substring of 'label'ed target
-      // - must match all NOPs in search_label
-      // - extra NOPs in 'label'ed target are ignored
-      int size_matched = 0;
-      while (size_matched < search_label.GetSize() && pos < memory.GetSize()) {
-        if (!m_inst_set->IsNop(memory[pos]) || search_label[size_matched] != m_inst_set->GetNopMod(memory[pos])) break;
-        size_matched++;
-        pos++;
-      }
-      
-      // Check that the label matches and has examined the full sequence of nops following the 'label' instruction
-      if (size_matched == search_label.GetSize()) {
-        // Return Head pointed at last NOP of label sequence
-        if (mark_executed) {
-          size_matched++; // Increment size matched so that it includes the label instruction
-          const int start = pos - size_matched;
-          const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
-          for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(start + i);
-        }
-        return cHeadCPU(this, pos - 1, ip.GetMemSpace());
-      }
-      
-      continue; 
-    }
-    pos++;
+  // Direct matched label pattern, can be substring of 'label'ed target
+  // - must match all NOPs in search_label
+  // - extra NOPs in 'label'ed target are ignored
+  int label_start = 0;
+  if (!findLabelSequence(memory, search_label, true, 0, false, label_start)) return ip; // Return start point if not found
+  
+  const int size_matched = search_label.GetSize() + 1; // includes the label instruction
+  if (mark_executed) {
+    const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
+    for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(label_start + i);
   }
   
-  // Return start point if not found
-  return ip;
+  // Return Head pointed at last NOP of label sequence
+  return cHeadCPU(this, label_start + size_matched - 1, ip.GetMemSpace());
 }
 
 cHeadCPU cHardwareExperimental::FindNopSequenceStart(bool mark_executed)
@@ -1019,37 +1009,21 @@ cHeadCPU cHardwareExperimental::FindNopSequenceStart(bool mark_executed)
   if (search_label.GetSize() == 0) return ip;
   
   cCPUMemory& memory = m_memory;
-  int pos = 0;
   
-  while (pos < memory.GetSize()) {
-    if (m_inst_set->IsNop(memory[pos])) { // start of sequence found
-      
-      // Check for direct matched label pattern, can be substring of 'label'ed target
-      // - must match all NOPs in search_label
-      // - extra NOPs in 'label'ed target are ignored
-      int size_matched = 0;
-      while (size_matched < search_label.GetSize() && pos < memory.GetSize()) {
-        if (!m_inst_set->IsNop(memory[pos]) || search_label[size_matched] != m_inst_set->GetNopMod(memory[pos])) break;
-        size_matched++;
-        pos++;
-      }
-      
-      // Check that the label matches and has examined the full sequence of nops following the 'label' instruction
-      if (size_matched == search_label.GetSize()) {
-        // Return Head pointed at last NOP of label sequence
-        if (mark_executed) {
-          const int start = pos - size_matched;
-          const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
-          for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(start + i);
-        }
-        return cHeadCPU(this, pos - 1, ip.GetMemSpace());
-      }
-    }
-    pos++;
+  // Direct matched label pattern, can be substring of 'label'ed target
+  // - must match all NOPs in search_label
+  // - extra NOPs in 'label'ed target are ignored
+  int seq_start = 0;
+  if (!findLabelSequence(memory, search_label, false, 0, false, seq_start)) return ip; // Return start point if not found
+  
+  const int size_matched = search_label.GetSize();
+  if (mark_executed) {
+    const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
+    for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(seq_start + i);
   }
   
-  // Return start point if not found
-  return ip;
+  // Return Head pointed at last NOP of label sequence
+  return cHeadCPU(this, seq_start + size_matched - 1, ip.GetMemSpace());
 }
 
 
@@ -1061,46 +1035,25 @@ cHeadCPU cHardwareExperimental::FindLabelForward(bool mark_executed)
   // Make sure the label is of size > 0.
   if (search_label.GetSize() == 0) return ip;
   
-  cHeadCPU pos(ip);
-  pos++;
+  // Direct matched label pattern, can be substring of 'label'ed target, searching circularly from just after the IP
+  // - must match all NOPs in search_label
+  // - extra NOPs in 'label'ed target are ignored
+  int label_start = 0;
+  if (!findLabelSequence(ip.GetMemory(), search_label, true, ip.GetPosition(), true, label_start)) return ip;
   
-  while (pos.GetPosition() != ip.GetPosition()) {
-    if (m_inst_set->IsLabel(pos.GetInst())) { // starting label found
-      const int label_start = pos.GetPosition();
-      pos++;
-      
-      // Check for direct matched label pattern, can be substring of 'label'ed target
-      // - must match all NOPs in search_label
-      // - extra NOPs in 'label'ed target are ignored
-      int size_matched = 0;
-      while (size_matched < search_label.GetSize() && pos.GetPosition() != ip.GetPosition()) {
-        if (!m_inst_set->IsNop(pos.GetInst()) || search_label[size_matched] != m_inst_set->GetNopMod(pos.GetInst())) break;
-        size_matched++;
-        pos++;
-      }
-      
-      // Check that the label matches and has examined the full sequence of nops following the 'label' instruction
-      if (size_matched == search_label.GetSize()) {
-        pos--;
-        const int found_pos = pos.GetPosition();
-        
-        if (mark_executed) {
-          pos.Set(label_start);
-          const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
-          for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
-        }
-        
-        // Return Head pointed at last NOP of label sequence
-        return cHeadCPU(this, found_pos, ip.GetMemSpace());
-      }
-      
-      continue; 
-    }
-    pos++;
+  const int size_matched = search_label.GetSize();
+  cHeadCPU pos(this, (label_start + size_matched + 1) % ip.GetMemSize(), ip.GetMemSpace());
+  pos--;
+  const int found_pos = pos.GetPosition();
+  
+  if (mark_executed) {
+    pos.Set(label_start);
+    const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
+    for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
   }
   
-  // Return start point if not found
-  return ip;
+  // Return Head pointed at last NOP of label sequence
+  return cHeadCPU(this, found_pos, ip.GetMemSpace());
 }
 
 cHeadCPU cHardwareExperimental::FindLabelBackward(bool mark_executed)
@@ -1162,45 +1115,25 @@ cHeadCPU cHardwareExperimental::FindNopSequenceForward(bool mark_executed)
   // Make sure the label is of size > 0.
   if (search_label.GetSize() == 0) return ip;
   
-  cHeadCPU pos(ip);
-  pos++;
+  // Direct matched nop sequence, can be substring of target, searching circularly from just after the IP
+  // - must match all NOPs in search_label
+  // - extra NOPs in target are ignored
+  int seq_start = 0;
+  if (!findLabelSequence(ip.GetMemory(), search_label, false, ip.GetPosition(), true, seq_start)) return ip;
   
-  while (pos.GetPosition() != ip.GetPosition()) {
-    if (m_inst_set->IsNop(pos.GetInst())) { // starting label found
-      const int label_start = pos.GetPosition();
-      
-      // Check for direct matched nop sequence, can be substring of target
-      // - must match all NOPs in search_label
-      // - extra NOPs in target are ignored
-      int size_matched = 0;
-      while (size_matched < search_label.GetSize() && pos.GetPosition() != ip.GetPosition()) {
-        if (!m_inst_set->IsNop(pos.GetInst()) || search_label[size_matched] != m_inst_set->GetNopMod(pos.GetInst())) break;
-        size_matched++;
-        pos++;
-      }
-      
-      // Check that the label matches and has examined the full sequence of nops
-      if (size_matched == search_label.GetSize()) {
-        pos--;
-        const int found_pos = pos.GetPosition();
-        
-        if (mark_executed) {
-          pos.Set(label_start);
-          const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
-          for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
-        }
-        
-        // Return Head pointed at last NOP of label sequence
-        return cHeadCPU(this, found_pos, ip.GetMemSpace());
-      }
-    }
-    
-    if (pos.GetPosition() == ip.GetPosition()) break;
-    pos++;
+  const int size_matched = search_label.GetSize();
+  cHeadCPU pos(this, (seq_start + size_matched) % ip.GetMemSize(), ip.GetMemSpace());
+  pos--;
+  const int found_pos = pos.GetPosition();
+  
+  if (mark_executed) {
+    pos.Set(seq_start);
+    const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
+    for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
   }
   
-  // Return start point if not found
-  return ip;
+  // Return Head pointed at last NOP of label sequence
+  return cHeadCPU(this, found_pos, ip.GetMemSpace());
 }
 
 
@@ -1463,7 +1396,7 @@ bool cHardwareExperimental::Allocate_Random(cAvidaContext& ctx, const int old_si
   m_memory.Resize(new_size);
   
   for (int i = old_size; i < new_size; i++) {
-    m_memory[i] = m_inst_set->GetRandomInst(ctx);
+    m_memory.SetInst(i, m_inst_set->GetRandomInst(ctx));
   }
   return true;
 }
@@ -1555,9 +1488,7 @@ bool cHardwareExperimental::Divide_Main(cAvidaContext& ctx, const int div_point,
   // Since the divide will now succeed, set up the information to be sent
   // to the new organism
   InstructionSequencePtr offspring_seq(new InstructionSequence(m_memory.Crop(div_point, div_point + child_size)));
-  HashPropertyMap props;
-  cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
-  Genome offspring(GetType(), props, offspring_seq);
+  Genome offspring(GetType(), (const char*)m_inst_set->GetInstSetName(), m_inst_set->GetInstSetNameID(), offspring_seq);
 
   m_organism->OffspringGenome() = offspring;
   
@@ -2980,9 +2911,7 @@ bool cHardwareExperimental::Inst_Repro(cAvidaContext& ctx)
   // Since the divide will now succeed, set up the information to be sent
   // to the new organism
   InstructionSequencePtr offspring_seq(new InstructionSequence(m_memory));
-  HashPropertyMap props;
-  cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
-  Genome offspring(GetType(), props, offspring_seq);
+  Genome offspring(GetType(), (const char*)m_inst_set->GetInstSetName(), m_inst_set->GetInstSetNameID(), offspring_seq);
 
   m_organism->OffspringGenome() = offspring;  
   m_organism->GetPhenotype().SetLinesCopied(m_memory.GetSize());
@@ -326,7 +326,7 @@ void cHardwareGP8::setupGenes()
       
       while (!m_inst_set->IsTerminator(seghead.GetInst()) && seghead != gene_content_start) {
         if (gene.GetSize() <= gene_idx) gene.Resize(gene.GetSize() + 1);
-        gene[gene_idx] = seghead.GetInst();
+        gene.SetInst(gene_idx, seghead.GetInst());
         seghead.SetFlagExecuted();
         gene_idx++;
         seghead.Advance();
@@ -387,6 +387,17 @@ void cHardwareGP8::Thread::Reset(cHardwareGP8* in_hardware, const Head& start_po
 }
 
 
+int cHardwareGP8::GetMemoryFootprint() const
+{
+  int bytes = sizeof(cHardwareGP8) + baseHeapSize();
+  for (int i = 0; i < m_genes.GetSize(); i++) bytes += sizeof(Gene) + m_genes[i].memory.GetHeapSize();
+  for (int i = 0; i < m_mem_array.GetSize(); i++) bytes += sizeof(cCPUMemory*) + sizeof(cCPUMemory) + m_mem_array[i].GetHeapSize();
+  bytes += m_threads.GetSize() * (sizeof(Thread*) + sizeof(Thread));
+  bytes += m_sensor_sessions.GetSize() * sizeof(cOrgSensor::sLookInit);
+  bytes += m_hw_queue_eat_threads.GetSize() * sizeof(int);
+  return bytes;
+}
+
 bool cHardwareGP8::SingleProcess(cAvidaContext& ctx, bool speculative)
 {
   // If speculatively stalled, stay that way until a real instruction comes
@@ -456,8 +467,9 @@ bool cHardwareGP8::SingleProcess(cAvidaContext& ctx, bool speculative)
     
       // Find the instruction to be executed
       const Instruction cur_inst = ip.GetInst();
+      const cInstSet::sInstDispatch& cur_info = m_inst_set->GetDispatch(cur_inst);
       
-      if (speculative && (m_spec_die || m_inst_set->ShouldStall(cur_inst))) {
+      if (speculative && (m_spec_die || (cur_info.flags & nInstFlag::STALL))) {
         // Speculative instruction stall, flag it and halt the thread
         m_spec_stall = true;
         m_organism->SetRunning(false);
@@ -481,7 +493,7 @@ bool cHardwareGP8::SingleProcess(cAvidaContext& ctx, bool speculative)
       bool exec = true;
       int exec_success = 0;
 
-      unsigned int inst_hw_units = m_hw_units[m_inst_set->GetLibFunctionIndex(ip.GetInst())];
+      unsigned int inst_hw_units = m_hw_units[cur_info.lib_fun_id];
       
       // Check if this instruction needs hardware units that are busy
       if ((inst_hw_units & m_hw_busy)) {
@@ -505,11 +517,11 @@ bool cHardwareGP8::SingleProcess(cAvidaContext& ctx, bool speculative)
         // NOTE: This call based on the cur_inst must occur prior to instruction
         //       execution, because this instruction reference may be invalid after
         //       certain classes of instructions (namely divide instructions) @DMB
-        const int addl_time_cost = m_inst_set->GetAddlTimeCost(cur_inst);
+        const int addl_time_cost = cur_info.addl_time_cost;
         
         // Prob of exec (moved from SingleProcess_PayCosts so that we advance IP after a fail)
-        if ( m_inst_set->GetProbFail(cur_inst) > 0.0 ) {
-          exec = !( ctx.GetRandom().P(m_inst_set->GetProbFail(cur_inst)) );
+        if ( cur_info.prob_fail > 0.0 ) {
+          exec = !( ctx.GetRandom().P(cur_info.prob_fail) );
           rand_fail = !exec;
         }
         
@@ -844,42 +856,25 @@ void cHardwareGP8::FindLabelStart(Head& head, Head& default_pos, bool mark_execu
   }
   
   cCPUMemory& memory = head.GetMemory();
-  int pos = 0;
   
-  while (pos < memory.GetSize()) {
-    if (m_inst_set->IsLabel(memory[pos])) { // starting label found
-      pos++;
-      
-      // Check for direct matched label pattern, can be substring of 'label'ed target
-      // - must match all NOPs in search_label
-      // - extra NOPs in 'label'ed target are ignored
-      int size_matched = 0;
-      while (size_matched < search_label.GetSize() && pos < memory.GetSize()) {
-        if (!m_inst_set->IsNop(memory[pos]) || search_label[size_matched] != m_inst_set->GetNopMod(memory[pos])) break;
-        size_matched++;
-        pos++;
-      }
-      
-      // Check that the label matches and has examined the full sequence of nops following the 'label' instruction
-      if (size_matched == search_label.GetSize()) {
-        // Return Head pointed at last NOP of label sequence
-        if (mark_executed) {
-          size_matched++; // Increment size matched so that it includes the label instruction
-          const int start = pos - size_matched;
-          const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
-          for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(start + i);
-        }
-        head.SetPosition(pos - 1);
-        return;
-      }
-      
-      continue; 
-    }
-    pos++;
+  // Direct matched label pattern, can be substring of 'label'ed target
+  // - must match all NOPs in search_label
+  // - extra NOPs in 'label'ed target are ignored
+  int label_start = 0;
+  if (!findLabelSequence(memory, search_label, true, 0, false, label_start)) {
+    // Return start point if not found
+    head.Set(default_pos);
+    return;
   }
   
-  // Return start point if not found
-  head.Set(default_pos);
+  const int size_matched = search_label.GetSize() + 1; // includes the label instruction
+  if (mark_executed) {
+    const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
+    for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(label_start + i);
+  }
+  
+  // Return Head pointed at last NOP of label sequence
+  head.SetPosition(label_start + size_matched - 1);
 }
 
 void cHardwareGP8::FindNopSequenceStart(Head& head, Head& default_pos, bool mark_executed)
@@ -893,38 +888,25 @@ void cHardwareGP8::FindNopSequenceStart(Head& head, Head& default_pos, bool mark
   }
   
   cCPUMemory& memory = head.GetMemory();
-  int pos = 0;
   
-  while (pos < memory.GetSize()) {
-    if (m_inst_set->IsNop(memory[pos])) { // start of sequence found
-      
-      // Check for direct matched label pattern, can be substring of 'label'ed target
-      // - must match all NOPs in search_label
-      // - extra NOPs in 'label'ed target are ignored
-      int size_matched = 0;
-      while (size_matched < search_label.GetSize() && pos < memory.GetSize()) {
-        if (!m_inst_set->IsNop(memory[pos]) || search_label[size_matched] != m_inst_set->GetNopMod(memory[pos])) break;
-        size_matched++;
-        pos++;
-      }
-      
-      // Check that the label matches and has examined the full sequence of nops following the 'label' instruction
-      if (size_matched == search_label.GetSize()) {
-        // Return Head pointed at last NOP of label sequence
-        if (mark_executed) {
-          const int start = pos - size_matched;
-          const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
-          for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(start + i);
-        }
-        head.SetPosition(pos - 1);
-        return;
-      }
-    }
-    pos++;
+  // Direct matched label pattern, can be substring of 'label'ed target
+  // - must match all NOPs in search_label
+  // - extra NOPs in 'label'ed target are ignored
+  int seq_start = 0;
+  if (!findLabelSequence(memory, search_label, false, 0, false, seq_start)) {
+    // Return start point if not found
+    head.Set(default_pos);
+    return;
   }
   
-  // Return start point if not found
-  head.Set(default_pos);
+  const int size_matched = search_label.GetSize();
+  if (mark_executed) {
+    const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
+    for (int i = 0; i < size_matched && i < max; i++) memory.SetFlagExecuted(seq_start + i);
+  }
+  
+  // Return Head pointed at last NOP of label sequence
+  head.SetPosition(seq_start + size_matched - 1);
 }
 
 
@@ -940,47 +922,30 @@ void cHardwareGP8::FindLabelForward(Head& head, Head& default_pos, bool mark_exe
   
   head.Adjust();
   
+  // Direct matched label pattern, can be substring of 'label'ed target, searching circularly from just after head
+  // - must match all NOPs in search_label
+  // - extra NOPs in 'label'ed target are ignored
+  int label_start = 0;
+  if (!findLabelSequence(head.GetMemory(), search_label, true, head.Position(), true, label_start)) {
+    // Return start point if not found
+    head.Set(default_pos);
+    return;
+  }
+  
+  const int size_matched = search_label.GetSize();
   Head pos(head);
-  pos++;
+  pos.SetPosition((label_start + size_matched + 1) % head.GetMemory().GetSize());
+  pos--;
+  const int found_pos = pos.Position();
   
-  while (pos.Position() != head.Position()) {
-    if (m_inst_set->IsLabel(pos.GetInst())) { // starting label found
-      const int label_start = pos.Position();
-      pos++;
-      
-      // Check for direct matched label pattern, can be substring of 'label'ed target
-      // - must match all NOPs in search_label
-      // - extra NOPs in 'label'ed target are ignored
-      int size_matched = 0;
-      while (size_matched < search_label.GetSize() && pos.Position() != head.Position()) {
-        if (!m_inst_set->IsNop(pos.GetInst()) || search_label[size_matched] != m_inst_set->GetNopMod(pos.GetInst())) break;
-        size_matched++;
-        pos++;
-      }
-      
-      // Check that the label matches and has examined the full sequence of nops following the 'label' instruction
-      if (size_matched == search_label.GetSize()) {
-        pos--;
-        const int found_pos = pos.Position();
-        
-        if (mark_executed) {
-          pos.SetPosition(label_start);
-          const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
-          for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
-        }
-        
-        // Return Head pointed at last NOP of label sequence
-        head.SetPosition(found_pos);
-        return;
-      }
-      
-      continue; 
-    }
-    pos++;
+  if (mark_executed) {
+    pos.SetPosition(label_start);
+    const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get() + 1; // Max label + 1 for the label instruction itself
+    for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
   }
   
-  // Return start point if not found
-  head.Set(default_pos);
+  // Return Head pointed at last NOP of label sequence
+  head.SetPosition(found_pos);
 }
 
 void cHardwareGP8::FindLabelBackward(Head& head, Head& default_pos, bool mark_executed)
@@ -1051,46 +1016,30 @@ void cHardwareGP8::FindNopSequenceForward(Head& head, Head& default_pos, bool ma
   
   head.Adjust();
   
+  // Direct matched nop sequence, can be substring of target, searching circularly from just after head
+  // - must match all NOPs in search_label
+  // - extra NOPs in target are ignored
+  int seq_start = 0;
+  if (!findLabelSequence(head.GetMemory(), search_label, false, head.Position(), true, seq_start)) {
+    // Return start point if not found
+    head.Set(default_pos);
+    return;
+  }
+  
+  const int size_matched = search_label.GetSize();
   Head pos(head);
-  pos++;
+  pos.SetPosition((seq_start + size_matched) % head.GetMemory().GetSize());
+  pos--;
+  const int found_pos = pos.Position();
   
-  while (pos.Position() != head.Position()) {
-    if (m_inst_set->IsNop(pos.GetInst())) { // starting label found
-      const int label_start = pos.Position();
-      
-      // Check for direct matched nop sequence, can be substring of target
-      // - must match all NOPs in search_label
-      // - extra NOPs in target are ignored
-      int size_matched = 0;
-      while (size_matched < search_label.GetSize() && pos.Position() != head.Position()) {
-        if (!m_inst_set->IsNop(pos.GetInst()) || search_label[size_matched] != m_inst_set->GetNopMod(pos.GetInst())) break;
-        size_matched++;
-        pos++;
-      }
-      
-      // Check that the label matches and has examined the full sequence of nops
-      if (size_matched == search_label.GetSize()) {
-        pos--;
-        const int found_pos = pos.Position();
-        
-        if (mark_executed) {
-          pos.SetPosition(label_start);
-          const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
-          for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
-        }
-        
-        // Return Head pointed at last NOP of label sequence
-        head.SetPosition(found_pos);
-        return;
-      }
-    }
-    
-    if (pos.Position() == head.Position()) break;
-    pos++;
+  if (mark_executed) {
+    pos.SetPosition(seq_start);
+    const int max = m_world->GetConfig().MAX_LABEL_EXE_SIZE.Get();
+    for (int i = 0; i < size_matched && i < max; i++, pos++) pos.SetFlagExecuted();
   }
   
-  // Return start point if not found
-  head.Set(default_pos);
+  // Return Head pointed at last NOP of label sequence
+  head.SetPosition(found_pos);
 }
 
 
@@ -1337,9 +1286,7 @@ bool cHardwareGP8::Divide_Main(cAvidaContext& ctx, int mem_space_used, int write
   m_mem_array[mem_space_used].Resize(write_head_pos);
   
   InstructionSequencePtr offspring_seq(new InstructionSequence(m_mem_array[mem_space_used]));
-  HashPropertyMap props;
-  cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
-  Genome offspring(GetType(), props, offspring_seq);
+  Genome offspring(GetType(), (const char*)m_inst_set->GetInstSetName(), m_inst_set->GetInstSetNameID(), offspring_seq);
   
   m_organism->OffspringGenome() = offspring;
 	
@@ -2163,9 +2110,7 @@ bool cHardwareGP8::Inst_Repro(cAvidaContext& ctx)
   // Since the divide will now succeed, set up the information to be sent
   // to the new organism
   InstructionSequencePtr offspring_seq(new InstructionSequence(memory));
-  HashPropertyMap props;
-  cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
-  Genome offspring(GetType(), props, offspring_seq);
+  Genome offspring(GetType(), (const char*)m_inst_set->GetInstSetName(), m_inst_set->GetInstSetNameID(), offspring_seq);
 
   m_organism->OffspringGenome() = offspring;  
   m_organism->GetPhenotype().SetLinesCopied(memory.GetSize());
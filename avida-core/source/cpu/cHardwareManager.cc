@@ -40,13 +40,11 @@
 
 using namespace Avida;
 
-static const Apto::BasicString<Apto::ThreadSafe> s_prop_id_instset("instset");
-
 cHardwareManager::cHardwareManager(cWorld* world)
 : m_world(world)
 {
   cString filename = world->GetConfig().INST_SET.Get();
-  m_is_name_map.Set("(default)", 0);
+  mapInstSetName("(default)", 0);
 
 }
 
@@ -150,7 +148,8 @@ bool cHardwareManager::loadInstSet(int hw_type, const Apto::String& name, int st
   
   int inst_set_id = m_inst_sets.GetSize();
   m_inst_sets.Push(inst_set);
-  m_is_name_map.Set(name, inst_set_id);
+  mapInstSetName(name, inst_set_id);
+  inst_set->SetInstSetNameID(InstSetNameID((const char*)inst_set->GetInstSetName()));
   
   Apto::Array<cString> names(inst_set->GetSize());
   for (int i = 0; i < inst_set->GetSize(); i++) names[i] = inst_set->GetName(i);
@@ -241,9 +240,7 @@ cHardwareBase* cHardwareManager::Create(cAvidaContext& ctx, cOrganism* org, cons
 {
   assert(org != NULL);
 	
-  Apto::String inst_set_name = mg.Properties().Get(s_prop_id_instset).StringValue();
-  assert(inst_set_name.GetSize());
-  int inst_set_id = m_is_name_map.GetWithDefault(inst_set_name, -1);
+  int inst_set_id = GetInstSetIndex(mg);
   if (inst_set_id == -1) {
     assert(false);
     return NULL; // No valid instruction set found
@@ -288,7 +285,22 @@ bool cHardwareManager::RegisterInstSet(const Apto::String& name, cInstSet* inst_
   
   int inst_set_id = m_inst_sets.GetSize();
   m_inst_sets.Push(inst_set);
-  m_is_name_map.Set(name, inst_set_id);  
+  mapInstSetName(name, inst_set_id);
+  inst_set->SetInstSetNameID(InstSetNameID((const char*)inst_set->GetInstSetName()));
   
   return true;
 }
+
+
+void cHardwareManager::mapInstSetName(const Apto::String& name, int inst_set_id)
+{
+  m_is_name_map.Set(name, inst_set_id);
+  
+  const int name_id = InstSetNameID(name);
+  if (name_id >= m_is_name_id_map.GetSize()) {
+    const int old_size = m_is_name_id_map.GetSize();
+    m_is_name_id_map.Resize(name_id + 1);
+    for (int i = old_size; i < name_id; i++) m_is_name_id_map[i] = -1;
+  }
+  m_is_name_id_map[name_id] = inst_set_id;
+}
@@ -22,11 +22,9 @@
 #ifndef cHardwareManager_h
 #define cHardwareManager_h
 
-#include "cTestCPU.h"
+#include "avida/core/Genome.h"
 
-namespace Avida {
-  class Genome;
-};
+#include "cTestCPU.h"
 
 class cAvidaContext;
 class cHardwareBase;
@@ -46,6 +44,7 @@ private:
   cWorld* m_world;
   Apto::Array<cInstSet*> m_inst_sets;
   Apto::Map<Apto::String, int> m_is_name_map;
+  Apto::Array<int> m_is_name_id_map;  // Inst set index by interned name ID, -1 where the name is not registered
 
   
   cHardwareManager(); // @not_implemented
@@ -59,6 +58,7 @@ public:
   
   static void Initialize();
   static void SetupPropertyMap(PropertyMap& props, const Apto::String& inst_set);
+  static int InstSetNameID(const Apto::String& name);  // Process-wide interned ID of an inst set name
   
   
   bool LoadInstSets(cUserFeedback* feedback = NULL);
@@ -73,6 +73,11 @@ public:
   inline cInstSet& GetInstSet(const Apto::String& name);
   const cInstSet& GetInstSet(int i) const { return *m_inst_sets[i]; }
   
+  // Lookups by the genome's interned inst set name ID, without any string hashing or comparison
+  inline int GetInstSetIndex(const Genome& genome) const;
+  inline const cInstSet& GetInstSet(const Genome& genome) const { return *m_inst_sets[GetInstSetIndex(genome)]; }
+  inline cInstSet& GetInstSet(const Genome& genome) { return *m_inst_sets[GetInstSetIndex(genome)]; }
+  
   const cInstSet& GetDefaultInstSet() const { return *m_inst_sets[0]; }
   
   int GetNumInstSets() const { return m_inst_sets.GetSize(); }
@@ -80,6 +85,7 @@ public:
   bool RegisterInstSet(const Apto::String& name, cInstSet* inst_set);
     
 private:
+  void mapInstSetName(const Apto::String& name, int inst_set_id);
   bool loadInstSet(int hw_type, const Apto::String& name, int stack_size, int uops_per_cycle, cStringList& sl, cUserFeedback* feedback);
 };
 
@@ -94,4 +100,10 @@ inline cInstSet& cHardwareManager::GetInstSet(const Apto::String& name)
   return (name == "(default)") ? *m_inst_sets[0] : *m_inst_sets[m_is_name_map.GetWithDefault(name, -1)];
 }
 
+inline int cHardwareManager::GetInstSetIndex(const Genome& genome) const
+{
+  const int name_id = genome.InstSetID();
+  return (name_id >= 0 && name_id < m_is_name_id_map.GetSize()) ? m_is_name_id_map[name_id] : -1;
+}
+
 #endif
@@ -200,6 +200,15 @@ Systematics::UnitPtr cHardwareTransSMT::ThreadGetOwner()
 }
 
 
+int cHardwareTransSMT::GetMemoryFootprint() const
+{
+  int bytes = sizeof(cHardwareTransSMT) + baseHeapSize();
+  for (int i = 0; i < m_mem_array.GetSize(); i++) bytes += sizeof(cCPUMemory*) + sizeof(cCPUMemory) + m_mem_array[i].GetHeapSize();
+  bytes += m_threads.GetSize() * (sizeof(cLocalThread*) + sizeof(cLocalThread));
+  return bytes;
+}
+
+
 // This function processes the very next command in the genome, and is made
 // to be as optimized as possible.  This is the heart of avida.
 bool cHardwareTransSMT::SingleProcess(cAvidaContext& ctx, bool speculative)
@@ -271,6 +280,7 @@ bool cHardwareTransSMT::SingleProcess(cAvidaContext& ctx, bool speculative)
     
     // Find the instruction to be executed
     const Instruction cur_inst = IP().GetInst();
+    const cInstSet::sInstDispatch& cur_info = m_inst_set->GetDispatch(cur_inst);
 		
     // Test if costs have been paid and it is okay to execute this now...
     bool exec = SingleProcess_PayPreCosts(ctx, cur_inst, m_cur_thread);
@@ -278,8 +288,8 @@ bool cHardwareTransSMT::SingleProcess(cAvidaContext& ctx, bool speculative)
     // Now execute the instruction...
     if (exec == true) {
       // Prob of exec (moved from SingleProcess_PayCosts so that we advance IP after a fail)
-      if ( m_inst_set->GetProbFail(cur_inst) > 0.0 ) {
-        exec = !( ctx.GetRandom().P(m_inst_set->GetProbFail(cur_inst)) );
+      if ( cur_info.prob_fail > 0.0 ) {
+        exec = !( ctx.GetRandom().P(cur_info.prob_fail) );
       }
       
       if (exec == true) if (SingleProcess_ExecuteInst(ctx, cur_inst)) { 
@@ -1057,7 +1067,7 @@ void cHardwareTransSMT::Inject_DoMutations(cAvidaContext& ctx, double mut_multip
   if( num_mut > 0 ){
     for (int i = 0; i < num_mut; i++) {
       int site = ctx.GetRandom().GetUInt(injected_code.GetSize());
-      injected_code[site] = m_inst_set->GetRandomInst(ctx);
+      injected_code.SetInst(site, m_inst_set->GetRandomInst(ctx));
     }
   }
 	
@@ -1106,7 +1116,7 @@ void cHardwareTransSMT::Inject_DoMutations(cAvidaContext& ctx, double mut_multip
     if (num_mut > 0) {
       for (int i = 0; i < num_mut; i++) {
         int site = ctx.GetRandom().GetUInt(memory.GetSize());
-        memory[site] = m_inst_set->GetRandomInst(ctx);
+        memory.SetInst(site, m_inst_set->GetRandomInst(ctx));
       }
     }
   }
@@ -1173,9 +1183,7 @@ bool cHardwareTransSMT::Divide_Main(cAvidaContext& ctx, double mut_multiplier)
   m_mem_array[mem_space_used].Resize(write_head_pos);
 	
   InstructionSequencePtr offspring_seq(new InstructionSequence(m_mem_array[mem_space_used]));
-  HashPropertyMap props;
-  cHardwareManager::SetupPropertyMap(props, (const char*)m_inst_set->GetInstSetName());
-  Genome offspring(GetType(), props, offspring_seq);
+  Genome offspring(GetType(), (const char*)m_inst_set->GetInstSetName(), m_inst_set->GetInstSetNameID(), offspring_seq);
 
   m_organism->OffspringGenome() = offspring;
 	
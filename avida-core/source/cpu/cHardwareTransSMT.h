@@ -190,6 +190,7 @@ public:
   // --------  Helper methods  --------
   int GetType() const { return HARDWARE_TYPE_CPU_TRANSSMT; }
   bool SupportsSpeculative() const { return false; }
+  int GetMemoryFootprint() const;
   void PrintStatus(std::ostream& fp);
   void SetupMiniTraceFileHeader(Avida::Output::File& df, const int gen_id, const Apto::String& genotype) { }
   void PrintMiniTraceStatus(cAvidaContext& ctx, std::ostream& fp) { (void)ctx; (void)fp; }
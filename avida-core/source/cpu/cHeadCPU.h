@@ -61,6 +61,7 @@ public:
   
   inline void Adjust() { if (m_mem_space != m_cached_ms || m_position < 0 || m_position >= GetMemSize()) fullAdjust(); }
   inline void Reset(cHardwareBase* hw, int ms = 0) { m_hardware = hw; m_position = 0; m_mem_space = ms; if (hw) Adjust(); }
+  inline void Rebind(cHardwareBase* hw);
   
   inline int GetMemSpace() const { return m_mem_space; }
   inline int GetPosition() const { return m_position; }
@@ -78,12 +79,13 @@ public:
   inline void Advance() { m_position++; Adjust(); }
   inline void Retreat() { m_position--; Adjust(); }
 
-  inline const Instruction& GetInst() const { return GetMemory()[m_position]; }
-  inline const Instruction& GetInst(int offset) const { return GetMemory()[m_position + offset]; }
+  inline const Instruction& GetInst() const { m_memory->TouchSite(m_position); return GetMemory()[m_position]; }
+  inline const Instruction& GetInst(int offset) const
+    { m_memory->TouchSite(m_position + offset); return GetMemory()[m_position + offset]; }
   inline Instruction GetPrevInst() const;
   inline Instruction GetNextInst() const;
 
-  inline void SetInst(const Instruction& value) { GetMemory()[m_position] = value; }
+  inline void SetInst(const Instruction& value) { m_memory->TouchSite(m_position); m_memory->SetInst(m_position, value); }
   inline void InsertInst(const Instruction& inst) { GetMemory().Insert(m_position, inst); }
   inline void RemoveInst() { GetMemory().Remove(m_position); }
 
@@ -145,6 +147,13 @@ inline void cHeadCPU::LoopJump(int jump)
   if (m_position <= 0) m_position += GetMemory().GetSize();
 }
 
+// Point this head at the equivalent memory space of another hardware instance, leaving the position untouched.
+inline void cHeadCPU::Rebind(cHardwareBase* hw)
+{
+  m_hardware = hw;
+  if (m_cached_ms >= 0) m_memory = &m_hardware->GetMemory(m_cached_ms);
+}
+
 inline cHeadCPU& cHeadCPU::operator=(const cHeadCPU& in_cpu_head)
 {
   m_hardware = in_cpu_head.m_hardware;
@@ -161,12 +170,16 @@ inline bool cHeadCPU::operator==(const cHeadCPU& in_cpu_head) const
 
 inline Instruction cHeadCPU::GetPrevInst() const
 {
-  return (AtFront()) ? GetMemory()[GetMemory().GetSize() - 1] : GetMemory()[m_position - 1];
+  const int pos = (AtFront()) ? GetMemory().GetSize() - 1 : m_position - 1;
+  m_memory->TouchSite(pos);
+  return GetMemory()[pos];
 }
 
 inline Instruction cHeadCPU::GetNextInst() const
 {
-  return (AtEnd()) ? m_hardware->GetInstSet().GetInstError() : GetMemory()[m_position + 1];
+  if (AtEnd()) return m_hardware->GetInstSet().GetInstError();
+  m_memory->TouchSite(m_position + 1);
+  return GetMemory()[m_position + 1];
 }
 
 #endif
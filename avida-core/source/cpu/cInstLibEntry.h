@@ -32,6 +32,7 @@ namespace nInstFlag {
   const unsigned int PROMOTER = 0x20;
   const unsigned int TERMINATOR = 0x40;
   const unsigned int IMMEDIATE_VALUE = 0x80;
+  const unsigned int ISOLATED = 0x100;  // Touches nothing outside the executing organism, safe for concurrent demes
 }
 
 enum InstructionClass {
@@ -86,6 +87,7 @@ public:
   inline bool ShouldStall() const { return (m_flags & nInstFlag::STALL) != 0; }
   inline bool ShouldSleep() const { return (m_flags & nInstFlag::SLEEP) != 0; }
   inline bool IsImmediateValue() const { return (m_flags & nInstFlag::IMMEDIATE_VALUE) != 0; }
+  inline bool IsIsolated() const { return (m_flags & nInstFlag::ISOLATED) != 0; }
 };
 
 #endif
@@ -40,6 +40,7 @@ using namespace Avida;
 cInstSet::cInstSet(const cInstSet& _in)
   : m_world(_in.m_world)
   , m_name(_in.m_name)
+  , m_name_id(_in.m_name_id)
   , m_hw_type(_in.m_hw_type)
   , m_inst_lib(_in.m_inst_lib)
   , m_lib_name_map(_in.m_lib_name_map)
@@ -55,12 +56,14 @@ cInstSet::cInstSet(const cInstSet& _in)
   , m_has_bonus_costs(_in.m_has_bonus_costs)
 {
   m_mutation_index = new cOrderedWeightedIndex(*_in.m_mutation_index);
+  compileDispatch();
 }
 
 cInstSet& cInstSet::operator=(const cInstSet& _in)
 {
   m_world = _in.m_world;
   m_name = _in.m_name;
+  m_name_id = _in.m_name_id;
   m_hw_type = _in.m_hw_type;
   m_inst_lib = _in.m_inst_lib;
   m_lib_name_map = _in.m_lib_name_map;
@@ -76,6 +79,7 @@ cInstSet& cInstSet::operator=(const cInstSet& _in)
   m_has_bonus_costs = _in.m_has_bonus_costs;
 
   m_mutation_index = new cOrderedWeightedIndex(*_in.m_mutation_index);
+  compileDispatch();
   return *this;
 }
 
@@ -116,10 +120,25 @@ Instruction cInstSet::ActivateNullInst()
   m_lib_name_map[inst_id].post_cost = 0;
   m_lib_name_map[inst_id].bonus_cost = 0.0;
   
+  compileDispatch();
+  
   return Instruction(inst_id);
 }
 
 
+void cInstSet::compileDispatch()
+{
+  m_dispatch.Resize(m_lib_name_map.GetSize());
+  for (int i = 0; i < m_lib_name_map.GetSize(); i++) {
+    const sInstEntry& entry = m_lib_name_map[i];
+    m_dispatch[i].lib_fun_id = entry.lib_fun_id;
+    m_dispatch[i].flags = m_inst_lib->Get(entry.lib_fun_id).GetFlags();
+    m_dispatch[i].addl_time_cost = entry.addl_time_cost;
+    m_dispatch[i].prob_fail = entry.prob_fail;
+  }
+}
+
+
 cString cInstSet::FindBestMatch(const cString& in_name) const
 {
   int best_dist = 1024;
@@ -309,6 +328,8 @@ bool cInstSet::LoadWithStringList(const cStringList& sl, cUserFeedback* feedback
      }
      m_mutation_index->SetWeight(id, m_lib_name_map[id].redundancy);
   }
+  
+  compileDispatch();
   return success;
 }
 
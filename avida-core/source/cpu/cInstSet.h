@@ -54,6 +54,7 @@ class cInstSet
 public:
   cWorld* m_world;
   cString m_name;
+  int m_name_id;
   int m_hw_type;
   cInstLib* m_inst_lib;
   
@@ -75,6 +76,16 @@ public:
   };
   Apto::Array<sInstEntry, Apto::Smart> m_lib_name_map;
   
+  // Compact per-opcode record of everything the hardware execution loops consult for each instruction, compiled from
+  // m_lib_name_map and the instruction library so that the hot path needs a single indexed load per query.
+  struct sInstDispatch {
+    int lib_fun_id;
+    unsigned int flags;       // cInstLibEntry flags (nInstFlag)
+    int addl_time_cost;
+    double prob_fail;
+  };
+  Apto::Array<sInstDispatch> m_dispatch;
+  
   Apto::Array<int> m_lib_nopmod_map;
   
   cOrderedWeightedIndex* m_mutation_index;     // Weighted index for instructions 
@@ -93,10 +104,12 @@ public:
   int m_uops_per_cycle;
   
   cInstSet(); // @not_implemented
+  
+  void compileDispatch();
 
 public:
   inline cInstSet(cWorld* world, const cString& name, int hw_type, cInstLib* inst_lib, int stack_size, int uops_per_cycle)
-    : m_world(world), m_name(name), m_hw_type(hw_type), m_inst_lib(inst_lib), m_mutation_index(NULL)
+    : m_world(world), m_name(name), m_name_id(-1), m_hw_type(hw_type), m_inst_lib(inst_lib), m_mutation_index(NULL)
     , m_has_costs(false), m_has_ft_costs(false), m_has_energy_costs(false), m_has_res_costs(false), m_has_fem_res_costs(false)
     , m_has_female_costs(false), m_has_choosy_female_costs(false), m_has_post_costs(false), m_has_bonus_costs(false), m_stack_size(stack_size)
     , m_uops_per_cycle(uops_per_cycle) { ; }
@@ -105,6 +118,8 @@ public:
   inline ~cInstSet() { if (m_mutation_index != NULL) delete m_mutation_index; }
   
   const cString& GetInstSetName() const { return m_name; }
+  int GetInstSetNameID() const { return m_name_id; }  // Interned name ID (see cHardwareManager::InstSetNameID), -1 if unregistered
+  void SetInstSetNameID(int name_id) { m_name_id = name_id; }
   int GetHardwareType() const { return m_hw_type; }
 
   // Accessors
@@ -115,8 +130,8 @@ public:
   int GetCost(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].cost; }
   int GetFTCost(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].ft_cost; }
   int GetEnergyCost(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].energy_cost; }
-  double GetProbFail(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].prob_fail; }
-  int GetAddlTimeCost(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].addl_time_cost; }
+  double GetProbFail(const Instruction& inst) const { return m_dispatch[inst.GetOp()].prob_fail; }
+  int GetAddlTimeCost(const Instruction& inst) const { return m_dispatch[inst.GetOp()].addl_time_cost; }
   int GetInstructionCode(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].inst_code; }
   double GetResCost(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].res_cost; }
   double GetFemResCost(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].fem_res_cost; }
@@ -125,7 +140,8 @@ public:
   int GetPostCost(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].post_cost; }
   double GetBonusCost(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].bonus_cost; }
   
-  int GetLibFunctionIndex(const Instruction& inst) const { return m_lib_name_map[inst.GetOp()].lib_fun_id; }
+  int GetLibFunctionIndex(const Instruction& inst) const { return m_dispatch[inst.GetOp()].lib_fun_id; }
+  const sInstDispatch& GetDispatch(const Instruction& inst) const { return m_dispatch[inst.GetOp()]; }
 
   int GetNopMod(const Instruction& inst) const
   {
@@ -154,21 +170,24 @@ public:
   
   // Instruction Analysis.
   int IsNop(const Instruction& inst) const { return (inst.GetOp() < m_lib_nopmod_map.GetSize()); }
-  bool IsLabel(const Instruction& inst) const { return m_inst_lib->Get(GetLibFunctionIndex(inst)).IsLabel(); }
-  bool IsPromoter(const Instruction& inst) const { return m_inst_lib->Get(GetLibFunctionIndex(inst)).IsPromoter(); }
-  bool IsTerminator(const Instruction& inst) const { return m_inst_lib->Get(GetLibFunctionIndex(inst)).IsTerminator(); }
-  bool ShouldStall(const Instruction& inst) const { return m_inst_lib->Get(GetLibFunctionIndex(inst)).ShouldStall(); }
-  bool ShouldSleep(const Instruction& inst) const { return m_inst_lib->Get(GetLibFunctionIndex(inst)).ShouldSleep(); }
-  bool IsImmediateValue(const Instruction& inst) const { return (inst != GetInstError() && m_inst_lib->Get(GetLibFunctionIndex(inst)).IsImmediateValue()); }
+  bool IsLabel(const Instruction& inst) const { return (GetFlags(inst) & nInstFlag::LABEL) != 0; }
+  bool IsPromoter(const Instruction& inst) const { return (GetFlags(inst) & nInstFlag::PROMOTER) != 0; }
+  bool IsTerminator(const Instruction& inst) const { return (GetFlags(inst) & nInstFlag::TERMINATOR) != 0; }
+  bool ShouldStall(const Instruction& inst) const { return (GetFlags(inst) & nInstFlag::STALL) != 0; }
+  bool ShouldSleep(const Instruction& inst) const { return (GetFlags(inst) & nInstFlag::SLEEP) != 0; }
+  bool IsIsolated(const Instruction& inst) const { return (GetFlags(inst) & nInstFlag::ISOLATED) != 0; }
+  bool IsImmediateValue(const Instruction& inst) const
+    { return (inst != GetInstError() && (GetFlags(inst) & nInstFlag::IMMEDIATE_VALUE) != 0); }
   
-  unsigned int GetFlags(const Instruction& inst) const { return m_inst_lib->Get(GetLibFunctionIndex(inst)).GetFlags(); }
+  unsigned int GetFlags(const Instruction& inst) const { return m_dispatch[inst.GetOp()].flags; }
   
 
   // Insertion of new instructions...
   Instruction ActivateNullInst();
   
   // Modification of instructions during run.
-  void SetProbFail(const Instruction& inst, double _prob_fail) { m_lib_name_map[inst.GetOp()].prob_fail = _prob_fail; }
+  void SetProbFail(const Instruction& inst, double _prob_fail)
+    { m_lib_name_map[inst.GetOp()].prob_fail = _prob_fail; m_dispatch[inst.GetOp()].prob_fail = _prob_fail; }
   void SetRedundancy(const Instruction& inst, int _redundancy) { m_lib_name_map[inst.GetOp()].redundancy = _redundancy; m_mutation_index->SetWeight(inst.GetOp(), _redundancy);}
 
   // accessors for instruction library
@@ -48,9 +48,43 @@ using namespace std;
 using namespace AvidaTools;
 
 
+// Upper bound on the number of checkpoints a single trace will hold
+static const int MAX_TRACE_SNAPSHOTS = 64;
+
+struct cTestCPUTrace::sSnapshot
+{
+  int time_used;
+  int cur_input;
+  int cur_receive;
+  cHardwareCheckpoint* hardware;
+  cOrganism::sCheckpoint organism;
+  
+  sSnapshot() : time_used(0), cur_input(0), cur_receive(0), hardware(NULL) { ; }
+  ~sSnapshot() { delete hardware; }
+};
+
+void cTestCPUTrace::clear()
+{
+  for (int i = 0; i < m_snapshots.GetSize(); i++) delete m_snapshots[i];
+  m_snapshots.Resize(0);
+  m_safe_snapshot.Resize(0);
+  m_recording = false;
+  m_valid = false;
+}
+
+void cTestCPUInputFork::clear()
+{
+  delete m_snapshot;
+  m_snapshot = NULL;
+  m_recording = false;
+}
+
+
 cTestCPU::cTestCPU(cAvidaContext& ctx, cWorld* world)
 {
   m_world = world;
+  m_input_observed = false;
+  m_draw_counter = NULL;
 	m_use_manual_inputs = false;
   m_test_solo_res = -1;
   m_test_solo_res_lev = 0;
@@ -140,8 +174,10 @@ void cTestCPU::ModifyResources(cAvidaContext& ctx, const Apto::Array<double>& re
 }
 
 
-// NOTE: This method assumes that the organism is a fresh creation.
-bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth)
+// NOTE: This method assumes that the organism is a fresh creation, or has just been restored from the resume snapshot.
+bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth,
+                                cTestCPUTrace* trace, const cTestCPUTrace::sSnapshot* resume,
+                                cTestCPUInputFork* fork)
 {
   assert(test_info.org_array[cur_depth] != NULL);
 
@@ -156,6 +192,7 @@ bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int
   // Prepare the inputs...
   cur_input = 0;
   cur_receive = 0;
+  m_input_observed = false;
 
   // Prepare the resources
   InitResources(ctx, test_info.m_res_method, test_info.m_res, test_info.m_res_update, test_info.m_res_cpu_cycle_offset);
@@ -164,6 +201,24 @@ bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int
   // This way of keeping track of time is only used to update resources...
   int time_used = m_res_cpu_cycle_offset; // Note: the offset is zero by default if no resources being used @JEB
   
+  // Pick up where the snapshot left off (resources are static whenever a snapshot is in use)
+  if (resume) {
+    time_used = resume->time_used;
+    cur_input = resume->cur_input;
+    cur_receive = resume->cur_receive;
+  }
+  
+  // Recording needs to know whether execution drew any random numbers, so the gestation runs through a counter
+  Apto::Random& rng = ctx.GetRandom();
+  cTestCPUDrawCounter draw_counter(rng);
+  if (trace || fork) {
+    ctx.SetRandom(draw_counter);
+    m_draw_counter = &draw_counter;
+  }
+  
+  if (trace) TraceBegin(test_info, organism, *trace);
+  if (fork) ForkBegin(test_info, organism, *fork);
+  
   organism.GetHardware().SetTrace(test_info.GetTracer());
   while (time_used < time_allocated && organism.GetPhenotype().GetNumDivides() == 0 && !organism.IsDead())
   {
@@ -175,6 +230,20 @@ bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int
     UpdateResources(ctx, time_used);
     
     organism.GetHardware().SingleProcess(ctx);
+    
+    if (trace && trace->m_recording && (time_used % trace->m_interval) == 0 &&
+        organism.GetPhenotype().GetNumDivides() == 0 && !organism.IsDead()) {
+      TraceSnapshot(organism, *trace, time_used);
+    }
+    if (fork && fork->m_recording) ForkSnapshot(organism, *fork, time_used);
+  }
+  
+  if (trace) TraceEnd(organism, *trace);
+  if (fork) fork->m_recording = false;
+  
+  if (trace || fork) {
+    ctx.SetRandom(rng);
+    m_draw_counter = NULL;
   }
   
   organism.GetHardware().SetTrace(HardwareTracerPtr(NULL));
@@ -187,6 +256,147 @@ bool cTestCPU::ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int
 }
 
 
+void cTestCPU::TraceBegin(cCPUTestInfo& test_info, cOrganism& organism, cTestCPUTrace& trace)
+{
+  trace.clear();
+  
+  trace.m_res_method = test_info.m_res_method;
+  trace.m_res = test_info.m_res;
+  trace.m_res_update = test_info.m_res_update;
+  trace.m_res_cpu_cycle_offset = test_info.m_res_cpu_cycle_offset;
+  trace.m_test_solo_res = m_test_solo_res;
+  trace.m_test_solo_res_lev = m_test_solo_res_lev;
+  
+  // Checkpoints do not capture random inputs, depletable resources, or anything a hardware tracer may observe
+  if (test_info.GetTracer() || test_info.GetUseRandomInputs() || test_info.GetUseManualInputs() ||
+      test_info.m_res_method >= RES_UPDATED_DEPLETABLE) {
+    return;
+  }
+  
+  const int genome_size = organism.GetHardware().GetMemory().GetSize();
+  trace.m_safe_snapshot.Resize(genome_size);
+  trace.m_safe_snapshot.SetAll(-2);
+  trace.m_draws = m_draw_counter->GetDraws();
+  trace.m_interval = Apto::Max(1, genome_size / 2);
+  trace.m_recording = true;
+  trace.m_valid = true;
+  
+  organism.GetHardware().GetMemory().StartTouchTracking();
+}
+
+void cTestCPU::TraceSnapshot(cOrganism& organism, cTestCPUTrace& trace, int time_used)
+{
+  cCPUMemory& memory = organism.GetHardware().GetMemory();
+  const int last = trace.m_snapshots.GetSize() - 1;
+  
+  // Every site observed since the previous snapshot can only be resumed from that snapshot (or earlier).  Once a random
+  // number has been drawn no later snapshot is usable, since resuming from it would skip the draw.
+  const bool drew = (m_draw_counter->GetDraws() != trace.m_draws);
+  bool all_observed = drew || memory.TouchedAll() || memory.GetSize() < trace.m_safe_snapshot.GetSize();
+  for (int i = 0; i < trace.m_safe_snapshot.GetSize(); i++) {
+    if (trace.m_safe_snapshot[i] == -2 && (all_observed || memory.FlagTouched(i))) trace.m_safe_snapshot[i] = last;
+  }
+  if (all_observed) {
+    trace.m_recording = false;
+    return;
+  }
+  
+  cTestCPUTrace::sSnapshot* snapshot = new cTestCPUTrace::sSnapshot;
+  snapshot->time_used = time_used;
+  snapshot->cur_input = cur_input;
+  snapshot->cur_receive = cur_receive;
+  snapshot->hardware = organism.GetHardware().SaveCheckpoint();
+  if (!snapshot->hardware || !organism.SaveCheckpoint(snapshot->organism)) {
+    delete snapshot;
+    trace.m_recording = false;
+    return;
+  }
+  trace.m_snapshots.Push(snapshot);
+  
+  if (trace.m_snapshots.GetSize() >= MAX_TRACE_SNAPSHOTS) trace.m_recording = false;
+}
+
+void cTestCPU::TraceEnd(cOrganism& organism, cTestCPUTrace& trace)
+{
+  if (!trace.m_valid) return;
+  
+  // Sites not observed before recording stopped are safe to resume from the final snapshot
+  const int last = trace.m_snapshots.GetSize() - 1;
+  for (int i = 0; i < trace.m_safe_snapshot.GetSize(); i++) {
+    if (trace.m_safe_snapshot[i] == -2) trace.m_safe_snapshot[i] = last;
+  }
+  trace.m_recording = false;
+  
+  organism.GetHardware().GetMemory().StopTouchTracking();
+}
+
+bool cTestCPU::TraceMatches(cCPUTestInfo& test_info, const cTestCPUTrace& trace) const
+{
+  return trace.IsValid() && !test_info.GetTracer() && !test_info.GetUseRandomInputs() && !test_info.GetUseManualInputs() &&
+    trace.m_res_method == test_info.m_res_method && trace.m_res == test_info.m_res &&
+    trace.m_res_update == test_info.m_res_update && trace.m_res_cpu_cycle_offset == test_info.m_res_cpu_cycle_offset &&
+    trace.m_test_solo_res == m_test_solo_res && trace.m_test_solo_res_lev == m_test_solo_res_lev;
+}
+
+
+void cTestCPU::ForkBegin(cCPUTestInfo& test_info, cOrganism& organism, cTestCPUInputFork& fork)
+{
+  fork.clear();
+  
+  fork.m_genome_size = organism.GetHardware().GetMemory().GetSize();
+  fork.m_res_method = test_info.m_res_method;
+  fork.m_res = test_info.m_res;
+  fork.m_res_update = test_info.m_res_update;
+  fork.m_res_cpu_cycle_offset = test_info.m_res_cpu_cycle_offset;
+  fork.m_test_solo_res = m_test_solo_res;
+  fork.m_test_solo_res_lev = m_test_solo_res_lev;
+  
+  // Depletable resources depend on the organism's own consumption, and a hardware tracer must see every cycle
+  if (test_info.GetTracer() || test_info.m_res_method >= RES_UPDATED_DEPLETABLE) return;
+  
+  fork.m_draws = m_draw_counter->GetDraws();
+  fork.m_interval = Apto::Max(1, fork.m_genome_size / 2);
+  fork.m_recording = true;
+}
+
+void cTestCPU::ForkSnapshot(cOrganism& organism, cTestCPUInputFork& fork, int time_used)
+{
+  // The last checkpoint taken before the first input was read or random number drawn is the fork point.  Resuming past
+  // a draw would hand every later trial the first trial's random values and shift their own random sequence.
+  if (m_input_observed || m_draw_counter->GetDraws() != fork.m_draws ||
+      organism.GetPhenotype().GetNumDivides() != 0 || organism.IsDead()) {
+    fork.m_recording = false;
+    return;
+  }
+  if ((time_used % fork.m_interval) != 0) return;
+  
+  cTestCPUTrace::sSnapshot* snapshot = new cTestCPUTrace::sSnapshot;
+  snapshot->time_used = time_used;
+  snapshot->cur_input = cur_input;
+  snapshot->cur_receive = cur_receive;
+  snapshot->hardware = organism.GetHardware().SaveCheckpoint();
+  if (!snapshot->hardware || !organism.SaveCheckpoint(snapshot->organism)) {
+    delete snapshot;
+    fork.m_recording = false;
+    return;
+  }
+  
+  delete fork.m_snapshot;
+  fork.m_snapshot = snapshot;
+}
+
+bool cTestCPU::ForkMatches(cCPUTestInfo& test_info, const Genome& genome, const cTestCPUInputFork& fork) const
+{
+  ConstInstructionSequencePtr seq_p;
+  seq_p.DynamicCastFrom(genome.Representation());
+  
+  return fork.IsValid() && !test_info.GetTracer() && seq_p->GetSize() == fork.m_genome_size &&
+    fork.m_res_method == test_info.m_res_method && fork.m_res == test_info.m_res &&
+    fork.m_res_update == test_info.m_res_update && fork.m_res_cpu_cycle_offset == test_info.m_res_cpu_cycle_offset &&
+    fork.m_test_solo_res == m_test_solo_res && fork.m_test_solo_res_lev == m_test_solo_res_lev;
+}
+
+
 bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome)
 {
   ctx.SetTestMode();
@@ -230,7 +440,84 @@ bool cTestCPU::TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Gen
   return test_info.is_viable;
 }
 
-bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth)
+bool cTestCPU::TraceGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, cTestCPUTrace& trace)
+{
+  ctx.SetTestMode();
+  test_info.Clear();
+  TestGenome_Body(ctx, test_info, genome, 0, &trace);
+  ctx.ClearTestMode();
+  
+  return test_info.is_viable;
+}
+
+// Genome must match the traced genome everywhere but site.  The skipped prefix drew no random numbers, so the resumed
+// run gives exactly the result of a full test.
+bool cTestCPU::TestMutant(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int site,
+                          const cTestCPUTrace& trace)
+{
+  const int snapshot_id = trace.GetSafeSnapshot(site);
+  if (snapshot_id < 0 || !TraceMatches(test_info, trace)) return TestGenome(ctx, test_info, genome);
+  
+  ConstInstructionSequencePtr seq_p;
+  seq_p.DynamicCastFrom(genome.Representation());
+  if (seq_p->GetSize() != trace.m_safe_snapshot.GetSize()) return TestGenome(ctx, test_info, genome);
+  
+  ctx.SetTestMode();
+  test_info.Clear();
+  
+  cOrganism* organism = SetupTestOrganism(ctx, test_info, genome, 0);
+  const cTestCPUTrace::sSnapshot* snapshot = trace.m_snapshots[snapshot_id];
+  if (organism->GetHardware().RestoreCheckpoint(*snapshot->hardware)) {
+    organism->RestoreCheckpoint(snapshot->organism);
+    organism->GetHardware().GetMemory().SetInst(site, (*seq_p)[site]);
+    ProcessGestation(ctx, test_info, 0, NULL, snapshot);
+  } else {
+    ProcessGestation(ctx, test_info, 0);
+  }
+  FinishTestOrganism(ctx, test_info, organism, 0);
+  
+  ctx.ClearTestMode();
+  return test_info.is_viable;
+}
+
+bool cTestCPU::ForkGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, cTestCPUInputFork& fork)
+{
+  ctx.SetTestMode();
+  test_info.Clear();
+  
+  cOrganism* organism = SetupTestOrganism(ctx, test_info, genome, 0);
+  ProcessGestation(ctx, test_info, 0, NULL, NULL, &fork);
+  FinishTestOrganism(ctx, test_info, organism, 0);
+  
+  ctx.ClearTestMode();
+  return test_info.is_viable;
+}
+
+// Genome must be the forked genome.  No random numbers are drawn before the fork point, so the trial's random sequence
+// continues exactly where a full test would have it.
+bool cTestCPU::TestForked(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome,
+                          const cTestCPUInputFork& fork)
+{
+  if (!ForkMatches(test_info, genome, fork)) return TestGenome(ctx, test_info, genome);
+  
+  ctx.SetTestMode();
+  test_info.Clear();
+  
+  // Setup draws this trial's own inputs; none of them have been observed at the fork point
+  cOrganism* organism = SetupTestOrganism(ctx, test_info, genome, 0);
+  if (organism->GetHardware().RestoreCheckpoint(*fork.m_snapshot->hardware)) {
+    organism->RestoreCheckpoint(fork.m_snapshot->organism);
+    ProcessGestation(ctx, test_info, 0, NULL, fork.m_snapshot);
+  } else {
+    ProcessGestation(ctx, test_info, 0);
+  }
+  FinishTestOrganism(ctx, test_info, organism, 0);
+  
+  ctx.ClearTestMode();
+  return test_info.is_viable;
+}
+
+cOrganism* cTestCPU::SetupTestOrganism(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth)
 {
   assert(cur_depth < test_info.generation_tests);
 
@@ -270,11 +557,23 @@ bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, cons
   ConstInstructionSequencePtr seq;
   seq.DynamicCastFrom(genome.Representation());
   organism->GetPhenotype().SetupInject(*seq);
+  
+  return organism;
+}
+
+bool cTestCPU::TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth,
+                               cTestCPUTrace* trace)
+{
+  cOrganism* organism = SetupTestOrganism(ctx, test_info, genome, cur_depth);
 
   // Run the current organism.
-  ProcessGestation(ctx, test_info, cur_depth);
+  ProcessGestation(ctx, test_info, cur_depth, trace);
 
-  
+  return FinishTestOrganism(ctx, test_info, organism, cur_depth);
+}
+
+bool cTestCPU::FinishTestOrganism(cAvidaContext& ctx, cCPUTestInfo& test_info, cOrganism* organism, int cur_depth)
+{
   // Notify the organism that it has died to allow for various cleanup methods to run
   organism->NotifyDeath(ctx);
   
@@ -430,6 +729,7 @@ void cTestCPU::PrintGenome(cAvidaContext& ctx, const Genome& genome, cString fil
 
 void cTestCPU::ResetInputs(cAvidaContext& ctx) 
 { 
+  m_input_observed = true;
 	if (!m_use_manual_inputs)
 		m_world->GetEnvironment().SetupInputs(ctx, input_array, m_use_random_inputs);
 }
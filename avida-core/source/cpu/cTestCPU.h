@@ -25,6 +25,8 @@
 
 #include <fstream>
 
+#include "apto/rng.h"
+
 #include "cString.h"
 #include "cResourceCount.h"
 #include "cCPUTestInfo.h"
@@ -34,12 +36,116 @@
 class cAvidaContext;
 class cBioGroup;
 class cInstSet;
+class cOrganism;
 class cResourceCount;
 class cResourceHistory;
 
 using namespace Avida;
 
 
+// Passes random draws through to another generator while counting them, so that the test CPU can tell whether a
+// stretch of execution consumed any randomness.  Values are exactly those the wrapped generator would have produced.
+class cTestCPUDrawCounter : public Apto::Random
+{
+private:
+  Apto::Random& m_rng;
+  unsigned long long m_draws;
+  
+  cTestCPUDrawCounter(); // @not_implemented
+  cTestCPUDrawCounter(const cTestCPUDrawCounter&); // @not_implemented
+  cTestCPUDrawCounter& operator=(const cTestCPUDrawCounter&); // @not_implemented
+  
+public:
+  cTestCPUDrawCounter(Apto::Random& rng) : m_rng(rng), m_draws(0) { m_seed = m_original_seed = rng.Seed(); }
+  ~cTestCPUDrawCounter() { ; }
+  
+  void ResetSeed(int seed) { m_rng.ResetSeed(seed); m_seed = m_original_seed = m_rng.Seed(); }
+  int MaxSeed() const { return m_rng.MaxSeed(); }
+  
+  unsigned long long GetDraws() const { return m_draws; }
+  
+protected:
+  double getNext() { m_draws++; return m_rng.GetDouble(); }
+};
+
+
+// Checkpoints recorded while running a genome on the test CPU (see cTestCPU::TraceGenome).  For each site of the
+// traced genome, the trace knows the last checkpoint taken before execution first observed that site, which lets
+// cTestCPU::TestMutant resume a single-site mutant from there instead of re-executing the shared prefix.  Recording
+// stops at the first random draw, so the skipped prefix never consumes randomness a full test would have drawn.
+class cTestCPUTrace
+{
+  friend class cTestCPU;
+  friend class cTestCPUInputFork;
+private:
+  struct sSnapshot;
+  
+  Apto::Array<sSnapshot*> m_snapshots;
+  Apto::Array<int> m_safe_snapshot;   // per site, index of the last snapshot taken before the site was observed
+  int m_interval;
+  bool m_recording;
+  bool m_valid;
+  unsigned long long m_draws;          // Draw count when gestation began
+  
+  // Test settings the trace was recorded under; mutants are only resumed under identical settings
+  int m_res_method;
+  const cResourceHistory* m_res;
+  int m_res_update;
+  int m_res_cpu_cycle_offset;
+  int m_test_solo_res;
+  double m_test_solo_res_lev;
+  
+  cTestCPUTrace(const cTestCPUTrace&); // @not_implemented
+  cTestCPUTrace& operator=(const cTestCPUTrace&); // @not_implemented
+  
+  void clear();
+
+public:
+  cTestCPUTrace() : m_interval(1), m_recording(false), m_valid(false), m_draws(0) { ; }
+  ~cTestCPUTrace() { clear(); }
+  
+  bool IsValid() const { return m_valid; }
+  int GetNumSnapshots() const { return m_snapshots.GetSize(); }
+  int GetSafeSnapshot(int site) const
+    { return (m_valid && site >= 0 && site < m_safe_snapshot.GetSize()) ? m_safe_snapshot[site] : -1; }
+};
+
+
+// Checkpoint recorded while running a genome on the test CPU (see cTestCPU::ForkGenome), taken at the latest point
+// before execution first observed the test CPU's inputs or drew a random number.  Execution up to there is the same for
+// every input set and leaves the random sequence untouched, so cTestCPU::TestForked runs further trials of the genome
+// from the checkpoint with their own inputs and gets exactly the results of testing them in full.
+class cTestCPUInputFork
+{
+  friend class cTestCPU;
+private:
+  cTestCPUTrace::sSnapshot* m_snapshot;
+  int m_interval;
+  bool m_recording;
+  unsigned long long m_draws;          // Draw count when gestation began
+  
+  // Test settings the fork was recorded under; trials are only resumed under identical settings
+  int m_genome_size;
+  int m_res_method;
+  const cResourceHistory* m_res;
+  int m_res_update;
+  int m_res_cpu_cycle_offset;
+  int m_test_solo_res;
+  double m_test_solo_res_lev;
+  
+  cTestCPUInputFork(const cTestCPUInputFork&); // @not_implemented
+  cTestCPUInputFork& operator=(const cTestCPUInputFork&); // @not_implemented
+  
+  void clear();
+  
+public:
+  cTestCPUInputFork() : m_snapshot(NULL), m_interval(1), m_recording(false), m_draws(0), m_genome_size(0) { ; }
+  ~cTestCPUInputFork() { clear(); }
+  
+  bool IsValid() const { return m_snapshot != NULL; }
+};
+
+
 class cTestCPU
 {
 public:
@@ -50,6 +156,8 @@ private:
   Apto::Array<int> receive_array;
   int cur_input;
   int cur_receive;  
+  mutable bool m_input_observed;   // Inputs or received values were read since the current gestation began
+  cTestCPUDrawCounter* m_draw_counter;  // Counts random draws while a trace or fork is being recorded
   bool m_use_random_inputs;
   bool m_use_manual_inputs;
   int m_test_solo_res;
@@ -68,8 +176,24 @@ private:
   cResourceCount m_cell_resource_count;
     
 
-  bool ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth);
-  bool TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth);
+  bool ProcessGestation(cAvidaContext& ctx, cCPUTestInfo& test_info, int cur_depth,
+                        cTestCPUTrace* trace = NULL, const cTestCPUTrace::sSnapshot* resume = NULL,
+                        cTestCPUInputFork* fork = NULL);
+  bool TestGenome_Body(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth,
+                       cTestCPUTrace* trace = NULL);
+  cOrganism* SetupTestOrganism(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int cur_depth);
+  bool FinishTestOrganism(cAvidaContext& ctx, cCPUTestInfo& test_info, cOrganism* organism, int cur_depth);
+  
+  // Trace recording
+  void TraceBegin(cCPUTestInfo& test_info, cOrganism& organism, cTestCPUTrace& trace);
+  void TraceSnapshot(cOrganism& organism, cTestCPUTrace& trace, int time_used);
+  void TraceEnd(cOrganism& organism, cTestCPUTrace& trace);
+  bool TraceMatches(cCPUTestInfo& test_info, const cTestCPUTrace& trace) const;
+  
+  // Input fork recording
+  void ForkBegin(cCPUTestInfo& test_info, cOrganism& organism, cTestCPUInputFork& fork);
+  void ForkSnapshot(cOrganism& organism, cTestCPUInputFork& fork, int time_used);
+  bool ForkMatches(cCPUTestInfo& test_info, const Genome& genome, const cTestCPUInputFork& fork) const;
 
   
   cTestCPU(); // @not_implemented
@@ -90,11 +214,22 @@ public:
   bool TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome);
   bool TestGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, std::ofstream& out_fp);
   
+  // Test a genome while recording checkpoints into trace, then test genomes that differ from it only at a single
+  // site.  Mutants fall back to a full test whenever the trace cannot be applied.
+  bool TraceGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, cTestCPUTrace& trace);
+  bool TestMutant(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, int site, const cTestCPUTrace& trace);
+  
+  // Test a genome while recording the point its execution first depends on the inputs or the random sequence, then run
+  // further trials of the same genome (typically with random inputs) that share everything before that point.  Trials
+  // fall back to a full test whenever the fork cannot be applied; offspring are always tested independently.
+  bool ForkGenome(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, cTestCPUInputFork& fork);
+  bool TestForked(cAvidaContext& ctx, cCPUTestInfo& test_info, const Genome& genome, const cTestCPUInputFork& fork);
+  
   void PrintGenome(cAvidaContext& ctx, const Genome& genome, cString filename = "", int update = -1, bool for_groups = false, int last_birth_cell = 0, int last_group_id = -1, int last_forager_type = -1);
 
   inline int GetInput();
   inline int GetInputAt(int & input_pointer);
-  inline const Apto::Array<int>& GetInputs() const { return input_array; }
+  inline const Apto::Array<int>& GetInputs() const { m_input_observed = true; return input_array; }
   void ResetInputs(cAvidaContext& ctx);
 
   inline int GetReceiveValue();
@@ -125,18 +260,21 @@ public:
 
 inline int cTestCPU::GetInput()
 {
+  m_input_observed = true;
   if (cur_input >= input_array.GetSize()) cur_input = 0;
   return input_array[cur_input++];
 }
 
 inline int cTestCPU::GetInputAt(int & input_pointer)
 {
+  m_input_observed = true;
   if (input_pointer >= input_array.GetSize()) input_pointer = 0;
   return input_array[input_pointer++];
 }
 
 inline int cTestCPU::GetReceiveValue()
 {
+  m_input_observed = true;
   if (cur_receive >= receive_array.GetSize()) cur_receive = 0;
   return receive_array[cur_receive++];
 }
@@ -211,7 +211,6 @@ public:
   double CalcGroupOddsOffspring(int) { return 0.0; }
   bool AttemptImmigrateGroup(cAvidaContext& ctx, int, cOrganism*) { return false; }
   void PushToleranceInstExe(int, cAvidaContext&) { ; }
-  int& GetGroupIntolerances(int, int, int) { return *(new int(0)); }
 
   void TryWriteGroupAttackBits(unsigned char) { ; }
   void TryWriteGroupAttackString(cString&) { ; }
@@ -28,9 +28,14 @@
 #include "avida/data/Package.h"
 #include "avida/data/Provider.h"
 #include "avida/data/Recorder.h"
+#include "avida/data/Snapshot.h"
 
 #include <cassert>
 
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
 
 static Avida::WorldFacetPtr DeserializeDataManager(Avida::ArchivePtr)
 {
@@ -42,13 +47,54 @@ bool Avida::Data::Manager::s_registered_with_facet_factory =
   Avida::WorldFacet::RegisterFacetType(Avida::Reserved::DataManagerFacetID, DeserializeDataManager);
 
 
-Avida::Data::Manager::Manager() : m_world(NULL), m_available(new DataSet)
+// Separates an argumented data id ("foo[bar]") into its raw id ("foo[]") and argument ("bar")
+static bool splitArgumentedID(const Avida::Data::DataID& data_id, Avida::Data::DataID& raw_id, Avida::Data::Argument& argument)
+{
+  if (!data_id.GetSize() || data_id[data_id.GetSize() - 1] != ']') return false;
+  
+  // Find start of argument
+  int start_idx = -1;
+  for (int i = 0; i < data_id.GetSize(); i++) {
+    if (data_id[i] == '[') {
+      start_idx = i + 1;
+      break;
+    }
+  }
+  if (start_idx == -1) return false;  // argument start not found
+  
+  // Separate argument from incoming requested data id
+  argument = data_id.Substring(start_idx, data_id.GetSize() - start_idx - 1);
+  raw_id = data_id.Substring(0, start_idx) + "]";
+  return true;
+}
+
+
+// Full barrier atomic operations used to publish snapshots without locking readers
+#if defined(_MSC_VER)
+static inline long atomicAdd(volatile long* value, long delta) { return _InterlockedExchangeAdd(value, delta) + delta; }
+static inline void* atomicLoad(void* volatile* target) { return _InterlockedCompareExchangePointer(target, NULL, NULL); }
+static inline void* atomicExchange(void* volatile* target, void* value) { return _InterlockedExchangePointer(target, value); }
+#else
+static inline long atomicAdd(volatile long* value, long delta) { return __sync_add_and_fetch(value, delta); }
+static inline void* atomicLoad(void* volatile* target) { return __sync_val_compare_and_swap(target, (void*)NULL, (void*)NULL); }
+static inline void* atomicExchange(void* volatile* target, void* value)
+{
+  __sync_synchronize();  // __sync_lock_test_and_set is only an acquire barrier
+  return __sync_lock_test_and_set(target, value);
+}
+#endif
+
+
+Avida::Data::Manager::Manager() : m_world(NULL), m_available(new DataSet), m_snapshot(NULL), m_snapshot_readers(0)
 {
   
 }
 
 Avida::Data::Manager::~Manager()
 {
+  // Drop the published reference
+  ConstSnapshotPtr released(m_snapshot);
+  m_snapshot = NULL;
 }
 
 
@@ -90,19 +136,9 @@ Apto::String Avida::Data::Manager::Describe(const DataID& data_id) const
   
   if (data_id[data_id.GetSize() - 1] == ']') {
     // Handle argumented data value
-    
-    // Find start of argument
-    int start_idx = -1;
-    for (int i = 0; i < data_id.GetSize(); i++) {
-      if (data_id[i] == '[') {
-        start_idx = i + 1;
-        break;
-      }
-    }
-    if (start_idx == -1) return "";  // argument start not found
-    
-    // Separate argument from incoming requested data id
-    DataID raw_id = data_id.Substring(0, start_idx) + "]";
+    DataID raw_id;
+    Argument argument;
+    if (!splitArgumentedID(data_id, raw_id, argument)) return "";  // argument start not found
     
     // Check if argumented provider exists for requested data
     ArgumentedProviderPtr provider;
@@ -121,10 +157,35 @@ Apto::String Avida::Data::Manager::Describe(const DataID& data_id) const
 }
 
 
+Avida::Data::DataHandle Avida::Data::Manager::HandleOf(const DataID& data_id) const
+{
+  DataHandle handle = -1;
+  m_rwlock.ReadLock();
+  if (m_handles) m_handles->Get(data_id, handle);
+  m_rwlock.ReadUnlock();
+  return handle;
+}
+
+Avida::Data::ConstSnapshotPtr Avida::Data::Manager::CurrentSnapshot() const
+{
+  // Registering as a reader keeps publishSnapshot from dropping the loaded snapshot before it is referenced here
+  atomicAdd(&m_snapshot_readers, 1);
+  const Snapshot* snapshot = static_cast<const Snapshot*>(atomicLoad((void* volatile*)&m_snapshot));
+  if (snapshot) const_cast<Snapshot*>(snapshot)->AddReference();
+  atomicAdd(&m_snapshot_readers, -1);
+  
+  return ConstSnapshotPtr(snapshot);
+}
+
+
 bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_update)
 {
   ConstDataSetPtr requested = recorder->RequestedData();
   
+  m_recorder_mutex.Lock();
+  const bool already_attached = m_recorders.Has(recorder);
+  m_recorder_mutex.Unlock();
+  
   m_rwlock.WriteLock();
   
   // Make sure that all requested data values are available
@@ -136,20 +197,9 @@ bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_
     
     if (data_id[data_id.GetSize() - 1] == ']') {
       // Handle argumented data value
-      
-      // Find start of argument
-      int start_idx = -1;
-      for (int i = 0; i < data_id.GetSize(); i++) {
-        if (data_id[i] == '[') {
-          start_idx = i + 1;
-          break;
-        }
-      }
-      if (start_idx == -1) return false;  // argument start not found
-      
-      // Separate argument from incoming requested data id
-      Apto::String argument = data_id.Substring(start_idx, data_id.GetSize() - start_idx - 1);
-      DataID raw_id = data_id.Substring(0, start_idx) + "]";
+      DataID raw_id;
+      Argument argument;
+      if (!splitArgumentedID(data_id, raw_id, argument)) return false;  // argument start not found
       
       // Check if argumented provider exists for requested data
       if (!m_arg_provider_map.Has(raw_id)) return false;
@@ -191,20 +241,9 @@ bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_
     if (rdid[rdid.GetSize() - 1] == ']') {
       
       // Handle argumented data value      
-      
-      // Find start of argument
-      int start_idx = -1;
-      for (int i = 0; i < rdid.GetSize(); i++) {
-        if (rdid[i] == '[') {
-          start_idx = i + 1;
-          break;
-        }
-      }
-      if (start_idx == -1) return false;  // argument start not found
-      
-      // Separate argument from incoming requested data id
-      Apto::String argument = rdid.Substring(start_idx, rdid.GetSize() - start_idx - 1);
-      DataID raw_id = rdid.Substring(0, start_idx) + "]";
+      DataID raw_id;
+      Argument argument;
+      if (!splitArgumentedID(rdid, raw_id, argument)) return false;  // argument start not found
 
       ArgumentedProviderPtr provider = m_active_arg_provider_map[raw_id];
       if (!provider) return false; // Argumented providers should be activated above, whaa??
@@ -295,23 +334,33 @@ bool Avida::Data::Manager::AttachRecorder(RecorderPtr recorder, bool concurrent_
     }
   }
   
+  
+  // Resolve each requested data id to a dense handle once, so that per-update retrieval never re-parses ids.
+  // The handle map is replaced rather than modified, since published snapshots share it.
+  if (!already_attached) {
+    DataHandleMap* handles = new DataHandleMap;
+    if (m_handles) *handles = *m_handles;
+    for (ConstDataSetIterator it = requested->Begin(); it.Next();) resolveHandle(*it.Get(), *handles);
+    m_handles = ConstDataHandleMapPtr(handles);
+  }
+  
   m_rwlock.WriteUnlock();
   
   
   if (concurrent_update) {
     for (Apto::Set<ProviderPtr>::Iterator it = provider_set.Begin(); it.Next();) {
-      if ((*it.Get())->SupportsConcurrentUpdate()) {
-        ProviderPtr provider = (*it.Get());
-        provider->UpdateProvidedValues(UPDATE_CONCURRENT);
-        
-        // Invalidate cached entries for this provider
-        ConstDataSetPtr provided = provider->Provides();
-        m_current_value_mutex.Lock();
-        for (ConstDataSetIterator pit = provided->Begin(); pit.Next();) m_current_values.Remove(*pit.Get());
-        m_current_value_mutex.Unlock();
-      }
+      if ((*it.Get())->SupportsConcurrentUpdate()) (*it.Get())->UpdateProvidedValues(UPDATE_CONCURRENT);
     }
-    DataRetrievalFunctor drf(this, &Manager::GetCurrentValue);
+    
+    m_rwlock.ReadLock();
+    Snapshot* snapshot = buildSnapshot(UPDATE_CONCURRENT);
+    m_rwlock.ReadUnlock();
+    
+    ConstSnapshotPtr snapshot_ptr(snapshot);
+    snapshot->AddReference();  // reference held by the published slot
+    publishSnapshot(snapshot);
+    
+    DataRetrievalFunctor drf(snapshot, &Snapshot::GetValueOf);
     recorder->NotifyData(UPDATE_CONCURRENT, drf);
   }
   
@@ -329,7 +378,30 @@ bool Avida::Data::Manager::DetachRecorder(RecorderPtr recorder)
   success = m_recorders.Remove(recorder);
   // @TODO - this should probably deactivate data providers that are no longer needed, or at least adjust schedule
   m_recorder_mutex.Unlock();
-  return success;
+  if (!success) return false;
+  
+  // Release the recorder's handles.  Ids that no remaining recorder requests leave the handle map, stop being
+  // collected into snapshots, and have their slots reused by later attachments.
+  ConstDataSetPtr requested = recorder->RequestedData();
+  m_rwlock.WriteLock();
+  DataHandleMap* handles = NULL;
+  for (ConstDataSetIterator it = requested->Begin(); it.Next();) {
+    DataHandle handle = -1;
+    if (!m_handles || !m_handles->Get(*it.Get(), handle)) continue;
+    if (--m_resolved[handle].num_recorders > 0) continue;
+    
+    if (!handles) {
+      handles = new DataHandleMap;
+      *handles = *m_handles;
+    }
+    handles->Remove(*it.Get());
+    m_resolved[handle] = sResolvedID();
+    m_free_handles.Push(handle);
+  }
+  if (handles) m_handles = ConstDataHandleMapPtr(handles);
+  m_rwlock.WriteUnlock();
+  
+  return true;
 }
 
 
@@ -420,17 +492,19 @@ Avida::WorldFacetID Avida::Data::Manager::UpdateAfter() const
 
 void Avida::Data::Manager::PerformUpdate(Context&, Update current_update)
 {
-  m_current_value_mutex.Lock();
-  m_current_values.Clear();
-  m_current_value_mutex.Unlock();
-  
   m_rwlock.ReadLock();
   
   // Update all of the active providers
   for (int i = 0; i < m_active_providers.GetSize(); i++) m_active_providers[i]->UpdateProvidedValues(current_update);
   
+  // Collect this update's values into an immutable snapshot, recorders read from it without further locking
+  Snapshot* snapshot = buildSnapshot(current_update);
+  ConstSnapshotPtr snapshot_ptr(snapshot);
+  snapshot->AddReference();  // reference held by the published slot
+  publishSnapshot(snapshot);
+  
   // Notify recorders that new data is available
-  DataRetrievalFunctor drf(this, &Manager::GetCurrentValue);
+  DataRetrievalFunctor drf(snapshot, &Snapshot::GetValueOf);
 
   // Lock recorder mutex before releasing RWLock, so that only recorders that have values will be notified
   m_recorder_mutex.Lock();
@@ -446,43 +520,84 @@ void Avida::Data::Manager::PerformUpdate(Context&, Update current_update)
 
 Avida::Data::PackagePtr Avida::Data::Manager::GetCurrentValue(const DataID& data_id) const
 {
-  PackagePtr rtn;
-  Apto::MutexAutoLock cvmutexlock(m_current_value_mutex);
-  
-  if (m_current_values.Get(data_id, rtn)) return rtn;
+  // Resolved data ids are served straight from the most recently published snapshot
+  ConstSnapshotPtr snapshot = CurrentSnapshot();
+  if (snapshot) {
+    DataHandle handle = snapshot->HandleOf(data_id);
+    if (handle >= 0) return snapshot->GetValue(handle);
+  }
   
-  if (data_id[data_id.GetSize() - 1] == ']') {
-    // Find start of argument
-    int start_idx = -1;
-    for (int i = 0; i < data_id.GetSize(); i++) {
-      if (data_id[i] == '[') {
-        start_idx = i + 1;
-        break;
-      }
-    }
-    if (start_idx == -1) return rtn;  // argument start not found
-    
-    // Separate argument from incoming requested data id
-    Apto::String argument = data_id.Substring(start_idx, data_id.GetSize() - start_idx - 1);
-    DataID raw_id = data_id.Substring(0, start_idx) + "]";
-    
-    m_rwlock.ReadLock();
+  // Otherwise query the active provider directly
+  PackagePtr rtn;
+  DataID raw_id;
+  Argument argument;
+  m_rwlock.ReadLock();
+  if (splitArgumentedID(data_id, raw_id, argument)) {
     ArgumentedProviderPtr arg_provider;
-    if (m_active_arg_provider_map.Get(raw_id, arg_provider)) {
-      rtn = arg_provider->GetProvidedValueForArgument(raw_id, argument);
-      if (rtn) m_current_values[data_id] = rtn;
-    }
-    m_rwlock.ReadUnlock();
-  } else {
-    m_rwlock.ReadLock();
+    if (m_active_arg_provider_map.Get(raw_id, arg_provider)) rtn = arg_provider->GetProvidedValueForArgument(raw_id, argument);
+  } else if (data_id.GetSize() && data_id[data_id.GetSize() - 1] != ']') {
     ProviderPtr provider;
-    if (m_active_provider_map.Get(data_id, provider)) {
-      rtn = provider->GetProvidedValue(data_id);
-      if (rtn) m_current_values[data_id] = rtn;
-    }
-    m_rwlock.ReadUnlock();
+    if (m_active_provider_map.Get(data_id, provider)) rtn = provider->GetProvidedValue(data_id);
   }
+  m_rwlock.ReadUnlock();
   
   return rtn;
 }
 
+
+Avida::Data::DataHandle Avida::Data::Manager::resolveHandle(const DataID& data_id, DataHandleMap& handles)
+{
+  // Must be called with the write lock held
+  DataHandle handle = -1;
+  if (handles.Get(data_id, handle)) {
+    m_resolved[handle].num_recorders++;
+    return handle;
+  }
+  
+  sResolvedID resolved;
+  resolved.data_id = data_id;
+  if (splitArgumentedID(data_id, resolved.raw_id, resolved.argument)) {
+    if (!m_active_arg_provider_map.Get(resolved.raw_id, resolved.arg_provider)) return -1;
+  } else {
+    if (!m_active_provider_map.Get(data_id, resolved.provider)) return -1;
+  }
+  
+  resolved.num_recorders = 1;
+  
+  const int num_free = m_free_handles.GetSize();
+  if (num_free) {
+    handle = m_free_handles[num_free - 1];
+    m_free_handles.Resize(num_free - 1);
+    m_resolved[handle] = resolved;
+  } else {
+    handle = m_resolved.GetSize();
+    m_resolved.Push(resolved);
+  }
+  handles[data_id] = handle;
+  return handle;
+}
+
+Avida::Data::Snapshot* Avida::Data::Manager::buildSnapshot(Update current_update) const
+{
+  // Must be called with (at least) the read lock held
+  Snapshot* snapshot = new Snapshot(current_update, m_handles, m_resolved.GetSize());
+  for (int i = 0; i < m_resolved.GetSize(); i++) {
+    const sResolvedID& resolved = m_resolved[i];
+    if (!resolved.num_recorders) continue;  // free slot, no attached recorder needs it
+    if (resolved.arg_provider) {
+      snapshot->m_values[i] = resolved.arg_provider->GetProvidedValueForArgument(resolved.raw_id, resolved.argument);
+    } else {
+      snapshot->m_values[i] = resolved.provider->GetProvidedValue(resolved.data_id);
+    }
+  }
+  return snapshot;
+}
+
+void Avida::Data::Manager::publishSnapshot(const Snapshot* snapshot)
+{
+  // Takes over one reference to snapshot.  The replaced snapshot's reference is only dropped once no reader can still
+  // be between loading the old pointer and adding its own reference.
+  const Snapshot* replaced = static_cast<const Snapshot*>(atomicExchange((void* volatile*)&m_snapshot, (void*)snapshot));
+  while (atomicAdd(&m_snapshot_readers, 0)) ;
+  ConstSnapshotPtr released(replaced);
+}
@@ -0,0 +1,45 @@
+/*
+ *  data/Snapshot.cc
+ *  avida-core
+ *
+ *  Copyright 2011 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/data/Snapshot.h"
+
+#include "avida/data/Package.h"
+
+
+Avida::Data::Snapshot::Snapshot(Update update, ConstDataHandleMapPtr handles, int num_values)
+  : m_update(update), m_handles(handles), m_values(num_values)
+{
+}
+
+Avida::Data::Snapshot::~Snapshot() { ; }
+
+
+Avida::Data::DataHandle Avida::Data::Snapshot::HandleOf(const DataID& data_id) const
+{
+  DataHandle handle = -1;
+  if (m_handles) m_handles->Get(data_id, handle);
+  return handle;
+}
+
+Avida::Data::PackagePtr Avida::Data::Snapshot::GetValueOf(const DataID& data_id) const
+{
+  return GetValue(HandleOf(data_id));
+}
@@ -281,7 +281,9 @@ public:
   CONFIG_ADD_GROUP(GENERAL_GROUP, "General Settings");
   CONFIG_ADD_VAR(VERBOSITY, int, 1, "0 = No output at all\n1 = Normal output\n2 = Verbose output, detailing progress\n3 = High level of details, as available\n4 = Print Debug Information, as applicable");
   CONFIG_ADD_VAR(RANDOM_SEED, int, -1, "Random number seed (<0 for based on time)");
+  CONFIG_ADD_VAR(RANDOM_GENERATOR, int, 0, "Random number generator\n0 = AvidaRNG, a single shared sequence (legacy)\n1 = Philox counter-based streams, derived from the seed for the world\n    and for each concurrent deme, scheduler and analyze job");
   CONFIG_ADD_VAR(SPECULATIVE, bool, 1, "Enable speculative execution\n(pre-execute instructions that don't affect other organisms)");
+  CONFIG_ADD_VAR(DEME_THREADS, int, 0, "Execute demes concurrently on this many threads (0 = off, -1 = all available).\nOnly used when demes are isolated: SPECULATIVE on, default CPUs whose\ninstructions all stall or only touch the organism itself, no migration,\nno implicit reproduction, energy, promoters, instruction resource\ncosts or parallel thread slicing");
   CONFIG_ADD_VAR(POPULATION_CAP, int, 0, "Carrying capacity in number of organisms (use 0 for no cap)");
   CONFIG_ADD_VAR(POP_CAP_ELDEST, int, 0, "Carrying capacity in number of organisms (use 0 for no cap). Will kill oldest organism in population, but still use birth method to place new offspring."); 
   
@@ -304,6 +306,12 @@ public:
   CONFIG_ADD_VAR(MIGRATION_FILE, cString, "-", "NxN file that describes connectivity weights between demes");   
   
   
+  // -------- Output config options --------
+  CONFIG_ADD_GROUP(OUTPUT_GROUP, "Output file writing");
+  CONFIG_ADD_VAR(OUTPUT_ASYNC_QUEUE, int, 0, "Write output files from a background thread\n0 = Synchronous output (default)\n>0 = Maximum number of filled buffers awaiting the writer;\n     the simulation waits when this many are pending\n-1 = Unbounded queue (never wait, memory permitting)");
+  CONFIG_ADD_VAR(OUTPUT_ASYNC_BUFFER_KB, int, 256, "Size (in KB) of each buffer handed to the background writer");
+  
+  
   // -------- Mutation config options --------
   CONFIG_ADD_GROUP(MUTATION_GROUP, "Mutation rates");  
   CONFIG_ADD_VAR(COPY_MUT_PROB, double, 0.0075, "Substitution rate (per copy)");
@@ -360,6 +368,7 @@ public:
   CONFIG_ADD_VAR(META_COPY_MUT, double, 0.0, "Prob. of copy mutation rate changing (per gen)");
   CONFIG_ADD_VAR(META_STD_DEV, double, 0.0, "Standard deviation of meta mutation size.");
   CONFIG_ADD_VAR(MUT_RATE_SOURCE, int, 1, "1 = Mutation rates determined by environment.\n2 = Mutation rates inherited from parent.");
+  CONFIG_ADD_VAR(MUTATION_SKIP_SAMPLING, bool, 0, "Draw the distance to the next copy and point mutation rather than testing every site.\nMutation rates are unchanged, but the random number stream differs from per-site testing.");
   
   
   // -------- Birth and Death config options --------
@@ -638,6 +647,8 @@ public:
   // -------- Analyze config options --------
   CONFIG_ADD_GROUP(ANALYZE_GROUP, "Analysis Settings");
   CONFIG_ADD_VAR(MAX_CONCURRENCY, int, -1, "Maximum number of analyze threads, -1 == use all available.");
+  CONFIG_ADD_VAR(FORK_PLASTICITY_TRIALS, int, 1, "Resume phenotypic plasticity trials after the first from its state just before it read\nany input or drew a random number (0 = run every trial in full)");
+  CONFIG_ADD_VAR(RESUME_LANDSCAPE_MUTANTS, int, 1, "Resume single-site landscape mutants from checkpoints of the base genome's test run,\ntaken before execution first observed the mutated site (0 = test every mutant in full)");
   CONFIG_ADD_VAR(INJECT_RESETS_TASKS, int, 0, "Executing INJECT (semi-succesfully) will trigger last_task_count to be writen from current_task_count");
   CONFIG_ADD_VAR(ANALYZE_OPTION_1, cString, "", "String variable accessible from analysis scripts");
   CONFIG_ADD_VAR(ANALYZE_OPTION_2, cString, "", "String variable accessible from analysis scripts");
@@ -28,6 +28,7 @@
 
 #include "avida/core/Types.h"
 
+class cAnalyzeJob;
 class cWorld;
 
 
@@ -36,14 +37,15 @@ class cAvidaContext
 private:
   Avida::WorldDriver* m_driver;
   Apto::Random* m_rng;
+  cAnalyzeJob* m_job;
 
   bool m_analyze;
   bool m_testing;
   bool m_org_faults;
   
 public:
-  cAvidaContext(Avida::WorldDriver* driver, Apto::Random& rng) : m_driver(driver), m_rng(&rng), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
-  cAvidaContext(Avida::WorldDriver* driver, Apto::Random* rng) : m_driver(driver), m_rng(rng), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
+  cAvidaContext(Avida::WorldDriver* driver, Apto::Random& rng) : m_driver(driver), m_rng(&rng), m_job(NULL), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
+  cAvidaContext(Avida::WorldDriver* driver, Apto::Random* rng) : m_driver(driver), m_rng(rng), m_job(NULL), m_analyze(false), m_testing(false), m_org_faults(false) { ; }
   ~cAvidaContext() { ; }
   
   Avida::WorldDriver& Driver() { return *m_driver; }
@@ -57,6 +59,9 @@ public:
   void ClearAnalyzeMode() { m_analyze = false; }
   bool GetAnalyzeMode() { return m_analyze; }
   
+  void SetAnalyzeJob(cAnalyzeJob* job) { m_job = job; }  // job currently executing in this context, if any
+  cAnalyzeJob* GetAnalyzeJob() { return m_job; }
+  
   void SetTestMode()   { m_testing = true; }   //@MRR  Some modifications I've made need to distinguish
   void ClearTestMode() { m_testing = false; }  //      when we're running a genotype through a test-cpu
   bool GetTestMode()   { return m_testing; }   //      versus when we're not when dealing with reactions rewards.
@@ -37,12 +37,53 @@
 #include <iostream>
 
 
+// Rankings are binary heaps of rank records, best first; equal scores go to the lower slot
+template <class T> static inline bool rankedBefore(const T& a, const T& b)
+{
+  return (a.score > b.score || (a.score == b.score && a.slot < b.slot));
+}
+
+// The free slot list is a heap of slot indices, lowest first
+static inline bool rankedBefore(int a, int b)
+{
+  return a < b;
+}
+
+template <class T> static void heapSiftUp(Apto::Array<T>& heap, int idx)
+{
+  while (idx > 0) {
+    const int parent = (idx - 1) / 2;
+    if (!rankedBefore(heap[idx], heap[parent])) break;
+    heap.Swap(idx, parent);
+    idx = parent;
+  }
+}
+
+template <class T> static void heapSiftDown(Apto::Array<T>& heap, int idx)
+{
+  const int size = heap.GetSize();
+  while (true) {
+    int best = idx;
+    const int left = 2 * idx + 1;
+    const int right = left + 1;
+    if (left < size && rankedBefore(heap[left], heap[best])) best = left;
+    if (right < size && rankedBefore(heap[right], heap[best])) best = right;
+    if (best == idx) break;
+    heap.Swap(idx, best);
+    idx = best;
+  }
+}
+
+
 cBirthMatingTypeGlobalHandler::~cBirthMatingTypeGlobalHandler()
 {
+  for (int i = 0; i < m_buckets.GetSize(); i++) delete m_buckets[i];
 }
 
 cBirthEntry* cBirthMatingTypeGlobalHandler::SelectOffspring(cAvidaContext& ctx, const Genome& offspring, cOrganism* parent)
 {
+  syncIndex();
+  
   int parent_sex = parent->GetPhenotype().GetMatingType();
   
   //Parent has not sexually matured
@@ -85,7 +126,7 @@ int cBirthMatingTypeGlobalHandler::GetWaitingOffspringNumber(int which_mating_ty
   int num_waiting = 0;
   
   for (int i = 0; i < m_entries.GetSize(); i++) {
-    if (m_bc->ValidateBirthEntry(m_entries[i])) {
+    if (validateSlot(i)) {
       if (m_entries[i].GetMatingType() == which_mating_type) num_waiting++;
     }
   }
@@ -193,36 +234,11 @@ void cBirthMatingTypeGlobalHandler::storeOffspring(cAvidaContext&, const Genome&
   //Find an empty entry
   //If there are none, make room for one
   //But if the birth chamber is at the size limit already, over-write the oldest one
-  int oldest_index = -1;
-  int entry_list_size = m_entries.GetSize();
-  //Loop through all the birth entries
-  for (int i = 0; i < entry_list_size; i++) {
-    if (m_bc->ValidateBirthEntry(m_entries[i])) {
-      //Current entry is valid, so let's just keep track of the oldest one
-      if (oldest_index == -1) oldest_index = i;
-      else oldest_index = (m_entries[i].timestamp < m_entries[oldest_index].timestamp ? i : oldest_index);
-    } else {
-      //Current entry is empty, so let's use this one
-      m_bc->ClearEntry(m_entries[i]);
-      m_bc->StoreAsEntry(offspring, parent, m_entries[i]);
-      return;
-    }
-  }
-
-  //If we're still here, it means we didn't find any empty entries
-  //So, let's make room for one and then store it; but if the list is already at its max size,
-  // we'll just have to over-write the oldest one
-  int store_index = m_entries.GetSize();
-  int max_buffer_size = m_world->GetConfig().MAX_GLOBAL_BIRTH_CHAMBER_SIZE.Get();
-  if (store_index >= max_buffer_size) {
-    //m_bc->ClearEntry(m_entries[oldest_index]);
-    store_index = oldest_index;
-  } else {
-    m_entries.Resize(store_index + 1);
-  }
+  int store_index = acquireSlot();
   
   m_bc->ClearEntry(m_entries[store_index]);
   m_bc->StoreAsEntry(offspring, parent, m_entries[store_index]);
+  indexSlot(store_index);
 }
 
 //Compares two birth entries and decides which one is preferred
@@ -305,71 +321,32 @@ bool cBirthMatingTypeGlobalHandler::compareBirthEntries(cAvidaContext& ctx, int
 //If none is found, it returns NULL
 cBirthEntry* cBirthMatingTypeGlobalHandler::selectMate(cAvidaContext& ctx, const Genome& offspring, cOrganism* parent, int which_mating_type, int mate_choice_method)
 {
-  //Loop through the entry list and find a mate
-  //If none are found, store the current offspring and return NULL
-  int num_waiting = m_entries.GetSize();
-  if (num_waiting == 0) {
-    storeOffspring(ctx, offspring, parent);
-    return NULL;
-  }
-  
-  int selected_index = -1;
-  
   if (m_world->GetConfig().FORCED_MATE_PREFERENCE.Get() != -1) {
     mate_choice_method = m_world->GetConfig().FORCED_MATE_PREFERENCE.Get();
   }
   
-  if (mate_choice_method == MATE_PREFERENCE_RANDOM) {
-    //This is a non-choosy individual, so pick a mate randomly!
-    //First, get a list of every element of m_entries that contains a waiting offspring (of the compatible sex)
-    //Then pick one at random
-    Apto::Array<int> compatible_entries; //This will hold a list of all the compatible birth entries waiting in the birth chamber
-    compatible_entries.Resize(num_waiting, -1);
-    int last_compatible = -1; //The index of the last entry in compatible_entries holding a compatible m_entries index
-    for (int i = 0; i < num_waiting; i++) {
-      if (m_bc->ValidateBirthEntry(m_entries[i])) { //Is the current entry valid/alive?
-        //Here, check to see if the current entry belongs to the parent's group! @CHC
-        bool groups_match = false;
-        if (!(m_world->GetConfig().MATE_IN_GROUPS.Get())) {
-          groups_match = true; //Within-group mating is turned off, so don't need to check
-        } else {
-          //Within-group mating is turned on, so we need to check if the parent's group is the same
-          if (parent->HasOpinion()) {
-            groups_match = (m_entries[i].GetGroupID() == parent->GetOpinion().first);
-          }
-        }
-        if (groups_match) {
-          if (m_entries[i].GetMatingType() == which_mating_type) { //Is the current entry a compatible mating type?
-            last_compatible++;
-            compatible_entries[last_compatible] = i;
-          }
-        }
-      }
-    }
-    if (last_compatible > -1) { //Don't bother picking one if we haven't found any compatible entries
-      selected_index = compatible_entries[ctx.GetRandom().GetUInt(last_compatible+1)];
-    }    
-  } else {
-    //This is a choosy female, so go through all the mates and pick the "best" one!
-    for (int i = 0; i < num_waiting; i++) {
-      if (m_bc->ValidateBirthEntry(m_entries[i])) { //Is the current entry valid/alive?
-        //Here, check to see if the current entry belongs to the parent's group! @CHC
-        bool groups_match = false;
-        if (!(m_world->GetConfig().MATE_IN_GROUPS.Get())) {
-          groups_match = true; //Within-group mating is turned off, so don't need to check
-        } else {
-          //Within-group mating is turned on, so we need to check if the parent's group is the same
-          if (parent->HasOpinion()) {
-            groups_match = (m_entries[i].GetGroupID() == parent->GetOpinion().first);
-          }
-        }
-        if (groups_match) {
-          if (m_entries[i].GetMatingType() == which_mating_type) { //Is the current entry a compatible mating type?
-            if (selected_index == -1) selected_index = i;
-            else selected_index = compareBirthEntries(ctx, mate_choice_method, m_entries[i], m_entries[selected_index]) ? i : selected_index;
-          }
-        }
-      }
+  //Only entries in the parent's bucket are compatible: the right mating type and, with within-group mating turned on,
+  // the parent's group @CHC
+  int bucket_id = -1;
+  if (!(m_world->GetConfig().MATE_IN_GROUPS.Get())) {
+    bucket_id = bucketFor(which_mating_type, 0, false);
+  } else if (parent->HasOpinion()) {
+    bucket_id = bucketFor(which_mating_type, parent->GetOpinion().first, false);
+  }
+  
+  int selected_index = -1;
+  if (bucket_id != -1) {
+    sBucket& bucket = *m_buckets[bucket_id];
+    if (mate_choice_method == MATE_PREFERENCE_RANDOM) {
+      //This is a non-choosy individual, so pick a mate randomly!
+      selected_index = selectRandom(ctx, bucket);
+    } else if (m_world->GetConfig().NOISY_MATE_ASSESSMENT.Get() || !isRankedPreference(mate_choice_method)) {
+      //Noisy assessment draws fresh noise for every comparison, and a preference without a ranking settles every
+      // comparison with a coin flip, so each candidate has to be assessed in turn
+      selected_index = selectAssessed(ctx, bucket, mate_choice_method);
+    } else {
+      //This is a choosy female, so pick the "best" one!
+      selected_index = selectRanked(bucket, mate_choice_method);
     }
   }
   
@@ -378,12 +355,280 @@ cBirthEntry* cBirthMatingTypeGlobalHandler::selectMate(cAvidaContext& ctx, const
     storeOffspring(ctx, offspring, parent);
     return NULL;
   }
+  
+  //The birth chamber clears the selected entry once the offspring is born, so its slot can be reused
+  releaseSlot(selected_index);
+  
   //cout << "Selected " << m_entries[selected_index].GetPhenotypeString() << "\n";
   return &(m_entries[selected_index]);
   
 }
 
 
+int cBirthMatingTypeGlobalHandler::bucketKey(int mating_type, int group_id) const
+{
+  assert(mating_type == MATING_TYPE_FEMALE || mating_type == MATING_TYPE_MALE);
+  if (!m_bucket_by_group) group_id = 0;
+  return group_id * 2 + mating_type;
+}
+
+int cBirthMatingTypeGlobalHandler::bucketFor(int mating_type, int group_id, bool create)
+{
+  const int key = bucketKey(mating_type, group_id);
+  int bucket_id = -1;
+  if (m_bucket_ids.Get(key, bucket_id)) return bucket_id;
+  if (!create) return -1;
+  
+  bucket_id = m_buckets.GetSize();
+  m_buckets.Push(new sBucket);
+  m_bucket_ids.Set(key, bucket_id);
+  return bucket_id;
+}
+
+//Rebuilds the index if MATE_IN_GROUPS has changed since entries were indexed
+void cBirthMatingTypeGlobalHandler::syncIndex()
+{
+  const bool by_group = m_world->GetConfig().MATE_IN_GROUPS.Get();
+  if (by_group == m_bucket_by_group) return;
+  
+  for (int i = 0; i < m_buckets.GetSize(); i++) delete m_buckets[i];
+  m_buckets.Resize(0);
+  m_bucket_ids.Clear();
+  m_age_queue.Resize(0);
+  m_age_head = 0;
+  m_free_slots.Resize(0);
+  m_bucket_by_group = by_group;
+  
+  for (int i = 0; i < m_entries.GetSize(); i++) {
+    m_slot_bucket[i] = -1;
+    if (m_bc->ValidateBirthEntry(m_entries[i])) indexSlot(i);
+    else pushFreeSlot(i);
+  }
+}
+
+void cBirthMatingTypeGlobalHandler::indexSlot(int slot)
+{
+  cBirthEntry& entry = m_entries[slot];
+  const int bucket_id = bucketFor(entry.GetMatingType(), entry.GetGroupID(), true);
+  sBucket& bucket = *m_buckets[bucket_id];
+  
+  // A new generation invalidates any records left over from the slot's previous entry
+  const int gen = ++m_slot_gen[slot];
+  m_slot_bucket[slot] = bucket_id;
+  
+  // Bucket slot lists are kept in ascending order, the order in which a scan of the chamber meets the entries
+  Apto::Array<int>& slots = bucket.slots;
+  int pos = slots.GetSize();
+  slots.Push(slot);
+  for (; pos > 0 && slots[pos - 1] > slot; pos--) slots[pos] = slots[pos - 1];
+  slots[pos] = slot;
+  
+  sSlotRecord age_rec = { slot, gen };
+  m_age_queue.Push(age_rec);
+  
+  for (int i = 0; i < NUM_RANKINGS; i++) {
+    if (!bucket.ranked[i]) continue;
+    sRankRecord rec = { rankScore(i, entry), slot, gen };
+    Apto::Array<sRankRecord>& heap = bucket.rankings[i];
+    heap.Push(rec);
+    heapSiftUp(heap, heap.GetSize() - 1);
+  }
+}
+
+void cBirthMatingTypeGlobalHandler::unindexSlot(int slot)
+{
+  const int bucket_id = m_slot_bucket[slot];
+  if (bucket_id == -1) return;
+  
+  // Remove from the bucket's ordered slot list; rankings and the age queue discard stale records as they meet them
+  Apto::Array<int>& slots = m_buckets[bucket_id]->slots;
+  int lo = 0;
+  int hi = slots.GetSize() - 1;
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (slots[mid] < slot) lo = mid + 1;
+    else hi = mid;
+  }
+  assert(slots[lo] == slot);
+  for (int i = lo + 1; i < slots.GetSize(); i++) slots[i - 1] = slots[i];
+  slots.Pop();
+  
+  m_slot_bucket[slot] = -1;
+  m_slot_gen[slot]++;
+}
+
+//Unindexes the slot and makes it available for storing
+void cBirthMatingTypeGlobalHandler::releaseSlot(int slot)
+{
+  unindexSlot(slot);
+  pushFreeSlot(slot);
+}
+
+void cBirthMatingTypeGlobalHandler::pushFreeSlot(int slot)
+{
+  m_free_slots.Push(slot);
+  heapSiftUp(m_free_slots, m_free_slots.GetSize() - 1);
+}
+
+int cBirthMatingTypeGlobalHandler::popFreeSlot()
+{
+  const int slot = m_free_slots[0];
+  m_free_slots.Swap(0, m_free_slots.GetSize() - 1);
+  m_free_slots.Pop();
+  heapSiftDown(m_free_slots, 0);
+  return slot;
+}
+
+//Releases every expired entry.  Entries expire oldest first, so they are found at the head of the age queue.
+void cBirthMatingTypeGlobalHandler::releaseExpired()
+{
+  for (int oldest = oldestSlot(); oldest != -1 && !m_bc->ValidateBirthEntry(m_entries[oldest]); oldest = oldestSlot()) {
+    releaseSlot(oldest);
+  }
+}
+
+//Releases the expired entries in the bucket, leaving only valid ones
+void cBirthMatingTypeGlobalHandler::pruneBucket(sBucket& bucket)
+{
+  for (int i = bucket.slots.GetSize() - 1; i >= 0; i--) validateSlot(bucket.slots[i]);
+}
+
+//Validates the entry in slot, releasing the slot if the entry has expired
+bool cBirthMatingTypeGlobalHandler::validateSlot(int slot)
+{
+  if (m_bc->ValidateBirthEntry(m_entries[slot])) return true;
+  if (m_slot_bucket[slot] != -1) releaseSlot(slot);
+  return false;
+}
+
+//Returns the slot to store the next entry in, unindexed.  As with a scan of the chamber, this is the lowest empty slot;
+// failing that a new slot, or the oldest entry once the chamber is full.
+int cBirthMatingTypeGlobalHandler::acquireSlot()
+{
+  releaseExpired();
+  if (m_free_slots.GetSize()) return popFreeSlot();
+  
+  //No entry is free, so let's make room for one; but if the list is already at its max size,
+  // we'll just have to over-write the oldest one
+  const int max_buffer_size = m_world->GetConfig().MAX_GLOBAL_BIRTH_CHAMBER_SIZE.Get();
+  if (m_entries.GetSize() >= max_buffer_size) {
+    int oldest = oldestSlot();
+    if (oldest != -1) {
+      //Timestamps never decrease along the age queue, so entries tied for the oldest follow the head; take the lowest
+      const int oldest_time = m_entries[oldest].timestamp;
+      for (int i = m_age_head + 1; i < m_age_queue.GetSize(); i++) {
+        const sSlotRecord& rec = m_age_queue[i];
+        if (m_slot_gen[rec.slot] != rec.gen || m_slot_bucket[rec.slot] == -1) continue;
+        if (m_entries[rec.slot].timestamp != oldest_time) break;
+        if (rec.slot < oldest) oldest = rec.slot;
+      }
+      unindexSlot(oldest);
+      return oldest;
+    }
+  }
+  
+  const int slot = m_entries.GetSize();
+  m_entries.Resize(slot + 1);
+  m_slot_gen.Push(0);
+  m_slot_bucket.Push(-1);
+  return slot;
+}
+
+//Returns the slot holding the oldest indexed entry, or -1 if there are none
+int cBirthMatingTypeGlobalHandler::oldestSlot()
+{
+  while (m_age_head < m_age_queue.GetSize()) {
+    const sSlotRecord& rec = m_age_queue[m_age_head];
+    if (m_slot_gen[rec.slot] == rec.gen && m_slot_bucket[rec.slot] != -1) break;
+    m_age_head++;
+  }
+  
+  // Compact once the queue is mostly stale records
+  const int live = m_age_queue.GetSize() - m_age_head;
+  if (m_age_head > live || live > 2 * m_entries.GetSize() + 16) {
+    int next = 0;
+    for (int i = m_age_head; i < m_age_queue.GetSize(); i++) {
+      const sSlotRecord rec = m_age_queue[i];
+      if (m_slot_gen[rec.slot] == rec.gen && m_slot_bucket[rec.slot] != -1) m_age_queue[next++] = rec;
+    }
+    m_age_queue.Resize(next);
+    m_age_head = 0;
+  }
+  
+  return (m_age_head < m_age_queue.GetSize()) ? m_age_queue[m_age_head].slot : -1;
+}
+
+
+//Picks a uniformly random valid entry from the bucket with a single draw over the valid entries in slot order, the
+// same draw a scan of the chamber makes
+int cBirthMatingTypeGlobalHandler::selectRandom(cAvidaContext& ctx, sBucket& bucket)
+{
+  pruneBucket(bucket);
+  if (!bucket.slots.GetSize()) return -1;
+  return bucket.slots[ctx.GetRandom().GetUInt(bucket.slots.GetSize())];
+}
+
+//Compares every valid entry in the bucket in slot order, as with noisy assessment each comparison can come out
+// differently
+int cBirthMatingTypeGlobalHandler::selectAssessed(cAvidaContext& ctx, sBucket& bucket, int mate_choice_method)
+{
+  pruneBucket(bucket);
+  int selected_index = -1;
+  for (int i = 0; i < bucket.slots.GetSize(); i++) {
+    const int slot = bucket.slots[i];
+    if (selected_index == -1) selected_index = slot;
+    else selected_index = compareBirthEntries(ctx, mate_choice_method, m_entries[slot], m_entries[selected_index]) ? slot : selected_index;
+  }
+  return selected_index;
+}
+
+//Returns the best valid entry under the given preference, ties going to the lowest slot as with a scan of the chamber
+int cBirthMatingTypeGlobalHandler::selectRanked(sBucket& bucket, int mate_choice_method)
+{
+  assert(isRankedPreference(mate_choice_method));
+  const int ranking = mate_choice_method - MATE_PREFERENCE_HIGHEST_DISPLAY_A;
+  
+  Apto::Array<sRankRecord>& heap = bucket.rankings[ranking];
+  if (!bucket.ranked[ranking] || heap.GetSize() > 2 * bucket.slots.GetSize() + 16) buildRanking(bucket, ranking);
+  
+  while (heap.GetSize()) {
+    const sRankRecord& top = heap[0];
+    if (m_slot_gen[top.slot] == top.gen && validateSlot(top.slot)) return top.slot;
+    
+    heap.Swap(0, heap.GetSize() - 1);
+    heap.Pop();
+    heapSiftDown(heap, 0);
+  }
+  return -1;
+}
+
+double cBirthMatingTypeGlobalHandler::rankScore(int ranking, const cBirthEntry& entry) const
+{
+  switch (ranking + MATE_PREFERENCE_HIGHEST_DISPLAY_A) {
+    case MATE_PREFERENCE_HIGHEST_DISPLAY_A: return (double) entry.GetMatingDisplayA();
+    case MATE_PREFERENCE_HIGHEST_DISPLAY_B: return (double) entry.GetMatingDisplayB();
+    case MATE_PREFERENCE_HIGHEST_MERIT:     return entry.merit.GetDouble();
+    case MATE_PREFERENCE_LOWEST_DISPLAY_A:  return -(double) entry.GetMatingDisplayA();
+    case MATE_PREFERENCE_LOWEST_DISPLAY_B:  return -(double) entry.GetMatingDisplayB();
+    case MATE_PREFERENCE_LOWEST_MERIT:      return -entry.merit.GetDouble();
+  }
+  return 0.0;
+}
+
+void cBirthMatingTypeGlobalHandler::buildRanking(sBucket& bucket, int ranking)
+{
+  Apto::Array<sRankRecord>& heap = bucket.rankings[ranking];
+  heap.Resize(bucket.slots.GetSize());
+  for (int i = 0; i < bucket.slots.GetSize(); i++) {
+    const int slot = bucket.slots[i];
+    heap[i].score = rankScore(ranking, m_entries[slot]);
+    heap[i].slot = slot;
+    heap[i].gen = m_slot_gen[slot];
+  }
+  for (int i = heap.GetSize() / 2 - 1; i >= 0; i--) heapSiftDown(heap, i);
+  bucket.ranked[ranking] = true;
+}
+
 
 int cBirthMatingTypeGlobalHandler::getWaitingOffspringMostTask(int which_mating_type, int task_id)
 {
@@ -413,7 +658,7 @@ void cBirthMatingTypeGlobalHandler::PrintBirthChamber(const cString& filename)
   std::ofstream& df_stream = df->OFStream();
   
   for (int i = 0; i < m_entries.GetSize(); i++) {
-    if (m_bc->ValidateBirthEntry(m_entries[i])) {
+    if (validateSlot(i)) {
       df_stream << m_entries[i].GetPhenotypeString() << endl;
     }
   }
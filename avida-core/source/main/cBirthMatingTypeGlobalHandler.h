@@ -34,9 +34,46 @@ class cBirthChamber;
 class cBirthMatingTypeGlobalHandler : public cBirthSelectionHandler
 {
 private:
+  // Waiting entries are indexed by bucket: one bucket per mating type, or per mating type and group when MATE_IN_GROUPS
+  // is set.  Entries can leave the chamber unannounced (they expire, and the birth chamber clears the selected mate), so
+  // every index record carries the generation of its slot and is checked and validated when it is used.
+  enum { NUM_RANKINGS = 6 };  // MATE_PREFERENCE_HIGHEST_DISPLAY_A .. MATE_PREFERENCE_LOWEST_MERIT
+  
+  struct sSlotRecord
+  {
+    int slot;
+    int gen;
+  };
+  
+  struct sRankRecord
+  {
+    double score;  // higher is preferred
+    int slot;
+    int gen;
+  };
+  
+  struct sBucket
+  {
+    Apto::Array<int> slots;  // ascending
+    Apto::Array<sRankRecord> rankings[NUM_RANKINGS];  // binary heaps, built on first use by a choosy parent
+    bool ranked[NUM_RANKINGS];
+    
+    sBucket() { for (int i = 0; i < NUM_RANKINGS; i++) ranked[i] = false; }
+  };
+  
   cWorld* m_world;
   cBirthChamber* m_bc;
   Apto::Array<cBirthEntry> m_entries;
+  
+  Apto::Array<int> m_slot_gen;
+  Apto::Array<int> m_slot_bucket;     // bucket holding each slot, -1 if the slot is not indexed
+  Apto::Array<int> m_free_slots;      // heap of released slots, lowest first
+  Apto::Array<sSlotRecord> m_age_queue; // slots in the order they were stored, oldest first from m_age_head
+  int m_age_head;
+  
+  Apto::Array<sBucket*> m_buckets;
+  Apto::Map<int, int> m_bucket_ids;
+  bool m_bucket_by_group;
 
   int getTaskID(cString task_name, cWorld* world);
   void storeOffspring(cAvidaContext& ctx, const Genome& offspring, cOrganism* parent);
@@ -44,8 +81,31 @@ private:
   int getWaitingOffspringMostTask(int which_mating_type, int task_id);
   bool compareBirthEntries(cAvidaContext& ctx, int mate_choice_method, const cBirthEntry& entry1, const cBirthEntry& entry2);
   
+  int bucketKey(int mating_type, int group_id) const;
+  int bucketFor(int mating_type, int group_id, bool create);
+  void syncIndex();
+  void indexSlot(int slot);
+  void unindexSlot(int slot);
+  void releaseSlot(int slot);
+  void pushFreeSlot(int slot);
+  int popFreeSlot();
+  void releaseExpired();
+  void pruneBucket(sBucket& bucket);
+  bool validateSlot(int slot);
+  int acquireSlot();
+  int oldestSlot();
+  
+  int selectRandom(cAvidaContext& ctx, sBucket& bucket);
+  int selectAssessed(cAvidaContext& ctx, sBucket& bucket, int mate_choice_method);
+  static bool isRankedPreference(int mate_choice_method)
+    { return mate_choice_method >= MATE_PREFERENCE_HIGHEST_DISPLAY_A && mate_choice_method < MATE_PREFERENCE_HIGHEST_DISPLAY_A + NUM_RANKINGS; }
+  int selectRanked(sBucket& bucket, int mate_choice_method);
+  double rankScore(int ranking, const cBirthEntry& entry) const;
+  void buildRanking(sBucket& bucket, int ranking);
+  
 public:
-  cBirthMatingTypeGlobalHandler(cWorld* world, cBirthChamber* bc) : m_world(world), m_bc(bc) { ; }
+  cBirthMatingTypeGlobalHandler(cWorld* world, cBirthChamber* bc)
+    : m_world(world), m_bc(bc), m_age_head(0), m_bucket_by_group(false) { ; }
   ~cBirthMatingTypeGlobalHandler();
   
   cBirthEntry* SelectOffspring(cAvidaContext& ctx, const Genome& offspring, cOrganism* parent);
@@ -45,6 +45,7 @@
 cDeme::cDeme()
   : _id(0)
   , width(0)
+  , m_num_live(0)
   , replicateDeme(false)
   , treatable(false)
   , cur_birth_count(0)
@@ -105,6 +106,10 @@ cDeme& cDeme::operator=(const cDeme& in_deme)
   _id                                 = in_deme._id;
   cell_ids                            = in_deme.cell_ids;
   width                               = in_deme.width;
+  m_occupied                          = in_deme.m_occupied;
+  m_live_pos                          = in_deme.m_live_pos;
+  m_live_index                        = in_deme.m_live_index;
+  m_num_live                          = in_deme.m_num_live;
   replicateDeme                       = in_deme.replicateDeme;
   treatable                           = in_deme.treatable;
   treatment_ages                      = in_deme.treatment_ages;
@@ -195,6 +200,12 @@ void cDeme::Setup(int id, const Apto::Array<int> & in_cells, int in_width, cWorl
 {
   _id = id;
   cell_ids = in_cells;
+  m_occupied.ResizeClear((cell_ids.GetSize() + 31) / 32);
+  m_occupied.SetAll(0);
+  m_live_pos.ResizeClear(cell_ids.GetSize());
+  m_live_index.ResizeClear(cell_ids.GetSize());
+  m_live_index.SetAll(-1);
+  m_num_live = 0;
   cur_birth_count = 0;
   last_birth_count = 0;
   cur_org_count = 0;
@@ -302,12 +313,68 @@ cOrganism* cDeme::GetOrganism(int pos) const
   return GetCell(pos).GetOrganism();
 }
 
+
+void cDeme::CellOccupied(int cell_id)
+{
+  const int pos = GetRelativeCellID(cell_id);
+  assert(cell_ids[pos] == cell_id);
+  assert(m_live_index[pos] == -1);
+  
+  m_occupied[pos >> 5] |= (1u << (pos & 31));
+  m_live_index[pos] = m_num_live;
+  m_live_pos[m_num_live++] = pos;
+}
+
+
+void cDeme::CellVacated(int cell_id)
+{
+  const int pos = GetRelativeCellID(cell_id);
+  assert(cell_ids[pos] == cell_id);
+  assert(m_live_index[pos] != -1);
+  
+  m_occupied[pos >> 5] &= ~(1u << (pos & 31));
+  
+  // Fill the hole with the last live position
+  const int idx = m_live_index[pos];
+  const int last = m_live_pos[--m_num_live];
+  m_live_pos[idx] = last;
+  m_live_index[last] = idx;
+  m_live_index[pos] = -1;
+}
+
+
+// Index of the lowest set bit of a non-zero word
+static inline int lowestSetBit(unsigned int word)
+{
+  static const int debruijn_pos[32] = {
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8, 31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+  };
+  return debruijn_pos[((word & (0u - word)) * 0x077CB531u) >> 27];
+}
+
+// Positions whose bit differs from flip, i.e. occupied for flip == 0 and empty for flip == ~0
+int cDeme::nextPosition(int pos, unsigned int flip) const
+{
+  const int size = cell_ids.GetSize();
+  if (pos >= size) return size;
+  
+  int word = pos >> 5;
+  unsigned int bits = (m_occupied[word] ^ flip) & (~0u << (pos & 31));
+  while (bits == 0) {
+    if (++word >= m_occupied.GetSize()) return size;
+    bits = m_occupied[word] ^ flip;
+  }
+  
+  // Bits past the end of the last word read as empty
+  const int found = (word << 5) + lowestSetBit(bits);
+  return (found < size) ? found : size;
+}
+
 std::vector<int> cDeme::GetGenotypeIDs()
 {
   std::vector<int> genotype_ids;
-  for (int i = 0; i < GetSize(); i++) {
-    cPopulationCell& cell = GetCell(i);
-    if (cell.IsOccupied()) genotype_ids.push_back(cell.GetOrganism()->SystematicsGroup("genotype")->ID());
+  for (int pos = NextOccupiedPosition(0); pos < GetSize(); pos = NextOccupiedPosition(pos + 1)) {
+    genotype_ids.push_back(GetOrganism(pos)->SystematicsGroup("genotype")->ID());
   }
 
   //assert(genotype_ids.size()>0); // How did we get to replication otherwise?
@@ -320,13 +387,10 @@ std::vector<int> cDeme::GetGenotypeIDs()
 
 int cDeme::GetNumOrgsWithOpinion() const
 {
-  int demeSize = GetSize();
   int count = 0;
   
-  for (int pos = 0; pos < demeSize; ++pos) {
-    cPopulationCell& cell = GetCell(pos);
-    if (cell.IsOccupied() && cell.GetOrganism()->HasOpinion())
-      ++count;
+  for (int i = 0; i < m_num_live; ++i) {
+    if (GetOrganism(m_live_pos[i])->HasOpinion()) ++count;
   }
 
   return count;
@@ -354,11 +418,8 @@ void cDeme::ProcessUpdate(cAvidaContext& ctx)
   }
   
   if (m_world->GetConfig().ENERGY_ENABLED.Get()) {
-    for(int i = 0; i < GetSize(); i++) {
-      cPopulationCell& cell = GetCell(i);
-      if(cell.IsOccupied()) {
-        energyUsage.Add(cell.GetOrganism()->GetPhenotype().GetEnergyUsageRatio());
-      }
+    for (int pos = NextOccupiedPosition(0); pos < GetSize(); pos = NextOccupiedPosition(pos + 1)) {
+      energyUsage.Add(GetOrganism(pos)->GetPhenotype().GetEnergyUsageRatio());
     }
   }
   
@@ -616,15 +677,12 @@ void cDeme::UpdateGenerationsPerLifetime(double old_avg_founder_generation, Apto
   generations_per_lifetime = new_avg_founder_generation - old_avg_founder_generation;
 }
 
-/*! Check every cell in this deme for a living organism.  If found, kill it. */
+/*! Kill every living organism in this deme. */
 void cDeme::KillAll(cAvidaContext& ctx) 
 {
   last_org_count = GetOrgCount();
-  for (int i=0; i<GetSize(); ++i) {
-    cPopulationCell& cell = m_world->GetPopulation().GetCell(cell_ids[i]);
-    if(cell.IsOccupied()) {
-      m_world->GetPopulation().KillOrganism(cell, ctx); 
-    }
+  for (int pos = NextOccupiedPosition(0); pos < GetSize(); pos = NextOccupiedPosition(pos + 1)) {
+    m_world->GetPopulation().KillOrganism(GetCell(pos), ctx); 
   }
 
   // HACK: organism are killed after DivideReset is called.
@@ -637,37 +695,21 @@ void cDeme::UpdateStats()
   //save stats about what tasks our orgs were doing
   //usually called before KillAll
   
-  for (int j = 0; j < cur_org_task_count.GetSize(); j++) {
-    int count = 0;
-    for (int k=0; k<GetSize(); k++) {
-      int cellid = GetCellID(k);
-      if(m_world->GetPopulation().GetCell(cellid).IsOccupied()) {
-        count += (m_world->GetPopulation().GetCell(cellid).GetOrganism()->GetPhenotype().GetLastTaskCount()[j] > 0);
-      }
-      cur_org_task_count[j] = count; 
-    }
-  }
-  
-  for(int j = 0; j < cur_org_task_exe_count.GetSize(); j++) {
-    int count = 0;
-    for(int k=0; k<GetSize(); k++) {
-      int cellid = GetCellID(k);
-      if(m_world->GetPopulation().GetCell(cellid).IsOccupied()) {
-        count += m_world->GetPopulation().GetCell(cellid).GetOrganism()->GetPhenotype().GetLastTaskCount()[j];
-      }
-      cur_org_task_exe_count[j] = count; 
-    }
-  }
+  cur_org_task_count.SetAll(0);
+  cur_org_task_exe_count.SetAll(0);
+  cur_org_reaction_count.SetAll(0);
   
-  for(int j = 0; j < cur_org_reaction_count.GetSize(); j++) {
-    int count = 0;
-    for(int k=0; k<GetSize(); k++) {
-      int cellid = GetCellID(k);
-      if(m_world->GetPopulation().GetCell(cellid).IsOccupied()) {
-        count += m_world->GetPopulation().GetCell(cellid).GetOrganism()->GetPhenotype().GetLastReactionCount()[j];
-      }
-      cur_org_reaction_count[j] = count; 
+  // One pass over the living organisms, each adding into every count
+  for (int i = 0; i < m_num_live; i++) {
+    const cPhenotype& phenotype = GetOrganism(m_live_pos[i])->GetPhenotype();
+    const Apto::Array<int>& task_count = phenotype.GetLastTaskCount();
+    const Apto::Array<int>& reaction_count = phenotype.GetLastReactionCount();
+    
+    for (int j = 0; j < cur_org_task_count.GetSize(); j++) {
+      cur_org_task_count[j] += (task_count[j] > 0);
+      cur_org_task_exe_count[j] += task_count[j];
     }
+    for (int j = 0; j < cur_org_reaction_count.GetSize(); j++) cur_org_reaction_count[j] += reaction_count[j];
   }
 }
 
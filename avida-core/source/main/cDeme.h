@@ -57,6 +57,12 @@ private:
   Apto::Array<int> cell_ids;
   int width; //!< Width of this deme.
 
+  // Occupancy by position, kept current by cPopulationCell as organisms are inserted and removed
+  Apto::Array<unsigned int> m_occupied;     //!< One bit per position
+  Apto::Array<int> m_live_pos;              //!< Occupied positions, unordered; the first m_num_live are in use
+  Apto::Array<int> m_live_index;            //!< Index of each position within m_live_pos, -1 if unoccupied
+  int m_num_live;
+
   bool replicateDeme;
   bool treatable;
   std::set<int> treatment_ages;
@@ -160,6 +166,17 @@ public:
   cPopulationCell& GetCell(int x, int y) const;
   cOrganism* GetOrganism(int pos) const;
   
+  // -= Occupancy =-
+  void CellOccupied(int cell_id);
+  void CellVacated(int cell_id);
+  bool IsOccupied(int pos) const { return ((m_occupied[pos >> 5] >> (pos & 31)) & 1) != 0; }
+  //! First occupied (empty) position at or after pos, or GetSize() if there is none.  Scans 32 positions at a time.
+  int NextOccupiedPosition(int pos) const { return nextPosition(pos, 0); }
+  int NextEmptyPosition(int pos) const { return nextPosition(pos, ~0u); }
+  //! Occupied positions, in no particular order.
+  int GetNumLiveCells() const { return m_num_live; }
+  int GetLiveCellPosition(int i) const { return m_live_pos[i]; }
+  
   std::vector<int> GetGenotypeIDs();
 
   int GetWidth() const { return width; }
@@ -443,7 +460,7 @@ private:
   int m_num_active; // number of active organisms in the lifetime of the deme
   int m_num_reproductives; // number of organisms that reproduced during the lifetime of the deme
 	
-	
+  int nextPosition(int pos, unsigned int flip) const;
 };
 
 #endif
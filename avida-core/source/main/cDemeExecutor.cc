@@ -0,0 +1,304 @@
+/*
+ *  cDemeExecutor.cc
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cDemeExecutor.h"
+
+#include "apto/rng.h"
+#include "apto/scheduler.h"
+
+#include "cAvidaContext.h"
+#include "cDeme.h"
+#include "cHardwareBase.h"
+#include "cOrganism.h"
+#include "cPhenotype.h"
+#include "cPhiloxRandom.h"
+#include "cPopulation.h"
+#include "cPopulationCell.h"
+#include "cStats.h"
+#include "cWorld.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+class cDemeExecutor::cWorker : public Apto::Thread
+{
+private:
+  cDemeExecutor* m_exec;
+
+  void Run();
+
+public:
+  cWorker(cDemeExecutor* exec) : m_exec(exec) { ; }
+};
+
+
+void cDemeExecutor::cWorker::Run()
+{
+  int round = 0;
+  while (1) {
+    m_exec->m_mutex.Lock();
+    while (!m_exec->m_shutdown && round == m_exec->m_round) m_exec->m_start_cond.Wait(m_exec->m_mutex);
+    round = m_exec->m_round;
+    bool shutdown = m_exec->m_shutdown;
+    m_exec->m_mutex.Unlock();
+
+    if (shutdown) break;
+
+    m_exec->runDemes();
+  }
+}
+
+
+// Orders demes by descending remainder, lower deme id first on ties
+class cRemainderOrder
+{
+private:
+  const Apto::Array<double>& m_remainder;
+
+public:
+  cRemainderOrder(const Apto::Array<double>& remainder) : m_remainder(remainder) { ; }
+  bool operator()(int a, int b) const
+  {
+    if (m_remainder[a] != m_remainder[b]) return m_remainder[a] > m_remainder[b];
+    return a < b;
+  }
+};
+
+
+cDemeExecutor::cDemeExecutor(cWorld* world, cPopulation* pop, int num_threads)
+  : m_world(world), m_pop(pop), m_slicing_method(world->GetConfig().SLICING_METHOD.Get())
+  , m_demes(pop->GetNumDemes()), m_priority(pop->GetSize()), m_held(pop->GetSize())
+  , m_round(0), m_next_deme(0), m_running(0), m_shutdown(false)
+{
+  m_priority.SetAll(0.0);
+  m_held.SetAll(false);
+
+  for (int deme_id = 0; deme_id < m_demes.GetSize(); deme_id++) {
+    sDemeState& state = m_demes[deme_id];
+    const int deme_size = pop->GetDeme(deme_id).GetSize();
+
+    // Scheduler stream 0 belongs to the population scheduler
+    Apto::SmartPtr<Apto::Random> sched_rng(world->NewRandomStream(RANDOM_STREAM_SCHEDULER, deme_id + 1));
+    switch (m_slicing_method) {
+      case SLICE_CONSTANT:              state.scheduler = new Apto::Scheduler::RoundRobin(deme_size); break;
+      case SLICE_INTEGRATED_MERIT:      state.scheduler = new Apto::Scheduler::Integrated(deme_size); break;
+      case SLICE_PROB_MERIT:            state.scheduler = new Apto::Scheduler::Probabilistic(deme_size, sched_rng); break;
+      case SLICE_PROB_INTEGRATED_MERIT: state.scheduler = new Apto::Scheduler::ProbabilisticIntegrated(deme_size, sched_rng); break;
+      default: assert(false); break;
+    }
+
+    state.rng = Apto::SmartPtr<Apto::Random>(world->NewRandomStream(RANDOM_STREAM_DEME, deme_id));
+  }
+
+  // The calling thread works through demes as well, so it counts toward num_threads
+  if (num_threads > m_demes.GetSize()) num_threads = m_demes.GetSize();
+  if (num_threads > 1) {
+    m_workers.Resize(num_threads - 1);
+    for (int i = 0; i < m_workers.GetSize(); i++) m_workers[i] = new cWorker(this);
+    for (int i = 0; i < m_workers.GetSize(); i++) m_workers[i]->Start();
+  }
+}
+
+
+cDemeExecutor::~cDemeExecutor()
+{
+  m_mutex.Lock();
+  m_shutdown = true;
+  m_start_cond.Broadcast();
+  m_mutex.Unlock();
+
+  for (int i = 0; i < m_workers.GetSize(); i++) {
+    m_workers[i]->Join();
+    delete m_workers[i];
+  }
+
+  for (int i = 0; i < m_demes.GetSize(); i++) {
+    delete m_demes[i].scheduler;
+    delete m_demes[i].ctx;
+  }
+}
+
+
+void cDemeExecutor::AdjustPriority(int cell_id, double priority)
+{
+  m_priority[cell_id] = priority;
+
+  cDeme& deme = m_pop->GetDeme(m_pop->GetCell(cell_id).GetDemeID());
+  m_demes[deme.GetID()].scheduler->AdjustPriority(deme.GetRelativeCellID(cell_id), priority);
+}
+
+
+void cDemeExecutor::ProcessUpdate(cAvidaContext& ctx, int update_size, double step_size)
+{
+  for (int i = 0; i < m_demes.GetSize(); i++) {
+    if (!m_demes[i].ctx) m_demes[i].ctx = new cAvidaContext(&ctx.Driver(), *m_demes[i].rng);
+  }
+
+  assignBudgets(update_size);
+
+  while (1) {
+    bool active = false;
+    for (int i = 0; i < m_demes.GetSize() && !active; i++) active = (m_demes[i].budget > 0);
+    if (!active) break;
+
+    runRound();
+    processBarrier(step_size);
+  }
+}
+
+
+void cDemeExecutor::assignBudgets(int update_size)
+{
+  const int num_demes = m_demes.GetSize();
+
+  // Shares are fixed for the update; each deme's weight is its organism count under constant slicing, otherwise the
+  // summed priority of its cells
+  Apto::Array<double> weight(num_demes);
+  double total = 0.0;
+  for (int deme_id = 0; deme_id < num_demes; deme_id++) {
+    cDeme& deme = m_pop->GetDeme(deme_id);
+    double deme_weight = 0.0;
+    for (int i = 0; i < deme.GetSize(); i++) {
+      const double priority = m_priority[deme.GetCellID(i)];
+      if (priority > 0.0) deme_weight += (m_slicing_method == SLICE_CONSTANT) ? 1.0 : priority;
+    }
+    weight[deme_id] = deme_weight;
+    total += deme_weight;
+  }
+
+  for (int deme_id = 0; deme_id < num_demes; deme_id++) m_demes[deme_id].budget = 0;
+  if (total <= 0.0) return;
+
+  // Largest remainder apportionment, so that the budgets sum to exactly update_size
+  Apto::Array<double> remainder(num_demes);
+  Apto::Array<int> order(num_demes);
+  int assigned = 0;
+  for (int deme_id = 0; deme_id < num_demes; deme_id++) {
+    const double exact = update_size * (weight[deme_id] / total);
+    const int budget = (int)floor(exact);
+    m_demes[deme_id].budget = budget;
+    remainder[deme_id] = exact - budget;
+    order[deme_id] = deme_id;
+    assigned += budget;
+  }
+
+  std::sort(&order[0], &order[0] + num_demes, cRemainderOrder(remainder));
+  for (int i = 0; i < num_demes && assigned < update_size; i++, assigned++) m_demes[order[i]].budget++;
+}
+
+
+void cDemeExecutor::runRound()
+{
+  m_mutex.Lock();
+  m_next_deme = 0;
+  m_running = m_workers.GetSize() + 1;
+  m_round++;
+  m_start_cond.Broadcast();
+  m_mutex.Unlock();
+
+  runDemes();
+
+  m_mutex.Lock();
+  while (m_running) m_done_cond.Wait(m_mutex);
+  m_mutex.Unlock();
+}
+
+
+void cDemeExecutor::runDemes()
+{
+  while (1) {
+    m_mutex.Lock();
+    const int deme_id = m_next_deme++;
+    m_mutex.Unlock();
+
+    if (deme_id >= m_demes.GetSize()) break;
+    runDeme(deme_id);
+  }
+
+  m_mutex.Lock();
+  if (--m_running == 0) m_done_cond.Broadcast();
+  m_mutex.Unlock();
+}
+
+
+void cDemeExecutor::runDeme(int deme_id)
+{
+  sDemeState& state = m_demes[deme_id];
+  cDeme& deme = m_pop->GetDeme(deme_id);
+
+  state.executed = 0;
+  while (state.budget > 0) {
+    const int pos = state.scheduler->Next();
+    if (pos < 0) {
+      // No living organisms; the rest of the deme's share goes unused
+      state.budget = 0;
+      break;
+    }
+
+    const int cell_id = deme.GetCellID(pos);
+    state.budget--;
+
+    // Nothing further can happen in this cell before the barrier
+    if (m_held[cell_id]) {
+      state.held.Push(cell_id);
+      break;
+    }
+
+    // Tracers may be shared between organisms, so traced slices always run at the barrier
+    cPopulationCell& cell = m_pop->GetCell(cell_id);
+    if (cell.GetHardware()->IsTraced() || !cell.GetHardware()->SingleProcess(*state.ctx, true)) {
+      m_held[cell_id] = true;
+      state.held.Push(cell_id);
+      continue;
+    }
+
+    state.executed++;
+    deme.IncTimeUsed(cell.GetOrganism()->GetPhenotype().GetMerit().GetDouble());
+    if (m_pop->ImplicitDemeReproDue(deme)) break;
+  }
+}
+
+
+void cDemeExecutor::processBarrier(double step_size)
+{
+  // Resources are advanced by the whole round before any held slice reads them
+  int round_slices = 0;
+  for (int i = 0; i < m_demes.GetSize(); i++) round_slices += m_demes[i].executed + m_demes[i].held.GetSize();
+  const double round_time = step_size * round_slices;
+  m_pop->GetResourceCount().Update(round_time);
+  for (int i = 0; i < m_demes.GetSize(); i++) m_pop->GetDeme(i).Update(round_time);
+
+  int executed = 0;
+  for (int deme_id = 0; deme_id < m_demes.GetSize(); deme_id++) {
+    sDemeState& state = m_demes[deme_id];
+    executed += state.executed;
+
+    m_pop->CheckImplicitDemeRepro(m_pop->GetDeme(deme_id), *state.ctx);
+    for (int i = 0; i < state.held.GetSize(); i++) {
+      m_held[state.held[i]] = false;
+      if (m_pop->ProcessDeferredStep(*state.ctx, state.held[i])) executed++;
+    }
+    state.held.Resize(0);
+  }
+
+  m_world->GetStats().AddExecuted(executed);
+}
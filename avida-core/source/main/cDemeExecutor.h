@@ -0,0 +1,100 @@
+/*
+ *  cDemeExecutor.h
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cDemeExecutor_h
+#define cDemeExecutor_h
+
+#include "apto/core.h"
+#include "apto/core/Thread.h"
+
+class cAvidaContext;
+class cPopulation;
+class cWorld;
+
+
+// cDemeExecutor     : Runs the time slices of isolated demes concurrently
+//
+// Each deme has its own scheduler over its cells and its own random streams, and is given a share of the update's
+// slices in proportion to its priority at the start of the update.  An update proceeds in rounds.  In the concurrent
+// phase of a round every deme executes its organisms speculatively, so only instructions that cannot affect anything
+// outside the organism run there.  A slice that would stall (divide, I/O, resource access, death) is held back, and the
+// deme stops once the scheduler draws a cell that is already held or once deme replication is due.  At the barrier the
+// held slices are executed normally, deme by deme, followed by deme replication checks and the resource clocks for the
+// round.  Results depend only on the seed, never on the number of threads.
+
+class cDemeExecutor
+{
+private:
+  class cWorker;
+  friend class cWorker;
+
+  struct sDemeState {
+    Apto::PriorityScheduler* scheduler;       // Over the deme's cells, by position within the deme
+    Apto::SmartPtr<Apto::Random> rng;
+    cAvidaContext* ctx;                       // Built on first use, once a driver is attached to the world
+    int budget;                               // Slices left to the deme in this update
+    int executed;                             // Slices executed concurrently in this round
+    Apto::Array<int, Apto::Smart> held;       // Cells whose slices wait for the barrier, in draw order
+
+    sDemeState() : scheduler(NULL), ctx(NULL), budget(0), executed(0) { ; }
+  };
+
+  cWorld* m_world;
+  cPopulation* m_pop;
+  int m_slicing_method;
+
+  Apto::Array<sDemeState> m_demes;
+  Apto::Array<double> m_priority;             // Current priority of each cell, mirrored from the population scheduler
+  Apto::Array<bool> m_held;                   // Cell has a slice waiting for the barrier
+
+  Apto::Array<cWorker*> m_workers;
+  Apto::Mutex m_mutex;
+  Apto::ConditionVariable m_start_cond;
+  Apto::ConditionVariable m_done_cond;
+  volatile int m_round;
+  volatile int m_next_deme;
+  volatile int m_running;
+  volatile bool m_shutdown;
+
+
+  cDemeExecutor(); // @not_implemented
+  cDemeExecutor(const cDemeExecutor&); // @not_implemented
+  cDemeExecutor& operator=(const cDemeExecutor&); // @not_implemented
+
+public:
+  cDemeExecutor(cWorld* world, cPopulation* pop, int num_threads);
+  ~cDemeExecutor();
+
+  int GetNumThreads() const { return m_workers.GetSize() + 1; }
+
+  void AdjustPriority(int cell_id, double priority);
+
+  // Execute update_size slices, split across the demes
+  void ProcessUpdate(cAvidaContext& ctx, int update_size, double step_size);
+
+private:
+  void assignBudgets(int update_size);
+  void runRound();
+  void runDemes();
+  void runDeme(int deme_id);
+  void processBarrier(double step_size);
+};
+
+#endif
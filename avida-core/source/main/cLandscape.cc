@@ -24,6 +24,8 @@
 
 #include "avida/output/File.h"
 
+#include "cAnalyze.h"
+#include "cAnalyzeJobQueue.h"
 #include "cCPUMemory.h"
 #include "cEnvironment.h"
 #include "cInstSet.h"
@@ -33,17 +35,40 @@
 #include "cStats.h"             // For GetUpdate in outputs...
 #include "cTestCPU.h"
 #include "cWorld.h"
+#include "tAnalyzeJobBatch.h"
 
 
 cLandscape::cLandscape(cWorld* world, const Genome& in_genome)
 : m_world(world), trials(1), m_min_found(0), m_max_trials(0), site_count(NULL)
+, m_chunk_mode(CHUNK_POINT), m_chunk_start(0), m_chunk_end(0), m_chunk_sites(true)
+, m_base_trace(NULL), m_trace(NULL)
 {
   Reset(in_genome);
 }
 
+cLandscape::cLandscape(const cLandscape& parent, eChunkMode mode, int start, int end, bool count_sites)
+: m_world(parent.m_world), m_cpu_test_info(parent.m_cpu_test_info), trials(1), m_min_found(0), m_max_trials(0)
+, site_count(NULL), m_chunk_mode(mode), m_chunk_start(start), m_chunk_end(end), m_chunk_sites(count_sites)
+, m_base_trace(NULL), m_trace(NULL)
+{
+  Reset(parent.base_genome);
+  m_trace = parent.m_trace;
+  
+  // Chunks share the base creature information collected by the parent
+  distance = parent.distance;
+  base_fitness = parent.base_fitness;
+  base_merit = parent.base_merit;
+  base_gestation = parent.base_gestation;
+  peak_fitness = parent.peak_fitness;
+  neut_min = parent.neut_min;
+  neut_max = parent.neut_max;
+  if (mode == CHUNK_CHART || mode == CHUNK_PAIRS) fitness_chart = parent.fitness_chart;
+}
+
 cLandscape::~cLandscape()
 {
   if (site_count != NULL) delete [] site_count;
+  delete m_base_trace;
 }
 
 void cLandscape::Reset(const Genome& in_genome)
@@ -92,11 +117,17 @@ void cLandscape::Reset(const Genome& in_genome)
   neut_max = 0.0;
   
   m_num_found = 0;
+  
+  delete m_base_trace;
+  m_base_trace = NULL;
+  m_trace = NULL;
 }
 
-double cLandscape::ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome& in_genome)
+// When mut_site is given, in_genome must differ from the base genome only at that site
+double cLandscape::ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome& in_genome, int mut_site)
 {
-  testcpu->TestGenome(ctx, m_cpu_test_info, in_genome);
+  if (m_trace && mut_site >= 0) testcpu->TestMutant(ctx, m_cpu_test_info, in_genome, mut_site, *m_trace);
+  else testcpu->TestGenome(ctx, m_cpu_test_info, in_genome);
   
   double test_fitness = m_cpu_test_info.GetColonyFitness();
   
@@ -124,9 +155,14 @@ double cLandscape::ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome&
 
 void cLandscape::ProcessBase(cAvidaContext& ctx, cTestCPU* testcpu)
 {
-  // Collect info on base creature.
-  
-  testcpu->TestGenome(ctx, m_cpu_test_info, base_genome);
+  // Collect info on base creature, recording checkpoints for the single-step mutants that follow.
+  if (m_world->GetConfig().RESUME_LANDSCAPE_MUTANTS.Get()) {
+    if (!m_base_trace) m_base_trace = new cTestCPUTrace;
+    testcpu->TraceGenome(ctx, m_cpu_test_info, base_genome, *m_base_trace);
+    m_trace = m_base_trace;
+  } else {
+    testcpu->TestGenome(ctx, m_cpu_test_info, base_genome);
+  }
   
   cPhenotype & phenotype = m_cpu_test_info.GetColonyOrganism()->GetPhenotype();
   base_fitness = m_cpu_test_info.GetColonyFitness();
@@ -149,13 +185,18 @@ void cLandscape::Process(cAvidaContext& ctx)
   ProcessBase(ctx, testcpu);
   
   // Now Process the new creature at the proper distance.
-  Process_Body(ctx, testcpu, base_genome, distance, 0);
+  ConstInstructionSequencePtr seq_p;
+  seq_p.DynamicCastFrom(base_genome.Representation());
+  const int genome_size = seq_p->GetSize();
+  if (!ProcessChunks(ctx, CHUNK_POINT, genome_size - distance + 1)) {
+    Process_Body(ctx, testcpu, base_genome, distance, 0, genome_size);
+  }
 
   delete testcpu;
   
   // Calculate the complexity...
   
-  double max_ent = log((double) m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize());
+  double max_ent = log((double) m_world->GetHardwareManager().GetInstSet(base_genome).GetSize());
   total_entropy = 0;
   ConstInstructionSequencePtr base_seq_p;
   GeneticRepresentationPtr rep_p = base_genome.Representation();
@@ -168,21 +209,21 @@ void cLandscape::Process(cAvidaContext& ctx)
   }
   complexity = base_seq.GetSize() - total_entropy;
   
-  m_num_found = base_seq.GetSize() * (m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize() - 1);
+  m_num_found = base_seq.GetSize() * (m_world->GetHardwareManager().GetInstSet(base_genome).GetSize() - 1);
 }
 
 
 // For distances greater than one, this needs to be called recursively.
 
 void cLandscape::Process_Body(cAvidaContext& ctx, cTestCPU* testcpu, Genome& cur_genome,
-                              int cur_distance, int start_line)
+                              int cur_distance, int start_line, int end_line)
 {
   ConstInstructionSequencePtr base_seq_p;
   GeneticRepresentationPtr rep_p = base_genome.Representation();
   base_seq_p.DynamicCastFrom(rep_p);
   const InstructionSequence& base_seq = *base_seq_p;
-  const int max_line = base_seq.GetSize() - cur_distance + 1;
-  const int inst_size = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
+  const int max_line = Apto::Min(end_line, base_seq.GetSize() - cur_distance + 1);
+  const int inst_size = m_world->GetHardwareManager().GetInstSet(base_genome).GetSize();
   
   Genome mg(cur_genome);
   InstructionSequencePtr mod_seq_p;
@@ -200,10 +241,10 @@ void cLandscape::Process_Body(cAvidaContext& ctx, cTestCPU* testcpu, Genome& cur
       
       mod_genome[line_num].SetOp(inst_num);
       if (cur_distance <= 1) {
-        ProcessGenome(ctx, testcpu, mg);
+        ProcessGenome(ctx, testcpu, mg, (cur_distance == distance) ? line_num : -1);
         if (m_cpu_test_info.GetColonyFitness() >= neut_min) site_count[line_num]++;
       } else {
-        Process_Body(ctx, testcpu, mg, cur_distance - 1, line_num + 1);
+        Process_Body(ctx, testcpu, mg, cur_distance - 1, line_num + 1, base_seq.GetSize());
       }
     }
     
@@ -228,7 +269,7 @@ void cLandscape::ProcessDump(cAvidaContext& ctx, Avida::Output::File& df)
   base_seq_p.DynamicCastFrom(rep_p);
   const InstructionSequence& base_seq = *base_seq_p;
   const int max_line = base_seq.GetSize();
-  const int inst_size = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
+  const int inst_size = m_world->GetHardwareManager().GetInstSet(base_genome).GetSize();
   
   Genome mg(base_genome);
   InstructionSequencePtr mod_seq_p;
@@ -248,7 +289,7 @@ void cLandscape::ProcessDump(cAvidaContext& ctx, Avida::Output::File& df)
         fitness = base_fitness;
       } else {
         mod_genome[line_num].SetOp(inst_num);
-        fitness = ProcessGenome(ctx, testcpu, mg);
+        fitness = ProcessGenome(ctx, testcpu, mg, line_num);
       }
       df.Write(fitness, "Mutation Fitness (instruction = column_number - 2)");
     }
@@ -268,11 +309,22 @@ void cLandscape::ProcessDelete(cAvidaContext& ctx)
 
   // Get the info about the base creature.
   ProcessBase(ctx, testcpu);
+  ConstInstructionSequencePtr base_seq_p;
+  GeneticRepresentationPtr rep_p = base_genome.Representation();
+  base_seq_p.DynamicCastFrom(rep_p);
+  const int max_line = base_seq_p->GetSize();
+
+  if (!ProcessChunks(ctx, CHUNK_DELETE, max_line)) ProcessDeleteRange(ctx, testcpu, 0, max_line, true);
+  
+  delete testcpu;
+}
+
+void cLandscape::ProcessDeleteRange(cAvidaContext& ctx, cTestCPU* testcpu, int start_line, int end_line, bool count_sites)
+{
   ConstInstructionSequencePtr base_seq_p;
   GeneticRepresentationPtr rep_p = base_genome.Representation();
   base_seq_p.DynamicCastFrom(rep_p);
   const InstructionSequence& base_seq = *base_seq_p;
-  const int max_line = base_seq.GetSize();
 
   Genome mg(base_genome);
   InstructionSequencePtr mod_seq_p;
@@ -281,17 +333,15 @@ void cLandscape::ProcessDelete(cAvidaContext& ctx)
   InstructionSequence& mod_seq = *mod_seq_p;
   cCPUMemory mod_genome = mod_seq;
   
-  // Loop through all the lines of genome, testing all deletions.
-  for (int line_num = 0; line_num < max_line; line_num++) {
+  // Loop through the lines of genome in range, testing all deletions.
+  for (int line_num = start_line; line_num < end_line; line_num++) {
     int cur_inst = base_seq[line_num].GetOp();
     mod_genome.Remove(line_num);
     mod_seq = mod_genome;
     ProcessGenome(ctx, testcpu, mg);
-    if (m_cpu_test_info.GetColonyFitness() >= neut_min) site_count[line_num]++;
+    if (count_sites && m_cpu_test_info.GetColonyFitness() >= neut_min) site_count[line_num]++;
     mod_genome.Insert(line_num, Instruction(cur_inst));
   }
-  
-  delete testcpu;
 }
 
 void cLandscape::ProcessInsert(cAvidaContext& ctx)
@@ -303,9 +353,16 @@ void cLandscape::ProcessInsert(cAvidaContext& ctx)
   ConstInstructionSequencePtr base_seq_p;
   GeneticRepresentationPtr rep_p = base_genome.Representation();
   base_seq_p.DynamicCastFrom(rep_p);
-  const InstructionSequence& base_seq = *base_seq_p;
-  const int max_line = base_seq.GetSize();
-  const int inst_size = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
+  const int max_line = base_seq_p->GetSize();
+  
+  if (!ProcessChunks(ctx, CHUNK_INSERT, max_line + 1)) ProcessInsertRange(ctx, testcpu, 0, max_line + 1, true);
+
+  delete testcpu;
+}
+
+void cLandscape::ProcessInsertRange(cAvidaContext& ctx, cTestCPU* testcpu, int start_line, int end_line, bool count_sites)
+{
+  const int inst_size = m_world->GetHardwareManager().GetInstSet(base_genome).GetSize();
   
   Genome mg(base_genome);
   InstructionSequencePtr mod_seq_p;
@@ -314,19 +371,17 @@ void cLandscape::ProcessInsert(cAvidaContext& ctx)
   InstructionSequence& mod_seq = *mod_seq_p;
   cCPUMemory mod_genome = mod_seq;
   
-  // Loop through all the lines of genome, testing all insertions.
-  for (int line_num = 0; line_num <= max_line; line_num++) {
+  // Loop through the lines of genome in range, testing all insertions.
+  for (int line_num = start_line; line_num < end_line; line_num++) {
     // Loop through all instructions...
     for (int inst_num = 0; inst_num < inst_size; inst_num++) {
       mod_genome.Insert(line_num, Instruction(inst_num));
       mod_seq = mod_genome;
       ProcessGenome(ctx, testcpu, mg);
-      if (m_cpu_test_info.GetColonyFitness() >= neut_min) site_count[line_num]++;
+      if (count_sites && m_cpu_test_info.GetColonyFitness() >= neut_min) site_count[line_num]++;
       mod_genome.Remove(line_num);
     }
   }
-
-  delete testcpu;
 }
 
 // Prediction for a landscape where n sites are _randomized_.
@@ -437,7 +492,7 @@ void cLandscape::PredictWProcess(cAvidaContext& ctx, Avida::Output::File& df, in
   
   // Calculate the complexity...
   
-  double max_ent = log(static_cast<double>(m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize()));
+  double max_ent = log(static_cast<double>(m_world->GetHardwareManager().GetInstSet(base_genome).GetSize()));
   total_entropy = 0;
   ConstInstructionSequencePtr base_seq_p;
   GeneticRepresentationPtr rep_p = base_genome.Representation();
@@ -584,7 +639,7 @@ void cLandscape::PredictNuProcess(cAvidaContext& ctx, Avida::Output::File& df, i
   
   // Calculate the complexity...
   
-  double max_ent = log(static_cast<double>(m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize()));
+  double max_ent = log(static_cast<double>(m_world->GetHardwareManager().GetInstSet(base_genome).GetSize()));
   total_entropy = 0;
   ConstInstructionSequencePtr base_seq_p;
   GeneticRepresentationPtr rep_p = base_genome.Representation();
@@ -616,7 +671,7 @@ void cLandscape::SampleProcess(cAvidaContext& ctx)
   int genome_size = base_seq.GetSize();
 
   cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
-  cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
+  cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome);
   
   ProcessBase(ctx, testcpu);
   
@@ -659,7 +714,7 @@ void cLandscape::RandomProcess(cAvidaContext& ctx)
   int genome_size = base_seq.GetSize();
   
   cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
-  cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
+  cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome);
   ProcessBase(ctx, testcpu);
   
   // Set to default number of trials if trials has not been specified
@@ -712,18 +767,28 @@ void cLandscape::BuildFitnessChart(cAvidaContext& ctx, cTestCPU* testcpu)
   ConstInstructionSequencePtr base_seq_p;
   GeneticRepresentationPtr rep_p = base_genome.Representation();
   base_seq_p.DynamicCastFrom(rep_p);
-  const InstructionSequence& base_seq = *base_seq_p;
-  const int max_line = base_seq.GetSize();
-  const int inst_size = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
+  const int max_line = base_seq_p->GetSize();
+  const int inst_size = m_world->GetHardwareManager().GetInstSet(base_genome).GetSize();
   fitness_chart.ResizeClear(max_line, inst_size);
   
+  if (!ProcessChunks(ctx, CHUNK_CHART, max_line)) BuildFitnessChartRange(ctx, testcpu, 0, max_line);
+}
+
+void cLandscape::BuildFitnessChartRange(cAvidaContext& ctx, cTestCPU* testcpu, int start_line, int end_line)
+{
+  ConstInstructionSequencePtr base_seq_p;
+  GeneticRepresentationPtr rep_p = base_genome.Representation();
+  base_seq_p.DynamicCastFrom(rep_p);
+  const InstructionSequence& base_seq = *base_seq_p;
+  const int inst_size = fitness_chart.GetNumCols();
+  
   Genome mod_genome(base_genome);
   InstructionSequencePtr mod_seq_p;
   mod_seq_p.DynamicCastFrom(mod_genome.Representation());
   InstructionSequence& mod_seq = *mod_seq_p;
   
-  // Loop through all the lines of genome, testing trying all combinations.
-  for (int line_num = 0; line_num < max_line; line_num++) {
+  // Loop through the lines of genome in range, testing trying all combinations.
+  for (int line_num = start_line; line_num < end_line; line_num++) {
     int cur_inst = base_seq[line_num].GetOp();
     
     // Loop through all instructions...
@@ -734,7 +799,7 @@ void cLandscape::BuildFitnessChart(cAvidaContext& ctx, cTestCPU* testcpu)
       }
       
       mod_seq[line_num].SetOp(inst_num);
-      ProcessGenome(ctx, testcpu, mod_genome);
+      ProcessGenome(ctx, testcpu, mod_genome, line_num);
       fitness_chart(line_num, inst_num) = m_cpu_test_info.GetColonyFitness();
     }
     
@@ -745,7 +810,7 @@ void cLandscape::BuildFitnessChart(cAvidaContext& ctx, cTestCPU* testcpu)
 void cLandscape::TestPairs(cAvidaContext& ctx)
 {
   cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
-  cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue());
+  cInstSet& inst_set = m_world->GetHardwareManager().GetInstSet(base_genome);
   
   ProcessBase(ctx, testcpu);
   if (base_fitness == 0.0) return;
@@ -794,17 +859,29 @@ void cLandscape::TestAllPairs(cAvidaContext& ctx)
   
   BuildFitnessChart(ctx, testcpu);
   
+  ConstInstructionSequencePtr base_seq_p;
+  GeneticRepresentationPtr rep_p = base_genome.Representation();
+  base_seq_p.DynamicCastFrom(rep_p);
+  const int max_line = base_seq_p->GetSize();
+  
+  if (!ProcessChunks(ctx, CHUNK_PAIRS, max_line - 1)) TestAllPairsRange(ctx, testcpu, 0, max_line - 1);
+  
+  delete testcpu;
+}
+
+void cLandscape::TestAllPairsRange(cAvidaContext& ctx, cTestCPU* testcpu, int start_line, int end_line)
+{
   ConstInstructionSequencePtr base_seq_p;
   GeneticRepresentationPtr rep_p = base_genome.Representation();
   base_seq_p.DynamicCastFrom(rep_p);
   const InstructionSequence& base_seq = *base_seq_p;
   const int max_line = base_seq.GetSize();
-  const int inst_size = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
+  const int inst_size = m_world->GetHardwareManager().GetInstSet(base_genome).GetSize();
   Genome mod_genome(base_genome);
   Instruction inst1, inst2;
   
-  // Loop through all the lines of genome, testing trying all combinations.
-  for (int line1_num = 0; line1_num < max_line - 1; line1_num++) {
+  // Loop through the first lines in range, testing trying all combinations.
+  for (int line1_num = start_line; line1_num < end_line; line1_num++) {
     for (int line2_num = line1_num + 1; line2_num < max_line; line2_num++) {
       
       // Loop through all instructions...
@@ -820,8 +897,6 @@ void cLandscape::TestAllPairs(cAvidaContext& ctx)
       
     } // line2_num loop
   } // line1_num loop.
-  
-  delete testcpu;
 }
 
 
@@ -829,16 +904,9 @@ void cLandscape::HillClimb(cAvidaContext& ctx, Avida::Output::File& df)
 {
   cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
   Genome cur_genome(base_genome);
-  Genome mg(base_genome);
-  InstructionSequencePtr mg_seq_p;
-  GeneticRepresentationPtr mg_rep_p = mg.Representation();
-  mg_seq_p.DynamicCastFrom(mg_rep_p);
-  InstructionSequence& mg_seq = *mg_seq_p;
-  cCPUMemory mod_genome = mg_seq;
 
   int gen = 0;
   
-  const int inst_size = m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize();
   double pos_frac = 1.0;
   
   distance = 1;
@@ -859,27 +927,10 @@ void cLandscape::HillClimb(cAvidaContext& ctx, Avida::Output::File& df)
     Process(ctx);
     
     // Try Insertion Mutations.
-    
-    mod_genome = cur_seq;
-    for (int line_num = 0; line_num <= max_line; line_num++) {
-      // Loop through all instructions...
-      for (int inst_num = 0; inst_num < inst_size; inst_num++) {
-        mod_genome.Insert(line_num, Instruction(inst_num));
-        mg_seq = mod_genome;
-        ProcessGenome(ctx, testcpu, mg);
-        mod_genome.Remove(line_num);
-      }
-    }
+    if (!ProcessChunks(ctx, CHUNK_INSERT, max_line + 1, false)) ProcessInsertRange(ctx, testcpu, 0, max_line + 1, false);
     
     // Try all deletion mutations.
-    
-    for (int line_num = 0; line_num < max_line; line_num++) {
-      int cur_inst = cur_seq[line_num].GetOp();
-      mod_genome.Remove(line_num);
-      mg_seq = mod_genome;
-      ProcessGenome(ctx, testcpu, mg);
-      mod_genome.Insert(line_num, Instruction(cur_inst));
-    }
+    if (!ProcessChunks(ctx, CHUNK_DELETE, max_line, false)) ProcessDeleteRange(ctx, testcpu, 0, max_line, false);
     
     pos_frac = GetProbPos();
     
@@ -906,6 +957,99 @@ void cLandscape::HillClimb(cAvidaContext& ctx, Avida::Output::File& df)
 }
 
 
+bool cLandscape::ProcessChunks(cAvidaContext& ctx, eChunkMode mode, int num_sites, bool count_sites)
+{
+  cAnalyzeJobQueue& jobqueue = m_world->GetAnalyze().GetJobQueue();
+  const int num_workers = jobqueue.GetNumWorkers();
+  if (num_workers == 0 || num_sites < 2) return false;
+  
+  // Over-partition the sites so that uneven chunk costs (e.g. early sites in multi-step landscapes) balance out
+  const int num_chunks = Apto::Min(num_sites, num_workers * 4);
+  Apto::Array<cLandscape*> chunks(num_chunks);
+  tAnalyzeJobBatch<cLandscape> jobbatch(jobqueue, ctx);
+  for (int i = 0; i < num_chunks; i++) {
+    const int start = (num_sites * i) / num_chunks;
+    const int end = (num_sites * (i + 1)) / num_chunks;
+    chunks[i] = new cLandscape(*this, mode, start, end, count_sites);
+    jobbatch.AddJob(chunks[i], &cLandscape::ProcessChunk);
+  }
+  jobbatch.RunBatch();
+  
+  // Reduce in site order, so that peak selection matches sequential processing
+  for (int i = 0; i < num_chunks; i++) {
+    MergeChunk(*chunks[i]);
+    delete chunks[i];
+  }
+  
+  return true;
+}
+
+void cLandscape::ProcessChunk(cAvidaContext& ctx)
+{
+  cTestCPU* testcpu = m_world->GetHardwareManager().CreateTestCPU(ctx);
+  
+  switch (m_chunk_mode) {
+    case CHUNK_POINT:
+      Process_Body(ctx, testcpu, base_genome, distance, m_chunk_start, m_chunk_end);
+      break;
+    case CHUNK_INSERT:
+      ProcessInsertRange(ctx, testcpu, m_chunk_start, m_chunk_end, m_chunk_sites);
+      break;
+    case CHUNK_DELETE:
+      ProcessDeleteRange(ctx, testcpu, m_chunk_start, m_chunk_end, m_chunk_sites);
+      break;
+    case CHUNK_CHART:
+      BuildFitnessChartRange(ctx, testcpu, m_chunk_start, m_chunk_end);
+      break;
+    case CHUNK_PAIRS:
+      TestAllPairsRange(ctx, testcpu, m_chunk_start, m_chunk_end);
+      break;
+  }
+  
+  delete testcpu;
+}
+
+void cLandscape::MergeChunk(const cLandscape& chunk)
+{
+  total_fitness += chunk.total_fitness;
+  total_sqr_fitness += chunk.total_sqr_fitness;
+  
+  total_count += chunk.total_count;
+  dead_count += chunk.dead_count;
+  neg_count += chunk.neg_count;
+  neut_count += chunk.neut_count;
+  pos_count += chunk.pos_count;
+  pos_size += chunk.pos_size;
+  neg_size += chunk.neg_size;
+  
+  total_epi_count += chunk.total_epi_count;
+  pos_epi_count += chunk.pos_epi_count;
+  neg_epi_count += chunk.neg_epi_count;
+  no_epi_count += chunk.no_epi_count;
+  dead_epi_count += chunk.dead_epi_count;
+  pos_epi_size += chunk.pos_epi_size;
+  neg_epi_size += chunk.neg_epi_size;
+  no_epi_size += chunk.no_epi_size;
+  
+  if (chunk.peak_fitness > peak_fitness) {
+    peak_fitness = chunk.peak_fitness;
+    peak_genome = chunk.peak_genome;
+  }
+  
+  ConstInstructionSequencePtr base_seq_p;
+  base_seq_p.DynamicCastFrom(base_genome.Representation());
+  for (int i = 0; i <= base_seq_p->GetSize(); i++) site_count[i] += chunk.site_count[i];
+  
+  if (chunk.m_chunk_mode == CHUNK_CHART) {
+    for (int line_num = chunk.m_chunk_start; line_num < chunk.m_chunk_end; line_num++) {
+      for (int inst_num = 0; inst_num < fitness_chart.GetNumCols(); inst_num++) {
+        fitness_chart(line_num, inst_num) = chunk.fitness_chart(line_num, inst_num);
+      }
+    }
+  }
+}
+
+
 double cLandscape::TestMutPair(cAvidaContext& ctx, cTestCPU* testcpu, Genome& mod_genome, int line1, int line2,
                                const Instruction& mut1, const Instruction& mut2)
 {
@@ -982,7 +1126,7 @@ void cLandscape::PrintStats(Avida::Output::File& df, int update)
 void cLandscape::PrintEntropy(Avida::Output::File& df)
 {
   df.WriteComment("Entropy Data");
-  double max_ent = log(static_cast<double>(m_world->GetHardwareManager().GetInstSet(base_genome.Properties().Get("instset").StringValue()).GetSize()));
+  double max_ent = log(static_cast<double>(m_world->GetHardwareManager().GetInstSet(base_genome).GetSize()));
   ConstInstructionSequencePtr base_seq_p;
   GeneticRepresentationPtr rep_p = base_genome.Representation();
   base_seq_p.DynamicCastFrom(rep_p);
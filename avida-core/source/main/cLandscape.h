@@ -33,6 +33,7 @@
 class cAvidaContext;
 class cInstSet;
 class cTestCPU;
+class cTestCPUTrace;
 class cWorld;
 
 using namespace Avida;
@@ -88,8 +89,20 @@ private:
   tMatrix<double> fitness_chart; // Chart of all one-step mutations.
   
   int m_num_found;
+  
+  // Site-range chunk processing state, used by chunk instances executing on the analyze job queue
+  enum eChunkMode { CHUNK_POINT, CHUNK_INSERT, CHUNK_DELETE, CHUNK_CHART, CHUNK_PAIRS };
+  eChunkMode m_chunk_mode;
+  int m_chunk_start;
+  int m_chunk_end;
+  bool m_chunk_sites;      // whether insert/delete chunks should record neutral site counts
+  
+  // Checkpoints of the base genome's test run, used to resume single-site mutants (shared read-only with chunks)
+  cTestCPUTrace* m_base_trace;
+  const cTestCPUTrace* m_trace;
 
 
+  cLandscape(const cLandscape& parent, eChunkMode mode, int start, int end, bool count_sites);
   cLandscape(); // @not_implemented
   cLandscape(const cLandscape&); // @not_implemented
   cLandscape& operator=(const cLandscape&); // @not_implemented
@@ -168,9 +181,18 @@ public:
   
 private:
   void BuildFitnessChart(cAvidaContext& ctx, cTestCPU* testcpu);
-  double ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome& in_genome);
+  double ProcessGenome(cAvidaContext& ctx, cTestCPU* testcpu, Genome& in_genome, int mut_site = -1);
   void ProcessBase(cAvidaContext& ctx, cTestCPU* testcpu);
-  void Process_Body(cAvidaContext& ctx, cTestCPU* testcpu, Genome& cur_genome, int cur_distance, int start_line);
+  void Process_Body(cAvidaContext& ctx, cTestCPU* testcpu, Genome& cur_genome, int cur_distance, int start_line,
+                    int end_line);
+  void ProcessInsertRange(cAvidaContext& ctx, cTestCPU* testcpu, int start_line, int end_line, bool count_sites);
+  void ProcessDeleteRange(cAvidaContext& ctx, cTestCPU* testcpu, int start_line, int end_line, bool count_sites);
+  void BuildFitnessChartRange(cAvidaContext& ctx, cTestCPU* testcpu, int start_line, int end_line);
+  void TestAllPairsRange(cAvidaContext& ctx, cTestCPU* testcpu, int start_line, int end_line);
+  
+  bool ProcessChunks(cAvidaContext& ctx, eChunkMode mode, int num_sites, bool count_sites = true);
+  void ProcessChunk(cAvidaContext& ctx);
+  void MergeChunk(const cLandscape& chunk);
   
   double TestMutPair(cAvidaContext& ctx, cTestCPU* testcpu, Genome& mod_genome, int line1, int line2,
                      const Instruction& mut1, const Instruction& mut2);  
@@ -25,6 +25,9 @@
 #include "cWorld.h"
 #include "cAvidaConfig.h"
 
+#include <climits>
+#include <cmath>
+
 
 void cMutationRates::Setup(cWorld* world)
 {
@@ -73,6 +76,9 @@ void cMutationRates::Setup(cWorld* world)
   meta.standard_dev = world->GetConfig().META_STD_DEV.Get();
 
   update.death_prob = world->GetConfig().DEATH_PROB.Get();  
+  
+  m_skip_sampling = world->GetConfig().MUTATION_SKIP_SAMPLING.Get();
+  resetCopySkip();
 }
 
 void cMutationRates::Clear()
@@ -122,6 +128,9 @@ void cMutationRates::Clear()
   meta.standard_dev = 0.0;
 
   update.death_prob = 0.0;
+  
+  m_skip_sampling = false;
+  resetCopySkip();
 }
 
 void cMutationRates::Copy(const cMutationRates& in_muts)
@@ -132,4 +141,17 @@ void cMutationRates::Copy(const cMutationRates& in_muts)
   inject = in_muts.inject;
   meta = in_muts.meta;
   update = in_muts.update;
+  
+  // Each holder of the rates draws its own countdowns
+  m_skip_sampling = in_muts.m_skip_sampling;
+  resetCopySkip();
+}
+
+int cMutationRates::DrawSkip(cAvidaContext& ctx, double prob)
+{
+  if (prob >= 1.0) return 0;
+  
+  // Inversion of the geometric distribution; GetDouble() lies in [0, 1).  log1p keeps small rates from rounding away.
+  const double skip = floor(log1p(-ctx.GetRandom().GetDouble()) / log1p(-prob));
+  return (skip < (double)INT_MAX) ? (int)skip : INT_MAX;
 }
@@ -41,6 +41,18 @@ private:
     double slip_prob;
   };
   sCopyMuts copy;
+  
+  // ...copy mutation skip sampling (MUTATION_SKIP_SAMPLING), copies left before the next mutation of each class...
+  struct sCopySkip {
+    int left;               // Copies that will pass before the next mutation
+    double prob;            // Rate the countdown was drawn for, redrawn whenever the rate changes
+  };
+  bool m_skip_sampling;
+  mutable sCopySkip m_skip_mut;
+  mutable sCopySkip m_skip_ins;
+  mutable sCopySkip m_skip_del;
+  mutable sCopySkip m_skip_uniform;
+  mutable sCopySkip m_skip_slip;
 
   // ...at the divide...
   struct sDivideMuts {
@@ -98,6 +110,10 @@ private:
   };
   sUpdateMuts update;
 
+  
+  inline void resetCopySkip();
+  inline bool testCopySkip(cAvidaContext& ctx, double prob, sCopySkip& skip) const;
+  
 public:
   cMutationRates() { Clear(); }
   cMutationRates(const cMutationRates& in_muts) { Copy(in_muts); }
@@ -108,14 +124,34 @@ public:
   void Clear();
   void Copy(const cMutationRates& in_muts);
 
+  // Number of independent trials of probability prob that fail before the next success (geometrically distributed)
+  static int DrawSkip(cAvidaContext& ctx, double prob);
+  
   // Copy muts should always check if they are 0.0 before consulting the random number generator for performance
-  bool TestCopyMut(cAvidaContext& ctx) const { return (copy.mut_prob == 0.0) ? false : ctx.GetRandom().P(copy.mut_prob); }
-  bool TestCopyIns(cAvidaContext& ctx) const { return (copy.ins_prob == 0.0) ? false : ctx.GetRandom().P(copy.ins_prob); }
-  bool TestCopyDel(cAvidaContext& ctx) const { return (copy.del_prob == 0.0) ? false : ctx.GetRandom().P(copy.del_prob); }
-  bool TestCopySlip(cAvidaContext& ctx) const { return (copy.slip_prob == 0.0) ? false : ctx.GetRandom().P(copy.slip_prob); }
+  bool TestCopyMut(cAvidaContext& ctx) const
+  {
+    if (copy.mut_prob == 0.0) return false;
+    return (m_skip_sampling) ? testCopySkip(ctx, copy.mut_prob, m_skip_mut) : ctx.GetRandom().P(copy.mut_prob);
+  }
+  bool TestCopyIns(cAvidaContext& ctx) const
+  {
+    if (copy.ins_prob == 0.0) return false;
+    return (m_skip_sampling) ? testCopySkip(ctx, copy.ins_prob, m_skip_ins) : ctx.GetRandom().P(copy.ins_prob);
+  }
+  bool TestCopyDel(cAvidaContext& ctx) const
+  {
+    if (copy.del_prob == 0.0) return false;
+    return (m_skip_sampling) ? testCopySkip(ctx, copy.del_prob, m_skip_del) : ctx.GetRandom().P(copy.del_prob);
+  }
+  bool TestCopySlip(cAvidaContext& ctx) const
+  {
+    if (copy.slip_prob == 0.0) return false;
+    return (m_skip_sampling) ? testCopySkip(ctx, copy.slip_prob, m_skip_slip) : ctx.GetRandom().P(copy.slip_prob);
+  }
   bool TestCopyUniform(cAvidaContext& ctx) const
   {
-    return (copy.uniform_prob == 0.0) ? false : ctx.GetRandom().P(copy.uniform_prob);
+    if (copy.uniform_prob == 0.0) return false;
+    return (m_skip_sampling) ? testCopySkip(ctx, copy.uniform_prob, m_skip_uniform) : ctx.GetRandom().P(copy.uniform_prob);
   }
   
   bool TestDivideMut(cAvidaContext& ctx) const { return ctx.GetRandom().P(divide.divide_mut_prob); }
@@ -239,6 +275,31 @@ public:
   void SetMetaStandardDev(double in_dev)    { meta.standard_dev     = in_dev; }
 
   void SetDeathProb(double in_prob)         { update.death_prob      = in_prob; }
+  
+  void SetSkipSampling(bool in_skip)        { m_skip_sampling = in_skip; resetCopySkip(); }
+  bool GetSkipSampling() const              { return m_skip_sampling; }
 };
 
+
+inline void cMutationRates::resetCopySkip()
+{
+  m_skip_mut.left = m_skip_ins.left = m_skip_del.left = m_skip_uniform.left = m_skip_slip.left = 0;
+  m_skip_mut.prob = m_skip_ins.prob = m_skip_del.prob = m_skip_uniform.prob = m_skip_slip.prob = -1.0;
+}
+
+inline bool cMutationRates::testCopySkip(cAvidaContext& ctx, double prob, sCopySkip& skip) const
+{
+  // The geometric distribution is memoryless, so a countdown may be redrawn at any time without changing the rate
+  if (skip.prob != prob) {
+    skip.left = DrawSkip(ctx, prob);
+    skip.prob = prob;
+  }
+  if (skip.left > 0) {
+    skip.left--;
+    return false;
+  }
+  skip.left = DrawSkip(ctx, prob);
+  return true;
+}
+
 #endif
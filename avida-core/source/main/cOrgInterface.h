@@ -192,7 +192,6 @@ public:
   virtual double CalcGroupOddsOffspring(int group_id) = 0;
   virtual bool AttemptImmigrateGroup(cAvidaContext& ctx, int group_id, cOrganism* org) = 0;
   virtual void PushToleranceInstExe(int tol_inst, cAvidaContext& ctx) = 0; 
-  virtual int& GetGroupIntolerances(int group_id, int tol_num, int mating_type) = 0;
   
   virtual void TryWriteGroupAttackBits(unsigned char raw_bits) = 0;
   virtual void TryWriteGroupAttackString(cString& string) = 0;
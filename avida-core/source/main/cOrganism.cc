@@ -145,9 +145,53 @@ void cOrganism::Initialize()
 // Creation Policies
 // --------------------------------------------------------------------------------------------------------------
 
+cOrganism::sExecState::sExecState(cWorld* world)
+  : input_pointer(0)
+  , input_buf(world->GetEnvironment().GetInputSize())
+  , output_buf(world->GetEnvironment().GetOutputSize())
+  , received_messages(RECEIVED_MESSAGES_SIZE)
+  , cur_sg(0)
+  , sent_value(0)
+  , sent_active(false)
+  , test_receive_pos(0)
+  , gradient_movement(0.0)
+  , pher_drop(false)
+  , frac_energy_donating(world->GetConfig().ENERGY_SHARING_PCT.Get())
+  , max_executed(-1)
+  , is_sleeping(false)
+  , is_dead(false)
+  , killed_event(false)
+  , self_raw_materials(world->GetConfig().RAW_MATERIAL_AMOUNT.Get())
+  , other_raw_materials(0)
+  , num_donate(0)
+  , num_donate_received(0)
+  , amount_donate_received(0)
+  , num_reciprocate(0)
+  , k(0)
+  , failed_reputation_increases(0)
+  , tag(make_pair(-1, 0))
+  , northerly(0)
+  , easterly(0)
+  , forage_target(-1)
+  , show_ft(-1)
+  , has_set_ft(false)
+  , teach(false)
+  , beggar(false)
+  , para_donate(world->GetConfig().PARASITE_VIRULENCE.Get())
+  , guard(false)
+  , num_guard(0)
+  , num_deposits(0)
+  , amount_deposited(0)
+  , num_point_mut(0)
+  , repair(false)
+  , av_in_index(-1)
+  , av_out_index(-1)
+{
+}
+
 cOrganism::cOrganism(cWorld* world, cAvidaContext& ctx, const Genome& genome, int parent_generation, Systematics::Source src)
   : m_world(world)
-  , m_phenotype(world, parent_generation, world->GetHardwareManager().GetInstSet(genome.Properties().Get(s_ext_prop_name_instset).StringValue()).GetNumNops())
+  , m_phenotype(world, parent_generation, world->GetHardwareManager().GetInstSet(genome).GetNumNops())
   , m_src(src)
   , m_initial_genome(genome)
   , m_interface(NULL)
@@ -158,52 +202,16 @@ cOrganism::cOrganism(cWorld* world, cAvidaContext& ctx, const Genome& genome, in
   , m_queued_display_data(NULL)
   , m_display(false)
   , m_lyse_display(false)
-  , m_input_pointer(0)
-  , m_input_buf(world->GetEnvironment().GetInputSize())
-  , m_output_buf(world->GetEnvironment().GetOutputSize())
-  , m_received_messages(RECEIVED_MESSAGES_SIZE)
-  , m_cur_sg(0)
-  , m_sent_value(0)
-  , m_sent_active(false)
-  , m_test_receive_pos(0)
-  , m_pher_drop(false)
-  , frac_energy_donating(m_world->GetConfig().ENERGY_SHARING_PCT.Get())
-  , m_max_executed(-1)
+  , m_state(world)
   , m_is_running(false)
-  , m_is_sleeping(false)
-  , m_is_dead(false)
-  , killed_event(false)
   , m_msg(0)
   , m_opinion(0)
   , m_neighborhood(0)
-  , m_self_raw_materials(world->GetConfig().RAW_MATERIAL_AMOUNT.Get())
-  , m_other_raw_materials(0)
-  , m_num_donate(0)
-  , m_num_donate_received(0)
-  , m_amount_donate_received(0)
-  , m_num_reciprocate(0)
-  , m_failed_reputation_increases(0)
-  , m_tag(make_pair(-1, 0))
-  , m_northerly(0)
-  , m_easterly(0)
-  , m_forage_target(-1)
-  , m_show_ft(-1)
-  , m_has_set_ft(false)
-  , m_teach(false)
   , m_parent_teacher(false)
   , m_parent_ft(-1)
   , m_parent_group(world->GetConfig().DEFAULT_GROUP.Get())
   , m_p_merit(0)
-  , m_beggar(false)
-  , m_para_donate(world->GetConfig().PARASITE_VIRULENCE.Get())
-  , m_guard(false)
-  , m_num_guard(0)
-  , m_num_deposits(0)
-  , m_amount_deposited(0)
   , m_string_map(NULL)
-  , m_num_point_mut(0)
-  , m_av_in_index(-1)
-  , m_av_out_index(-1)
   , m_prop_map(this)
 {
 	// initializing this here because it may be needed during hardware creation:
@@ -216,32 +224,32 @@ cOrganism::cOrganism(cWorld* world, cAvidaContext& ctx, const Genome& genome, in
 
 void cOrganism::initialize(cAvidaContext& ctx)
 {
-  m_phenotype.SetInstSetSize(m_hardware->GetInstSet().GetSize());
+  m_phenotype.SetInstSetSize(m_hardware->GetInstSet().GetSize(), m_hardware->GetType() == HARDWARE_TYPE_CPU_EXPERIMENTAL);
   const_cast<Genome&>(m_initial_genome).Properties().SetValue(s_ext_prop_name_instset,(const char*)m_hardware->GetInstSet().GetInstSetName());
   m_phenotype.SetGroupAttackInstSetSize(m_world->GetStats().GetGroupAttackInsts(m_hardware->GetInstSet().GetInstSetName()).GetSize());
   
   if (m_world->GetConfig().DEATH_METHOD.Get() > DEATH_METHOD_OFF) {
-    m_max_executed = m_world->GetConfig().AGE_LIMIT.Get();
+    m_state.max_executed = m_world->GetConfig().AGE_LIMIT.Get();
     if (m_world->GetConfig().AGE_DEVIATION.Get() > 0.0) {
-      m_max_executed += (int) (ctx.GetRandom().GetRandNormal() * m_world->GetConfig().AGE_DEVIATION.Get());
+      m_state.max_executed += (int) (ctx.GetRandom().GetRandNormal() * m_world->GetConfig().AGE_DEVIATION.Get());
     }
     if (m_world->GetConfig().DEATH_METHOD.Get() == DEATH_METHOD_MULTIPLE) {
       ConstInstructionSequencePtr seq;
       seq.DynamicCastFrom(m_initial_genome.Representation());
-      m_max_executed *= seq->GetSize();
+      m_state.max_executed *= seq->GetSize();
     }
     
-    // m_max_executed must be positive or an organism will not die!
-    if (m_max_executed < 1) m_max_executed = 1;
+    // m_state.max_executed must be positive or an organism will not die!
+    if (m_state.max_executed < 1) m_state.max_executed = 1;
   }
   
-  m_repair = (m_world->GetConfig().POINT_MUT_REPAIR_START.Get());
+  m_state.repair = (m_world->GetConfig().POINT_MUT_REPAIR_START.Get());
   
 	// randomize the amout of raw materials an organism has at its 
 	// disposal.
 	if (m_world->GetConfig().RANDOMIZE_RAW_MATERIAL_AMOUNT.Get()) {
 		int raw_mat = m_world->GetConfig().RAW_MATERIAL_AMOUNT.Get();
-		m_self_raw_materials = ctx.GetRandom().GetUInt(0, raw_mat+1);
+		m_state.self_raw_materials = ctx.GetRandom().GetUInt(0, raw_mat+1);
 	}
 }
 
@@ -270,7 +278,7 @@ void cOrganism::SetOrgInterface(cAvidaContext& ctx, cOrgInterface* org_interface
   HardwareReset(ctx);
 }
 
-const cStateGrid& cOrganism::GetStateGrid() const { return m_world->GetEnvironment().GetStateGrid(m_cur_sg); }
+const cStateGrid& cOrganism::GetStateGrid() const { return m_world->GetEnvironment().GetStateGrid(m_state.cur_sg); }
 
 double cOrganism::GetVitality() const {
   double mean_age = m_world->GetStats().SumCreatureAge().Ave();
@@ -367,7 +375,7 @@ int cOrganism::ReceiveValue()
 
 void cOrganism::DoInput(const int value)
 {
-  DoInput(m_input_buf, m_output_buf, value);
+  DoInput(m_state.input_buf, m_state.output_buf, value);
 }
 
 void cOrganism::DoInput(tBuffer<int>& input_buffer, tBuffer<int>& output_buffer, const int value)
@@ -378,22 +386,22 @@ void cOrganism::DoInput(tBuffer<int>& input_buffer, tBuffer<int>& output_buffer,
 
 void cOrganism::DoOutput(cAvidaContext& ctx, const bool on_divide, cContextPhenotype* context_phenotype)
 {
-  if (m_world->GetConfig().USE_AVATARS.Get()) doAVOutput(ctx, m_input_buf, m_output_buf, on_divide, false, context_phenotype);
-  else doOutput(ctx, m_input_buf, m_output_buf, on_divide, false, context_phenotype);
+  if (m_world->GetConfig().USE_AVATARS.Get()) doAVOutput(ctx, m_state.input_buf, m_state.output_buf, on_divide, false, context_phenotype);
+  else doOutput(ctx, m_state.input_buf, m_state.output_buf, on_divide, false, context_phenotype);
 }
 
 void cOrganism::DoOutput(cAvidaContext& ctx, const int value)
 {
-  m_output_buf.Add(value);
-  if (m_world->GetConfig().USE_AVATARS.Get()) doAVOutput(ctx, m_input_buf, m_output_buf, false, false);
-  else doOutput(ctx, m_input_buf, m_output_buf, false, false);
+  m_state.output_buf.Add(value);
+  if (m_world->GetConfig().USE_AVATARS.Get()) doAVOutput(ctx, m_state.input_buf, m_state.output_buf, false, false);
+  else doOutput(ctx, m_state.input_buf, m_state.output_buf, false, false);
 }
 
 void cOrganism::DoOutput(cAvidaContext& ctx, const int value, bool is_parasite, cContextPhenotype* context_phenotype) 
 {
-  m_output_buf.Add(value);
-  if (m_world->GetConfig().USE_AVATARS.Get()) doAVOutput(ctx, m_input_buf, m_output_buf, false, (bool)is_parasite, context_phenotype); 
-  else doOutput(ctx, m_input_buf, m_output_buf, false, (bool)is_parasite, context_phenotype); 
+  m_state.output_buf.Add(value);
+  if (m_world->GetConfig().USE_AVATARS.Get()) doAVOutput(ctx, m_state.input_buf, m_state.output_buf, false, (bool)is_parasite, context_phenotype); 
+  else doOutput(ctx, m_state.input_buf, m_state.output_buf, false, (bool)is_parasite, context_phenotype); 
 }
 
 void cOrganism::DoOutput(cAvidaContext& ctx, tBuffer<int>& input_buffer, tBuffer<int>& output_buffer, const int value)
@@ -427,7 +435,7 @@ void cOrganism::doOutput(cAvidaContext& ctx,
       cOrganism * cur_neighbor = m_interface->GetNeighbor();
       if (cur_neighbor == NULL) continue;
       
-      other_input_list.Push( &(cur_neighbor->m_input_buf) );
+      other_input_list.Push( &(cur_neighbor->m_state.input_buf) );
     }
   }
   
@@ -439,7 +447,7 @@ void cOrganism::doOutput(cAvidaContext& ctx,
       cOrganism * cur_neighbor = m_interface->GetNeighbor();
       if (cur_neighbor == NULL) continue;
       
-      other_output_list.Push( &(cur_neighbor->m_output_buf) );
+      other_output_list.Push( &(cur_neighbor->m_state.output_buf) );
     }
   }
   
@@ -452,7 +460,7 @@ void cOrganism::doOutput(cAvidaContext& ctx,
   deme_res_change.SetAll(0.0);
   Apto::Array<cString> insts_triggered;
   
-  tBuffer<int>* received_messages_point = &m_received_messages;
+  tBuffer<int>* received_messages_point = &m_state.received_messages;
   if (!m_world->GetConfig().SAVE_RECEIVED.Get()) received_messages_point = NULL;
   
   cTaskContext taskctx(this, input_buffer, output_buffer, other_input_list, other_output_list,
@@ -543,7 +551,7 @@ void cOrganism::doAVOutput(cAvidaContext& ctx,
       const Apto::Array<cOrganism*>& cur_neighbors = m_interface->GetFacedAVs();
       for (int i = 0; i < cur_neighbors.GetSize(); i++) {
         if (cur_neighbors[i] == NULL) continue;
-        other_input_list.Push( &(cur_neighbors[i]->m_input_buf) );
+        other_input_list.Push( &(cur_neighbors[i]->m_state.input_buf) );
       }
     }
   }
@@ -556,7 +564,7 @@ void cOrganism::doAVOutput(cAvidaContext& ctx,
       const Apto::Array<cOrganism*>& cur_neighbors = m_interface->GetFacedAVs();
       for (int i = 0; i < cur_neighbors.GetSize(); i++) {
         if (cur_neighbors[i] == NULL) continue;
-        other_output_list.Push( &(cur_neighbors[i]->m_output_buf) );
+        other_output_list.Push( &(cur_neighbors[i]->m_state.output_buf) );
       }
     }
   }
@@ -570,7 +578,7 @@ void cOrganism::doAVOutput(cAvidaContext& ctx,
 
   Apto::Array<cString> insts_triggered;
   
-  tBuffer<int>* received_messages_point = &m_received_messages;
+  tBuffer<int>* received_messages_point = &m_state.received_messages;
   if (!m_world->GetConfig().SAVE_RECEIVED.Get()) received_messages_point = NULL;
   
   cTaskContext taskctx(this, input_buffer, output_buffer, other_input_list, other_output_list,
@@ -636,7 +644,7 @@ void cOrganism::HardwareReset(cAvidaContext& ctx)
 {
   if (m_world->GetEnvironment().GetNumStateGrids() > 0 && m_interface) {
     // Select random state grid in the environment
-    m_cur_sg = m_interface->GetStateGridID(ctx);
+    m_state.cur_sg = m_interface->GetStateGridID(ctx);
     
     const cStateGrid& sg = GetStateGrid();
     
@@ -663,8 +671,8 @@ void cOrganism::HardwareReset(cAvidaContext& ctx)
 void cOrganism::NotifyDeath(cAvidaContext& ctx)
 {
   // Update Sleeping State
-  if (m_is_sleeping) {
-    m_is_sleeping = false;
+  if (m_state.is_sleeping) {
+    m_state.is_sleeping = false;
     GetDeme()->DecSleepingCount();
   }
   
@@ -738,7 +746,7 @@ void cOrganism::PrintStatus(ostream& fp)
   fp << setbase(16) << setfill('0');
   
   fp << "Input (env):";
-  for (int i = 0; i < m_input_buf.GetCapacity(); i++) {
+  for (int i = 0; i < m_state.input_buf.GetCapacity(); i++) {
     int j = i; // temp holder, because GetInputAt self adjusts the input pointer
     fp << " 0x" << setw(8) << m_interface->GetInputAt(j);
   }
@@ -795,7 +803,7 @@ bool cOrganism::Divide_CheckViable(cAvidaContext& ctx)
   if (m_world->GetConfig().REQUIRED_PRED_HABITAT.Get() != -1 || m_world->GetConfig().REQUIRED_PREY_HABITAT.Get() != -1) {
     int habitat_required = -1;
     double required_value = 0;
-    if (m_forage_target <= -2) {
+    if (m_state.forage_target <= -2) {
       habitat_required = m_world->GetConfig().REQUIRED_PRED_HABITAT.Get();
       required_value = m_world->GetConfig().REQUIRED_PRED_HABITAT_VALUE.Get();
     }
@@ -961,9 +969,29 @@ void cOrganism::NewTrial()
 {
   //More should be reset here... @JEB
   GetPhenotype().NewTrial();
-  m_input_pointer = 0;
-  m_input_buf.Clear();
-  m_output_buf.Clear();
+  m_state.input_pointer = 0;
+  m_state.input_buf.Clear();
+  m_state.output_buf.Clear();
+}
+
+
+bool cOrganism::SaveCheckpoint(sCheckpoint& checkpoint) const
+{
+  // State held outside of the organism proper (or in lazily-allocated structures) cannot be captured
+  if (m_msg || m_opinion || m_neighborhood || m_string_map || m_parasites.GetSize()) return false;
+  if (donor_list.size() || donating_lineages.size()) return false;
+  
+  checkpoint.phenotype = m_phenotype;
+  checkpoint.offspring_genome = m_offspring_genome;
+  checkpoint.state = m_state;
+  return true;
+}
+
+void cOrganism::RestoreCheckpoint(const sCheckpoint& checkpoint)
+{
+  m_phenotype = checkpoint.phenotype;
+  m_offspring_genome = checkpoint.offspring_genome;
+  m_state = checkpoint.state;
 }
 
 
@@ -1081,7 +1109,7 @@ std::pair<bool, cOrgMessage> cOrganism::RetrieveMessage() {
 bool cOrganism::Move(cAvidaContext& ctx)
 {
   assert(m_interface);
-  if (m_is_dead) return false;  
+  if (m_state.is_dead) return false;  
   /*********************/
   // TEMP.  Remove once movement tasks are implemented.
   if (GetCellData() < GetFacedCellData()) { // move up gradient
@@ -1103,25 +1131,25 @@ bool cOrganism::Move(cAvidaContext& ctx)
     //Keep track of successful movement E/W and N/S in support of get-easterly and get-northerly for navigation
     //Skip counting if random < chance of miscounting a step.
     if (m_world->GetConfig().STEP_COUNTING_ERROR.Get()==0 || ctx.GetRandom().GetInt(0,101) > m_world->GetConfig().STEP_COUNTING_ERROR.Get()) {
-      if (facing == 0) m_northerly = m_northerly - 1;       // N
+      if (facing == 0) m_state.northerly = m_state.northerly - 1;       // N
       else if (facing == 1) {                           // NE
-        m_northerly = m_northerly - 1; 
-        m_easterly = m_easterly + 1;
+        m_state.northerly = m_state.northerly - 1; 
+        m_state.easterly = m_state.easterly + 1;
       }  
-      else if (facing == 2) m_easterly = m_easterly + 1;    // E
+      else if (facing == 2) m_state.easterly = m_state.easterly + 1;    // E
       else if (facing == 3) {                           // SE
-        m_northerly = m_northerly + 1; 
-        m_easterly = m_easterly + 1;
+        m_state.northerly = m_state.northerly + 1; 
+        m_state.easterly = m_state.easterly + 1;
       }
-      else if (facing == 4) m_northerly = m_northerly + 1;  // S
+      else if (facing == 4) m_state.northerly = m_state.northerly + 1;  // S
       else if (facing == 5) {                           // SW
-        m_northerly = m_northerly + 1; 
-        m_easterly = m_easterly - 1;
+        m_state.northerly = m_state.northerly + 1; 
+        m_state.easterly = m_state.easterly - 1;
       }
-      else if (facing == 6) m_easterly = m_easterly - 1;    // W    
+      else if (facing == 6) m_state.easterly = m_state.easterly - 1;    // W    
       else if (facing == 7) {                           // NW
-        m_northerly = m_northerly - 1; 
-        m_easterly = m_easterly - 1;
+        m_state.northerly = m_state.northerly - 1; 
+        m_state.easterly = m_state.easterly - 1;
       }      
     }
   }
@@ -1235,35 +1263,35 @@ void cOrganism::SetForageTarget(cAvidaContext& ctx, int forage_target, bool inje
   // if using avatars, make sure you swap avatar lists if the org type changes!
   if (m_world->GetConfig().PRED_PREY_SWITCH.Get() == -2 || m_world->GetConfig().PRED_PREY_SWITCH.Get() > -1) {
     // change to pred
-    if (forage_target == -2 && m_forage_target > -2) {
+    if (forage_target == -2 && m_state.forage_target > -2) {
       if (!inject) m_interface->DecNumPreyOrganisms();
       m_interface->IncNumPredOrganisms();
     }
-    else if (forage_target == -2 && m_forage_target < -2) {
+    else if (forage_target == -2 && m_state.forage_target < -2) {
       if (!inject) m_interface->DecNumTopPredOrganisms();
       m_interface->IncNumPredOrganisms();
     }
     // change to top pred
-    else if (forage_target < -2 && m_forage_target > -2) {
+    else if (forage_target < -2 && m_state.forage_target > -2) {
       if (!inject) m_interface->DecNumPreyOrganisms();
       m_interface->IncNumTopPredOrganisms();
     }
-    else if (forage_target < -2 && m_forage_target == -2) {
+    else if (forage_target < -2 && m_state.forage_target == -2) {
       if (!inject) m_interface->DecNumPredOrganisms();
       m_interface->IncNumTopPredOrganisms();
     }
     // change to prey
-    else if (forage_target > -2 && m_forage_target == -2) {
+    else if (forage_target > -2 && m_state.forage_target == -2) {
       m_interface->IncNumPreyOrganisms();
       if (!inject) m_interface->DecNumPredOrganisms();
     }
-    else if (forage_target > -2 && m_forage_target < -2) {
+    else if (forage_target > -2 && m_state.forage_target < -2) {
       m_interface->IncNumPreyOrganisms();
       if (!inject) m_interface->DecNumTopPredOrganisms();
     }
   }
-  m_forage_target = forage_target;
-  if (m_show_ft == -1) m_show_ft = m_forage_target;
+  m_state.forage_target = forage_target;
+  if (m_state.show_ft == -1) m_state.show_ft = m_state.forage_target;
 }
 
 void cOrganism::CopyParentFT(cAvidaContext& ctx) {
@@ -1271,7 +1299,7 @@ void cOrganism::CopyParentFT(cAvidaContext& ctx) {
   // close potential loop-hole allowing orgs to switch ft to prey at birth, collect res,
   // switch ft to pred, and then copy parent to become prey again.
   if (m_world->GetConfig().PRED_PREY_SWITCH.Get() <= 0 || m_world->GetConfig().PRED_PREY_SWITCH.Get() == 2) {
-    if (m_parent_ft > -2 && m_forage_target < -1) {
+    if (m_parent_ft > -2 && m_state.forage_target < -1) {
       copy_ft = false;
     }
   }
@@ -1345,9 +1373,9 @@ bool cOrganism::HasNeighborhoodChanged(cAvidaContext& ctx) {
 bool cOrganism::SubtractSelfRawMaterials (int amount)
 {
 	bool isSuccessful = false;
-	if (amount <= m_self_raw_materials) { 
+	if (amount <= m_state.self_raw_materials) { 
 		isSuccessful = true; 
-		m_self_raw_materials -= amount;
+		m_state.self_raw_materials -= amount;
 	}
 	return isSuccessful;
 }
@@ -1360,9 +1388,9 @@ bool cOrganism::SubtractSelfRawMaterials (int amount)
 bool cOrganism::SubtractOtherRawMaterials (int amount)
 {
 	bool isSuccessful = false;
-	if (amount <= m_other_raw_materials) { 
+	if (amount <= m_state.other_raw_materials) { 
 		isSuccessful = true; 
-		m_other_raw_materials -= amount;
+		m_state.other_raw_materials -= amount;
 	}
 	return isSuccessful;
 }
@@ -1374,10 +1402,10 @@ bool cOrganism::SubtractOtherRawMaterials (int amount)
 
 bool cOrganism::AddOtherRawMaterials (int amount, int donor_id) {
 	bool isSuccessful = true;
-	m_other_raw_materials += amount;
+	m_state.other_raw_materials += amount;
 	donor_list.insert(donor_id);
-	m_num_donate_received += amount;	
-	m_amount_donate_received++;	
+	m_state.num_donate_received += amount;	
+	m_state.amount_donate_received++;	
 	return isSuccessful;
 }
 
@@ -1392,10 +1420,10 @@ bool cOrganism::AddOtherRawMaterials (int amount, int donor_id) {
 
 bool cOrganism::AddRawMaterials (int amount, int donor_id) {
 	bool isSuccessful = true;
-	m_self_raw_materials += amount;
+	m_state.self_raw_materials += amount;
 	donor_list.insert(donor_id);	
-	m_num_donate_received += amount;
-	m_amount_donate_received++;
+	m_state.num_donate_received += amount;
+	m_state.amount_donate_received++;
 	return isSuccessful;
 }
 
@@ -1443,12 +1471,12 @@ bool cOrganism::IsDonor(int neighbor_id)
 void cOrganism::UpdateTag(int new_tag, int bits)
 {
 	unsigned int rand_int = m_world->GetRandom().GetUInt(0, 2);
-	if ((m_tag.first == -1) || 
-			(m_tag.first == new_tag) ||
-			(m_tag.second < bits)) {
-		m_tag = make_pair(new_tag, bits);
-	} else if ((m_tag.second == bits) && rand_int){ 		
-		m_tag = make_pair(new_tag, bits);
+	if ((m_state.tag.first == -1) || 
+			(m_state.tag.first == new_tag) ||
+			(m_state.tag.second < bits)) {
+		m_state.tag = make_pair(new_tag, bits);
+	} else if ((m_state.tag.second == bits) && rand_int){ 		
+		m_state.tag = make_pair(new_tag, bits);
 	}
 }
 
@@ -1473,7 +1501,7 @@ void cOrganism::SetOutputNegative1()
 	for (int i=0; i<GetOutputBuf().GetCapacity(); i++) {
 		AddOutput(-1);
 	}
-	m_output_buf.Clear(); 
+	m_state.output_buf.Clear(); 
 }
 
 /* Initialize the string tracking map */
@@ -1526,8 +1554,8 @@ bool cOrganism::ReceiveString(int string_tag, int amount, int donor_id)
 		(*m_string_map)[string_tag].received_string++; 
 		(*m_string_map)[string_tag].on_hand++;
 		donor_list.insert(donor_id);	
-		m_num_donate_received += amount;
-		m_amount_donate_received++;
+		m_state.num_donate_received += amount;
+		m_state.amount_donate_received++;
 		val = true;
 	}
 	return val;
@@ -1565,7 +1593,7 @@ void cOrganism::DonateResConsumedToDeme()
 bool cOrganism::MoveAV(cAvidaContext& ctx)
 {
   assert(m_interface);
-  if (m_is_dead) return false;
+  if (m_state.is_dead) return false;
   
   // Actually perform the move
   if (m_interface->MoveAV(ctx)) {
@@ -1575,28 +1603,28 @@ bool cOrganism::MoveAV(cAvidaContext& ctx)
       int facing = m_interface->GetAVFacing();
 
       if (facing == 0)
-        m_northerly = m_northerly - 1;                  // N
+        m_state.northerly = m_state.northerly - 1;                  // N
       else if (facing == 1) {
-        m_northerly = m_northerly - 1;                  // NE
-        m_easterly = m_easterly + 1;
+        m_state.northerly = m_state.northerly - 1;                  // NE
+        m_state.easterly = m_state.easterly + 1;
       }  
       else if (facing == 2)
-        m_easterly = m_easterly + 1;                    // E
+        m_state.easterly = m_state.easterly + 1;                    // E
       else if (facing == 3) {
-        m_northerly = m_northerly + 1;                  // SE
-        m_easterly = m_easterly + 1;
+        m_state.northerly = m_state.northerly + 1;                  // SE
+        m_state.easterly = m_state.easterly + 1;
       }
       else if (facing == 4)
-        m_northerly = m_northerly + 1;                  // S
+        m_state.northerly = m_state.northerly + 1;                  // S
       else if (facing == 5) {
-        m_northerly = m_northerly + 1;                  // SW
-        m_easterly = m_easterly - 1;
+        m_state.northerly = m_state.northerly + 1;                  // SW
+        m_state.easterly = m_state.easterly - 1;
       }
       else if (facing == 6)
-        m_easterly = m_easterly - 1;                    // W    
+        m_state.easterly = m_state.easterly - 1;                    // W    
       else if (facing == 7) {
-        m_northerly = m_northerly - 1;                  // NW
-        m_easterly = m_easterly - 1;
+        m_state.northerly = m_state.northerly - 1;                  // NW
+        m_state.easterly = m_state.easterly - 1;
       }      
     }
     else return false;                  
@@ -85,29 +85,68 @@ private:
   // Other stats
   Genome m_offspring_genome;              // Child genome, while under construction.
 
-  // Input and Output with the environment
-  int m_input_pointer;
-  tBuffer<int> m_input_buf;
-  tBuffer<int> m_output_buf;
-  tBuffer<int> m_received_messages;
-
-  int m_cur_sg;
-
-  // Communication
-  int m_sent_value;         // What number is this org sending?
-  bool m_sent_active;       // Has this org sent a number?
-  int m_test_receive_pos;   // In a test CPU, what message to receive next?
-
-  double m_gradient_movement;  // TEMP.  Remove once movement tasks are implemented.
-  bool m_pher_drop;	   // Is the organism dropping pheromone?
-  double frac_energy_donating;  // What fraction of the organism's energy is it donating
-
-  int m_max_executed;      // Max number of instruction executed before death.  
+  // Per-organism execution state.  Test CPU checkpoints copy it as a unit, so state that execution changes belongs here.
+  struct sExecState
+  {
+    // Input and Output with the environment
+    int input_pointer;
+    tBuffer<int> input_buf;
+    tBuffer<int> output_buf;
+    tBuffer<int> received_messages;
+    
+    int cur_sg;
+    
+    // Communication
+    int sent_value;         // What number is this org sending?
+    bool sent_active;       // Has this org sent a number?
+    int test_receive_pos;   // In a test CPU, what message to receive next?
+    
+    double gradient_movement;  // TEMP.  Remove once movement tasks are implemented.
+    bool pher_drop;            // Is the organism dropping pheromone?
+    double frac_energy_donating;  // What fraction of the organism's energy is it donating
+    
+    int max_executed;       // Max number of instruction executed before death.
+    bool is_sleeping;       // Is this organism sleeping?
+    bool is_dead;           // Is this organism dead?
+    
+    bool killed_event;
+    
+    int self_raw_materials;       // The organism's own raw materials
+    int other_raw_materials;      // The raw materials an oranism has collected from others
+    int num_donate;               // number of donations
+    int num_donate_received;      // number of donations received
+    int amount_donate_received;   // amount of donations received
+    int num_reciprocate;          // number of reciprocations
+    int k;                        // reputation minimum for donation/rotation, based on Nowak89
+    int failed_reputation_increases;  // number of reputation increase failures
+    std::pair<int, int> tag;
+    int northerly;                // total number of steps taken to north (minus S steps) since birth
+    int easterly;                 // total number of steps taken to east (minus W steps) since birth
+    
+    int forage_target;
+    int show_ft;
+    bool has_set_ft;
+    bool teach;
+    
+    bool beggar;
+    double para_donate;
+    bool guard;
+    int num_guard;
+    int num_deposits;
+    double amount_deposited;
+    
+    int num_point_mut;
+    bool repair;
+    
+    int av_in_index;
+    int av_out_index;
+    
+    sExecState() : input_buf(1), output_buf(1), received_messages(1) { ; }
+    explicit sExecState(cWorld* world);
+  };
+  sExecState m_state;
+  
   bool m_is_running;       // Does this organism have the CPU?
-  bool m_is_sleeping;      // Is this organism sleeping?
-  bool m_is_dead;          // Is this organism dead?
-
-  bool killed_event;
 
   cOrganism(); // @not_implemented
   cOrganism(const cOrganism&); // @not_implemented
@@ -144,6 +183,18 @@ public:
 
   void NewTrial();
 
+  // --------  Test CPU Checkpointing  --------
+  // Execution state needed to resume a test CPU run part way through gestation.  Organisms that have engaged the
+  // lazily-allocated social machinery (messaging, opinions, neighborhoods, donations, parasites) are not checkpointed.
+  struct sCheckpoint
+  {
+    cPhenotype phenotype;
+    Genome offspring_genome;
+    sExecState state;
+  };
+  bool SaveCheckpoint(sCheckpoint& checkpoint) const;
+  void RestoreCheckpoint(const sCheckpoint& checkpoint);
+
   // --------  Accessor Methods  --------
   const Genome& GetGenome() const { return m_initial_genome; }
   const cPhenotype& GetPhenotype() const { return m_phenotype; }
@@ -173,7 +224,7 @@ public:
   void AddToRBin(const int index, const double value);
   void IncCollectSpecCount(const int spec_id);
 
-  int GetMaxExecuted() const { return m_max_executed; }
+  int GetMaxExecuted() const { return m_state.max_executed; }
 
   Genome& OffspringGenome() { return m_offspring_genome; }
   const Genome& OffspringGenome() const { return m_offspring_genome; }
@@ -182,18 +233,18 @@ public:
   bool IsRunning() { return m_is_running; }
 
   inline void SetSleeping(bool in_sleeping);
-  bool IsSleeping() { return m_is_sleeping; }
+  bool IsSleeping() { return m_state.is_sleeping; }
 
-  bool IsDead() { return m_is_dead; }
+  bool IsDead() { return m_state.is_dead; }
 
   bool IsInterrupted();
 
-  bool GetPheromoneStatus() { return m_pher_drop; }
-  void TogglePheromone() { m_pher_drop = (m_pher_drop == true) ? false : true; }
-  void SetPheromone(bool newval) { m_pher_drop = newval; }
+  bool GetPheromoneStatus() { return m_state.pher_drop; }
+  void TogglePheromone() { m_state.pher_drop = (m_state.pher_drop == true) ? false : true; }
+  void SetPheromone(bool newval) { m_state.pher_drop = newval; }
 
-  double GetFracEnergyDonating() { return frac_energy_donating; }
-  void SetFracEnergyDonating(double newval) { assert(newval >= 0); assert(newval <= 1); frac_energy_donating = newval; }
+  double GetFracEnergyDonating() { return m_state.frac_energy_donating; }
+  void SetFracEnergyDonating(double newval) { assert(newval >= 0); assert(newval <= 1); m_state.frac_energy_donating = newval; }
 
   const cStateGrid& GetStateGrid() const;
 
@@ -246,18 +297,18 @@ public:
   void Rotate(cAvidaContext& ctx, int direction) { m_interface->Rotate(ctx, direction); }
 
   int GetInputAt(int i) { return m_interface->GetInputAt(i); }
-  int GetNextInput() { return m_interface->GetInputAt(m_input_pointer); }
+  int GetNextInput() { return m_interface->GetInputAt(m_state.input_pointer); }
   int GetNextInput(int& in_input_pointer) { return m_interface->GetInputAt(in_input_pointer); }
-  tBuffer<int>& GetInputBuf() { return m_input_buf; }
-  tBuffer<int>& GetOutputBuf() { return m_output_buf; }
-  void Die(cAvidaContext& ctx) { m_interface->Die(ctx); m_is_dead = true; } 
+  tBuffer<int>& GetInputBuf() { return m_state.input_buf; }
+  tBuffer<int>& GetOutputBuf() { return m_state.output_buf; }
+  void Die(cAvidaContext& ctx) { m_interface->Die(ctx); m_state.is_dead = true; } 
   void KillCellID(int target, cAvidaContext& ctx) { m_interface->KillCellID(target, ctx); } 
   void Kaboom(int dist, cAvidaContext& ctx) { m_interface->Kaboom(dist,ctx);}
   void Kaboom(int dist, cAvidaContext& ctx, double effect) { m_interface->Kaboom(dist,ctx, effect);}
   void SpawnDeme(cAvidaContext& ctx) { m_interface->SpawnDeme(ctx); }
-  bool GetSentActive() { return m_sent_active; }
-  void SendValue(int value) { m_sent_active = true; m_sent_value = value; }
-  int RetrieveSentValue() { m_sent_active = false; return m_sent_value; }
+  bool GetSentActive() { return m_state.sent_active; }
+  void SendValue(int value) { m_state.sent_active = true; m_state.sent_value = value; }
+  int RetrieveSentValue() { m_state.sent_active = false; return m_state.sent_value; }
   int ReceiveValue();
   void UpdateMerit(cAvidaContext& ctx, double new_merit) { m_interface->UpdateMerit(ctx, new_merit); }
 
@@ -290,9 +341,9 @@ public:
   //! Check tasks based on the passed-in IO buffers and value (on_divide=false).
   void DoOutput(cAvidaContext& ctx, tBuffer<int>& input_buffer, tBuffer<int>& output_buffer, const int value);    
 
-  void ClearInput() { m_input_buf.Clear(); }
-  void ResetInput() {m_input_pointer = 0; m_input_buf.Clear(); };
-  void AddOutput(int val) { m_output_buf.Add(val); }
+  void ClearInput() { m_state.input_buf.Clear(); }
+  void ResetInput() {m_state.input_pointer = 0; m_state.input_buf.Clear(); };
+  void AddOutput(int val) { m_state.output_buf.Add(val); }
 
   // --------  Divide Methods  --------
   bool Divide_CheckViable(cAvidaContext& ctx);
@@ -426,11 +477,11 @@ private:
   // -------- Movement TEMP --------
 public:
   double GetGradientMovement() const {
-    return m_gradient_movement;
+    return m_state.gradient_movement;
   }
 
   void SetGradientMovement(const double value) {
-    m_gradient_movement = value;
+    m_state.gradient_movement = value;
   }
 
 
@@ -445,8 +496,8 @@ public:
 
   void DivideOrgTestamentAmongDeme(double value) { m_interface->DivideOrgTestamentAmongDeme(value); }
 
-  void SetEventKilled() { killed_event = true; }
-  bool GetEventKilled() { return killed_event; }
+  void SetEventKilled() { m_state.killed_event = true; }
+  bool GetEventKilled() { return m_state.killed_event; }
 
 
   // -------- Opinion support --------
@@ -531,11 +582,11 @@ public:
   // receive raw materials 
   bool AddRawMaterials(int amount, int donor_id);
   // receive raw materials 
-  void AddSelfRawMaterials(int amount) { if (m_self_raw_materials < 10) m_self_raw_materials += amount;}
+  void AddSelfRawMaterials(int amount) { if (m_state.self_raw_materials < 10) m_state.self_raw_materials += amount;}
   // retrieve the organism's own amount of raw materials
-  int GetSelfRawMaterials() { return m_self_raw_materials; }
+  int GetSelfRawMaterials() { return m_state.self_raw_materials; }
   // retrieve the amount of raw materials collected from others
-  int GetOtherRawMaterials() { return m_other_raw_materials; }
+  int GetOtherRawMaterials() { return m_state.other_raw_materials; }
   // get the organism's reputation
   int GetReputation(); 
   // set the organism's reputation
@@ -549,17 +600,17 @@ public:
   // get number of donors
   int GetNumberOfDonors() { return donor_list.size(); }
   // organism donated
-  void Donated(){m_num_donate++;}
+  void Donated(){m_state.num_donate++;}
   // get number of donations
-  int GetNumberOfDonations() { return m_num_donate; }
+  int GetNumberOfDonations() { return m_state.num_donate; }
   // get number of donations received
-  int GetNumberOfDonationsReceived() { return m_num_donate_received; }
+  int GetNumberOfDonationsReceived() { return m_state.num_donate_received; }
   // get amout of donations received
-  int GetAmountOfDonationsReceived() { return m_amount_donate_received; }
+  int GetAmountOfDonationsReceived() { return m_state.amount_donate_received; }
   // organism reciprocated
-  void Reciprocated() {m_num_reciprocate++;}
+  void Reciprocated() {m_state.num_reciprocate++;}
   // get number of reciprocations
-  int GetNumberOfReciprocations() { return m_num_reciprocate; }
+  int GetNumberOfReciprocations() { return m_state.num_reciprocate; }
   // was the organism a donor
   bool IsDonor(int neighbor_id); 
 
@@ -569,16 +620,16 @@ public:
   // Add a donor
   void AddDonor(int org_id) { donor_list.insert(org_id); }
   // Set tag 
-  void SetTag(int new_tag, int bits) { m_tag = make_pair(new_tag, bits); }
+  void SetTag(int new_tag, int bits) { m_state.tag = make_pair(new_tag, bits); }
   // Set tag
-  void SetTag(pair < int, int > new_tag)  { m_tag = new_tag; }
+  void SetTag(pair < int, int > new_tag)  { m_state.tag = new_tag; }
   // Update tag
   void UpdateTag(int new_tag, int bits); 
   // Get tag
-  int GetTagLabel() { return m_tag.first; }
-  pair < int, int > GetTag() { return m_tag; }
+  int GetTagLabel() { return m_state.tag.first; }
+  pair < int, int > GetTag() { return m_state.tag; }
   // Get number of failed reputation increases
-  int GetFailedReputationIncreases() { return m_failed_reputation_increases; }
+  int GetFailedReputationIncreases() { return m_state.failed_reputation_increases; }
 
   // Clear the output buffer
   void SetOutputNegative1();
@@ -593,25 +644,25 @@ public:
   bool CanReceiveString(int string_tag, int amount); 
 
   // get the organism's relative position (from birth place)
-  int GetNortherly() { return m_northerly; }
-  int GetEasterly() { return m_easterly; } 
-  void ClearEasterly() { m_easterly = 0; }
-  void ClearNortherly() { m_northerly = 0; }
+  int GetNortherly() { return m_state.northerly; }
+  int GetEasterly() { return m_state.easterly; } 
+  void ClearEasterly() { m_state.easterly = 0; }
+  void ClearNortherly() { m_state.northerly = 0; }
   
-  int GetForageTarget() const { return m_forage_target; }
-  int GetShowForageTarget() const { return m_show_ft; }
+  int GetForageTarget() const { return m_state.forage_target; }
+  int GetShowForageTarget() const { return m_state.show_ft; }
   void SetForageTarget(cAvidaContext& ctx, int forage_target, bool inject = false);
   void SetPredFT(cAvidaContext& ctx) { SetForageTarget(ctx, -2); }
   void SetTopPredFT(cAvidaContext& ctx) { SetForageTarget(ctx, -3); }
-  bool IsPreyFT() { return m_forage_target > -2; }
-  bool IsPredFT() { return m_forage_target == -2; }
-  bool IsTopPredFT() { return m_forage_target < -2; }
-  bool IsMimicFT() { return m_forage_target == 1; }
-  void SetShowForageTarget(cAvidaContext& ctx, int forage_target) { m_show_ft = forage_target; }
-  bool HasSetFT() const { return m_has_set_ft; }
-  void RecordFTSet() { m_has_set_ft = true; }
-  bool IsTeacher() const { return m_teach; }
-  void Teach(bool teach) { m_teach = teach; }
+  bool IsPreyFT() { return m_state.forage_target > -2; }
+  bool IsPredFT() { return m_state.forage_target == -2; }
+  bool IsTopPredFT() { return m_state.forage_target < -2; }
+  bool IsMimicFT() { return m_state.forage_target == 1; }
+  void SetShowForageTarget(cAvidaContext& ctx, int forage_target) { m_state.show_ft = forage_target; }
+  bool HasSetFT() const { return m_state.has_set_ft; }
+  void RecordFTSet() { m_state.has_set_ft = true; }
+  bool IsTeacher() const { return m_state.teach; }
+  void Teach(bool teach) { m_state.teach = teach; }
   bool HadParentTeacher() const { return m_parent_teacher; }
   void SetParentTeacher(bool had_teacher) { m_parent_teacher = had_teacher; }
   void SetParentFT(int parent_ft) { m_parent_ft = parent_ft; }
@@ -624,69 +675,34 @@ public:
   void SetParentMultiThreaded(bool parent_is_mt) { m_p_mthread = parent_is_mt; }
   bool IsParentMThreaded() { return m_p_mthread; }
   
-  void ChangeBeg() { m_beggar = !m_beggar; }
-  bool IsBeggar() { return m_beggar; }
+  void ChangeBeg() { m_state.beggar = !m_state.beggar; }
+  bool IsBeggar() { return m_state.beggar; }
   
-  double GetParaDonate() { return m_para_donate;}
-  void SetParaDonate(double donate_prob) { m_para_donate = donate_prob;}
+  double GetParaDonate() { return m_state.para_donate;}
+  void SetParaDonate(double donate_prob) { m_state.para_donate = donate_prob;}
   
-  void SetGuard() { m_guard = !m_guard; }
-  bool IsGuard() { return m_guard; }
-  void IncGuard() { m_num_guard++; }
-  int GetNumGuard() { return m_num_guard; }
-  void IncNumDeposits() { m_num_deposits++; }
-  void IncAmountDeposited(double amount) { m_amount_deposited = m_amount_deposited + amount; } 
-  int GetNumDeposits() { return m_num_deposits; }
-  double GetAmountDeposited() { return m_amount_deposited; }
+  void SetGuard() { m_state.guard = !m_state.guard; }
+  bool IsGuard() { return m_state.guard; }
+  void IncGuard() { m_state.num_guard++; }
+  int GetNumGuard() { return m_state.num_guard; }
+  void IncNumDeposits() { m_state.num_deposits++; }
+  void IncAmountDeposited(double amount) { m_state.amount_deposited = m_state.amount_deposited + amount; } 
+  int GetNumDeposits() { return m_state.num_deposits; }
+  double GetAmountDeposited() { return m_state.amount_deposited; }
   
   
 protected:
-  // The organism's own raw materials
-  int m_self_raw_materials; 
-  // The raw materials an oranism has collected from others
-  int m_other_raw_materials;
   // Organisms that have donated to this organism
   set<int> donor_list;
   // Strings this organism has received. 
   set<int> donating_lineages;
-  // number of donations
-  int m_num_donate;
-  // number of donations received
-  int m_num_donate_received;
-  // amount of donations received
-  int m_amount_donate_received;
-  // number of reciprocations
-  int m_num_reciprocate;
-  // reputation minimum for donation/rotation 
-  // based on Nowak89
-  int m_k;
-  // int number of reputation increase failures
-  int m_failed_reputation_increases;
-  std::pair < int, int > m_tag;
-  //total number of steps taken to north (minus S steps) since birth
-  int m_northerly;
-  //total number of steps taken to east (minus W steps) since birth  
-  int m_easterly;
-
-  int m_forage_target;
-  int m_show_ft;
-  bool m_has_set_ft;
-  bool m_teach;
+
   bool m_parent_teacher;
   int m_parent_ft;
   int m_parent_group;
   double m_p_merit;
   bool m_p_mthread;
   
-  bool m_beggar;
-  
-  double m_para_donate;
-  
-  bool m_guard;
-    int m_num_guard;
-    int m_num_deposits;
-    double m_amount_deposited;
-  
   
   /*! Contains all the different data structures needed to
   track strings, production of strings, and donation/trade
@@ -716,31 +732,24 @@ public:
   // -------- Division of Labor support --------
 public:
   void DonateResConsumedToDeme(); //! donate consumed resources to the deme.
-  int GetNumOfPointMutationsApplied() {return m_num_point_mut; } //! number of point mutations applied to org.
-  void IncPointMutations(int n) {m_num_point_mut+=n;} 
+  int GetNumOfPointMutationsApplied() {return m_state.num_point_mut; } //! number of point mutations applied to org.
+  void IncPointMutations(int n) {m_state.num_point_mut+=n;} 
   void JoinGermline() {m_phenotype.is_germ_cell = true;}
   void ExitGermline() {m_phenotype.is_germ_cell = false;}
-  void RepairPointMutOn() {m_repair = true;}
-  void RepairPointMutOff() {m_repair = false;}
+  void RepairPointMutOn() {m_state.repair = true;}
+  void RepairPointMutOff() {m_state.repair = false;}
   bool IsGermline() { return m_phenotype.is_germ_cell; }
-private: 
-  int m_num_point_mut;
-//  bool m_germline;
-  bool m_repair;
 	
 	// -------- Avatar support --------
 public:
   bool MoveAV(cAvidaContext& ctx);
-  inline void SetAVInIndex(int index) { m_av_in_index = index; }
-  inline int GetAVInIndex() { return m_av_in_index; }
-  inline void SetAVOutIndex(int index) { m_av_out_index = index; }
-  inline int GetAVOutIndex() { return m_av_out_index; }
+  inline void SetAVInIndex(int index) { m_state.av_in_index = index; }
+  inline int GetAVInIndex() { return m_state.av_in_index; }
+  inline void SetAVOutIndex(int index) { m_state.av_out_index = index; }
+  inline int GetAVOutIndex() { return m_state.av_out_index; }
     
 	// -------- Internal Support Methods --------
 private:
-  int m_av_in_index;
-  int m_av_out_index;
-  
   void initialize(cAvidaContext& ctx);
   
   
@@ -851,7 +860,7 @@ inline double cOrganism::GetTestColonyFitness(cAvidaContext& ctx) const {
 
 inline void cOrganism::SetSleeping(bool sleeping)
 {
-  m_is_sleeping = sleeping;
+  m_state.is_sleeping = sleeping;
 
   if (sleeping) m_interface->BeginSleep();
   else m_interface->EndSleep();
@@ -51,16 +51,24 @@ void cPhenPlastGenotype::Process(cCPUTestInfo& test_info, cWorld* world, cAvidaC
 
   if (m_num_trials > 1) test_info.UseRandomInputs(true);
   
+  // Trials only differ once the genome reads its inputs or draws a random number; later trials resume from the first
+  // one at that point
+  const bool fork_trials = (m_num_trials > 1 && m_world->GetConfig().FORK_PLASTICITY_TRIALS.Get());
+  cTestCPUInputFork fork;
   for (int k = 0; k < m_num_trials; k++){
-    test_cpu->TestGenome(ctx, test_info, m_genome);
+    if (k == 0 && fork_trials) test_cpu->ForkGenome(ctx, test_info, m_genome, fork);
+    else if (k == 0 || !fork_trials) test_cpu->TestGenome(ctx, test_info, m_genome);
+    else test_cpu->TestForked(ctx, test_info, m_genome, fork);
     //Is this a new phenotype?
-    UniquePhenotypes::iterator uit = m_unique.find(&test_info.GetTestPhenotype());
-    if (uit == m_unique.end()){  // Yes, make a new entry for it
+    bool inserted = false;
+    cPlasticPhenotype*& entry = m_signatures.Get(cPhenotypeSignature::OfPhenotype(test_info.GetTestPhenotype()), inserted);
+    if (inserted){  // Yes, make a new entry for it
       cPlasticPhenotype* new_phen = new cPlasticPhenotype(test_info, m_num_trials);
+      entry = new_phen;
       m_plastic_phenotypes.Push(new_phen);
       m_unique.insert( static_cast<cPhenotype*>(new_phen) );
     } else{   // No, add an observation to existing entry, make sure it is equivalent
-      if (!static_cast<cPlasticPhenotype*>((*uit))->AddObservation(test_info)){
+      if (!entry->AddObservation(test_info)){
         cerr << "Error with this plastic phenotype. Abort." << endl;
         exit(3);
       }
@@ -29,6 +29,7 @@
 #include "cCPUMemory.h"
 #include "cPlasticPhenotype.h"
 #include "cPhenotype.h"
+#include "cPhenotypeSignature.h"
 #include "cHardwareManager.h"
 #include "cWorld.h"
 #include "cEnvironment.h"
@@ -54,6 +55,7 @@ private:
   
   int m_num_trials;  
   UniquePhenotypes m_unique;
+  tPhenotypeSignatureMap<cPlasticPhenotype*> m_signatures;  // Finds the entry of m_unique matching a trial
   cWorld* m_world;
     
   double m_max_fitness;
@@ -2345,6 +2345,90 @@ void cPhenotype::TrialDivideReset(const InstructionSequence& _genome)
   if (m_world->GetConfig().GENERATION_INC_METHOD.Get() == GENERATION_INC_BOTH) generation++;
 }
 
+template <typename T> static inline int arrayHeapSize(const Apto::Array<T>& arr)
+{
+  return arr.GetSize() * static_cast<int>(sizeof(T));
+}
+
+template <typename T> static inline int arrayHeapSize(const Apto::Array<Apto::Array<T> >& arr)
+{
+  int bytes = arr.GetSize() * static_cast<int>(sizeof(Apto::Array<T>));
+  for (int i = 0; i < arr.GetSize(); i++) bytes += arrayHeapSize(arr[i]);
+  return bytes;
+}
+
+template <typename T> static inline int listHeapSize(const tList<T>& list)
+{
+  return list.GetSize() * static_cast<int>(sizeof(tListNode<T>) + sizeof(T));
+}
+
+int cPhenotype::GetHeapSize() const
+{
+  // Counts the elements currently held; any spare capacity inside the arrays is not visible from here
+  int bytes = 0;
+
+  bytes += arrayHeapSize(cur_task_count);
+  bytes += arrayHeapSize(cur_para_tasks);
+  bytes += arrayHeapSize(cur_host_tasks);
+  bytes += arrayHeapSize(cur_internal_task_count);
+  bytes += arrayHeapSize(eff_task_count);
+  bytes += arrayHeapSize(cur_task_quality);
+  bytes += arrayHeapSize(cur_task_value);
+  bytes += arrayHeapSize(cur_internal_task_quality);
+  bytes += arrayHeapSize(cur_rbins_total);
+  bytes += arrayHeapSize(cur_rbins_avail);
+  bytes += arrayHeapSize(cur_collect_spec_counts);
+  bytes += arrayHeapSize(cur_reaction_count);
+  bytes += arrayHeapSize(first_reaction_cycles);
+  bytes += arrayHeapSize(first_reaction_execs);
+  bytes += arrayHeapSize(cur_stolen_reaction_count);
+  bytes += arrayHeapSize(cur_reaction_add_reward);
+  bytes += arrayHeapSize(cur_inst_count);
+  bytes += arrayHeapSize(cur_from_sensor_count);
+  bytes += arrayHeapSize(cur_killed_targets);
+  bytes += arrayHeapSize(cur_sense_count);
+  bytes += arrayHeapSize(sensed_resources);
+  bytes += arrayHeapSize(cur_task_time);
+  bytes += arrayHeapSize(cur_trial_fitnesses);
+  bytes += arrayHeapSize(cur_trial_bonuses);
+  bytes += arrayHeapSize(cur_trial_times_used);
+  bytes += arrayHeapSize(cur_from_message_count);
+  bytes += arrayHeapSize(m_intolerances);
+  bytes += arrayHeapSize(last_task_count);
+  bytes += arrayHeapSize(last_para_tasks);
+  bytes += arrayHeapSize(last_host_tasks);
+  bytes += arrayHeapSize(last_internal_task_count);
+  bytes += arrayHeapSize(last_task_quality);
+  bytes += arrayHeapSize(last_task_value);
+  bytes += arrayHeapSize(last_internal_task_quality);
+  bytes += arrayHeapSize(last_rbins_total);
+  bytes += arrayHeapSize(last_rbins_avail);
+  bytes += arrayHeapSize(last_collect_spec_counts);
+  bytes += arrayHeapSize(last_reaction_count);
+  bytes += arrayHeapSize(last_reaction_add_reward);
+  bytes += arrayHeapSize(last_inst_count);
+  bytes += arrayHeapSize(last_from_sensor_count);
+  bytes += arrayHeapSize(last_sense_count);
+  bytes += arrayHeapSize(last_killed_targets);
+  bytes += arrayHeapSize(last_from_message_count);
+  bytes += arrayHeapSize(testCPU_inst_count);
+  bytes += arrayHeapSize(is_donor_locus);
+  bytes += arrayHeapSize(is_donor_locus_last);
+  bytes += arrayHeapSize(cur_group_attack_count);
+  bytes += arrayHeapSize(cur_top_pred_group_attack_count);
+  bytes += arrayHeapSize(last_group_attack_count);
+  bytes += arrayHeapSize(last_top_pred_group_attack_count);
+
+  bytes += listHeapSize(m_tolerance_immigrants);
+  bytes += listHeapSize(m_tolerance_offspring_own);
+  bytes += listHeapSize(m_tolerance_offspring_others);
+
+  bytes += m_task_states.GetSize() * static_cast<int>(sizeof(void*) + sizeof(cTaskState));
+  if (m_reaction_result) bytes += sizeof(cReactionResult);
+
+  return bytes;
+}
+
 // Arbitrary (but consistant) ordering.
 // Return -1 if lhs is "less", +1 is it is "greater", and 0 otherwise.
 int cPhenotype::Compare(const cPhenotype* lhs, const cPhenotype* rhs) {
@@ -2357,8 +2441,8 @@ int cPhenotype::Compare(const cPhenotype* lhs, const cPhenotype* rhs) {
   else if ( lhs->GetGestationTime() > rhs->GetGestationTime() ) return 1;
   
   // If gestation times are also equal, compare each task
-  Apto::Array<int> lhsTasks = lhs->GetLastTaskCount();
-  Apto::Array<int> rhsTasks = rhs->GetLastTaskCount();
+  const Apto::Array<int>& lhsTasks = lhs->GetLastTaskCount();
+  const Apto::Array<int>& rhsTasks = rhs->GetLastTaskCount();
   for (int k = 0; k < lhsTasks.GetSize(); k++) {
     if (lhsTasks[k] < rhsTasks[k]) return -1;
     else if (lhsTasks[k] > rhsTasks[k]) return 1;
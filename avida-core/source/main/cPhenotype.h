@@ -311,7 +311,7 @@ private:
   double permanent_germline_propensity;
   
 
-  inline void SetInstSetSize(int inst_set_size);
+  inline void SetInstSetSize(int inst_set_size, bool track_input_sources);
   inline void SetGroupAttackInstSetSize(int num_group_attack_inst);
   
 public:
@@ -749,6 +749,9 @@ public:
   
   // Compare two phenotypes and determine an ordering (arbitrary, but consistant among phenotypes).
   static int Compare(const cPhenotype* lhs, const cPhenotype* rhs);
+  
+  // Bytes held by the phenotype's arrays and lists, in addition to sizeof(cPhenotype)
+  int GetHeapSize() const;
 
   // This pseudo-function is used to help sort phenotypes
   struct PhenotypeCompare {
@@ -757,14 +760,17 @@ public:
 };
 
 
-inline void cPhenotype::SetInstSetSize(int inst_set_size)
+inline void cPhenotype::SetInstSetSize(int inst_set_size, bool track_input_sources)
 {
   cur_inst_count.Resize(inst_set_size, 0);
-  cur_from_sensor_count.Resize(inst_set_size, 0);
-  cur_from_message_count.Resize(inst_set_size, 0);
   last_inst_count.Resize(inst_set_size, 0);
-  last_from_sensor_count.Resize(inst_set_size, 0);
-  last_from_message_count.Resize(inst_set_size, 0);
+  
+  // Sensor and message input counts are only recorded by hardware that tracks input sources, leave them empty otherwise
+  const int source_size = (track_input_sources) ? inst_set_size : 0;
+  cur_from_sensor_count.Resize(source_size, 0);
+  cur_from_message_count.Resize(source_size, 0);
+  last_from_sensor_count.Resize(source_size, 0);
+  last_from_message_count.Resize(source_size, 0);
 }
 
 inline void cPhenotype::SetGroupAttackInstSetSize(int num_group_attack_inst)
@@ -0,0 +1,104 @@
+/*
+ *  cPhenotypeSignature.cc
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPhenotypeSignature.h"
+
+#include "cPhenotype.h"
+
+#include <cstring>
+
+
+static const unsigned long long PRIME_1 = 0x9E3779B185EBCA87ULL;
+static const unsigned long long PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+static const unsigned long long PRIME_3 = 0x165667B19E3779F9ULL;
+static const unsigned long long PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+// Distinct seeds keep the count and presence signatures of the same array apart
+static const unsigned long long SEED_COUNTS = 0x0;
+static const unsigned long long SEED_PRESENCE = 0x5BD1E9955BD1E995ULL;
+
+
+static inline unsigned long long rotl64(unsigned long long x, int r) { return (x << r) | (x >> (64 - r)); }
+
+static inline unsigned long long mixRound(unsigned long long acc, unsigned long long value)
+{
+  acc += value * PRIME_2;
+  acc = rotl64(acc, 31);
+  return acc * PRIME_1;
+}
+
+static inline unsigned long long avalanche(unsigned long long x)
+{
+  x ^= x >> 33;
+  x *= PRIME_2;
+  x ^= x >> 29;
+  x *= PRIME_3;
+  x ^= x >> 32;
+  return x;
+}
+
+
+cPhenotypeSignature cPhenotypeSignature::OfCounts(const Apto::Array<int>& counts)
+{
+  return hashValues((counts.GetSize()) ? &counts[0] : NULL, counts.GetSize(), false, SEED_COUNTS);
+}
+
+
+cPhenotypeSignature cPhenotypeSignature::OfPresence(const Apto::Array<int>& counts)
+{
+  return hashValues((counts.GetSize()) ? &counts[0] : NULL, counts.GetSize(), true, SEED_PRESENCE);
+}
+
+
+cPhenotypeSignature cPhenotypeSignature::OfPhenotype(const cPhenotype& phenotype)
+{
+  // Adding zero folds -0.0 into 0.0, which compare equal as merits
+  const double merit = phenotype.GetMerit().GetDouble() + 0.0;
+  unsigned long long merit_bits = 0;
+  memcpy(&merit_bits, &merit, sizeof(merit_bits));
+
+  const unsigned long long seed = avalanche(merit_bits ^ rotl64((unsigned int)phenotype.GetGestationTime(), 32));
+  const Apto::Array<int>& tasks = phenotype.GetLastTaskCount();
+  return hashValues((tasks.GetSize()) ? &tasks[0] : NULL, tasks.GetSize(), false, seed);
+}
+
+
+cPhenotypeSignature cPhenotypeSignature::hashValues(const int* values, int count, bool presence, unsigned long long seed)
+{
+  unsigned long long acc[4] = { seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed, seed - PRIME_1 };
+
+  // Four values per step, one to each accumulator
+  const int whole = count - (count % 4);
+  for (int i = 0; i < whole; i += 4) {
+    for (int lane = 0; lane < 4; lane++) {
+      const unsigned long long value = (presence) ? (values[i + lane] > 0) : (unsigned int)values[i + lane];
+      acc[lane] = mixRound(acc[lane], value);
+    }
+  }
+  for (int i = whole; i < count; i++) {
+    const unsigned long long value = (presence) ? (values[i] > 0) : (unsigned int)values[i];
+    acc[i - whole] = mixRound(acc[i - whole], value);
+  }
+
+  cPhenotypeSignature sig;
+  sig.m_lo = avalanche(rotl64(acc[0], 1) + rotl64(acc[1], 7) + rotl64(acc[2], 12) + rotl64(acc[3], 18) + count);
+  sig.m_hi = avalanche((acc[0] * PRIME_3) ^ rotl64(acc[1], 23) ^ (acc[2] * PRIME_5) ^ rotl64(acc[3], 41) ^ (count * PRIME_1));
+  return sig;
+}
@@ -0,0 +1,144 @@
+/*
+ *  cPhenotypeSignature.h
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cPhenotypeSignature_h
+#define cPhenotypeSignature_h
+
+#include "apto/core.h"
+
+class cPhenotype;
+
+
+// cPhenotypeSignature     : 128-bit hash standing in for a phenotype in equality tests
+//
+// Count arrays are folded into four independent accumulators, four values at a time, so the inner loop carries no
+// dependency from one value to the next.  Two phenotypes with equal signatures are treated as equal; at 128 bits a
+// false match is not a practical concern for diversity counts.
+
+class cPhenotypeSignature
+{
+private:
+  unsigned long long m_lo;
+  unsigned long long m_hi;
+
+public:
+  cPhenotypeSignature() : m_lo(0), m_hi(0) { ; }
+
+  // Signature of the count values themselves
+  static cPhenotypeSignature OfCounts(const Apto::Array<int>& counts);
+  // Signature of which counts are non-zero (e.g. which tasks were done)
+  static cPhenotypeSignature OfPresence(const Apto::Array<int>& counts);
+  // Signature of the fields cPhenotype::Compare orders on: merit, gestation time and last task counts
+  static cPhenotypeSignature OfPhenotype(const cPhenotype& phenotype);
+
+  inline unsigned long long GetHash() const { return m_lo; }
+
+  inline bool operator==(const cPhenotypeSignature& rhs) const { return m_lo == rhs.m_lo && m_hi == rhs.m_hi; }
+  inline bool operator!=(const cPhenotypeSignature& rhs) const { return !operator==(rhs); }
+
+private:
+  static cPhenotypeSignature hashValues(const int* values, int count, bool presence, unsigned long long seed);
+};
+
+
+// tPhenotypeSignatureMap     : Open addressing map keyed by phenotype signature
+//
+// Keys and values are stored in flat arrays with linear probing and the table is kept at most half full.  Slots may be
+// walked directly (GetCapacity/IsUsed/GetKey/GetValue); slot order is unrelated to insertion order.
+
+template <class T> class tPhenotypeSignatureMap
+{
+private:
+  Apto::Array<cPhenotypeSignature> m_keys;
+  Apto::Array<T> m_values;
+  Apto::Array<bool> m_used;
+  int m_size;
+
+public:
+  tPhenotypeSignatureMap(int capacity = 16) : m_size(0) { resize(capacity); }
+
+  inline int GetSize() const { return m_size; }
+  void Clear() { m_used.SetAll(false); m_size = 0; }
+
+  // Value stored for sig, or NULL if there is none
+  T* Find(const cPhenotypeSignature& sig)
+  {
+    const int slot = findSlot(sig);
+    return (m_used[slot]) ? &m_values[slot] : NULL;
+  }
+
+  // Value stored for sig, default constructed and flagged through inserted if it is new.  The reference is valid until
+  // the next insertion.
+  T& Get(const cPhenotypeSignature& sig, bool& inserted)
+  {
+    int slot = findSlot(sig);
+    inserted = !m_used[slot];
+    if (inserted) {
+      if (2 * (m_size + 1) > m_keys.GetSize()) {
+        resize(2 * m_keys.GetSize());
+        slot = findSlot(sig);
+      }
+      m_keys[slot] = sig;
+      m_values[slot] = T();
+      m_used[slot] = true;
+      m_size++;
+    }
+    return m_values[slot];
+  }
+
+  inline int GetCapacity() const { return m_keys.GetSize(); }
+  inline bool IsUsed(int slot) const { return m_used[slot]; }
+  inline const cPhenotypeSignature& GetKey(int slot) const { return m_keys[slot]; }
+  inline T& GetValue(int slot) { return m_values[slot]; }
+  inline const T& GetValue(int slot) const { return m_values[slot]; }
+
+private:
+  int findSlot(const cPhenotypeSignature& sig) const
+  {
+    const int mask = m_keys.GetSize() - 1;
+    int slot = (int)(sig.GetHash() & (unsigned long long)mask);
+    while (m_used[slot] && m_keys[slot] != sig) slot = (slot + 1) & mask;
+    return slot;
+  }
+
+  void resize(int capacity)
+  {
+    int new_capacity = 16;
+    while (new_capacity < capacity) new_capacity *= 2;
+
+    Apto::Array<cPhenotypeSignature> old_keys(m_keys);
+    Apto::Array<T> old_values(m_values);
+    Apto::Array<bool> old_used(m_used);
+
+    m_keys.Resize(new_capacity);
+    m_values.Resize(new_capacity);
+    m_used.Resize(new_capacity);
+    m_used.SetAll(false);
+    for (int i = 0; i < old_keys.GetSize(); i++) {
+      if (!old_used[i]) continue;
+      const int slot = findSlot(old_keys[i]);
+      m_keys[slot] = old_keys[i];
+      m_values[slot] = old_values[i];
+      m_used[slot] = true;
+    }
+  }
+};
+
+#endif
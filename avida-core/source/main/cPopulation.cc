@@ -36,6 +36,7 @@
 #include "avida/private/systematics/GenomeTestMetrics.h"
 #include "avida/private/systematics/Genotype.h"
 
+#include "apto/platform.h"
 #include "apto/rng.h"
 #include "apto/scheduler.h"
 #include "apto/stat/Accumulator.h"
@@ -45,7 +46,9 @@
 #include "cAvidaContext.h"
 #include "cCPUTestInfo.h"
 #include "cCodeLabel.h"
+#include "cDemeExecutor.h"
 #include "cDemePlaceholderUnit.h"
+#include "cDetailFileReader.h"
 #include "cEnvironment.h"
 #include "cHardwareBase.h"
 #include "cHardwareManager.h"
@@ -54,7 +57,9 @@
 #include "cMigrationMatrix.h"   
 #include "cOrganism.h"
 #include "cParasite.h"
+#include "cPhiloxRandom.h"
 #include "cPhenotype.h"
+#include "cPhenotypeSignature.h"
 #include "cPopulationCell.h"
 #include "cResource.h"
 #include "cResourceCount.h"
@@ -78,8 +83,6 @@
 using namespace std;
 using namespace AvidaTools;
 
-static const PropertyID s_prop_id_instset("instset");
-
 
 cPopulationOrgStatProvider::~cPopulationOrgStatProvider() { ; }
 
@@ -156,7 +159,7 @@ public:
   
   void HandleOrganism(cOrganism* organism)
   {
-    Apto::String inst_set = organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue();
+    Apto::String inst_set((const char*)m_world->GetHardwareManager().GetInstSet(organism->GetGenome()).GetInstSetName());
     Apto::Array<Apto::Stat::Accumulator<int> >& inst_exe_counts = m_is_exe_inst_map[inst_set];
     for (int j = 0; j < organism->GetPhenotype().GetLastInstCount().GetSize(); j++) {
       inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
@@ -244,7 +247,7 @@ public:
   
   void HandleOrganism(cOrganism* organism)
   {
-    Apto::String inst_set = organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue();
+    Apto::String inst_set((const char*)m_world->GetHardwareManager().GetInstSet(organism->GetGenome()).GetInstSetName());
     Apto::Array<Apto::Stat::Accumulator<int> >& inst_exe_counts = m_is_exe_inst_map[inst_set];
     for (int j = 0; j < organism->GetPhenotype().GetLastFromMessageInstCount().GetSize(); j++) {
       inst_exe_counts[j].Add(organism->GetPhenotype().GetLastFromMessageInstCount()[j]);
@@ -265,6 +268,7 @@ public:
 cPopulation::cPopulation(cWorld* world)  
 : m_world(world)
 , m_scheduler(NULL)
+, m_deme_executor(NULL)
 , birth_chamber(world)
 , print_mini_trace_genomes(false)
 , use_micro_traces(false)
@@ -316,6 +320,7 @@ void cPopulation::ClearCellGrid()
 {
   delete sleep_log; sleep_log = NULL;
   reaper_queue.Clear();
+  delete m_deme_executor; m_deme_executor = NULL;
   delete m_scheduler; m_scheduler = NULL;
 }
 
@@ -603,6 +608,7 @@ bool cPopulation::IsValidArgument(const Data::DataID& data_id, Data::Argument ar
 cPopulation::~cPopulation()
 {
   for (int i = 0; i < cell_array.GetSize(); i++) delete cell_array[i].GetOrganism(); 
+  delete m_deme_executor;
   delete m_scheduler;
 }
 
@@ -611,7 +617,9 @@ inline void cPopulation::AdjustSchedule(const cPopulationCell& cell, const cMeri
 {
   const int deme_id = cell.GetDemeID();
   const cDeme& deme = deme_array[deme_id];
-  m_scheduler->AdjustPriority(cell.GetID(), deme.HasDemeMerit() ? (merit.GetDouble() * deme.GetDemeMerit().GetDouble()) : merit.GetDouble());
+  const double priority = deme.HasDemeMerit() ? (merit.GetDouble() * deme.GetDemeMerit().GetDouble()) : merit.GetDouble();
+  m_scheduler->AdjustPriority(cell.GetID(), priority);
+  if (m_deme_executor) m_deme_executor->AdjustPriority(cell.GetID(), priority);
 }
 
 
@@ -627,25 +635,10 @@ bool cPopulation::ActivateOffspring(cAvidaContext& ctx, const Genome& offspring_
   Apto::Array<cMerit> merit_array;
   
   // If divide method is split, parent will be reset to completely tolerant
-  // must remove their intolerance from the group's cached total.
-  if (m_world->GetConfig().DIVIDE_METHOD.Get() == DIVIDE_METHOD_SPLIT) {
-    if (m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0) {
-      int tol_max = m_world->GetConfig().MAX_TOLERANCE.Get();
-      int group_id = parent_organism->GetOpinion().first;
-      int org_imm_tolerance = parent_organism->GetPhenotype().CalcToleranceImmigrants();
-      m_group_intolerances[group_id][0].second -= tol_max - org_imm_tolerance; 
-      if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
-        if (parent_organism->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
-          m_group_intolerances_females[group_id][0].second -= tol_max - org_imm_tolerance;
-        } else if (parent_organism->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
-          m_group_intolerances_males[group_id][0].second -= tol_max - org_imm_tolerance;
-        } else if (parent_organism->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) {
-          m_group_intolerances_juvs[group_id][0].second -= tol_max - org_imm_tolerance;
-        }
-      }
-      m_group_intolerances[group_id][1].second -= tol_max - parent_organism->GetPhenotype().CalcToleranceOffspringOthers();
-    }
-  }
+  // so its group's running tolerance sums must follow the reset.
+  const bool split_tolerance = (m_world->GetConfig().DIVIDE_METHOD.Get() == DIVIDE_METHOD_SPLIT &&
+                                m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0);
+  if (split_tolerance) BeginGroupToleranceChange(parent_organism);
   
   // Update the parent's phenotype.
   // This needs to be done before the parent goes into the birth chamber
@@ -655,6 +648,7 @@ bool cPopulation::ActivateOffspring(cAvidaContext& ctx, const Genome& offspring_
   ConstInstructionSequencePtr seq;
   seq.DynamicCastFrom(parent_organism->GetGenome().Representation());
   parent_phenotype.DivideReset(*seq);
+  if (split_tolerance) EndGroupToleranceChange(parent_organism);
   
   GeneticRepresentationPtr tmpHostGenome;
   
@@ -1233,8 +1227,9 @@ bool cPopulation::ActivateParasite(cOrganism* host, Systematics::UnitPtr parent,
   
   // Pre-check target hardware
   const cHardwareBase& hw = target_organism->GetHardware();
-  if (hw.GetType() != parent->UnitGenome().HardwareType() ||
-      hw.GetInstSet().GetInstSetName() != (const char*)parent->UnitGenome().Properties().Get(s_prop_id_instset).StringValue() ||
+  const int parasite_is = m_world->GetHardwareManager().GetInstSetIndex(parent->UnitGenome());
+  if (hw.GetType() != parent->UnitGenome().HardwareType() || parasite_is < 0 ||
+      &hw.GetInstSet() != &m_world->GetHardwareManager().GetInstSet(parasite_is) ||
       hw.GetNumThreads() == m_world->GetConfig().MAX_CPU_THREADS.Get()) return false;
   
   //Handle host specific injection
@@ -2359,9 +2354,9 @@ void cPopulation::Kaboom(cPopulationCell& in_cell, cAvidaContext& ctx, int dista
   Apto::String coop_inst = "Z";
   
   if (effect < 1)
-  agg_inst = m_world->GetHardwareManager().GetInstSet(organism->GetGenome().Properties().Get("instset").StringValue()).GetInst("agg-SA").GetSymbol();
+  agg_inst = m_world->GetHardwareManager().GetInstSet(organism->GetGenome()).GetInst("agg-SA").GetSymbol();
   else
-  coop_inst = m_world->GetHardwareManager().GetInstSet(organism->GetGenome().Properties().Get("instset").StringValue()).GetInst("coop-SA").GetSymbol();
+  coop_inst = m_world->GetHardwareManager().GetInstSet(organism->GetGenome()).GetInst("coop-SA").GetSymbol();
   int radius = m_world->GetConfig().KABOOM_RADIUS.Get();
   
   int sa_kin_count = 0;
@@ -3203,7 +3198,7 @@ void cPopulation::ReplaceDeme(cDeme& source_deme, cDeme& target_deme, cAvidaCont
     Genome next_germ(source_deme.GetGermline().GetLatest());
     InstructionSequencePtr seq;
     seq.DynamicCastFrom(next_germ.Representation());
-    const cInstSet& instset = m_world->GetHardwareManager().GetInstSet(next_germ.Properties().Get(s_prop_id_instset).StringValue());
+    const cInstSet& instset = m_world->GetHardwareManager().GetInstSet(next_germ);
     
     if (m_world->GetConfig().GERMLINE_COPY_MUT.Get() > 0.0) {
       for(int i = 0; i < seq->GetSize(); ++i) {
@@ -3257,12 +3252,12 @@ void cPopulation::ReplaceDeme(cDeme& source_deme, cDeme& target_deme, cAvidaCont
     InstructionSequencePtr seq;
     seq.DynamicCastFrom(mg.Representation());
     cCPUMemory new_genome(*seq);
-    const cInstSet& instset = m_world->GetHardwareManager().GetInstSet(mg.Properties().Get(s_prop_id_instset).StringValue());
+    const cInstSet& instset = m_world->GetHardwareManager().GetInstSet(mg);
     
     if (m_world->GetConfig().GERMLINE_COPY_MUT.Get() > 0.0) {
       for(int i=0; i < new_genome.GetSize(); ++i) {
         if (ctx.GetRandom().P(m_world->GetConfig().GERMLINE_COPY_MUT.Get())) {
-          new_genome[i] = instset.GetRandomInst(ctx);
+          new_genome.SetInst(i, instset.GetRandomInst(ctx));
         }
       }
     }
@@ -3435,15 +3430,15 @@ void cPopulation::ReplaceDemeFlaggedGermline(cDeme& source_deme, cDeme& target_d
     seq.DynamicCastFrom(mg.Representation());
     cCPUMemory new_genome(*seq);
 
-    const cInstSet& instset = m_world->GetHardwareManager().GetInstSet(mg.Properties().Get(s_prop_id_instset).StringValue());
+    const cInstSet& instset = m_world->GetHardwareManager().GetInstSet(mg);
     
     if (m_world->GetConfig().GERMLINE_COPY_MUT.Get() > 0.0) {
       for(int i=0; i<new_genome.GetSize(); ++i) {
         if (m_world->GetRandom().P(m_world->GetConfig().GERMLINE_COPY_MUT.Get())) {
-          new_genome[i] = instset.GetRandomInst(ctx2);
+          new_genome.SetInst(i, instset.GetRandomInst(ctx2));
         } else if (in_memory_genome.GetSize() > i){
           // this line copies the mutations accured as a result of performing tasks to the new genome
-          new_genome[i] = in_memory_genome[i]; 
+          new_genome.SetInst(i, in_memory_genome[i]);
         }
       }
     }
@@ -3675,10 +3670,9 @@ bool cPopulation::SeedDeme(cDeme& source_deme, cDeme& target_deme, cAvidaContext
           if (source_deme.GetOrgCount() >= 2) {
             
             //Collect prospective founder organisms into a list
-            for (int i=0; i < source_deme.GetSize(); i++) {
-              if ( GetCell(source_deme.GetCellID(i)).IsOccupied() ) {
-                prospective_founders.Push( GetCell(source_deme.GetCellID(i)).GetOrganism() );
-              }
+            for (int pos = source_deme.NextOccupiedPosition(0); pos < source_deme.GetSize();
+                 pos = source_deme.NextOccupiedPosition(pos + 1)) {
+              prospective_founders.Push(source_deme.GetOrganism(pos));
             }
             
             //add orgs alternately to source and target founders until
@@ -4066,12 +4060,12 @@ void cPopulation::SeedDeme_InjectDemeFounder(int _cell_id, Systematics::GroupPtr
     InstructionSequencePtr seq;
     seq.DynamicCastFrom(mg.Representation());
     cCPUMemory new_genome(*seq);
-    const cInstSet& instset = m_world->GetHardwareManager().GetInstSet(mg.Properties().Get(s_prop_id_instset).StringValue());
+    const cInstSet& instset = m_world->GetHardwareManager().GetInstSet(mg);
     
     if (m_world->GetConfig().GERMLINE_COPY_MUT.Get() > 0.0) {
       for(int i=0; i<new_genome.GetSize(); ++i) {
         if (ctx.GetRandom().P(m_world->GetConfig().GERMLINE_COPY_MUT.Get())) {
-          new_genome[i] = instset.GetRandomInst(ctx);
+          new_genome.SetInst(i, instset.GetRandomInst(ctx));
         }
       }
     }
@@ -4488,14 +4482,20 @@ void cPopulation::CheckImplicitDemeRepro(cDeme& deme, cAvidaContext& ctx) {
   
   if (GetNumDemes() <= 1) return;
   
-  if (m_world->GetConfig().DEMES_REPLICATE_CPU_CYCLES.Get()
-      && (deme.GetTimeUsed() >= m_world->GetConfig().DEMES_REPLICATE_CPU_CYCLES.Get())) ReplicateDeme(deme, ctx); 
-  else if (m_world->GetConfig().DEMES_REPLICATE_TIME.Get() 
-           && (deme.GetNormalizedTimeUsed() >= m_world->GetConfig().DEMES_REPLICATE_TIME.Get())) ReplicateDeme(deme, ctx); 
-  else if (m_world->GetConfig().DEMES_REPLICATE_BIRTHS.Get() 
-           && (deme.GetBirthCount() >= m_world->GetConfig().DEMES_REPLICATE_BIRTHS.Get())) ReplicateDeme(deme, ctx); 
-  else if (m_world->GetConfig().DEMES_REPLICATE_ORGS.Get() 
-           && (deme.GetOrgCount() >= m_world->GetConfig().DEMES_REPLICATE_ORGS.Get())) ReplicateDeme(deme, ctx);      
+  if (ImplicitDemeReproDue(deme)) ReplicateDeme(deme, ctx);
+}
+
+// Only reads deme state, so concurrently running demes may each test their own
+bool cPopulation::ImplicitDemeReproDue(cDeme& deme)
+{
+  return (m_world->GetConfig().DEMES_REPLICATE_CPU_CYCLES.Get()
+          && (deme.GetTimeUsed() >= m_world->GetConfig().DEMES_REPLICATE_CPU_CYCLES.Get()))
+      || (m_world->GetConfig().DEMES_REPLICATE_TIME.Get() 
+          && (deme.GetNormalizedTimeUsed() >= m_world->GetConfig().DEMES_REPLICATE_TIME.Get()))
+      || (m_world->GetConfig().DEMES_REPLICATE_BIRTHS.Get() 
+          && (deme.GetBirthCount() >= m_world->GetConfig().DEMES_REPLICATE_BIRTHS.Get()))
+      || (m_world->GetConfig().DEMES_REPLICATE_ORGS.Get() 
+          && (deme.GetOrgCount() >= m_world->GetConfig().DEMES_REPLICATE_ORGS.Get()));
 }
 
 // Print out all statistics about individual demes
@@ -4819,7 +4819,7 @@ void cPopulation::PrintDemeInstructions()
       for (int i = 0; i < cur_deme.GetSize(); i++) {
         int cur_cell = cur_deme.GetCellID(i);
         if (!cell_array[cur_cell].IsOccupied()) continue;
-        if (cell_array[cur_cell].GetOrganism()->GetGenome().Properties().Get(s_prop_id_instset).StringValue() != inst_set) continue;
+        if (m_world->GetHardwareManager().GetInstSetIndex(cell_array[cur_cell].GetOrganism()->GetGenome()) != is_id) continue;
         cPhenotype& phenotype = GetCell(cur_cell).GetOrganism()->GetPhenotype();
         
         for (int j = 0; j < num_inst; j++) single_deme_inst[j].Add(phenotype.GetLastInstCount()[j]);
@@ -5669,17 +5669,26 @@ int cPopulation::UpdateEmptyCellIDArray(int deme_id)
   // that resize it (like Push) will slow this code down considerably.
   // Instead, we keep track of how much of this memory we are using.
   
-  // Look at all cells
+  // Demes hold contiguous blocks of cells, so visiting every deme in order visits all cells in order.  When the demes
+  // do not cover the world (WORLD_Y not divisible by NUM_DEMES) the leftover cells belong to no deme, so look at all
+  // cells directly.
   if (deme_id == -1) {
-    for (int i=0; i<cell_array.GetSize(); i++) {
-      if (GetCell(i).IsOccupied() == false) empty_cell_id_array[num_empty_cells++] = i;
+    int num_deme_cells = 0;
+    for (int i = 0; i < deme_array.GetSize(); i++) num_deme_cells += deme_array[i].GetSize();
+    if (num_deme_cells != cell_array.GetSize()) {
+      for (int i = 0; i < cell_array.GetSize(); i++) {
+        if (GetCell(i).IsOccupied() == false) empty_cell_id_array[num_empty_cells++] = i;
+      }
+      return num_empty_cells;
     }
   }
-  // Look at a specific deme
-  else {
-    cDeme& deme = deme_array[deme_id];
-    for (int i=0; i<deme.GetSize(); i++) {
-      if (GetCell(deme.GetCellID(i)).IsOccupied() == false) empty_cell_id_array[num_empty_cells++] = deme.GetCellID(i);
+  
+  const int first_deme = (deme_id == -1) ? 0 : deme_id;
+  const int last_deme = (deme_id == -1) ? deme_array.GetSize() - 1 : deme_id;
+  for (int cur_deme = first_deme; cur_deme <= last_deme; cur_deme++) {
+    cDeme& deme = deme_array[cur_deme];
+    for (int pos = deme.NextEmptyPosition(0); pos < deme.GetSize(); pos = deme.NextEmptyPosition(pos + 1)) {
+      empty_cell_id_array[num_empty_cells++] = deme.GetCellID(pos);
     }
   }
   return num_empty_cells;
@@ -5778,6 +5787,37 @@ void cPopulation::ProcessStepSpeculative(cAvidaContext& ctx, double step_size, i
   resource_count.Update(step_size);
 }
 
+
+void cPopulation::ProcessUpdateByDeme(cAvidaContext& ctx, int UD_size, double step_size)
+{
+  assert(m_deme_executor);
+  m_deme_executor->ProcessUpdate(ctx, UD_size, step_size);
+}
+
+
+// Execute a slice that concurrent deme execution held back for the barrier.  Resource time and the executed count are
+// advanced by the caller for the whole round.  Returns false if the cell was emptied before its slice came up.
+bool cPopulation::ProcessDeferredStep(cAvidaContext& ctx, int cell_id)
+{
+  cPopulationCell& cell = GetCell(cell_id);
+  if (!cell.IsOccupied()) return false;
+  cOrganism* cur_org = cell.GetOrganism();
+  
+  cell.GetHardware()->SingleProcess(ctx);
+  
+  double merit = cur_org->GetPhenotype().GetMerit().GetDouble();
+  if (cur_org->GetPhenotype().GetToDelete() == true) {
+    cur_org->GetHardware().DeleteMiniTrace(print_mini_trace_reacs);
+    delete cur_org;
+  }
+  
+  cDeme& deme = GetDeme(cell.GetDemeID());
+  deme.IncTimeUsed(merit);
+  CheckImplicitDemeRepro(deme, ctx);
+  
+  return true;
+}
+
 // Loop through all the demes getting stats and doing calculations
 // which must be done on a deme by deme basis.
 void cPopulation::UpdateDemeStats(cAvidaContext& ctx) { 
@@ -5895,7 +5935,7 @@ void cPopulation::UpdateOrganismStats(cAvidaContext& ctx)
     const int cur_gestation_time = phenotype.GetGestationTime();
     const int cur_genome_length = phenotype.GetGenomeLength();
     
-    Apto::Array<Apto::Stat::Accumulator<int> >& from_message_exec_counts = stats.InstFromMessageExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+    Apto::Array<Apto::Stat::Accumulator<int> >& from_message_exec_counts = stats.InstFromMessageExeCountsForInstSet(m_world->GetHardwareManager().GetInstSet(organism->GetGenome()).GetInstSetName());
     for (int j = 0; j < phenotype.GetLastFromMessageInstCount().GetSize(); j++) {
       from_message_exec_counts[j].Add(organism->GetPhenotype().GetLastFromMessageInstCount()[j]);
     }
@@ -6068,6 +6108,7 @@ void cPopulation::UpdateFTOrgStats(cAvidaContext&)
   for (int i = 0; i < live_org_list.GetSize(); i++) {
     cOrganism* organism = live_org_list[i];
     const cPhenotype& phenotype = organism->GetPhenotype();
+    const cString& inst_set = m_world->GetHardwareManager().GetInstSet(organism->GetGenome()).GetInstSetName();
     const cMerit cur_merit = phenotype.GetMerit();
     const double cur_fitness = phenotype.GetFitness();
     
@@ -6078,11 +6119,11 @@ void cPopulation::UpdateFTOrgStats(cAvidaContext&)
       stats.SumPreyCreatureAge().Add(phenotype.GetAge());
       stats.SumPreyGeneration().Add(phenotype.GetGeneration());
       
-      Apto::Array<Apto::Stat::Accumulator<int> >& prey_inst_exe_counts = stats.InstPreyExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      Apto::Array<Apto::Stat::Accumulator<int> >& prey_inst_exe_counts = stats.InstPreyExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
         prey_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
       }
-      Apto::Array<Apto::Stat::Accumulator<int> >& prey_from_sensor_exec_counts = stats.InstPreyFromSensorExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      Apto::Array<Apto::Stat::Accumulator<int> >& prey_from_sensor_exec_counts = stats.InstPreyFromSensorExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastFromSensorInstCount().GetSize(); j++) {
         prey_from_sensor_exec_counts[j].Add(organism->GetPhenotype().GetLastFromSensorInstCount()[j]);
       }
@@ -6096,19 +6137,19 @@ void cPopulation::UpdateFTOrgStats(cAvidaContext&)
       stats.SumAttacks().Add(phenotype.GetLastAttacks());
       stats.SumKills().Add(phenotype.GetLastKills());
 
-      Apto::Array<Apto::Stat::Accumulator<int> >& pred_inst_exe_counts = stats.InstPredExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      Apto::Array<Apto::Stat::Accumulator<int> >& pred_inst_exe_counts = stats.InstPredExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
         pred_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
       }
 
-      Apto::Array<Apto::Stat::Accumulator<int> >& pred_from_sensor_exec_counts = stats.InstPredFromSensorExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      Apto::Array<Apto::Stat::Accumulator<int> >& pred_from_sensor_exec_counts = stats.InstPredFromSensorExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastFromSensorInstCount().GetSize(); j++) {
         pred_from_sensor_exec_counts[j].Add(organism->GetPhenotype().GetLastFromSensorInstCount()[j]);
       }
 
-      Apto::Array<cString> att_inst = m_world->GetStats().GetGroupAttackInsts((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      Apto::Array<cString> att_inst = m_world->GetStats().GetGroupAttackInsts(inst_set);
       for (int k = 0; k < att_inst.GetSize(); k++) {
-        Apto::Array<Apto::Stat::Accumulator<int> >& group_attack_inst_exe_counts = stats.ExecCountsForGroupAttackInst((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue(), att_inst[k]);
+        Apto::Array<Apto::Stat::Accumulator<int> >& group_attack_inst_exe_counts = stats.ExecCountsForGroupAttackInst(inst_set, att_inst[k]);
         for (int j = 0; j < phenotype.GetLastGroupAttackInstCount()[k].GetSize(); j++) {
           group_attack_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastGroupAttackInstCount()[k][j]);
         }
@@ -6123,17 +6164,17 @@ void cPopulation::UpdateFTOrgStats(cAvidaContext&)
       stats.SumAttacks().Add(phenotype.GetLastAttacks());
       stats.SumKills().Add(phenotype.GetLastKills());
      
-      Apto::Array<Apto::Stat::Accumulator<int> >& tpred_inst_exe_counts = stats.InstTopPredExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      Apto::Array<Apto::Stat::Accumulator<int> >& tpred_inst_exe_counts = stats.InstTopPredExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
         tpred_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
       }
-      Apto::Array<Apto::Stat::Accumulator<int> >& tpred_from_sensor_exec_counts = stats.InstTopPredFromSensorExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      Apto::Array<Apto::Stat::Accumulator<int> >& tpred_from_sensor_exec_counts = stats.InstTopPredFromSensorExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastFromSensorInstCount().GetSize(); j++) {
         tpred_from_sensor_exec_counts[j].Add(organism->GetPhenotype().GetLastFromSensorInstCount()[j]);
       }
-      Apto::Array<cString> att_inst = m_world->GetStats().GetGroupAttackInsts((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      Apto::Array<cString> att_inst = m_world->GetStats().GetGroupAttackInsts(inst_set);
       for (int k = 0; k < att_inst.GetSize(); k++) {
-        Apto::Array<Apto::Stat::Accumulator<int> >& group_attack_inst_exe_counts = stats.ExecCountsForGroupAttackInst((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue(), att_inst[k]);
+        Apto::Array<Apto::Stat::Accumulator<int> >& group_attack_inst_exe_counts = stats.ExecCountsForGroupAttackInst(inst_set, att_inst[k]);
         for (int j = 0; j < phenotype.GetLastTopPredGroupAttackInstCount()[k].GetSize(); j++) {
           group_attack_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastTopPredGroupAttackInstCount()[k][j]);
         }
@@ -6180,6 +6221,7 @@ void cPopulation::UpdateMaleFemaleOrgStats(cAvidaContext& ctx)
   for (int i = 0; i < live_org_list.GetSize(); i++) {  
     cOrganism* organism = live_org_list[i];
     const cPhenotype& phenotype = organism->GetPhenotype();
+    const cString& inst_set = m_world->GetHardwareManager().GetInstSet(organism->GetGenome()).GetInstSetName();
     const cMerit cur_merit = phenotype.GetMerit();
     const double cur_fitness = phenotype.GetFitness();
     
@@ -6190,7 +6232,7 @@ void cPopulation::UpdateMaleFemaleOrgStats(cAvidaContext& ctx)
       stats.SumMaleCreatureAge().Add(phenotype.GetAge());
       stats.SumMaleGeneration().Add(phenotype.GetGeneration());
       
-      Apto::Array<Apto::Stat::Accumulator<int> >& male_inst_exe_counts = stats.InstMaleExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      Apto::Array<Apto::Stat::Accumulator<int> >& male_inst_exe_counts = stats.InstMaleExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
         male_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
       }
@@ -6202,7 +6244,7 @@ void cPopulation::UpdateMaleFemaleOrgStats(cAvidaContext& ctx)
       stats.SumFemaleCreatureAge().Add(phenotype.GetAge());
       stats.SumFemaleGeneration().Add(phenotype.GetGeneration());
       
-      Apto::Array<Apto::Stat::Accumulator<int> >& female_inst_exe_counts = stats.InstFemaleExeCountsForInstSet((const char*)organism->GetGenome().Properties().Get(s_prop_id_instset).StringValue());
+      Apto::Array<Apto::Stat::Accumulator<int> >& female_inst_exe_counts = stats.InstFemaleExeCountsForInstSet(inst_set);
       for (int j = 0; j < phenotype.GetLastInstCount().GetSize(); j++) {
         female_inst_exe_counts[j].Add(organism->GetPhenotype().GetLastInstCount()[j]);
       }
@@ -6218,6 +6260,46 @@ void cPopulation::UpdateResStats(cAvidaContext& ctx)
   stats.SetResourcesGeometry(resource_count.GetResourcesGeometry()); 
 }
 
+void cPopulation::PointMutateOrganisms(cAvidaContext& ctx)
+{
+  const double mut_prob = m_world->GetConfig().POINT_MUT_PROB.Get();
+  const bool skip_sampling = m_world->GetConfig().MUTATION_SKIP_SAMPLING.Get() && mut_prob > 0.0;
+  
+  // With skip sampling, substitutions are placed by walking the sites of all organisms in cell order and jumping a
+  // geometrically distributed distance between mutations, rather than drawing a binomial count per organism
+  int skip = (skip_sampling) ? cMutationRates::DrawSkip(ctx, mut_prob) : 0;
+  
+  for (int i = 0; i < cell_array.GetSize(); i++) {
+    if (!cell_array[i].IsOccupied()) continue;
+    cOrganism* organism = cell_array[i].GetOrganism();
+    
+    // Organisms with their own point mutation rates, or with insertions and deletions, mutate individually
+    if (!skip_sampling || organism->GetPointMutProb() != mut_prob ||
+        organism->GetPointInsProb() > 0.0 || organism->GetPointDelProb() > 0.0) {
+      organism->IncPointMutations(organism->GetHardware().PointMutate(ctx));
+      continue;
+    }
+    
+    cCPUMemory& memory = organism->GetHardware().GetMemory();
+    const int num_sites = memory.GetSize();
+    if (skip >= num_sites) {
+      skip -= num_sites;
+      continue;
+    }
+    
+    memory.TouchAll();
+    int num_mut = 0;
+    while (skip < num_sites) {
+      memory.SetInst(skip, organism->GetHardware().GetInstSet().GetRandomInst(ctx));
+      num_mut++;
+      const int next = cMutationRates::DrawSkip(ctx, mut_prob);
+      skip = (next < INT_MAX - skip - 1) ? skip + next + 1 : INT_MAX;
+    }
+    skip -= num_sites;
+    organism->IncPointMutations(num_mut);
+  }
+}
+
 void cPopulation::ProcessPreUpdate()
 {
   resource_count.SetSpatialUpdate(m_world->GetStats().GetUpdate());
@@ -6715,7 +6797,7 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
 {
   // @TODO - build in support for verifying population dimensions
   
-  cInitFile input_file(filename, m_world->GetWorkingDir(), ctx.Driver().Feedback());
+  cDetailFileReader input_file(filename, m_world->GetWorkingDir(), ctx.Driver().Feedback());
   if (!input_file.WasOpened()) return false;
   
   // Clear out the population, unless an offset is being used
@@ -6728,8 +6810,6 @@ bool cPopulation::LoadPopulation(const cString& filename, cAvidaContext& ctx, in
   
   bool structured = false;
   for (int line_id = 0; line_id < input_file.GetNumLines(); line_id++) {
-    cString cur_line = input_file.GetLine(line_id);
-    
     // Setup the genotype for this line...
     sTmpGenotype& tmp = genotypes[line_id];
     tmp.props = input_file.GetLineAsDict(line_id);
@@ -7326,13 +7406,17 @@ void cPopulation::BuildTimeSlicer()
       break;
     case SLICE_PROB_MERIT:
     {
-      Apto::SmartPtr<Apto::Random> rng(new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(0x7FFFFFFF)));
+      Apto::SmartPtr<Apto::Random> rng;
+      if (m_world->UsesRandomStreams()) rng = Apto::SmartPtr<Apto::Random>(m_world->NewRandomStream(RANDOM_STREAM_SCHEDULER, 0));
+      else rng = Apto::SmartPtr<Apto::Random>(new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(0x7FFFFFFF)));
       m_scheduler = new Apto::Scheduler::Probabilistic(cell_array.GetSize(), rng);
     }
       break;
     case SLICE_PROB_INTEGRATED_MERIT:
     {
-      Apto::SmartPtr<Apto::Random> rng(new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(m_world->GetRandom().MaxSeed())));
+      Apto::SmartPtr<Apto::Random> rng;
+      if (m_world->UsesRandomStreams()) rng = Apto::SmartPtr<Apto::Random>(m_world->NewRandomStream(RANDOM_STREAM_SCHEDULER, 0));
+      else rng = Apto::SmartPtr<Apto::Random>(new Apto::RNG::AvidaRNG(m_world->GetRandom().GetInt(m_world->GetRandom().MaxSeed())));
       m_scheduler = new Apto::Scheduler::ProbabilisticIntegrated(cell_array.GetSize(), rng);
     }
       break;
@@ -7341,6 +7425,43 @@ void cPopulation::BuildTimeSlicer()
       m_world->GetDriver().Abort(Avida::INVALID_CONFIG);
       break;
   }
+  
+  int deme_threads = m_world->GetConfig().DEME_THREADS.Get();
+  if (deme_threads != 0) {
+    if (deme_threads < 0) deme_threads = Apto::Platform::AvailableCPUs();
+    if (DemesAreIsolated()) m_deme_executor = new cDemeExecutor(m_world, this, deme_threads);
+    else cout << "warning: DEME_THREADS ignored, demes are not isolated in this configuration." << endl;
+  }
+}
+
+// Concurrent deme execution relies upon speculative execution to keep each deme's organisms to themselves, and upon
+// nothing moving between demes except at the barrier.  Every instruction that can run outside the barrier must be
+// audited as touching only the executing organism (nInstFlag::ISOLATED); anything else must stall.
+bool cPopulation::DemesAreIsolated()
+{
+  cAvidaConfig& config = m_world->GetConfig();
+  if (GetNumDemes() <= 1) return false;
+  if (!config.SPECULATIVE.Get()) return false;
+  if (config.MIGRATION_RATE.Get() > 0.0 || config.DEMES_MIGRATION_RATE.Get() > 0.0 ||
+      config.DEMES_PARASITE_MIGRATION_RATE.Get() > 0.0) return false;
+  if (config.THREAD_SLICING_METHOD.Get() == 1) return false;
+  if (config.IMPLICIT_REPRO_TIME.Get() || config.IMPLICIT_REPRO_CPU_CYCLES.Get() || config.IMPLICIT_REPRO_BONUS.Get() ||
+      config.IMPLICIT_REPRO_END.Get() || config.IMPLICIT_REPRO_ENERGY.Get()) return false;
+  
+  if (config.ENERGY_ENABLED.Get() || config.PROMOTERS_ENABLED.Get() || config.CONSTITUTIVE_REGULATION.Get()) return false;
+  
+  const cHardwareManager& hw_mgr = m_world->GetHardwareManager();
+  for (int i = 0; i < hw_mgr.GetNumInstSets(); i++) {
+    const cInstSet& inst_set = hw_mgr.GetInstSet(i);
+    if (inst_set.GetHardwareType() != HARDWARE_TYPE_CPU_ORIGINAL) return false;
+    if (inst_set.HasResCosts() || inst_set.HasFemResCosts()) return false;
+    for (int op = 0; op < inst_set.GetSize(); op++) {
+      const Instruction inst(op);
+      if (!inst_set.ShouldStall(inst) && !inst_set.IsIsolated(inst)) return false;
+    }
+  }
+  
+  return true;
 }
 
 
@@ -7584,80 +7705,7 @@ void cPopulation::InjectPreyClone(cAvidaContext& ctx, cOrganism* org_to_clone) {
 
 void cPopulation::PrintPhenotypeData(const cString& filename)
 {
-  set<int> ids;
-  set<cString> complete;
-  double average_shannon_diversity = 0.0;
-  int num_orgs = 0; //could get from elsewhere, but more self-contained this way
-  double average_num_tasks = 0.0;
-  
-  //implementing a very poor man's hash...
-  Apto::Array<int> phenotypes;
-  Apto::Array<int> phenotype_counts;
-  
-  for (int i = 0; i < cell_array.GetSize(); i++) {
-    // Only look at cells with organisms in them.
-    if (cell_array[i].IsOccupied() == false) continue;
-    
-    num_orgs++;
-    const cPhenotype& phenotype = cell_array[i].GetOrganism()->GetPhenotype();
-    
-    int total_tasks = 0;
-    int id = 0;
-    cString key;
-    for (int j = 0; j < phenotype.GetLastTaskCount().GetSize(); j++) {
-      if (phenotype.GetLastTaskCount()[j] > 0) id += (1 << j);
-      if (phenotype.GetLastTaskCount()[j] > 0) average_num_tasks += 1.0;
-      key += cStringUtil::Stringf("%i-", phenotype.GetLastTaskCount()[j]);
-      total_tasks += phenotype.GetLastTaskCount()[j];
-    }
-    ids.insert(id);
-    complete.insert(key);
-    
-    // add one to our count for this key
-    int k;
-    for(k=0; k<phenotypes.GetSize(); k++)
-    {
-      if (phenotypes[k] == id) {
-        phenotype_counts[k] = phenotype_counts[k] + 1;
-        break;
-      }
-    }
-    // this is a new key
-    if (k == phenotypes.GetSize()) {
-      phenotypes.Push(id);
-      phenotype_counts.Push(1);
-    }
-    
-    // go through again to calculate Shannon Diversity of task counts
-    // now that we know the total number of tasks done
-    double shannon_diversity = 0;
-    for (int j = 0; j < phenotype.GetLastTaskCount().GetSize(); j++) {
-      if (phenotype.GetLastTaskCount()[j] == 0) continue;
-      double fraction = static_cast<double>(phenotype.GetLastTaskCount()[j]) / static_cast<double>(total_tasks);
-      shannon_diversity -= fraction * log(fraction) / log(2.0);
-    }
-    
-    average_shannon_diversity += static_cast<double>(shannon_diversity);
-  }
-  
-  double shannon_diversity_of_phenotypes = 0.0;
-  for (int j = 0; j < phenotype_counts.GetSize(); j++) {
-    double fraction = static_cast<double>(phenotype_counts[j]) / static_cast<double>(num_orgs);
-    shannon_diversity_of_phenotypes -= fraction * log(fraction) / log(2.0);
-  }
-  
-  average_shannon_diversity /= static_cast<double>(num_orgs);
-  average_num_tasks /= num_orgs;
-  
-  Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  df->WriteTimeStamp();
-  df->Write(m_world->GetStats().GetUpdate(), "Update");
-  df->Write(static_cast<int>(ids.size()), "Unique Phenotypes (by task done)");
-  df->Write(shannon_diversity_of_phenotypes, "Shannon Diversity of Phenotypes (by task done)");
-  df->Write(static_cast<int>(complete.size()), "Unique Phenotypes (by task count)");
-  df->Write(average_shannon_diversity, "Average Phenotype Shannon Diversity (by task count)");
-  df->Write(average_num_tasks, "Average Task Diversity (number of different tasks)");
-  df->Endl();
+  PrintTaskPhenotypeData(filename, &cPhenotype::GetLastTaskCount);
 }
 
 void cPopulation::PrintPhenotypeStatus(const cString& filename)
@@ -7708,134 +7756,54 @@ void cPopulation::PrintPhenotypeStatus(const cString& filename)
 
 void cPopulation::PrintHostPhenotypeData(const cString& filename)
 {
-  set<int> ids;
-  set<cString> complete;
-  double average_shannon_diversity = 0.0;
-  int num_orgs = 0; //could get from elsewhere, but more self-contained this way
-  double average_num_tasks = 0.0;
-  
-  //implementing a very poor man's hash...
-  Apto::Array<int> phenotypes;
-  Apto::Array<int> phenotype_counts;
-  
-  for (int i = 0; i < cell_array.GetSize(); i++) {
-    // Only look at cells with organisms in them.
-    if (cell_array[i].IsOccupied() == false) continue;
-    
-    num_orgs++;
-    const cPhenotype& phenotype = cell_array[i].GetOrganism()->GetPhenotype();
-    
-    int total_tasks = 0;
-    int id = 0;
-    cString key;
-    for (int j = 0; j < phenotype.GetLastHostTaskCount().GetSize(); j++) {
-      if (phenotype.GetLastHostTaskCount()[j] > 0) id += (1 << j);
-      if (phenotype.GetLastHostTaskCount()[j] > 0) average_num_tasks += 1.0;
-      key += cStringUtil::Stringf("%i-", phenotype.GetLastHostTaskCount()[j]);
-      total_tasks += phenotype.GetLastHostTaskCount()[j];
-    }
-    ids.insert(id);
-    complete.insert(key);
-    
-    // add one to our count for this key
-    int k;
-    for(k=0; k<phenotypes.GetSize(); k++)
-    {
-      if (phenotypes[k] == id) {
-        phenotype_counts[k] = phenotype_counts[k] + 1;
-        break;
-      }
-    }
-    // this is a new key
-    if (k == phenotypes.GetSize()) {
-      phenotypes.Push(id);
-      phenotype_counts.Push(1);
-    }
-    
-    // go through again to calculate Shannon Diversity of task counts
-    // now that we know the total number of tasks done
-    double shannon_diversity = 0;
-    for (int j = 0; j < phenotype.GetLastHostTaskCount().GetSize(); j++) {
-      if (phenotype.GetLastHostTaskCount()[j] == 0) continue;
-      double fraction = static_cast<double>(phenotype.GetLastHostTaskCount()[j]) / static_cast<double>(total_tasks);
-      shannon_diversity -= fraction * log(fraction) / log(2.0);
-    }
-    
-    average_shannon_diversity += static_cast<double>(shannon_diversity);
-  }
-  
-  double shannon_diversity_of_phenotypes = 0.0;
-  for (int j = 0; j < phenotype_counts.GetSize(); j++) {
-    double fraction = static_cast<double>(phenotype_counts[j]) / static_cast<double>(num_orgs);
-    shannon_diversity_of_phenotypes -= fraction * log(fraction) / log(2.0);
-  }
-  
-  average_shannon_diversity /= static_cast<double>(num_orgs);
-  average_num_tasks /= num_orgs;
-  
-  Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
-  df->WriteTimeStamp();
-  df->Write(m_world->GetStats().GetUpdate(), "Update");
-  df->Write(static_cast<int>(ids.size()), "Unique Phenotypes (by task done)");
-  df->Write(shannon_diversity_of_phenotypes, "Shannon Diversity of Phenotypes (by task done)");
-  df->Write(static_cast<int>(complete.size()), "Unique Phenotypes (by task count)");
-  df->Write(average_shannon_diversity, "Average Phenotype Shannon Diversity (by task count)");
-  df->Write(average_num_tasks, "Average Task Diversity (number of different tasks)");
-  df->Endl();
+  PrintTaskPhenotypeData(filename, &cPhenotype::GetLastHostTaskCount);
 }
 
 void cPopulation::PrintParasitePhenotypeData(const cString& filename)
 {
-  set<int> ids;
-  set<cString> complete;
+  PrintTaskPhenotypeData(filename, &cPhenotype::GetLastParasiteTaskCount);
+}
+
+// Phenotypes are told apart by signature (see cPhenotypeSignature) rather than by string keys, so that these outputs
+// stay cheap enough to print every update on large populations.
+void cPopulation::PrintTaskPhenotypeData(const cString& filename, const Apto::Array<int>& (cPhenotype::*task_counts)() const)
+{
+  tPhenotypeSignatureMap<int> done_index;   // by task done, index into phenotype_counts
+  tPhenotypeSignatureMap<int> complete;     // by task count
+  Apto::Array<int, Apto::Smart> phenotype_counts;
   double average_shannon_diversity = 0.0;
   int num_orgs = 0; //could get from elsewhere, but more self-contained this way
   double average_num_tasks = 0.0;
   
-  //implementing a very poor man's hash...
-  Apto::Array<int> phenotypes;
-  Apto::Array<int> phenotype_counts;
-  
   for (int i = 0; i < cell_array.GetSize(); i++) {
     // Only look at cells with organisms in them.
     if (cell_array[i].IsOccupied() == false) continue;
     
     num_orgs++;
-    const cPhenotype& phenotype = cell_array[i].GetOrganism()->GetPhenotype();
+    const Apto::Array<int>& counts = (cell_array[i].GetOrganism()->GetPhenotype().*task_counts)();
     
     int total_tasks = 0;
-    int id = 0;
-    cString key;
-    for (int j = 0; j < phenotype.GetLastParasiteTaskCount().GetSize(); j++) {
-      if (phenotype.GetLastParasiteTaskCount()[j] > 0) id += (1 << j);
-      if (phenotype.GetLastParasiteTaskCount()[j] > 0) average_num_tasks += 1.0;
-      key += cStringUtil::Stringf("%i-", phenotype.GetLastParasiteTaskCount()[j]);
-      total_tasks += phenotype.GetLastParasiteTaskCount()[j];
-    }
-    ids.insert(id);
-    complete.insert(key);
-    
-    // add one to our count for this key
-    int k;
-    for(k=0; k<phenotypes.GetSize(); k++)
-    {
-      if (phenotypes[k] == id) {
-        phenotype_counts[k] = phenotype_counts[k] + 1;
-        break;
-      }
+    for (int j = 0; j < counts.GetSize(); j++) {
+      if (counts[j] > 0) average_num_tasks += 1.0;
+      total_tasks += counts[j];
     }
-    // this is a new key
-    if (k == phenotypes.GetSize()) {
-      phenotypes.Push(id);
-      phenotype_counts.Push(1);
+    
+    // add one to our count for this phenotype, in order of first appearance
+    bool inserted = false;
+    int& index = done_index.Get(cPhenotypeSignature::OfPresence(counts), inserted);
+    if (inserted) {
+      index = phenotype_counts.GetSize();
+      phenotype_counts.Push(0);
     }
+    phenotype_counts[index]++;
+    complete.Get(cPhenotypeSignature::OfCounts(counts), inserted);
     
     // go through again to calculate Shannon Diversity of task counts
     // now that we know the total number of tasks done
     double shannon_diversity = 0;
-    for (int j = 0; j < phenotype.GetLastParasiteTaskCount().GetSize(); j++) {
-      if (phenotype.GetLastParasiteTaskCount()[j] == 0) continue;
-      double fraction = static_cast<double>(phenotype.GetLastParasiteTaskCount()[j]) / static_cast<double>(total_tasks);
+    for (int j = 0; j < counts.GetSize(); j++) {
+      if (counts[j] == 0) continue;
+      double fraction = static_cast<double>(counts[j]) / static_cast<double>(total_tasks);
       shannon_diversity -= fraction * log(fraction) / log(2.0);
     }
     
@@ -7854,9 +7822,9 @@ void cPopulation::PrintParasitePhenotypeData(const cString& filename)
   Avida::Output::FilePtr df = Avida::Output::File::StaticWithPath(m_world->GetNewWorld(), (const char*)filename);
   df->WriteTimeStamp();
   df->Write(m_world->GetStats().GetUpdate(), "Update");
-  df->Write(static_cast<int>(ids.size()), "Unique Phenotypes (by task done)");
+  df->Write(done_index.GetSize(), "Unique Phenotypes (by task done)");
   df->Write(shannon_diversity_of_phenotypes, "Shannon Diversity of Phenotypes (by task done)");
-  df->Write(static_cast<int>(complete.size()), "Unique Phenotypes (by task count)");
+  df->Write(complete.GetSize(), "Unique Phenotypes (by task count)");
   df->Write(average_shannon_diversity, "Average Phenotype Shannon Diversity (by task count)");
   df->Write(average_num_tasks, "Average Task Diversity (number of different tasks)");
   df->Endl();
@@ -8642,18 +8610,6 @@ void  cPopulation::JoinGroup(cOrganism* org, int group_id)
     m_groups[group_id] = 0;
     Apto::Array<cOrganism*, Apto::Smart> temp;
     m_group_list.Set(group_id, temp);
-    // If tolerance is on, create the new group's tolerance cache
-    if (m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0) {
-      Apto::Array<pair<int,int> > temp_array(2);
-      temp_array[0] = make_pair(-1, -1);
-      temp_array[1] = make_pair(-1, -1);
-      m_group_intolerances.Set(group_id, temp_array);
-      if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
-        m_group_intolerances_females.Set(group_id, temp_array);
-        m_group_intolerances_males.Set(group_id, temp_array);
-        m_group_intolerances_juvs.Set(group_id, temp_array);
-      }
-    }
   }
   // add to group
   m_groups[group_id]++;
@@ -8661,21 +8617,10 @@ void  cPopulation::JoinGroup(cOrganism* org, int group_id)
   else if (org->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) m_group_males[group_id]++;
   
   m_group_list[group_id].Push(org);
-  // If tolerance is on, must add the organism's intolerance to the group cache
+  // If tolerance is on, the organism's tolerances join the group's running sums
   if (m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0) {
-    int tol_max = m_world->GetConfig().MAX_TOLERANCE.Get();
-    int immigrant_tol = org->GetPhenotype().CalcToleranceImmigrants();
-    m_group_intolerances[group_id][0].second += tol_max - immigrant_tol;
-    if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
-      if (org->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
-        m_group_intolerances_females[group_id][0].second += tol_max - immigrant_tol;
-      } else if (org->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
-        m_group_intolerances_males[group_id][0].second += tol_max - immigrant_tol;
-      } else if (org->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) { 
-        m_group_intolerances_juvs[group_id][0].second += tol_max - immigrant_tol;
-      }
-    }
-    m_group_intolerances[group_id][1].second += tol_max - org->GetPhenotype().CalcToleranceOffspringOthers();
+    sGroupToleranceStats* stats = FindCurrentGroupToleranceStats(group_id);
+    if (stats) AdjustGroupToleranceStats(*stats, org, true);
   }
 }
 
@@ -8714,21 +8659,10 @@ void  cPopulation::LeaveGroup(cOrganism* org, int group_id)
     }
   }
 
-  // If tolerance is on, remove the organim's intolerance from the group's cache
-  if (m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0) { 
-    int tol_max = m_world->GetConfig().MAX_TOLERANCE.Get();
-    int immigrant_tol = org->GetPhenotype().CalcToleranceImmigrants();
-    m_group_intolerances[group_id][0].second -= tol_max - immigrant_tol;
-    if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
-      if (org->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
-        m_group_intolerances_females[group_id][0].second -= tol_max - immigrant_tol;
-      } else if (org->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
-        m_group_intolerances_males[group_id][0].second -= tol_max - immigrant_tol;
-      } else if (org->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) { 
-        m_group_intolerances_juvs[group_id][0].second -= tol_max - immigrant_tol; 
-      }
-    }
-    m_group_intolerances[group_id][1].second -= tol_max - org->GetPhenotype().CalcToleranceOffspringOthers();
+  // If tolerance is on, remove the organism's tolerances from the group's running sums
+  if (m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0) {
+    sGroupToleranceStats* stats = FindCurrentGroupToleranceStats(group_id);
+    if (stats) AdjustGroupToleranceStats(*stats, org, false);
   }
   
   for (int i = 0; i < m_group_list[group_id].GetSize(); i++) {
@@ -8740,6 +8674,7 @@ void  cPopulation::LeaveGroup(cOrganism* org, int group_id)
       if (m_world->GetConfig().USE_FORM_GROUPS.Get() == 1) {
         if (m_group_list[group_id].GetSize() <= 0) {
           m_group_list.Remove(group_id);
+          m_group_tolerance_stats.Remove(group_id);
         }
       }
       break;
@@ -8806,26 +8741,13 @@ void  cPopulation::ChangeGroupMatingTypes(cOrganism* org, int group_id, int old_
   if (new_type == 0) m_group_females[group_id]++;
   else if (new_type == 1) m_group_males[group_id]++;   
   
-  if (m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0) { 
-    if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
-      int tol_max = m_world->GetConfig().MAX_TOLERANCE.Get();
-      int immigrant_tol = org->GetPhenotype().CalcToleranceImmigrants();
-      // remove from old
-      if (old_type == 0) {
-        m_group_intolerances_females[group_id][0].second -= tol_max - immigrant_tol;
-      } else if (old_type == 1) {
-        m_group_intolerances_males[group_id][0].second -= tol_max - immigrant_tol;
-      } else if (old_type == 2) {
-        m_group_intolerances_juvs[group_id][0].second -= tol_max - immigrant_tol;   
-      }
-      // add to new
-      if (new_type == 0) {
-        m_group_intolerances_females[group_id][0].second += tol_max - immigrant_tol;
-      } else if (new_type == 1) {
-        m_group_intolerances_males[group_id][0].second += tol_max - immigrant_tol;
-      } else if (new_type == 2) {
-        m_group_intolerances_juvs[group_id][0].second += tol_max - immigrant_tol;      
-      }
+  // Move the organism's immigrant tolerance between the mating type sums
+  if (m_world->GetConfig().TOLERANCE_WINDOW.Get() > 0) {
+    sGroupToleranceStats* stats = FindCurrentGroupToleranceStats(group_id);
+    if (stats && old_type >= 0 && old_type <= 2 && new_type >= 0 && new_type <= 2) {
+      const double immigrant_tol = org->GetPhenotype().CalcToleranceImmigrants();
+      stats->immigrants_by_type[old_type].Subtract(immigrant_tol);
+      stats->immigrants_by_type[new_type].Add(immigrant_tol);
     }
   }
 }
@@ -8838,57 +8760,13 @@ int cPopulation::CalcGroupToleranceImmigrants(int group_id, int mating_type)
   if (group_id < 0) return tolerance_max;
   if (m_group_list[group_id].GetSize() <= 0) return tolerance_max;
   
-  // use cache, if up to date
-  int tol_update = m_group_intolerances[group_id][0].first;
-  int group_intol = m_group_intolerances[group_id][0].second;
-  if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
-    if (mating_type == 0) { 
-      tol_update = m_group_intolerances_females[group_id][0].first;
-      group_intol = m_group_intolerances_females[group_id][0].second;
-    } else if (mating_type == 1) { 
-      tol_update = m_group_intolerances_males[group_id][0].first;
-      group_intol = m_group_intolerances_males[group_id][0].second;
-    } else if (mating_type == 2) { 
-      tol_update = m_group_intolerances_juvs[group_id][0].first;
-      group_intol = m_group_intolerances_juvs[group_id][0].second;
-    }
-  }  
-  int cur_update = m_world->GetStats().GetUpdate();
-  if (tol_update == cur_update) return max(0, tolerance_max - group_intol);
-
-  // If can't use cache, sum the total group intolerance
-  int group_intolerance = 0;  
-  int single_member_intolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-    bool use_org = true;
-    // if using immigrant only tolerance + sex, only update the cache for this current mating type
-    if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
-      if (mating_type == 0 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() != MATING_TYPE_FEMALE)  use_org = false;
-      else if (mating_type == 1 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() != MATING_TYPE_MALE)  use_org = false;
-      else if (mating_type == 2 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() != MATING_TYPE_JUVENILE)  use_org = false;
-    }
-    if (use_org) single_member_intolerance = tolerance_max - m_group_list[group_id][index]->GetPhenotype().CalcToleranceImmigrants();
-    group_intolerance += single_member_intolerance;
-  }
-  
-  // Save current update and current intolerance to group cache
-  // this is the only time we can do this since this is the only 
-  // time we ever look at the entire group (updated every individual) or sub-group (by sex)
-  if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() != 2) {
-    m_group_intolerances[group_id][0].first = cur_update;
-    m_group_intolerances[group_id][0].second = group_intolerance;
-  } else {
-    if (mating_type == 0) {
-      m_group_intolerances_females[group_id][0].first = cur_update;
-      m_group_intolerances_females[group_id][0].second = group_intolerance;      
-    } else if (mating_type == 1) {
-      m_group_intolerances_males[group_id][0].first = cur_update;
-      m_group_intolerances_males[group_id][0].second = group_intolerance;      
-    } else if (mating_type == 2) {
-      m_group_intolerances_juvs[group_id][0].first = cur_update;
-      m_group_intolerances_juvs[group_id][0].second = group_intolerance;      
-    }
+  // if using immigrant only tolerance + sex, only the members of this mating type count
+  const sGroupToleranceStats& stats = GetGroupToleranceStats(group_id);
+  const cDoubleSum* immigrants = &stats.immigrants;
+  if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2 && mating_type >= 0 && mating_type <= 2) {
+    immigrants = &stats.immigrants_by_type[mating_type];
   }
+  int group_intolerance = (int) (immigrants->Count() * tolerance_max - immigrants->Sum());
   
   int group_tolerance = tolerance_max - group_intolerance;
   // return zero if totally intolerant (no negative numbers)
@@ -8904,23 +8782,11 @@ int cPopulation::CalcGroupToleranceOffspring(cOrganism* parent_organism)
   if ((group_id < 0) || (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() > 0)) return tolerance_max;
   if (m_group_list[group_id].GetSize() <= 0) return tolerance_max;
   
-  int cur_update = m_world->GetStats().GetUpdate();
   int parent_intolerance = tolerance_max - parent_organism->GetPhenotype().CalcToleranceOffspringOthers();
   
-  int group_intolerance = 0;
-  if (m_group_intolerances[group_id][1].first == cur_update) {
-    group_intolerance = m_group_intolerances[group_id][1].second;
-  } else {
-    int single_member_intolerance = 0;
-    // Sum the total group intolerance
-    for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-      single_member_intolerance = tolerance_max - m_group_list[group_id][index]->GetPhenotype().CalcToleranceOffspringOthers();
-      group_intolerance += single_member_intolerance;
-    }
-    // Save current update and current intolerance to cache
-    m_group_intolerances[group_id][1].first = cur_update;
-    m_group_intolerances[group_id][1].second = group_intolerance;
-  }
+  // Sum the total group intolerance
+  const cDoubleSum& others = GetGroupToleranceStats(group_id).offspring_others;
+  int group_intolerance = (int) (others.Count() * tolerance_max - others.Sum());
   
   // Remove the parent intolerance
   group_intolerance -= parent_intolerance;
@@ -9007,16 +8873,8 @@ double cPopulation::CalcGroupOddsOffspring(int group_id)
   
   const int tolerance_max = m_world->GetConfig().MAX_TOLERANCE.Get();
   
-  int group_intolerance = 0;
-  int single_member_intolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-    single_member_intolerance = tolerance_max - m_group_list[group_id][index]->GetPhenotype().CalcToleranceOffspringOthers();
-    group_intolerance += single_member_intolerance;
-    if (group_intolerance >= tolerance_max) {
-      group_intolerance = tolerance_max;
-      break;
-    }
-  }
+  const cDoubleSum& others = GetGroupToleranceStats(group_id).offspring_others;
+  int group_intolerance = min(tolerance_max, (int) (others.Count() * tolerance_max - others.Sum()));
   
   int group_tolerance = tolerance_max - group_intolerance;
   double offspring_odds = (double) group_tolerance / (double) tolerance_max;
@@ -9139,110 +8997,121 @@ bool cPopulation::AttemptOffspringParentGroup(cAvidaContext& ctx, cOrganism* par
 // Calculates the average for intra-group tolerance to immigrants
 double cPopulation::CalcGroupAveImmigrants(int group_id, int mating_type)
 {
-  cDoubleSum immigrant_tolerance;
-  int single_member_tolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-    bool count_org = false;
-    if (mating_type == -1) count_org = true;
-    else if (mating_type == 0 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
-      count_org = true;
-    } else if (mating_type == 1 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
-      count_org = true;
-    } else if (mating_type == 2 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) {
-      count_org = true;
-    }
-    if (count_org) {
-      single_member_tolerance = m_group_list[group_id][index]->GetPhenotype().CalcToleranceImmigrants();
-      immigrant_tolerance.Add(single_member_tolerance);
-    }
-  }
-  double aveimmigrants = immigrant_tolerance.Average();
-  return aveimmigrants;
+  const sGroupToleranceStats& stats = GetGroupToleranceStats(group_id);
+  if (mating_type >= 0 && mating_type <= 2) return stats.immigrants_by_type[mating_type].Average();
+  return stats.immigrants.Average();
 }
 
 // Calculates the standard deviation for group tolerance to immigrants
 double cPopulation::CalcGroupSDevImmigrants(int group_id, int mating_type)
 {
-  cDoubleSum immigrant_tolerance;
-  int single_member_tolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-    bool count_org = false;
-    if (mating_type == -1) count_org = true;
-    else if (mating_type == 0 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) {
-      count_org = true;
-    } else if (mating_type == 1 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) {
-      count_org = true;
-    } else if (mating_type == 2 && m_group_list[group_id][index]->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) {
-      count_org = true;
-    }
-    if (count_org) {
-      single_member_tolerance = m_group_list[group_id][index]->GetPhenotype().CalcToleranceImmigrants();
-      immigrant_tolerance.Add(single_member_tolerance);
-    }
-  }
-  double sdevimmigrants = immigrant_tolerance.StdDeviation();
-  return sdevimmigrants;
+  const sGroupToleranceStats& stats = GetGroupToleranceStats(group_id);
+  if (mating_type >= 0 && mating_type <= 2) return stats.immigrants_by_type[mating_type].StdDeviation();
+  return stats.immigrants.StdDeviation();
 }
 
 // Calculates the average for intra-group tolerance to own offspring
 double cPopulation::CalcGroupAveOwn(int group_id)
 {
-  cDoubleSum own_tolerance;
-  int single_member_tolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-    single_member_tolerance = m_group_list[group_id][index]->GetPhenotype().CalcToleranceOffspringOwn();
-    own_tolerance.Add(single_member_tolerance);
-  }
-  double aveown = own_tolerance.Average();
-  return aveown;
+  return GetGroupToleranceStats(group_id).offspring_own.Average();
 }
 
 // Calculates the standard deviation for group tolerance to their own offspring
 double cPopulation::CalcGroupSDevOwn(int group_id)
 {
-  cDoubleSum own_tolerance;
-  int single_member_tolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-    single_member_tolerance = m_group_list[group_id][index]->GetPhenotype().CalcToleranceOffspringOwn();
-    own_tolerance.Add(single_member_tolerance);
-  }
-  double sdevown = own_tolerance.StdDeviation();
-  return sdevown;
+  return GetGroupToleranceStats(group_id).offspring_own.StdDeviation();
 }
 
 // Calculates the average for intra-group tolerance to other offspring
 double cPopulation::CalcGroupAveOthers(int group_id)
 {
-  cDoubleSum others_tolerance;
-  int single_member_tolerance = 0;
-  for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-    single_member_tolerance = m_group_list[group_id][index]->GetPhenotype().CalcToleranceOffspringOthers();
-    others_tolerance.Add(single_member_tolerance);
-  }
-  double aveothers = others_tolerance.Average();
-  return aveothers;
+  return GetGroupToleranceStats(group_id).offspring_others.Average();
 }
 
 // Calculates the standard deviation for group tolerance to other group offspring
 double cPopulation::CalcGroupSDevOthers(int group_id)
 {
-  cDoubleSum others_tolerance;
-  int single_member_tolerance = 0;
+  return GetGroupToleranceStats(group_id).offspring_others.StdDeviation();
+}
+
+void cPopulation::BeginGroupToleranceChange(cOrganism* org)
+{
+  if (!org->HasOpinion()) return;
+  sGroupToleranceStats* stats = FindCurrentGroupToleranceStats(org->GetOpinion().first);
+  if (stats) AdjustGroupToleranceStats(*stats, org, false);
+}
+
+void cPopulation::EndGroupToleranceChange(cOrganism* org)
+{
+  if (!org->HasOpinion()) return;
+  sGroupToleranceStats* stats = FindCurrentGroupToleranceStats(org->GetOpinion().first);
+  if (stats) AdjustGroupToleranceStats(*stats, org, true);
+}
+
+// Member tolerances decay as their records age out of the tolerance window, so the running sums are
+// only trusted for the update in which they were built.
+const cPopulation::sGroupToleranceStats& cPopulation::GetGroupToleranceStats(int group_id)
+{
+  if (!m_group_tolerance_stats.Has(group_id)) m_group_tolerance_stats.Set(group_id, sGroupToleranceStats());
+  sGroupToleranceStats& stats = m_group_tolerance_stats[group_id];
+  if (stats.update != m_world->GetStats().GetUpdate()) {
+    BuildGroupToleranceStats(group_id, stats);
+  }
+#ifdef DEBUG
+  else {
+    sGroupToleranceStats check;
+    BuildGroupToleranceStats(group_id, check);
+    assert(check.immigrants.Count() == stats.immigrants.Count() && check.immigrants.Sum() == stats.immigrants.Sum());
+    assert(check.offspring_own.Sum() == stats.offspring_own.Sum());
+    assert(check.offspring_others.Sum() == stats.offspring_others.Sum());
+    for (int i = 0; i < 3; i++) {
+      assert(check.immigrants_by_type[i].Count() == stats.immigrants_by_type[i].Count());
+      assert(check.immigrants_by_type[i].Sum() == stats.immigrants_by_type[i].Sum());
+    }
+  }
+#endif
+  return stats;
+}
+
+cPopulation::sGroupToleranceStats* cPopulation::FindCurrentGroupToleranceStats(int group_id)
+{
+  if (!m_group_tolerance_stats.Has(group_id)) return NULL;
+  sGroupToleranceStats& stats = m_group_tolerance_stats[group_id];
+  if (stats.update != m_world->GetStats().GetUpdate()) return NULL;
+  return &stats;
+}
+
+void cPopulation::BuildGroupToleranceStats(int group_id, sGroupToleranceStats& stats)
+{
+  stats = sGroupToleranceStats();
+  stats.update = m_world->GetStats().GetUpdate();
   for (int index = 0; index < m_group_list[group_id].GetSize(); index++) {
-    single_member_tolerance = m_group_list[group_id][index]->GetPhenotype().CalcToleranceOffspringOthers();
-    others_tolerance.Add(single_member_tolerance);
+    AdjustGroupToleranceStats(stats, m_group_list[group_id][index], true);
   }
-  double sdevothers = others_tolerance.StdDeviation();
-  return sdevothers;
 }
 
-int& cPopulation::GetGroupIntolerances(int group_id, int tol_num, int mating_type)
+void cPopulation::AdjustGroupToleranceStats(sGroupToleranceStats& stats, cOrganism* org, bool add)
 {
-  int& intolerance = m_group_intolerances[group_id][tol_num].second;
-  if (mating_type == 0) intolerance = m_group_intolerances_females[group_id][tol_num].second;
-  else if (mating_type == 1) intolerance = m_group_intolerances_males[group_id][tol_num].second;
-  else if (mating_type == 2) intolerance = m_group_intolerances_juvs[group_id][tol_num].second;
-  return intolerance;
+  cPhenotype& phenotype = org->GetPhenotype();
+  const double immigrants = phenotype.CalcToleranceImmigrants();
+  const double offspring_own = phenotype.CalcToleranceOffspringOwn();
+  const double offspring_others = phenotype.CalcToleranceOffspringOthers();
+  
+  int mating_type = 2;
+  if (phenotype.GetMatingType() == MATING_TYPE_FEMALE) mating_type = 0;
+  else if (phenotype.GetMatingType() == MATING_TYPE_MALE) mating_type = 1;
+  
+  if (add) {
+    stats.immigrants.Add(immigrants);
+    stats.immigrants_by_type[mating_type].Add(immigrants);
+    stats.offspring_own.Add(offspring_own);
+    stats.offspring_others.Add(offspring_others);
+  } else {
+    stats.immigrants.Subtract(immigrants);
+    stats.immigrants_by_type[mating_type].Subtract(immigrants);
+    stats.offspring_own.Subtract(offspring_own);
+    stats.offspring_others.Subtract(offspring_others);
+  }
 }
 
 /*!	Modify current level of the HGT resource.
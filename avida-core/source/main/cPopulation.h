@@ -27,6 +27,7 @@
 
 #include "cBirthChamber.h"
 #include "cDeme.h"
+#include "cDoubleSum.h"
 #include "cOrgInterface.h"
 #include "cPopulationInterface.h"
 #include "cResourceCount.h"
@@ -40,9 +41,11 @@
 
 class cAvidaContext;
 class cCodeLabel;
+class cDemeExecutor;
 class cEnvironment;
 class cLineage;
 class cOrganism;
+class cPhenotype;
 class cPopulationCell;
 
 using namespace Avida;
@@ -66,16 +69,27 @@ private:
   // Components...
   cWorld* m_world;
   Apto::PriorityScheduler* m_scheduler;                // Handles allocation of CPU cycles
+  cDemeExecutor* m_deme_executor;                      // Runs isolated demes concurrently, if enabled
   Apto::Array<cPopulationCell> cell_array;  // Local cells composing the population
   Apto::Array<int> empty_cell_id_array;     // Used for PREFER_EMPTY birth methods
   cResourceCount resource_count;       // Global resources available
   cBirthChamber birth_chamber;         // Global birth chamber.
   //Keeps track of which organisms are in which group.
   Apto::Map<int, Apto::Array<cOrganism*, Apto::Smart> > m_group_list;
-  Apto::Map<int, Apto::Array<pair<int,int> > > m_group_intolerances;
-  Apto::Map<int, Apto::Array<pair<int,int> > > m_group_intolerances_females;
-  Apto::Map<int, Apto::Array<pair<int,int> > > m_group_intolerances_males;
-  Apto::Map<int, Apto::Array<pair<int,int> > > m_group_intolerances_juvs;
+  
+  // Running sums of member tolerances for each group.  Member tolerances only drift between updates (as records age
+  // out of TOLERANCE_WINDOW), so a group's sums are rebuilt on its first query in an update and then kept current as
+  // members join, leave, change mating type, or execute tolerance instructions.
+  struct sGroupToleranceStats {
+    int update;
+    cDoubleSum immigrants;
+    cDoubleSum immigrants_by_type[3];   // Female, male, juvenile
+    cDoubleSum offspring_own;
+    cDoubleSum offspring_others;
+    
+    sGroupToleranceStats() : update(-1) { ; }
+  };
+  Apto::Map<int, sGroupToleranceStats> m_group_tolerance_stats;
   
   // Keep list of live organisms
   Apto::Array<cOrganism*, Apto::Smart> live_org_list;
@@ -224,6 +238,7 @@ public:
   void AddDemePred(cString type, int times);
 
   void CheckImplicitDemeRepro(cDeme& deme, cAvidaContext& ctx);
+  bool ImplicitDemeReproDue(cDeme& deme);
   
   // Deme-related stats methods
   void PrintDemeAllStats(cAvidaContext& ctx); 
@@ -259,12 +274,20 @@ public:
   int ScheduleOrganism();          // Determine next organism to be processed.
   void ProcessStep(cAvidaContext& ctx, double step_size, int cell_id);
   void ProcessStepSpeculative(cAvidaContext& ctx, double step_size, int cell_id);
+  
+  // Process a whole update with demes running concurrently (see cDemeExecutor)
+  bool UsesDemeExecutor() const { return m_deme_executor != NULL; }
+  void ProcessUpdateByDeme(cAvidaContext& ctx, int UD_size, double step_size);
+  bool ProcessDeferredStep(cAvidaContext& ctx, int cell_id);
 
   // Calculate the statistics from the most recent update.
   void ProcessPostUpdate(cAvidaContext& ctx);
   void ProcessPreUpdate();
   void UpdateResStats(cAvidaContext& ctx);
   void ProcessUpdateCellActions(cAvidaContext& ctx);
+  
+  // Apply per-update point (cosmic ray) mutations to every living organism
+  void PointMutateOrganisms(cAvidaContext& ctx);
 
   // Clear all but a subset of cells...
   void SerialTransfer(int transfer_size, bool ignore_deads, cAvidaContext& ctx); 
@@ -438,7 +461,9 @@ public:
   double CalcGroupSDevOwn(int group_id);
   double CalcGroupAveOthers(int group_id);
   double CalcGroupSDevOthers(int group_id);
-  int& GetGroupIntolerances(int group_id, int tol_num, int mating_type);
+  // Bracket any change to an organism's tolerances so that its group's running sums follow it
+  void BeginGroupToleranceChange(cOrganism* org);
+  void EndGroupToleranceChange(cOrganism* org);
 
   // -------- HGT support --------
   //! Modify current level of the HGT resource.
@@ -452,6 +477,7 @@ private:
   void SetupCellGrid();
   void ClearCellGrid();
   void BuildTimeSlicer(); // Build the schedule object
+  bool DemesAreIsolated();
   
   // Methods to place offspring in the population.
   cPopulationCell& PositionOffspring(cPopulationCell& parent_cell, cAvidaContext& ctx, bool parent_ok = true); 
@@ -492,6 +518,12 @@ private:
   inline void AdjustSchedule(const cPopulationCell& cell, const cMerit& merit);
   
   bool LoadGenotypeList(const cString& filename, cAvidaContext& ctx, Apto::Array<GeneticRepresentationPtr>& list_obj);
+  void PrintTaskPhenotypeData(const cString& filename, const Apto::Array<int>& (cPhenotype::*task_counts)() const);
+  
+  const sGroupToleranceStats& GetGroupToleranceStats(int group_id);
+  sGroupToleranceStats* FindCurrentGroupToleranceStats(int group_id);
+  void BuildGroupToleranceStats(int group_id, sGroupToleranceStats& stats);
+  void AdjustGroupToleranceStats(sGroupToleranceStats& stats, cOrganism* org, bool add);
 };
 
 #endif
@@ -267,6 +267,7 @@ void cPopulationCell::InsertOrganism(cOrganism* new_org, cAvidaContext& ctx)
   // Adjust this cell's attributes to account for the new organism.
   m_organism = new_org;
   m_hardware = &new_org->GetHardware();
+  if (m_deme_id >= 0) m_world->GetPopulation().GetDeme(m_deme_id).CellOccupied(m_cell_id);
   m_world->GetStats().AddSpeculativeWaste(m_spec_state);
   m_spec_state = 0;
 	
@@ -303,6 +304,7 @@ cOrganism * cPopulationCell::RemoveOrganism(cAvidaContext& ctx)
   }
   m_organism = NULL;
   m_hardware = NULL;
+  if (m_deme_id >= 0) m_world->GetPopulation().GetDeme(m_deme_id).CellVacated(m_cell_id);
   return out_organism;
 }
 
@@ -1189,7 +1189,7 @@ void cPopulationInterface::DoHGTMutation(cAvidaContext& ctx, Genome& offspring)
 				break;
 			}
 			case 2: { // replace the instructions in the fragment with random instructions.
-				const cInstSet& instset = m_world->GetHardwareManager().GetInstSet(offspring.Properties().Get("instset").StringValue());
+				const cInstSet& instset = m_world->GetHardwareManager().GetInstSet(offspring);
 				for(int j=0; j<i->GetSize(); ++j) {
 					(*i)[j] = instset.GetRandomInst(ctx);
 				}
@@ -1361,32 +1361,26 @@ void cPopulationInterface::ChangeGroupMatingTypes(cOrganism* org, int group_id,
  */
 int cPopulationInterface::IncTolerance(const int tolerance_type, cAvidaContext &ctx)
 {
-  int group_id = GetOrganism()->GetOpinion().first;
+  cPopulation& population = m_world->GetPopulation();
+  int tolerance = -1;
+  
+  if (tolerance_type < 0 || tolerance_type > 2) return tolerance;
+  PushToleranceInstExe(tolerance_type, ctx);
   
+  population.BeginGroupToleranceChange(GetOrganism());
   if (tolerance_type == 0) {
     // Modify tolerance towards immigrants
-    PushToleranceInstExe(0, ctx);
-    
     // Update tolerance list by removing the most recent dec_tolerance record
     delete GetOrganism()->GetPhenotype().GetToleranceImmigrants().Pop();
     
-    // If not at individual's max tolerance, adjust both caches
+    // If not at individual's max tolerance, adjust the cache
     if (GetOrganism()->GetPhenotype().GetIntolerances()[0].second != 0) {
       GetOrganism()->GetPhenotype().GetIntolerances()[0].second--;
-      GetGroupIntolerances(group_id, 0, -1)--;
-      if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
-        if (GetOrganism()->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) GetGroupIntolerances(group_id, 0, 0)--;
-        else if (GetOrganism()->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) GetGroupIntolerances(group_id, 0, 1)--;
-        else if (GetOrganism()->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) GetGroupIntolerances(group_id, 0, 2)--;
-      }
     }
     // Retrieve modified tolerance total for immigrants
-    return GetOrganism()->GetPhenotype().CalcToleranceImmigrants();
-  }
-  if (tolerance_type == 1) {
+    tolerance = GetOrganism()->GetPhenotype().CalcToleranceImmigrants();
+  } else if (tolerance_type == 1) {
     // Modify tolerance towards own offspring
-    PushToleranceInstExe(1, ctx);
-    
     // Update tolerance list by removing the most recent dec_tolerance record
     delete  GetOrganism()->GetPhenotype().GetToleranceOffspringOwn().Pop();
     
@@ -1395,24 +1389,22 @@ int cPopulationInterface::IncTolerance(const int tolerance_type, cAvidaContext &
       GetOrganism()->GetPhenotype().GetIntolerances()[1].second--;
     }
     // Retrieve modified tolerance total for own offspring.
-    return GetOrganism()->GetPhenotype().CalcToleranceOffspringOwn();
-  }
-  if (tolerance_type == 2) {
+    tolerance = GetOrganism()->GetPhenotype().CalcToleranceOffspringOwn();
+  } else if (tolerance_type == 2) {
     // Modify tolerance towards other offspring of the group
-    PushToleranceInstExe(2, ctx);
-    
     // Update tolerance list by removing the most recent dec_tolerance record
     delete GetOrganism()->GetPhenotype().GetToleranceOffspringOthers().Pop();
     
     // If not at max tolerance, decrease the intolerance cache
     if (GetOrganism()->GetPhenotype().GetIntolerances()[2].second != 0) {
       GetOrganism()->GetPhenotype().GetIntolerances()[2].second--;
-      GetGroupIntolerances(group_id, 1, -1)--;
     }
     // Retrieve modified tolerance total for other offspring in group.
-    return GetOrganism()->GetPhenotype().CalcToleranceOffspringOthers();
+    tolerance = GetOrganism()->GetPhenotype().CalcToleranceOffspringOthers();
   }
-  return -1;
+  population.EndGroupToleranceChange(GetOrganism());
+  
+  return tolerance;
 }
 
 /* Decreases tolerance towards the addition of members to the group.
@@ -1427,12 +1419,15 @@ int cPopulationInterface::DecTolerance(const int tolerance_type, cAvidaContext &
 {
   const int cur_update = m_world->GetStats().GetUpdate();
   const int tolerance_max = m_world->GetConfig().MAX_TOLERANCE.Get();
-  int group_id = GetOrganism()->GetOpinion().first;
+  cPopulation& population = m_world->GetPopulation();
+  int tolerance = -1;
+  
+  if (tolerance_type < 0 || tolerance_type > 2) return tolerance;
+  PushToleranceInstExe(tolerance_type + 3, ctx);
   
+  population.BeginGroupToleranceChange(GetOrganism());
   if (tolerance_type == 0) {
     // Modify tolerance towards immigrants
-    PushToleranceInstExe(3, ctx);
-    
     // Update tolerance list by inserting new record (at the front)
     tList<int>& tolerance_list = GetOrganism()->GetPhenotype().GetToleranceImmigrants();
     tolerance_list.Push(new int(cur_update));
@@ -1441,20 +1436,11 @@ int cPopulationInterface::DecTolerance(const int tolerance_type, cAvidaContext &
     // If not at min tolerance, increase the intolerance cache
     if (GetOrganism()->GetPhenotype().GetIntolerances()[0].second != tolerance_max) {
       GetOrganism()->GetPhenotype().GetIntolerances()[0].second++;
-      GetGroupIntolerances(group_id, 0, -1)++;
-      if (m_world->GetConfig().TOLERANCE_VARIATIONS.Get() == 2) {
-        if (GetOrganism()->GetPhenotype().GetMatingType() == MATING_TYPE_FEMALE) GetGroupIntolerances(group_id, 0, 0)++;
-        else if (GetOrganism()->GetPhenotype().GetMatingType() == MATING_TYPE_MALE) GetGroupIntolerances(group_id, 0, 1)++;
-        else if (GetOrganism()->GetPhenotype().GetMatingType() == MATING_TYPE_JUVENILE) GetGroupIntolerances(group_id, 0, 2)++;
-      }
     }
     
     // Return modified tolerance total for immigrants.
-    return GetOrganism()->GetPhenotype().CalcToleranceImmigrants();
-  }
-  if (tolerance_type == 1) {
-    PushToleranceInstExe(4, ctx);
-    
+    tolerance = GetOrganism()->GetPhenotype().CalcToleranceImmigrants();
+  } else if (tolerance_type == 1) {
     // Update tolerance list by inserting new record (at the front)
     tList<int>& tolerance_list = GetOrganism()->GetPhenotype().GetToleranceOffspringOwn();
     tolerance_list.Push(new int(cur_update));
@@ -1465,12 +1451,8 @@ int cPopulationInterface::DecTolerance(const int tolerance_type, cAvidaContext &
       GetOrganism()->GetPhenotype().GetIntolerances()[1].second++;
     }
     // Return modified tolerance total for own offspring.
-    return GetOrganism()->GetPhenotype().CalcToleranceOffspringOwn();
-
-  }
-  if (tolerance_type == 2) {
-    PushToleranceInstExe(5, ctx);
-    
+    tolerance = GetOrganism()->GetPhenotype().CalcToleranceOffspringOwn();
+  } else if (tolerance_type == 2) {
     // Update tolerance list by inserting new record (at the front)
     tList<int>& tolerance_list = GetOrganism()->GetPhenotype().GetToleranceOffspringOthers();
     tolerance_list.Push(new int(cur_update));
@@ -1479,12 +1461,13 @@ int cPopulationInterface::DecTolerance(const int tolerance_type, cAvidaContext &
     // If not at min tolerance, increase the intolerance cache
     if (GetOrganism()->GetPhenotype().GetIntolerances()[2].second != tolerance_max) {
       GetOrganism()->GetPhenotype().GetIntolerances()[2].second++;
-      GetOrganism()->GetOrgInterface().GetGroupIntolerances(group_id, 1, -1)++;
     }
     // Retrieve modified tolerance total for other offspring in the group.
-    return GetOrganism()->GetPhenotype().CalcToleranceOffspringOthers();
+    tolerance = GetOrganism()->GetPhenotype().CalcToleranceOffspringOthers();
   }
-  return -1;
+  population.EndGroupToleranceChange(GetOrganism());
+  
+  return tolerance;
 }
 
 int cPopulationInterface::CalcGroupToleranceImmigrants(int prop_group_id, int mating_type)
@@ -1558,11 +1541,6 @@ void cPopulationInterface::PushToleranceInstExe(int tol_inst, cAvidaContext& ctx
   return;
 }
 
-int& cPopulationInterface::GetGroupIntolerances(int group_id, int tol_num, int mating_type)
-{
-  return m_world->GetPopulation().GetGroupIntolerances(group_id, tol_num, mating_type);
-}
-
 void cPopulationInterface::TryWriteGroupAttackBits(unsigned char raw_bits)
 {
   m_world->GetStats().PrintGroupAttackBits(raw_bits);
@@ -247,7 +247,6 @@ public:
   double CalcGroupOddsOffspring(int group_id);
   bool AttemptImmigrateGroup(cAvidaContext& ctx, int group_id, cOrganism* org);
   void PushToleranceInstExe(int tol_inst, cAvidaContext& ctx);
-  int& GetGroupIntolerances(int group_id, int tol_num, int mating_type);
   
   void TryWriteGroupAttackBits(unsigned char raw_bits);
   void TryWriteGroupAttackString(cString& string);
@@ -25,8 +25,6 @@
 
 #include "cSpatialCountElem.h"
 
-const int MAXFLOWPTS = 8;
-
 
 /* Intial spatial resource count elements with an initial amount */
 
@@ -35,10 +33,6 @@ cSpatialCountElem::cSpatialCountElem(double initamount)
   amount = initamount;
   delta = 0.0;
   initial = initamount;
-  elempt.Resize(MAXFLOWPTS);
-  xdist.Resize(MAXFLOWPTS);
-  ydist.Resize(MAXFLOWPTS);
-  dist.Resize(MAXFLOWPTS);
 }
 
 /* Intial spatial resource count elements without an initial amount */
@@ -48,18 +42,4 @@ cSpatialCountElem::cSpatialCountElem()
   amount = 0.0;
   delta = 0.0;
   initial = 0.0;
-  elempt.Resize(MAXFLOWPTS);
-  xdist.Resize(MAXFLOWPTS);
-  ydist.Resize(MAXFLOWPTS);
-  dist.Resize(MAXFLOWPTS);
-}
-
-/* Set pointer to one other elements from the current element */  
-
-void cSpatialCountElem::SetPtr(int innum, int inelempt, int inxdist, int inydist, double indist)
-{
-  elempt[innum] = inelempt;
-  xdist[innum] = inxdist;
-  ydist[innum] = inydist;
-  dist[innum] = indist;
 }
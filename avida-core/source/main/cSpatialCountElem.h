@@ -30,8 +30,6 @@ class cSpatialCountElem
 {
 private:
   mutable double amount, delta, initial;
-  Apto::Array<int> elempt, xdist, ydist;
-  Apto::Array<double> dist;
   
 public:
   cSpatialCountElem();
@@ -41,15 +39,11 @@ public:
   void State() { amount += delta; delta = 0.0; }
   double GetAmount() const { return amount; }
   void SetAmount(double res) const { amount = res; }
-  void SetPtr(int innum, int inelempt, int inxdist, int  inydist, double indist);
-  int GetElemPtr(int innum) { return elempt[innum]; }
-  int GetPtrXdist(int innum) { return xdist[innum]; }
-  int GetPtrYdist(int innum) { return ydist[innum]; }
-  double GetPtrDist(int innum) { return dist[innum]; }
   friend void FlowMatter(cSpatialCountElem&, cSpatialCountElem&, double, double, double, double,
                          int, int, double);
   void SetInitial(double init) { initial = init; }
   double GetInitial() { return initial; }
+  bool IsEmpty() const { return amount == 0.0 && delta == 0.0 && initial == 0.0; }
   
   inline void ResetResourceCount(double res_initial) { amount = res_initial + initial; }
 };
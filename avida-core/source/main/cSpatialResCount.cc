@@ -34,6 +34,7 @@ using namespace AvidaTools;
 cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry, double inxdiffuse, double inydiffuse,
                                    double inxgravity, double inygravity)
 : grid(inworld_x * inworld_y), m_initial(0.0), m_modified(false)
+, m_bounded(false), m_box_x1(0), m_box_y1(0), m_box_w(inworld_x), m_box_h(inworld_y)
 {
   int i;
  
@@ -49,13 +50,13 @@ cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry,
     cSpatialCountElem tmpelem;
     grid[i] = tmpelem;
   } 
-  SetPointers();
 }
 
 /* Setup a single spatial resource using default flow amounts  */
 
 cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry)
 : grid(inworld_x * inworld_y), m_initial(0.0), m_modified(false)
+, m_bounded(false), m_box_x1(0), m_box_y1(0), m_box_w(inworld_x), m_box_h(inworld_y)
 {
   int i;
  
@@ -71,10 +72,11 @@ cSpatialResCount::cSpatialResCount(int inworld_x, int inworld_y, int ingeometry)
     cSpatialCountElem tmpelem;
     grid[i] = tmpelem;
    } 
-   SetPointers();
 }
 
-cSpatialResCount::cSpatialResCount() : m_initial(0.0), xdiffuse(1.0), ydiffuse(1.0), xgravity(0.0), ygravity(0.0), m_modified(false)
+cSpatialResCount::cSpatialResCount() : m_initial(0.0), xdiffuse(1.0), ydiffuse(1.0), xgravity(0.0), ygravity(0.0)
+, world_x(0), world_y(0), num_cells(0), m_modified(false)
+, m_bounded(false), m_box_x1(0), m_box_y1(0), m_box_w(0), m_box_h(0)
 {
   geometry = nGeometry::GLOBAL;
 }
@@ -86,67 +88,137 @@ void cSpatialResCount::ResizeClear(int inworld_x, int inworld_y, int ingeometry)
 {
   int i;
  
-  grid.ResizeClear(inworld_x * inworld_y); 
   world_x = inworld_x;
   world_y = inworld_y;
   geometry = ingeometry;
   num_cells = world_x * world_y;
+  
+  /* bounded storage starts out empty and grows as cells are written */
+  if (m_bounded) {
+    grid.ResizeClear(0);
+    m_box_x1 = m_box_y1 = m_box_w = m_box_h = 0;
+    return;
+  }
+  
+  grid.ResizeClear(num_cells); 
+  m_box_x1 = m_box_y1 = 0;
+  m_box_w = world_x;
+  m_box_h = world_y;
   for (i = 0; i < GetSize(); i++) {
     cSpatialCountElem tmpelem;
     grid[i] = tmpelem;
    } 
-   SetPointers();
 }
 
-void cSpatialResCount::SetPointers()
-{
-  /* Pointer 0 will point to the cell above and to the left the current cell
-     and will go clockwise around the cell.                               */
+/* Switch between full-world storage and storage that only covers the box of
+   non-empty cells.  Cells outside the box read as zero. */
 
-  int     i,ii;
-  double  SQRT2 = sqrt(2.0);
+void cSpatialResCount::SetBoundedStorage(bool bounded)
+{
+  if (bounded == m_bounded) return;
+  if (bounded) {
+    m_bounded = true;
+    TrimStorage();
+  } else {
+    resizeStorage(0, 0, world_x - 1, world_y - 1);
+    m_bounded = false;
+  }
+}
 
-  /* First treat all cells like they are in a torus */
+/* Reallocate bounded storage to cover exactly the box (x1, y1) - (x2, y2),
+   carrying over the cells shared with the old box. */
 
-  for (i = 0; i < GetSize(); i++) {
-    grid[i].SetPtr(0 ,GridNeighbor(i, world_x, world_y, -1, -1), -1, -1, SQRT2);
-    grid[i].SetPtr(1 ,GridNeighbor(i, world_x, world_y,  0, -1),  0, -1, 1.0);
-    grid[i].SetPtr(2 ,GridNeighbor(i, world_x, world_y, +1, -1), +1, -1, SQRT2);
-    grid[i].SetPtr(3 ,GridNeighbor(i, world_x, world_y, +1,  0), +1,  0, 1.0);
-    grid[i].SetPtr(4 ,GridNeighbor(i, world_x, world_y, +1, +1), +1, +1, SQRT2);
-    grid[i].SetPtr(5 ,GridNeighbor(i, world_x, world_y,  0, +1),  0, +1, 1.0);
-    grid[i].SetPtr(6 ,GridNeighbor(i, world_x, world_y, -1, +1), -1, +1, SQRT2);
-    grid[i].SetPtr(7 ,GridNeighbor(i, world_x, world_y, -1,  0), -1,  0, 1.0);
-  }
- 
-  /* Fix links for top, bottom and sides for non-torus */
+void cSpatialResCount::resizeStorage(int x1, int y1, int x2, int y2)
+{
+  const int new_w = (x2 >= x1) ? (x2 - x1 + 1) : 0;
+  const int new_h = (y2 >= y1) ? (y2 - y1 + 1) : 0;
+  if (x1 == m_box_x1 && y1 == m_box_y1 && new_w == m_box_w && new_h == m_box_h) return;
   
-  if (geometry == nGeometry::GRID) {
-    /* Top and bottom */
-
-    for (i = 0; i < world_x; i++) {
-      grid[i].SetPtr(0, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[i].SetPtr(1, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[i].SetPtr(2, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      ii = num_cells-1-i;
-      grid[ii].SetPtr(4, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[ii].SetPtr(5, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[ii].SetPtr(6, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
+  Apto::Array<cSpatialCountElem> new_grid(new_w * new_h);
+  const int ox1 = Apto::Max(x1, m_box_x1);
+  const int oy1 = Apto::Max(y1, m_box_y1);
+  const int ox2 = Apto::Min(x1 + new_w, m_box_x1 + m_box_w);
+  const int oy2 = Apto::Min(y1 + new_h, m_box_y1 + m_box_h);
+  for (int y = oy1; y < oy2; y++) {
+    for (int x = ox1; x < ox2; x++) {
+      new_grid[(y - y1) * new_w + (x - x1)] = grid[(y - m_box_y1) * m_box_w + (x - m_box_x1)];
     }
+  }
+  
+  grid = new_grid;
+  m_box_x1 = x1;
+  m_box_y1 = y1;
+  m_box_w = new_w;
+  m_box_h = new_h;
+}
+
+/* Make sure a cell has backing storage.  Each side of the bounded box that has
+   to move is pushed out by at least half the box's extent, so a resource
+   creeping across the world reallocates a logarithmic number of times; once
+   the box would cover half the world, the whole world is reserved instead. */
 
-    /* fix links for right and left sides */
-
-    for (i = 0; i < world_y; i++) {
-      ii = i * world_x;    
-      grid[ii].SetPtr(0, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[ii].SetPtr(7, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[ii].SetPtr(6, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      ii = ((i + 1) * world_x) - 1;
-      grid[ii].SetPtr(2, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[ii].SetPtr(3, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
-      grid[ii].SetPtr(4, cResource::NONE, cResource::NONE, cResource::NONE, cResource::NONE);
+void cSpatialResCount::storeCell(int cell_id)
+{
+  assert(cell_id >= 0 && cell_id < num_cells);
+  if (storageIndex(cell_id) >= 0) return;
+  
+  const int STORAGE_SLACK = 4;
+  const int x = cell_id % world_x;
+  const int y = cell_id / world_x;
+  int x1 = x - STORAGE_SLACK;
+  int y1 = y - STORAGE_SLACK;
+  int x2 = x + STORAGE_SLACK;
+  int y2 = y + STORAGE_SLACK;
+  if (m_box_w > 0 && m_box_h > 0) {
+    const int grow_x = Apto::Max(STORAGE_SLACK, m_box_w / 2);
+    const int grow_y = Apto::Max(STORAGE_SLACK, m_box_h / 2);
+    const int box_x2 = m_box_x1 + m_box_w - 1;
+    const int box_y2 = m_box_y1 + m_box_h - 1;
+    x1 = (x < m_box_x1) ? Apto::Min(x1, m_box_x1 - grow_x) : m_box_x1;
+    y1 = (y < m_box_y1) ? Apto::Min(y1, m_box_y1 - grow_y) : m_box_y1;
+    x2 = (x > box_x2) ? Apto::Max(x2, box_x2 + grow_x) : box_x2;
+    y2 = (y > box_y2) ? Apto::Max(y2, box_y2 + grow_y) : box_y2;
+  }
+  x1 = Apto::Max(x1, 0);
+  y1 = Apto::Max(y1, 0);
+  x2 = Apto::Min(x2, world_x - 1);
+  y2 = Apto::Min(y2, world_y - 1);
+  if (2 * (x2 - x1 + 1) * (y2 - y1 + 1) > num_cells) {
+    x1 = 0;
+    y1 = 0;
+    x2 = world_x - 1;
+    y2 = world_y - 1;
+  }
+  resizeStorage(x1, y1, x2, y2);
+}
+
+/* Shrink bounded storage down to the cells that still hold anything.  Only
+   reallocates when that frees at least half of the current box. */
+
+void cSpatialResCount::TrimStorage()
+{
+  if (!m_bounded) return;
+  
+  int x1 = world_x, y1 = world_y, x2 = -1, y2 = -1;
+  for (int y = 0; y < m_box_h; y++) {
+    for (int x = 0; x < m_box_w; x++) {
+      if (grid[y * m_box_w + x].IsEmpty()) continue;
+      if (x < x1) x1 = x;
+      if (x > x2) x2 = x;
+      if (y < y1) y1 = y;
+      if (y > y2) y2 = y;
     }
   }
+  
+  if (x2 < 0) {
+    grid.ResizeClear(0);
+    m_box_x1 = m_box_y1 = m_box_w = m_box_h = 0;
+    return;
+  }
+  
+  const int used_area = (x2 - x1 + 1) * (y2 - y1 + 1);
+  if (2 * used_area > m_box_w * m_box_h) return;
+  resizeStorage(m_box_x1 + x1, m_box_y1 + y1, m_box_x1 + x2, m_box_y1 + y2);
 }
 
 
@@ -222,7 +294,7 @@ void cSpatialResCount::SetCellList(Apto::Array<cCellResource>* in_cell_list_ptr)
     /* Be sure the user entered a valid cell id or if the the program is loading
        the resource for the testCPU that does not have a grid set up */
        
-    if (cell_id >= 0 && cell_id <= grid.GetSize()) {
+    if (cell_id >= 0 && cell_id < num_cells) {
       Rate((*cell_list_ptr)[i].GetId(), (*cell_list_ptr)[i].GetInitial());
       State((*cell_list_ptr)[i].GetId());
       Element(cell_id).SetInitial((*cell_list_ptr)[i].GetInitial());
@@ -232,9 +304,15 @@ void cSpatialResCount::SetCellList(Apto::Array<cCellResource>* in_cell_list_ptr)
 
 /* Set the rate variable for one element using the array index */
 
-void cSpatialResCount::Rate(int x, double ratein) const {
-  if (x >= 0 && x < grid.GetSize()) {
-    grid[x].Rate(ratein);
+void cSpatialResCount::Rate(int x, double ratein) {
+  if (x >= 0 && x < num_cells) {
+    int idx = storageIndex(x);
+    if (idx < 0) {
+      if (ratein == 0.0) return;
+      storeCell(x);
+      idx = storageIndex(x);
+    }
+    grid[idx].Rate(ratein);
   } else {
     assert(false); // x not valid id
   }
@@ -242,9 +320,9 @@ void cSpatialResCount::Rate(int x, double ratein) const {
 
 /* Set the rate variable for one element using the x,y coordinate */
 
-void cSpatialResCount::Rate(int x, int y, double ratein) const { 
+void cSpatialResCount::Rate(int x, int y, double ratein) { 
   if (x >= 0 && x < world_x && y>= 0 && y < world_y) {
-    grid[y * world_x + x].Rate(ratein);
+    Rate(y * world_x + x, ratein);
   } else {
     assert(false); // x or y not valid id
   }
@@ -254,8 +332,9 @@ void cSpatialResCount::Rate(int x, int y, double ratein) const {
    the array index */
    
 void cSpatialResCount::State(int x) { 
-  if (x >= 0 && x < grid.GetSize()) {
-    grid[x].State();
+  if (x >= 0 && x < num_cells) {
+    const int idx = storageIndex(x);
+    if (idx >= 0) grid[idx].State();
   } else {
     assert(false); // x not valid id
   }
@@ -266,7 +345,7 @@ void cSpatialResCount::State(int x) {
    
 void cSpatialResCount::State(int x, int y) { 
   if (x >= 0 && x < world_x && y >= 0 && y < world_y) {
-    grid[y*world_x + x].State();
+    State(y * world_x + x);
   } else {
     assert(false); // x or y not valid id
   }
@@ -275,8 +354,9 @@ void cSpatialResCount::State(int x, int y) {
 /* Get the state of one element using the array index */
 
 double cSpatialResCount::GetAmount(int x) const { 
-  if (x >= 0 && x < grid.GetSize()) {
-    return grid[x].GetAmount(); 
+  if (x >= 0 && x < num_cells) {
+    const int idx = storageIndex(x);
+    return (idx >= 0) ? grid[idx].GetAmount() : 0.0;
   } else {
     return cResource::NONE;
   }
@@ -286,7 +366,7 @@ double cSpatialResCount::GetAmount(int x) const {
 
 double cSpatialResCount::GetAmount(int x, int y) const { 
   if (x >= 0 && x < world_x && y >= 0 && y < world_y) {
-    return grid[y*world_x + x].GetAmount(); 
+    return GetAmount(y * world_x + x);
   } else {
     return cResource::NONE;
   }
@@ -296,7 +376,8 @@ void cSpatialResCount::RateAll(double ratein) {
 
   int i;
  
-  for (i = 0; i < num_cells; i++) {
+  if (m_bounded && ratein != 0.0) resizeStorage(0, 0, world_x - 1, world_y - 1);
+  for (i = 0; i < grid.GetSize(); i++) {
     grid[i].Rate(ratein);
   } 
 }
@@ -308,7 +389,7 @@ void cSpatialResCount::StateAll() {
 
   int i;
  
-  for (i = 0; i < num_cells; i++) {
+  for (i = 0; i < grid.GetSize(); i++) {
     grid[i].State();
   } 
 }
@@ -318,23 +399,30 @@ void cSpatialResCount::FlowAll() {
   // @JEB save time if diffusion and gravity off...
   if ((xdiffuse == 0.0) && (ydiffuse == 0.0) && (xgravity == 0.0) && (ygravity == 0.0)) return;
 
-  int     i,k,ii,xdist,ydist;
-  double  dist;
+  /* because flow is two way we must check only half the neighbors to 
+     prevent double flow calculations: right, lower right, below and lower left */
+
+  static const int flow_dx[4] = { +1, +1,  0, -1 };
+  static const int flow_dy[4] = {  0, +1, +1, +1 };
+  const double SQRT2 = sqrt(2.0);
+  const double flow_dist[4] = { 1.0, SQRT2, 1.0, SQRT2 };
+  
+  // Flow can reach any cell, so it needs the whole world backed
+  if (m_bounded) resizeStorage(0, 0, world_x - 1, world_y - 1);
+
+  int     i,k,ii,x,y;
  
   for (i = 0; i < num_cells; i++) {
-      
-    /* because flow is two way we must check only half the neighbors to 
-       prevent double flow calculations */
-
-    for (k = 3; k <= 6; k++) {
-      ii = grid[i].GetElemPtr(k);
-      xdist = grid[i].GetPtrXdist(k);
-      ydist = grid[i].GetPtrYdist(k);
-      dist = grid[i].GetPtrDist(k);
-      if (ii >= 0) {
-        FlowMatter(grid[i],grid[ii],xdiffuse,ydiffuse,xgravity,ygravity,
-                   xdist, ydist, dist);
+    x = i % world_x;
+    y = i / world_x;
+    for (k = 0; k < 4; k++) {
+      /* a grid has no links across its edges, everything else wraps like a torus */
+      if (geometry == nGeometry::GRID) {
+        if (x + flow_dx[k] < 0 || x + flow_dx[k] >= world_x || y + flow_dy[k] >= world_y) continue;
       }
+      ii = GridNeighbor(i, world_x, world_y, flow_dx[k], flow_dy[k]);
+      FlowMatter(grid[i], grid[ii], xdiffuse, ydiffuse, xgravity, ygravity,
+                 flow_dx[k], flow_dy[k], flow_dist[k]);
     }
   }
 }
@@ -346,8 +434,8 @@ double cSpatialResCount::SumAll() const{
   int i;
   double sum = 0.0;
 
-  for (i = 0; i < num_cells; i++) {
-    sum += GetAmount(i);
+  for (i = 0; i < grid.GetSize(); i++) {
+    sum += grid[i].GetAmount();
   } 
   return sum;
 }
@@ -355,7 +443,7 @@ double cSpatialResCount::SumAll() const{
 /* Take a given amount of resource and spread it among all the cells in the 
    inflow rectange */
 
-void cSpatialResCount::Source(double amount) const {
+void cSpatialResCount::Source(double amount) {
   int     i, j, elem;
   double  totalcells;
 
@@ -372,14 +460,14 @@ void cSpatialResCount::Source(double amount) const {
 
 /* Handle the inflow for a list of individual cells */
 
-void cSpatialResCount::CellInflow() const {
+void cSpatialResCount::CellInflow() {
   for (int i=0; i < cell_list_ptr->GetSize(); i++) {
     const int cell_id = (*cell_list_ptr)[i].GetId();
     
     /* Be sure the user entered a valid cell id or if the the program is loading
        the resource for the testCPU that does not have a grid set up */
        
-    if (cell_id >= 0 && cell_id < grid.GetSize()) {
+    if (cell_id >= 0 && cell_id < num_cells) {
       Rate(cell_id, (*cell_list_ptr)[i].GetInflow());
     }
   }
@@ -387,7 +475,7 @@ void cSpatialResCount::CellInflow() const {
 
 /* Take away a give percentage of a resource from outflow rectangle */
 
-void cSpatialResCount::Sink(double decay) const {
+void cSpatialResCount::Sink(double decay) {
 
   int     i, j, elem;
   double  deltaamount;
@@ -405,7 +493,7 @@ void cSpatialResCount::Sink(double decay) const {
 
 /* Take away a give percentage of a resource from individual cells */
 
-void cSpatialResCount::CellOutflow() const {
+void cSpatialResCount::CellOutflow() {
 
   double deltaamount = 0.0;
 
@@ -415,7 +503,7 @@ void cSpatialResCount::CellOutflow() const {
     /* Be sure the user entered a valid cell id or if the the program is loading
        the resource for the testCPU that does not have a grid set up */
        
-    if (cell_id >= 0 && cell_id < grid.GetSize()) {
+    if (cell_id >= 0 && cell_id < num_cells) {
       deltaamount = Apto::Max((GetAmount(cell_id) * (*cell_list_ptr)[i].GetOutflow()), 0.0);
     }                     
     Rate((*cell_list_ptr)[i].GetId(), -deltaamount); 
@@ -424,8 +512,10 @@ void cSpatialResCount::CellOutflow() const {
 
 void cSpatialResCount::SetCellAmount(int cell_id, double res)
 {
-  if (cell_id >= 0 && cell_id < grid.GetSize())
+  if (cell_id >= 0 && cell_id < num_cells)
   {
+    // writing zero to a cell that has no storage is already a no-op
+    if (res == 0.0 && storageIndex(cell_id) < 0) return;
     Element(cell_id).SetAmount(res);
   }
 }
@@ -433,5 +523,6 @@ void cSpatialResCount::SetCellAmount(int cell_id, double res)
 
 void cSpatialResCount::ResetResourceCounts()
 {
+  if (m_bounded && m_initial != 0.0) resizeStorage(0, 0, world_x - 1, world_y - 1);
   for (int i = 0; i < grid.GetSize(); i++) grid[i].ResetResourceCount(m_initial);
 }
@@ -50,6 +50,14 @@ private:
   Apto::Array<cCellResource> *cell_list_ptr;
   bool m_modified;
   
+  /* bounded storage only holds the cells inside the box below; anything outside it is empty */
+  bool m_bounded;
+  int m_box_x1, m_box_y1, m_box_w, m_box_h;
+  
+  inline int storageIndex(int cell_id) const;
+  void resizeStorage(int x1, int y1, int x2, int y2);
+  void storeCell(int cell_id);
+  
 public:
   cSpatialResCount();
   cSpatialResCount(int inworld_x, int inworld_y, int ingeometry);
@@ -59,28 +67,27 @@ public:
   virtual ~cSpatialResCount();
   
   void ResizeClear(int inworld_x, int inworld_y, int ingeometry);
-  void SetPointers();
   void CheckRanges();
   void SetCellList(Apto::Array<cCellResource> *in_cell_list_ptr);
-  int GetSize() const { return grid.GetSize(); }
+  int GetSize() const { return num_cells; }
   int GetX() const { return world_x; }
   int GetY() const { return world_y; }
   int GetCellListSize() const { return cell_list_ptr->GetSize(); }
-  cSpatialCountElem& Element(int x) { return grid[x]; }
-  void Rate(int x, double ratein) const;
-  void Rate(int x, int y, double ratein) const;
+  cSpatialCountElem& Element(int x) { storeCell(x); return grid[storageIndex(x)]; }
+  void Rate(int x, double ratein);
+  void Rate(int x, int y, double ratein);
   void State(int x);
   void State(int x, int y);
   double GetAmount(int x) const;
   double GetAmount(int x, int y) const;
   void RateAll(double ratein); 
   virtual void StateAll();
-  void FlowAll(); 
+  virtual void FlowAll(); 
   double SumAll() const;
-  void Source(double amount) const;
-  void CellInflow() const;
-  void Sink(double percent) const;
-  void CellOutflow() const;
+  void Source(double amount);
+  void CellInflow();
+  void Sink(double percent);
+  void CellOutflow();
   void SetCellAmount(int cell_id, double res);
   void SetInitial(double initial) { m_initial = initial; }
   double GetInitial() const { return m_initial; }
@@ -102,6 +109,11 @@ public:
   void SetModified(bool in_modified) { m_modified = in_modified; }
   bool GetModified() { return m_modified; }
   
+  void SetBoundedStorage(bool bounded);
+  bool GetBoundedStorage() const { return m_bounded; }
+  void TrimStorage();
+  int GetStorageSize() const { return grid.GetSize(); }
+  
   virtual void SetGradInitialPlat(double) { ; }
   virtual void SetGradPeakX(int) { ; }
   virtual void SetGradPeakY(int) { ; }
@@ -159,4 +171,14 @@ public:
   virtual int GetMaxUsedY() { return -1; }
 };
 
+
+inline int cSpatialResCount::storageIndex(int cell_id) const
+{
+  if (!m_bounded) return cell_id;
+  const int x = (cell_id % world_x) - m_box_x1;
+  const int y = (cell_id / world_x) - m_box_y1;
+  if (x < 0 || x >= m_box_w || y < 0 || y >= m_box_h) return -1;
+  return y * m_box_w + x;
+}
+
 #endif
@@ -366,6 +366,53 @@ void cTaskLib::NewTask(const cString& name, const cString& desc, tTaskTest task_
 }
 
 
+// Setup logic_out to test the output for each logical combination...
+// Assuming each bit in logic out to be based on the inputs:
+//
+//  Logic ID Bit: 7 6 5 4 3 2 1 0
+//       Input C: 1 1 1 1 0 0 0 0
+//       Input B: 1 1 0 0 1 1 0 0
+//       Input A: 1 0 1 0 1 0 1 0
+//
+// The inputs are bit-sliced: for each of the eight input patterns a mask selects every bit position at which the
+// inputs take that pattern, so the whole truth table is filled with a few word-wide operations and no per-bit branches.
+static inline int calcLogicId(int num_inputs, unsigned int a, unsigned int b, unsigned int c, unsigned int out)
+{
+  const unsigned int na = ~a;
+  const unsigned int nb = ~b;
+  const unsigned int nc = ~c;
+  const unsigned int low[4] = { na & nb, a & nb, na & b, a & b };
+  
+  unsigned int ones = 0;   // patterns observed with an output bit of 1
+  unsigned int zeros = 0;  // patterns observed with an output bit of 0
+  for (int i = 0; i < 4; i++) {
+    const unsigned int c_off = low[i] & nc;
+    const unsigned int c_on = low[i] & c;
+    ones |= ((unsigned int)((c_off & out) != 0) << i) | ((unsigned int)((c_on & out) != 0) << (i + 4));
+    zeros |= ((unsigned int)((c_off & ~out) != 0) << i) | ((unsigned int)((c_on & ~out) != 0) << (i + 4));
+  }
+  
+  // If there were any inconsistancies, the output is not a logic function of the inputs
+  if (ones & zeros) return -1;
+  
+  // Patterns that require a missing input take the value of the same pattern with that input off
+  if (num_inputs < 1) ones = (ones & ~0x02u) | ((ones & 0x01u) << 1);  // 000 -> 001
+  if (num_inputs < 2) ones = (ones & ~0x0Cu) | ((ones & 0x03u) << 2);  // 000 -> 010; 001 -> 011
+  if (num_inputs < 3) ones = (ones & 0x0Fu) | ((ones & 0x0Fu) << 4);   // 000->100;  001->101;  010->110;  011->111
+  
+  return (int)ones;
+}
+
+
+int cTaskLib::CalcLogicId(int num_inputs, const int* inputs, int output)
+{
+  const unsigned int a = (num_inputs > 0) ? inputs[0] : 0;
+  const unsigned int b = (num_inputs > 1) ? inputs[1] : 0;
+  const unsigned int c = (num_inputs > 2) ? inputs[2] : 0;
+  return calcLogicId(num_inputs, a, b, c, output);
+}
+
+
 void cTaskLib::SetupTests(cTaskContext& ctx) const
 {
   const tBuffer<int>& input_buffer = ctx.GetInputBuffer();
@@ -379,72 +426,7 @@ void cTaskLib::SetupTests(cTaskContext& ctx) const
   int test_output = 0;
   if (ctx.GetOutputBuffer().GetNumStored()) test_output = ctx.GetOutputBuffer()[0];
   
-  
-  // Setup logic_out to test the output for each logical combination...
-  // Assuming each bit in logic out to be based on the inputs:
-  //
-  //  Logic ID Bit: 7 6 5 4 3 2 1 0
-  //       Input C: 1 1 1 1 0 0 0 0
-  //       Input B: 1 1 0 0 1 1 0 0
-  //       Input A: 1 0 1 0 1 0 1 0
-  
-  int logic_out[8];
-  for (int i = 0; i < 8; i++) logic_out[i] = -1;
-  
-  // Test all input combos!
-  bool func_OK = true;  // Have all outputs been consistant?
-  for (int test_pos = 0; test_pos < 32; test_pos++) {
-    int logic_pos = 0;
-    for (int i = 0; i < 3; i++)  logic_pos += (test_inputs[i] & 1) << i;
-    
-    if ( logic_out[logic_pos] != -1 &&
-        logic_out[logic_pos] != (test_output & 1) ) {
-      func_OK = false;
-      break;
-    }
-    else {
-      logic_out[logic_pos] = test_output & 1;
-    }
-    
-    test_output >>= 1;
-    for (int i = 0; i < 3; i++) test_inputs[i] >>= 1;
-  }
-  
-  // If there were any inconsistancies, deal with them.
-  if (func_OK == false) {
-    ctx.SetLogicId(-1);
-    return;
-  }
-  
-  // Determine the logic ID number of this task.
-  if (num_inputs < 1) {  // 000 -> 001
-    logic_out[1] = logic_out[0];
-  }
-  if (num_inputs < 2) { // 000 -> 010; 001 -> 011
-    logic_out[2] = logic_out[0];
-    logic_out[3] = logic_out[1];
-  }
-  if (num_inputs < 3) { // 000->100;  001->101;  010->110;  011->111
-    logic_out[4] = logic_out[0];
-    logic_out[5] = logic_out[1];
-    logic_out[6] = logic_out[2];
-    logic_out[7] = logic_out[3];
-  }
-  
-  // Lets just make sure we've gotten this correct...
-  assert(logic_out[0] >= 0 && logic_out[0] <= 1);
-  assert(logic_out[1] >= 0 && logic_out[1] <= 1);
-  assert(logic_out[2] >= 0 && logic_out[2] <= 1);
-  assert(logic_out[3] >= 0 && logic_out[3] <= 1);
-  assert(logic_out[4] >= 0 && logic_out[4] <= 1);
-  assert(logic_out[5] >= 0 && logic_out[5] <= 1);
-  assert(logic_out[6] >= 0 && logic_out[6] <= 1);
-  assert(logic_out[7] >= 0 && logic_out[7] <= 1);
-  
-  int logicid = 0;
-  for (int i = 0; i < 8; i++) logicid += logic_out[i] << i;
-  
-  ctx.SetLogicId(logicid);
+  ctx.SetLogicId(CalcLogicId(num_inputs, test_inputs, test_output));
 }
 
 
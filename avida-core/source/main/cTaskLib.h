@@ -67,6 +67,9 @@ public:
   cTaskEntry * GetTaskReference(int id) { return task_array[id]; }
 
   void SetupTests(cTaskContext& ctx) const;
+  
+  // Logic ID (0-255) of an output over up to three inputs, -1 if the output is not a consistent bitwise function
+  static int CalcLogicId(int num_inputs, const int* inputs, int output);
   inline double TestOutput(cTaskContext& ctx) const { return (this->*(ctx.GetTaskEntry()->GetTestFun()))(ctx); }
 
   bool UseNeighborInput() const { return use_neighbor_input; }
@@ -39,6 +39,7 @@
 #include "cHardwareManager.h"
 #include "cMigrationMatrix.h"  
 #include "cInstSet.h"
+#include "cPhiloxRandom.h"
 #include "cPopulation.h"
 #include "cStats.h"
 #include "cTestCPU.h"
@@ -100,8 +101,12 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
   bool success = true;
   
   // Setup Random Number Generator
-  m_rng.ResetSeed(m_conf->RANDOM_SEED.Get());
-  m_ctx = new cAvidaContext(NULL, m_rng);
+  if (UsesRandomStreams()) {
+    m_rng = Apto::SmartPtr<Apto::Random>(new cPhiloxRandom(m_conf->RANDOM_SEED.Get(), RANDOM_STREAM_WORLD));
+  } else {
+    m_rng = Apto::SmartPtr<Apto::Random>(new Apto::RNG::AvidaRNG(m_conf->RANDOM_SEED.Get()));
+  }
+  m_ctx = new cAvidaContext(NULL, *m_rng);
   
   // Initialize new API-based data structures here for now
   {
@@ -114,7 +119,11 @@ bool cWorld::setup(World* new_world, cUserFeedback* feedback, const Apto::Map<Ap
     
     // Output Manager
     Apto::String opath = Apto::FileSystem::GetAbsolutePath(Apto::String(m_conf->DATA_DIR.Get()), Apto::String(m_working_dir));
-    Output::ManagerPtr(new Output::Manager(opath))->AttachTo(new_world);
+    Output::ManagerPtr output_mgr(new Output::Manager(opath));
+    if (m_conf->OUTPUT_ASYNC_QUEUE.Get() != 0) {
+      output_mgr->StartAsyncWriter(m_conf->OUTPUT_ASYNC_QUEUE.Get(), m_conf->OUTPUT_ASYNC_BUFFER_KB.Get() * 1024);
+    }
+    output_mgr->AttachTo(new_world);
   }
   
 
@@ -229,13 +238,27 @@ int cWorld::GetNumResources()
   return m_env->GetResourceLib().GetSize();
 }
 
+Apto::Random* cWorld::NewRandomStream(int stream_type, int object_id) const
+{
+  if (UsesRandomStreams()) return new cPhiloxRandom(m_rng->Seed(), stream_type, object_id);
+
+  // Legacy generators have no streams, so seed a fresh one from a SplitMix64 hash of (seed, type, object id)
+  unsigned long long z = ((unsigned long long)(unsigned int)m_rng->Seed() << 32);
+  z ^= ((unsigned long long)(unsigned int)stream_type << 24) ^ (unsigned int)object_id;
+  z += 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z ^= (z >> 31);
+  return new Apto::RNG::AvidaRNG((int)(z % (unsigned long long)m_rng->MaxSeed()));
+}
+
 
 void cWorld::SetDriver(WorldDriver* driver, bool take_ownership)
 {
   // cleanup current driver, if needed
   if (m_own_driver) delete m_driver;
   if (m_ctx) delete m_ctx;
-  m_ctx = new cAvidaContext(driver, m_rng);
+  m_ctx = new cAvidaContext(driver, *m_rng);
   
   // store new driver information
   m_driver = driver;
@@ -69,7 +69,7 @@ protected:
   
   Data::ManagerPtr m_data_mgr;
 
-  Apto::RNG::AvidaRNG m_rng;
+  Apto::SmartPtr<Apto::Random> m_rng;
   
   bool m_test_on_div;     // flag derived from a collection of configuration settings
   bool m_test_sterilize;  // flag derived from a collection of configuration settings
@@ -95,7 +95,7 @@ public:
   cHardwareManager& GetHardwareManager() { return *m_hw_mgr; }
   cMigrationMatrix& GetMigrationMatrix(){ return *m_mig_mat; };
   cPopulation& GetPopulation() { return *m_pop; }
-  Apto::Random& GetRandom() { return m_rng; }
+  Apto::Random& GetRandom() { return *m_rng; }
   cStats& GetStats() { return *m_stats; }
   WorldDriver& GetDriver() { return *m_driver; }
   World* GetNewWorld() { return m_new_world; }
@@ -105,6 +105,11 @@ public:
   Data::ProviderPtr GetStatsProvider(World*);
   Data::ArgumentedProviderPtr GetPopulationProvider(World*);
   
+  // Independent generator for one object, derived from the world seed without drawing from the world generator.
+  // With RANDOM_GENERATOR set to Philox the result is that object's counter-based stream.  Caller owns the result.
+  Apto::Random* NewRandomStream(int stream_type, int object_id) const;
+  bool UsesRandomStreams() const { return m_conf->RANDOM_GENERATOR.Get() == RANDOM_GENERATOR_PHILOX; }
+  
   // Config Dependent Modes
   bool GetTestOnDivide() const { return m_test_on_div; }
   bool GetTestSterilize() const { return m_test_sterilize; }
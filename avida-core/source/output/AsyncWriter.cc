@@ -0,0 +1,337 @@
+/*
+ *  output/AsyncWriter.cc
+ *  avida-core
+ *
+ *  Copyright 2013 Michigan State University. All rights reserved.
+ *  http://avida.devosoft.org/
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "avida/private/output/AsyncWriter.h"
+
+#include "avida/core/Feedback.h"
+
+#include <cassert>
+
+
+static const int MAX_POOLED_BUFFERS = 32;
+
+
+Avida::Output::AsyncWriter::AsyncWriter(int max_queued, int buffer_size)
+  : m_max_queued((max_queued > 0) ? max_queued : UNBOUNDED), m_buffer_size((buffer_size > 0) ? buffer_size : 4096)
+  , m_ops(16), m_head(0), m_count(0), m_queued_buffers(0), m_busy(false), m_running(true), m_shutdown(false)
+{
+  Start();
+}
+
+Avida::Output::AsyncWriter::~AsyncWriter()
+{
+  Shutdown();
+  for (int i = 0; i < m_free_buffers.GetSize(); i++) delete [] m_free_buffers[i];
+}
+
+
+Avida::Output::AsyncFileBuffer* Avida::Output::AsyncWriter::Open(const OutputID& path, bool append, bool binary)
+{
+  // Data for a previous incarnation of this path must reach the disk before the file is reopened (and truncated)
+  m_mutex.Lock();
+  while (m_closing.Has(path)) m_retire_cond.Wait(m_mutex);
+  m_mutex.Unlock();
+  
+  const char* mode = (append) ? ((binary) ? "ab" : "a") : ((binary) ? "wb" : "w");
+  std::FILE* fp = std::fopen((const char*)path, mode);
+  if (!fp) return NULL;
+  
+  // Writes always arrive as whole buffers, stdio buffering would only add a copy
+  std::setvbuf(fp, NULL, _IONBF, 0);
+  
+  AddReference();  // explictly add reference, since this is internally creating a smart pointer to itself
+  return new AsyncFileBuffer(AsyncWriterPtr(this), fp, path);
+}
+
+
+char* Avida::Output::AsyncWriter::AcquireBuffer()
+{
+  char* buf = NULL;
+  m_mutex.Lock();
+  const int num_free = m_free_buffers.GetSize();
+  if (num_free) {
+    buf = m_free_buffers[num_free - 1];
+    m_free_buffers.Resize(num_free - 1);
+  }
+  m_mutex.Unlock();
+  
+  if (!buf) buf = new char[m_buffer_size];
+  return buf;
+}
+
+void Avida::Output::AsyncWriter::ReleaseBuffer(char* buf)
+{
+  if (!buf) return;
+  
+  m_mutex.Lock();
+  const int max_pooled = (m_max_queued == UNBOUNDED) ? MAX_POOLED_BUFFERS : m_max_queued + 1;
+  if (m_free_buffers.GetSize() < max_pooled) {
+    m_free_buffers.Push(buf);
+    buf = NULL;
+  }
+  m_mutex.Unlock();
+  
+  delete [] buf;
+}
+
+
+void Avida::Output::AsyncWriter::SubmitWrite(std::FILE* fp, const OutputID& path, char* buf, int len)
+{
+  sOp op;
+  op.type = OP_WRITE;
+  op.fp = fp;
+  op.buf = buf;
+  op.len = len;
+  op.path = path;
+  submit(op);
+}
+
+void Avida::Output::AsyncWriter::SubmitFlush(std::FILE* fp, const OutputID& path)
+{
+  sOp op;
+  op.type = OP_FLUSH;
+  op.fp = fp;
+  op.buf = NULL;
+  op.len = 0;
+  op.path = path;
+  submit(op);
+}
+
+void Avida::Output::AsyncWriter::SubmitClose(std::FILE* fp, const OutputID& path)
+{
+  sOp op;
+  op.type = OP_CLOSE;
+  op.fp = fp;
+  op.buf = NULL;
+  op.len = 0;
+  op.path = path;
+  submit(op);
+}
+
+
+void Avida::Output::AsyncWriter::Sync()
+{
+  m_mutex.Lock();
+  while (m_count || m_busy) m_retire_cond.Wait(m_mutex);
+  m_mutex.Unlock();
+}
+
+void Avida::Output::AsyncWriter::Shutdown()
+{
+  m_mutex.Lock();
+  if (!m_running || m_shutdown) {
+    m_mutex.Unlock();
+    return;
+  }
+  m_shutdown = true;
+  m_work_cond.Signal();
+  m_mutex.Unlock();
+  
+  Join();
+  
+  m_mutex.Lock();
+  m_running = false;
+  m_mutex.Unlock();
+}
+
+void Avida::Output::AsyncWriter::ReportFailures(Feedback* feedback)
+{
+  m_mutex.Lock();
+  Apto::Array<OutputID> failed(m_failed);
+  m_failed.Resize(0);
+  m_mutex.Unlock();
+  
+  for (int i = 0; i < failed.GetSize(); i++) {
+    if (feedback) feedback->Error("unable to write output file '%s'", (const char*)failed[i]);
+    else std::fprintf(stderr, "error: unable to write output file '%s'\n", (const char*)failed[i]);
+  }
+}
+
+
+void Avida::Output::AsyncWriter::Run()
+{
+  m_mutex.Lock();
+  while (true) {
+    while (!m_count && !m_shutdown) m_work_cond.Wait(m_mutex);
+    if (!m_count) break;  // shutdown requested and queue drained
+    
+    sOp op = m_ops[m_head];
+    m_ops[m_head].path = OutputID();  // leave this thread's copy as the only reference to the path
+    m_head = (m_head + 1) % m_ops.GetSize();
+    m_count--;
+    m_busy = true;
+    m_mutex.Unlock();
+    
+    const bool success = perform(op);
+    
+    m_mutex.Lock();
+    m_busy = false;
+    if (!success) recordFailure(op.path);
+    if (op.type == OP_WRITE) {
+      m_queued_buffers--;
+    } else if (op.type == OP_CLOSE) {
+      // Only the last pending close of a path releases reopens of it
+      int pending = 0;
+      m_closing.Get(op.path, pending);
+      if (pending > 1) m_closing.Set(op.path.Clone(), pending - 1);
+      else m_closing.Remove(op.path);
+    }
+    m_retire_cond.Broadcast();
+  }
+  m_mutex.Unlock();
+}
+
+
+void Avida::Output::AsyncWriter::submit(const sOp& op)
+{
+  m_mutex.Lock();
+  
+  // Once the writer has been shut down, perform operations on the calling thread
+  if (m_shutdown) {
+    m_mutex.Unlock();
+    sOp inline_op(op);
+    if (!perform(inline_op)) {
+      m_mutex.Lock();
+      recordFailure(op.path);
+      m_mutex.Unlock();
+    }
+    return;
+  }
+  
+  // Apply back-pressure, only buffer writes count against the queue bound
+  if (op.type == OP_WRITE) {
+    if (m_max_queued != UNBOUNDED) while (m_queued_buffers >= m_max_queued) m_retire_cond.Wait(m_mutex);
+    m_queued_buffers++;
+  } else if (op.type == OP_CLOSE) {
+    int pending = 0;
+    m_closing.Get(op.path, pending);
+    m_closing.Set(op.path.Clone(), pending + 1);
+  }
+  
+  // Grow the ring, preserving queue order, when full
+  if (m_count == m_ops.GetSize()) {
+    Apto::Array<sOp> ops(m_ops.GetSize() * 2);
+    for (int i = 0; i < m_count; i++) ops[i] = m_ops[(m_head + i) % m_ops.GetSize()];
+    m_ops = ops;
+    m_head = 0;
+  }
+  // Queued operations own a private copy of the path, as it is released on the writer thread
+  sOp& queued = m_ops[(m_head + m_count) % m_ops.GetSize()];
+  queued = op;
+  queued.path = op.path.Clone();
+  m_count++;
+  
+  m_work_cond.Signal();
+  m_mutex.Unlock();
+}
+
+bool Avida::Output::AsyncWriter::perform(sOp& op)
+{
+  bool success = true;
+  switch (op.type) {
+    case OP_WRITE:
+      if (op.len) success = (std::fwrite(op.buf, 1, op.len, op.fp) == static_cast<size_t>(op.len));
+      ReleaseBuffer(op.buf);
+      op.buf = NULL;
+      break;
+      
+    case OP_FLUSH:
+      success = (std::fflush(op.fp) == 0);
+      break;
+      
+    case OP_CLOSE:
+      success = (std::fclose(op.fp) == 0);
+      break;
+  }
+  return success;
+}
+
+void Avida::Output::AsyncWriter::recordFailure(const OutputID& path)
+{
+  // Caller must hold m_mutex; each path is reported once per ReportFailures
+  for (int i = 0; i < m_failed.GetSize(); i++) if (m_failed[i] == path) return;
+  m_failed.Push(path.Clone());
+}
+
+
+
+Avida::Output::AsyncFileBuffer::AsyncFileBuffer(AsyncWriterPtr writer, std::FILE* fp, const OutputID& path)
+  : m_writer(writer), m_fp(fp), m_path(path), m_buf(writer->AcquireBuffer())
+{
+  setp(m_buf, m_buf + m_writer->BufferSize());
+}
+
+Avida::Output::AsyncFileBuffer::~AsyncFileBuffer()
+{
+  Close();
+}
+
+
+void Avida::Output::AsyncFileBuffer::Flush()
+{
+  if (!m_fp) return;
+  
+  handOff();
+  m_writer->SubmitFlush(m_fp, m_path);
+}
+
+void Avida::Output::AsyncFileBuffer::Close()
+{
+  if (!m_fp) return;
+  
+  handOff();
+  m_writer->ReleaseBuffer(m_buf);
+  m_buf = NULL;
+  setp(NULL, NULL);
+  
+  m_writer->SubmitClose(m_fp, m_path);
+  m_fp = NULL;
+}
+
+
+Avida::Output::AsyncFileBuffer::int_type Avida::Output::AsyncFileBuffer::overflow(int_type c)
+{
+  if (!m_fp) return traits_type::eof();
+  
+  handOff();
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+int Avida::Output::AsyncFileBuffer::sync()
+{
+  // Stream flushes are not sync points, data is submitted as buffers fill and on explicit Flush
+  return 0;
+}
+
+
+void Avida::Output::AsyncFileBuffer::handOff()
+{
+  const int len = pptr() - pbase();
+  if (!len) return;
+  
+  m_writer->SubmitWrite(m_fp, m_path, m_buf, len);
+  m_buf = m_writer->AcquireBuffer();
+  setp(m_buf, m_buf + m_writer->BufferSize());
+}
@@ -26,11 +26,13 @@
 
 #include "avida/core/Feedback.h"
 #include "avida/output/Manager.h"
+#include "avida/private/output/AsyncWriter.h"
 
 #include <ctime>
 
 
-Avida::Output::FilePtr Avida::Output::File::createWithPath(World* world, Apto::String path, bool append, Feedback* feedback)
+Avida::Output::FilePtr Avida::Output::File::createWithPath(World* world, Apto::String path, bool append, bool binary,
+                                                           Feedback* feedback)
 {
   Output::ManagerPtr mgr = Output::Manager::Of(world);
   OutputID oid = mgr->OutputIDFromPath(path);
@@ -45,7 +47,7 @@ Avida::Output::FilePtr Avida::Output::File::createWithPath(World* world, Apto::S
     return FilePtr(NULL);
   }
   
-  FilePtr rtn(new File(world, oid, append));
+  FilePtr rtn(new File(world, oid, append, binary));
   
   if (!rtn->Good() || rtn->Fail()) {
     if (feedback) feedback->Error("unable to open file '%s' for writing", (const char*)oid);
@@ -55,7 +57,7 @@ Avida::Output::FilePtr Avida::Output::File::createWithPath(World* world, Apto::S
   return rtn;
 }
 
-Avida::Output::FilePtr Avida::Output::File::StaticWithPath(World* world, Apto::String path, Feedback* feedback)
+Avida::Output::FilePtr Avida::Output::File::staticWithPath(World* world, Apto::String path, bool binary, Feedback* feedback)
 {
   Output::ManagerPtr mgr = Output::Manager::Of(world);
   OutputID oid = mgr->OutputIDFromPath(path);
@@ -74,7 +76,7 @@ Avida::Output::FilePtr Avida::Output::File::StaticWithPath(World* world, Apto::S
       if (feedback) feedback->Error("'%s' already open, incompatible socket type", (const char*)oid);
       return FilePtr(NULL);
     }
-    rtn = createWithPath(world, path, false, feedback);
+    rtn = createWithPath(world, path, false, binary, feedback);
     if (rtn) {
       if (!rtn->registerAsStatic()) {
         if (feedback) feedback->Error("unable to register '%s' as a static socket", (const char*)oid);
@@ -88,14 +90,32 @@ Avida::Output::FilePtr Avida::Output::File::StaticWithPath(World* world, Apto::S
 
 
 
-Avida::Output::File::File(World* world, const OutputID& name, bool append)
-  : Socket(world, name), m_descr_written(false), m_num_cols(0)
+Avida::Output::File::File(World* world, const OutputID& name, bool append, bool binary)
+  : Socket(world, name), m_descr_written(false), m_num_cols(0), m_async_buf(NULL)
 {
-  m_fp.open(name, (append) ? (std::ios::out | std::ios::app) : std::ios::out);
+  AsyncWriterPtr writer = Manager::Of(world)->m_writer;
+  if (writer) {
+    // Redirect the stream to the background writer; the ofstream's own file buffer is left unopened
+    m_async_buf = writer->Open(name, append, binary);
+    if (m_async_buf) m_fp.std::ios::rdbuf(m_async_buf);
+    else m_fp.setstate(std::ios::failbit);
+  } else {
+    std::ios::openmode mode = (append) ? (std::ios::out | std::ios::app) : std::ios::out;
+    if (binary) mode |= std::ios::binary;
+    m_fp.open(name, mode);
+  }
   assert(m_fp.good());
 }
 
-Avida::Output::File::~File() { ; }
+Avida::Output::File::~File()
+{
+  if (m_async_buf) {
+    // Queue remaining data and the close with the writer, the file itself is closed in the background
+    m_async_buf->Close();
+    m_fp.std::ios::rdbuf(m_fp.rdbuf());
+    delete m_async_buf;
+  }
+}
 
 
 
@@ -254,5 +274,6 @@ void Avida::Output::File::Endl()
 
 void Avida::Output::File::Flush()
 {
-  m_fp.flush();
+  if (m_async_buf) m_async_buf->Flush();
+  else m_fp.flush();
 }
@@ -24,7 +24,10 @@
 
 #include "avida/output/Manager.h"
 
+#include "avida/core/Context.h"
+#include "avida/core/WorldDriver.h"
 #include "avida/output/Socket.h"
+#include "avida/private/output/AsyncWriter.h"
 
 Avida::Output::Manager::Manager(const Apto::String& output_path) : m_world(NULL)
 {
@@ -40,7 +43,14 @@ Avida::Output::Manager::Manager(const Apto::String& output_path) : m_world(NULL)
   }
 }
 
-Avida::Output::Manager::~Manager() { ; }
+Avida::Output::Manager::~Manager()
+{
+  if (m_writer) {
+    FlushAll();
+    m_writer->Shutdown();
+    m_writer->ReportFailures(NULL);  // the driver is no longer reachable at teardown
+  }
+}
 
 
 Avida::Output::OutputID Avida::Output::Manager::OutputIDFromPath(Apto::String path) const
@@ -112,6 +122,17 @@ void Avida::Output::Manager::FlushAll()
     (*it.Get())->Flush();
   }
   m_mutex.Unlock();
+  
+  if (m_writer) m_writer->Sync();
+}
+
+bool Avida::Output::Manager::StartAsyncWriter(int max_queued, int buffer_size)
+{
+  Apto::MutexAutoLock lock(m_mutex);
+  if (m_writer) return false;
+  
+  m_writer = Apto::SmartPtr<AsyncWriter, Apto::InternalRCObject>(new AsyncWriter(max_queued, buffer_size));
+  return true;
 }
 
 
@@ -155,6 +176,12 @@ Avida::WorldFacetID Avida::Output::Manager::UpdateAfter() const
   return "";
 }
 
+void Avida::Output::Manager::PerformUpdate(Context& ctx, Update)
+{
+  // Failures on the background writer thread surface here, on the simulation thread
+  if (m_writer) m_writer->ReportFailures(&ctx.Driver().Feedback());
+}
+
 
 bool Avida::Output::Manager::RegisterSocket(const OutputID& output_id, SocketWeakRef socket_ref)
 {
@@ -0,0 +1,160 @@
+/*
+ *  cASBytecode.h
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cASBytecode_h
+#define cASBytecode_h
+
+#include "avida/Avida.h"
+#include "AvidaScript.h"
+
+#include "cString.h"
+
+class cASFunction;
+class cASTNode;
+
+
+// AvidaScript register bytecode, as produced by cBytecodeCompileASTVisitor and run by cASBytecodeVM
+//
+// Every function frame has two register banks: numeric registers (bool, char, int and float values) and string
+// registers.  Variables are resolved to fixed registers at compile time, followed by the temporaries needed for
+// expression evaluation.  Operands are register indices in the frame unless noted otherwise.
+
+typedef enum eASOpcodes {
+  AS_OP_LOAD_BOOL = 0,    // a = dst, b = immediate
+  AS_OP_LOAD_CHAR,        // a = dst, b = immediate
+  AS_OP_LOAD_INT,         // a = dst, b = immediate
+  AS_OP_LOAD_FLOAT,       // a = dst, b = float constant index
+  AS_OP_LOAD_STRING,      // a = dst string, b = string constant index
+  AS_OP_MOVE,             // a = dst, b = src
+  AS_OP_MOVE_STRING,
+  AS_OP_GET_GLOBAL,       // a = dst, b = global register
+  AS_OP_GET_GLOBAL_STRING,
+  AS_OP_SET_GLOBAL,       // a = global register, b = src
+  AS_OP_SET_GLOBAL_STRING,
+
+  // Conversions, a = dst, b = src
+  AS_OP_B2C, AS_OP_B2I, AS_OP_B2F, AS_OP_B2S,
+  AS_OP_C2B, AS_OP_C2I, AS_OP_C2F, AS_OP_C2S,
+  AS_OP_I2B, AS_OP_I2C, AS_OP_I2F, AS_OP_I2S,
+  AS_OP_F2B, AS_OP_F2I, AS_OP_F2S,
+  AS_OP_S2B, AS_OP_S2I, AS_OP_S2F,
+
+  // Arithmetic, a = b op c
+  AS_OP_ADD_CHAR, AS_OP_ADD_INT, AS_OP_ADD_FLOAT, AS_OP_ADD_STRING,
+  AS_OP_SUB_CHAR, AS_OP_SUB_INT, AS_OP_SUB_FLOAT,
+  AS_OP_MUL_CHAR, AS_OP_MUL_INT, AS_OP_MUL_FLOAT,
+  AS_OP_DIV_CHAR, AS_OP_DIV_INT, AS_OP_DIV_FLOAT,
+  AS_OP_MOD_CHAR, AS_OP_MOD_INT, AS_OP_MOD_FLOAT,
+  AS_OP_BIT_AND_CHAR, AS_OP_BIT_AND_INT,
+  AS_OP_BIT_OR_CHAR, AS_OP_BIT_OR_INT,
+  AS_OP_LOGIC_AND, AS_OP_LOGIC_OR,
+
+  // Unary, a = op b
+  AS_OP_BIT_NOT_CHAR, AS_OP_BIT_NOT_INT,
+  AS_OP_NEG_CHAR, AS_OP_NEG_INT, AS_OP_NEG_FLOAT,
+  AS_OP_LOGIC_NOT,
+
+  // Comparison, a (bool) = b op c
+  AS_OP_EQ_BOOL, AS_OP_NEQ_BOOL,
+  AS_OP_EQ_INT, AS_OP_NEQ_INT, AS_OP_LT_INT, AS_OP_LE_INT, AS_OP_GT_INT, AS_OP_GE_INT,
+  AS_OP_EQ_FLOAT, AS_OP_NEQ_FLOAT, AS_OP_LT_FLOAT, AS_OP_LE_FLOAT, AS_OP_GT_FLOAT, AS_OP_GE_FLOAT,
+  AS_OP_EQ_STRING, AS_OP_NEQ_STRING,
+
+  // Control flow
+  AS_OP_JUMP,             // a = target
+  AS_OP_JUMP_FALSE,       // a = condition, b = target
+  AS_OP_RANGE_INIT,       // a = current (a + 1 = end), sets the step in a + 2
+  AS_OP_RANGE_NEXT,       // a = current, b = target; steps toward end and jumps, falls through once end is reached
+  AS_OP_CALL,             // a = function, b = first numeric argument, c = first string argument; result in b or c
+  AS_OP_CALL_NATIVE,      // a = native function, b/c as for AS_OP_CALL
+  AS_OP_RETURN,           // a = value
+  AS_OP_RETURN_STRING,    // a = value
+  AS_OP_RETURN_VOID
+} ASOpcode_t;
+
+
+struct sASInstruction
+{
+  ASOpcode_t op;
+  int a;
+  int b;
+  int c;
+
+  sASInstruction() : op(AS_OP_RETURN_VOID), a(0), b(0), c(0) { ; }
+  sASInstruction(ASOpcode_t in_op, int in_a, int in_b, int in_c) : op(in_op), a(in_a), b(in_b), c(in_c) { ; }
+};
+
+
+typedef union {
+  bool as_bool;
+  char as_char;
+  int as_int;
+  double as_float;
+} uASRegister;
+
+
+class cASBytecodeFunction
+{
+public:
+  cString name;
+  ASType_t rtype;
+
+  Apto::Array<sASInstruction> code;
+  Apto::Array<const cASTNode*> source;  // originating node of each instruction, for error reporting
+
+  int num_locals;                       // numeric variable registers, zeroed on entry
+  int str_locals;                       // string variable registers, cleared on entry
+  int num_regs;                         // total numeric registers, including temporaries
+  int str_regs;                         // total string registers, including temporaries
+
+  Apto::Array<int> num_args;            // registers receiving the numeric arguments, in argument order
+  Apto::Array<int> str_args;            // registers receiving the string arguments, in argument order
+
+  cASBytecodeFunction(const cString& in_name, ASType_t in_rtype)
+    : name(in_name), rtype(in_rtype), num_locals(0), str_locals(0), num_regs(0), str_regs(0) { ; }
+};
+
+
+class cASBytecodeProgram
+{
+public:
+  struct sNativeCall
+  {
+    const cASFunction* func;
+    Apto::Array<ASType_t> arg_types;
+    ASType_t rtype;
+
+    sNativeCall() : func(NULL), rtype(AS_TYPE_VOID) { ; }
+  };
+
+  Apto::Array<cASBytecodeFunction*> functions;  // function 0 is the script body, its frame holds the globals
+  Apto::Array<double> float_consts;
+  Apto::Array<cString> str_consts;
+  Apto::Array<sNativeCall> natives;
+
+  cASBytecodeProgram() { ; }
+  ~cASBytecodeProgram() { for (int i = 0; i < functions.GetSize(); i++) delete functions[i]; }
+
+private:
+  cASBytecodeProgram(const cASBytecodeProgram&); // @not_implemented
+  cASBytecodeProgram& operator=(const cASBytecodeProgram&); // @not_implemented
+};
+
+#endif
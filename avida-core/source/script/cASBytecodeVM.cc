@@ -0,0 +1,305 @@
+/*
+ *  cASBytecodeVM.cc
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cASBytecodeVM.h"
+
+#include "ASTree.h"
+#include "cASFunction.h"
+#include "cStringUtil.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+
+static const int INITIAL_REGISTERS = 1024;
+
+
+cASBytecodeVM::cASBytecodeVM(const cASBytecodeProgram* program)
+  : m_program(program), m_num(INITIAL_REGISTERS), m_str(INITIAL_REGISTERS / 8), m_empty("")
+{
+  int max_arity = 1;
+  for (int i = 0; i < m_program->natives.GetSize(); i++) {
+    if (m_program->natives[i].arg_types.GetSize() > max_arity) max_arity = m_program->natives[i].arg_types.GetSize();
+  }
+  m_native_args.Resize(max_arity);
+}
+
+
+int cASBytecodeVM::Execute()
+{
+  enter(*m_program->functions[0], 0, 0);
+
+  cString str_rvalue(m_empty);
+  return execute(0, 0, 0, str_rvalue).as_int;
+}
+
+
+uASRegister cASBytecodeVM::execute(int fun_idx, int num_base, int str_base, cString& str_rvalue)
+{
+  const cASBytecodeFunction& fun = *m_program->functions[fun_idx];
+  const sASInstruction* code = &fun.code[0];
+
+  uASRegister* R = &m_num[num_base];
+  cString* S = &m_str[str_base];
+
+  uASRegister rvalue;
+  rvalue.as_float = 0.0;
+
+  int pc = 0;
+  while (true) {
+    const sASInstruction& in = code[pc++];
+
+    switch (in.op) {
+      case AS_OP_LOAD_BOOL:           R[in.a].as_bool = (in.b != 0); break;
+      case AS_OP_LOAD_CHAR:           R[in.a].as_char = static_cast<char>(in.b); break;
+      case AS_OP_LOAD_INT:            R[in.a].as_int = in.b; break;
+      case AS_OP_LOAD_FLOAT:          R[in.a].as_float = m_program->float_consts[in.b]; break;
+      case AS_OP_LOAD_STRING:         S[in.a] = m_program->str_consts[in.b]; break;
+      case AS_OP_MOVE:                R[in.a] = R[in.b]; break;
+      case AS_OP_MOVE_STRING:         S[in.a] = S[in.b]; break;
+      case AS_OP_GET_GLOBAL:          R[in.a] = m_num[in.b]; break;
+      case AS_OP_GET_GLOBAL_STRING:   S[in.a] = m_str[in.b]; break;
+      case AS_OP_SET_GLOBAL:          m_num[in.a] = R[in.b]; break;
+      case AS_OP_SET_GLOBAL_STRING:   m_str[in.a] = S[in.b]; break;
+
+      case AS_OP_B2C:   R[in.a].as_char = R[in.b].as_bool ? 1 : 0; break;
+      case AS_OP_B2I:   R[in.a].as_int = R[in.b].as_bool ? 1 : 0; break;
+      case AS_OP_B2F:   R[in.a].as_float = R[in.b].as_bool ? 1.0 : 0.0; break;
+      case AS_OP_B2S:   S[in.a] = cStringUtil::Convert(R[in.b].as_bool); break;
+      case AS_OP_C2B:   R[in.a].as_bool = (R[in.b].as_char != 0); break;
+      case AS_OP_C2I:   R[in.a].as_int = static_cast<int>(R[in.b].as_char); break;
+      case AS_OP_C2F:   R[in.a].as_float = static_cast<double>(R[in.b].as_char); break;
+      case AS_OP_C2S:   { cString str(1); str[0] = R[in.b].as_char; S[in.a] = str; } break;
+      case AS_OP_I2B:   R[in.a].as_bool = (R[in.b].as_int != 0); break;
+      case AS_OP_I2C:   R[in.a].as_char = static_cast<char>(R[in.b].as_int); break;
+      case AS_OP_I2F:   R[in.a].as_float = static_cast<double>(R[in.b].as_int); break;
+      case AS_OP_I2S:   S[in.a] = cStringUtil::Convert(R[in.b].as_int); break;
+      case AS_OP_F2B:   R[in.a].as_bool = (R[in.b].as_float != 0.0); break;
+      case AS_OP_F2I:   R[in.a].as_int = static_cast<int>(R[in.b].as_float); break;
+      case AS_OP_F2S:   S[in.a] = cStringUtil::Convert(R[in.b].as_float); break;
+      case AS_OP_S2B:   R[in.a].as_bool = (S[in.b] != ""); break;
+      case AS_OP_S2I:   R[in.a].as_int = S[in.b].AsInt(); break;
+      case AS_OP_S2F:   R[in.a].as_float = S[in.b].AsDouble(); break;
+
+      case AS_OP_ADD_CHAR:    R[in.a].as_char = R[in.b].as_char + R[in.c].as_char; break;
+      case AS_OP_ADD_INT:     R[in.a].as_int = R[in.b].as_int + R[in.c].as_int; break;
+      case AS_OP_ADD_FLOAT:   R[in.a].as_float = R[in.b].as_float + R[in.c].as_float; break;
+      case AS_OP_ADD_STRING:  S[in.a] = S[in.b] + S[in.c]; break;
+      case AS_OP_SUB_CHAR:    R[in.a].as_char = R[in.b].as_char - R[in.c].as_char; break;
+      case AS_OP_SUB_INT:     R[in.a].as_int = R[in.b].as_int - R[in.c].as_int; break;
+      case AS_OP_SUB_FLOAT:   R[in.a].as_float = R[in.b].as_float - R[in.c].as_float; break;
+      case AS_OP_MUL_CHAR:    R[in.a].as_char = R[in.b].as_char * R[in.c].as_char; break;
+      case AS_OP_MUL_INT:     R[in.a].as_int = R[in.b].as_int * R[in.c].as_int; break;
+      case AS_OP_MUL_FLOAT:   R[in.a].as_float = R[in.b].as_float * R[in.c].as_float; break;
+
+      case AS_OP_DIV_CHAR:
+        if (R[in.c].as_char == 0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, fun.source[pc - 1]);
+        R[in.a].as_char = R[in.b].as_char / R[in.c].as_char;
+        break;
+      case AS_OP_DIV_INT:
+        if (R[in.c].as_int == 0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, fun.source[pc - 1]);
+        R[in.a].as_int = R[in.b].as_int / R[in.c].as_int;
+        break;
+      case AS_OP_DIV_FLOAT:
+        if (R[in.c].as_float == 0.0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, fun.source[pc - 1]);
+        R[in.a].as_float = R[in.b].as_float / R[in.c].as_float;
+        break;
+      case AS_OP_MOD_CHAR:
+        if (R[in.c].as_char == 0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, fun.source[pc - 1]);
+        R[in.a].as_char = R[in.b].as_char % R[in.c].as_char;
+        break;
+      case AS_OP_MOD_INT:
+        if (R[in.c].as_int == 0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, fun.source[pc - 1]);
+        R[in.a].as_int = R[in.b].as_int % R[in.c].as_int;
+        break;
+      case AS_OP_MOD_FLOAT:
+        if (R[in.c].as_float == 0.0) reportError(AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO, fun.source[pc - 1]);
+        R[in.a].as_float = fmod(R[in.b].as_float, R[in.c].as_float);
+        break;
+
+      case AS_OP_BIT_AND_CHAR:  R[in.a].as_char = R[in.b].as_char & R[in.c].as_char; break;
+      case AS_OP_BIT_AND_INT:   R[in.a].as_int = R[in.b].as_int & R[in.c].as_int; break;
+      case AS_OP_BIT_OR_CHAR:   R[in.a].as_char = R[in.b].as_char | R[in.c].as_char; break;
+      case AS_OP_BIT_OR_INT:    R[in.a].as_int = R[in.b].as_int | R[in.c].as_int; break;
+      case AS_OP_LOGIC_AND:     R[in.a].as_bool = (R[in.b].as_bool && R[in.c].as_bool); break;
+      case AS_OP_LOGIC_OR:      R[in.a].as_bool = (R[in.b].as_bool || R[in.c].as_bool); break;
+
+      case AS_OP_BIT_NOT_CHAR:  R[in.a].as_char = ~R[in.b].as_char; break;
+      case AS_OP_BIT_NOT_INT:   R[in.a].as_int = ~R[in.b].as_int; break;
+      case AS_OP_NEG_CHAR:      R[in.a].as_char = -R[in.b].as_char; break;
+      case AS_OP_NEG_INT:       R[in.a].as_int = -R[in.b].as_int; break;
+      case AS_OP_NEG_FLOAT:     R[in.a].as_float = -R[in.b].as_float; break;
+      case AS_OP_LOGIC_NOT:     R[in.a].as_bool = !R[in.b].as_bool; break;
+
+      case AS_OP_EQ_BOOL:       R[in.a].as_bool = (R[in.b].as_bool == R[in.c].as_bool); break;
+      case AS_OP_NEQ_BOOL:      R[in.a].as_bool = (R[in.b].as_bool != R[in.c].as_bool); break;
+      case AS_OP_EQ_INT:        R[in.a].as_bool = (R[in.b].as_int == R[in.c].as_int); break;
+      case AS_OP_NEQ_INT:       R[in.a].as_bool = (R[in.b].as_int != R[in.c].as_int); break;
+      case AS_OP_LT_INT:        R[in.a].as_bool = (R[in.b].as_int < R[in.c].as_int); break;
+      case AS_OP_LE_INT:        R[in.a].as_bool = (R[in.b].as_int <= R[in.c].as_int); break;
+      case AS_OP_GT_INT:        R[in.a].as_bool = (R[in.b].as_int > R[in.c].as_int); break;
+      case AS_OP_GE_INT:        R[in.a].as_bool = (R[in.b].as_int >= R[in.c].as_int); break;
+      case AS_OP_EQ_FLOAT:      R[in.a].as_bool = (R[in.b].as_float == R[in.c].as_float); break;
+      case AS_OP_NEQ_FLOAT:     R[in.a].as_bool = (R[in.b].as_float != R[in.c].as_float); break;
+      case AS_OP_LT_FLOAT:      R[in.a].as_bool = (R[in.b].as_float < R[in.c].as_float); break;
+      case AS_OP_LE_FLOAT:      R[in.a].as_bool = (R[in.b].as_float <= R[in.c].as_float); break;
+      case AS_OP_GT_FLOAT:      R[in.a].as_bool = (R[in.b].as_float > R[in.c].as_float); break;
+      case AS_OP_GE_FLOAT:      R[in.a].as_bool = (R[in.b].as_float >= R[in.c].as_float); break;
+      case AS_OP_EQ_STRING:     R[in.a].as_bool = (S[in.b] == S[in.c]); break;
+      case AS_OP_NEQ_STRING:    R[in.a].as_bool = (S[in.b] != S[in.c]); break;
+
+      case AS_OP_JUMP:
+        pc = in.a;
+        break;
+      case AS_OP_JUMP_FALSE:
+        if (!R[in.a].as_bool) pc = in.b;
+        break;
+
+      case AS_OP_RANGE_INIT:
+        R[in.a + 2].as_int = (R[in.a + 1].as_int > R[in.a].as_int) ? 1 : -1;
+        break;
+      case AS_OP_RANGE_NEXT:
+        if (R[in.a].as_int != R[in.a + 1].as_int) {
+          R[in.a].as_int += R[in.a + 2].as_int;
+          pc = in.b;
+        }
+        break;
+
+      case AS_OP_CALL:
+        {
+          const cASBytecodeFunction& callee = *m_program->functions[in.a];
+          int callee_num = num_base + fun.num_regs;
+          int callee_str = str_base + fun.str_regs;
+          enter(callee, callee_num, callee_str);
+
+          // The register banks may have been reallocated
+          R = &m_num[num_base];
+          S = &m_str[str_base];
+
+          for (int i = 0; i < callee.num_args.GetSize(); i++) m_num[callee_num + callee.num_args[i]] = R[in.b + i];
+          for (int i = 0; i < callee.str_args.GetSize(); i++) m_str[callee_str + callee.str_args[i]] = S[in.c + i];
+
+          cString str_result(m_empty);
+          uASRegister result = execute(in.a, callee_num, callee_str, str_result);
+
+          R = &m_num[num_base];
+          S = &m_str[str_base];
+          if (callee.rtype == AS_TYPE_STRING) S[in.c] = str_result;
+          else if (callee.rtype != AS_TYPE_VOID) R[in.b] = result;
+        }
+        break;
+
+      case AS_OP_CALL_NATIVE:
+        callNative(m_program->natives[in.a], &R[in.b], &S[in.c]);
+        break;
+
+      case AS_OP_RETURN:
+        rvalue = R[in.a];
+        return rvalue;
+      case AS_OP_RETURN_STRING:
+        str_rvalue = S[in.a];
+        return rvalue;
+      case AS_OP_RETURN_VOID:
+        return rvalue;
+    }
+  }
+
+  return rvalue;
+}
+
+
+void cASBytecodeVM::enter(const cASBytecodeFunction& fun, int num_base, int str_base)
+{
+  // Keep one register past the frame, so that empty argument windows still address valid storage
+  int num_size = num_base + fun.num_regs + 1;
+  if (m_num.GetSize() < num_size) {
+    int size = m_num.GetSize() * 2;
+    while (size < num_size) size *= 2;
+    m_num.Resize(size);
+  }
+  int str_size = str_base + fun.str_regs + 1;
+  if (m_str.GetSize() < str_size) {
+    int size = m_str.GetSize() * 2;
+    while (size < str_size) size *= 2;
+    m_str.Resize(size);
+  }
+
+  for (int i = 0; i < fun.num_locals; i++) m_num[num_base + i].as_float = 0.0;
+  for (int i = 0; i < fun.str_locals; i++) m_str[str_base + i] = m_empty;
+}
+
+
+void cASBytecodeVM::callNative(const cASBytecodeProgram::sNativeCall& native, uASRegister* num_args, cString* str_args)
+{
+  cASCPPParameter* args = &m_native_args[0];
+
+  // Arguments are passed straight from the registers, string arguments by reference
+  int num_idx = 0;
+  int str_idx = 0;
+  for (int i = 0; i < native.arg_types.GetSize(); i++) {
+    switch (native.arg_types[i]) {
+      case AS_TYPE_BOOL:    args[i].Set(num_args[num_idx++].as_bool); break;
+      case AS_TYPE_CHAR:    args[i].Set(num_args[num_idx++].as_char); break;
+      case AS_TYPE_INT:     args[i].Set(num_args[num_idx++].as_int); break;
+      case AS_TYPE_FLOAT:   args[i].Set(num_args[num_idx++].as_float); break;
+      case AS_TYPE_STRING:  args[i].Set(&str_args[str_idx++]); break;
+      default:              reportError(AS_DIRECT_INTERPRET_ERR_INTERNAL, NULL); break;
+    }
+  }
+
+  cASCPPParameter rvalue = native.func->Call(args);
+
+  switch (native.rtype) {
+    case AS_TYPE_BOOL:    num_args[0].as_bool = rvalue.Get<bool>(); break;
+    case AS_TYPE_CHAR:    num_args[0].as_char = rvalue.Get<char>(); break;
+    case AS_TYPE_INT:     num_args[0].as_int = rvalue.Get<int>(); break;
+    case AS_TYPE_FLOAT:   num_args[0].as_float = rvalue.Get<double>(); break;
+    case AS_TYPE_STRING:
+      {
+        cString* str = rvalue.Get<cString*>();
+        str_args[0] = *str;
+        delete str;
+      }
+      break;
+    default: break;
+  }
+}
+
+
+void cASBytecodeVM::reportError(ASDirectInterpretError_t err, const cASTNode* node)
+{
+  if (node) std::cerr << node->GetFilePosition().GetFilename() << ":" << node->GetFilePosition().GetLineNumber() << ": ";
+  std::cerr << "error: ";
+
+  switch (err) {
+    case AS_DIRECT_INTERPRET_ERR_DIVISION_BY_ZERO:
+      std::cerr << "division by zero" << std::endl;
+      break;
+    case AS_DIRECT_INTERPRET_ERR_INTERNAL:
+      std::cerr << "internal bytecode interpreter error" << std::endl;
+      break;
+    default:
+      std::cerr << "unknown error" << std::endl;
+      break;
+  }
+
+  exit(AS_EXIT_FAIL_INTERPRET);
+}
@@ -0,0 +1,62 @@
+/*
+ *  cASBytecodeVM.h
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cASBytecodeVM_h
+#define cASBytecodeVM_h
+
+#include "cASBytecode.h"
+#include "cASCPPParameter.h"
+
+
+// Executes a cASBytecodeProgram.  Frames are laid out consecutively in the two register banks, with the script body
+// (and therefore the global variables) at the bottom.  Runtime errors are reported like cDirectInterpretASTVisitor's.
+
+class cASBytecodeVM
+{
+private:
+  const cASBytecodeProgram* m_program;
+
+  Apto::Array<uASRegister> m_num;
+  Apto::Array<cString> m_str;
+  Apto::Array<cASCPPParameter> m_native_args;
+  const cString m_empty;
+
+
+  cASBytecodeVM(); // @not_implemented
+  cASBytecodeVM(const cASBytecodeVM&); // @not_implemented
+  cASBytecodeVM& operator=(const cASBytecodeVM&); // @not_implemented
+
+
+public:
+  cASBytecodeVM(const cASBytecodeProgram* program);
+
+  // Runs the script body, returning its exit code
+  int Execute();
+
+
+private:
+  uASRegister execute(int fun_idx, int num_base, int str_base, cString& str_rvalue);
+  void enter(const cASBytecodeFunction& fun, int num_base, int str_base);
+  void callNative(const cASBytecodeProgram::sNativeCall& native, uASRegister* num_args, cString* str_args);
+
+  void reportError(ASDirectInterpretError_t err, const cASTNode* node);
+};
+
+#endif
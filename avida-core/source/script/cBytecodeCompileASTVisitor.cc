@@ -0,0 +1,911 @@
+/*
+ *  cBytecodeCompileASTVisitor.cc
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cBytecodeCompileASTVisitor.h"
+
+#include "cASFunction.h"
+#include "cSymbolTable.h"
+
+using namespace AvidaScript;
+
+
+#define TOKEN(x) AS_TOKEN_ ## x
+#define TYPE(x) AS_TYPE_ ## x
+#define OP(x) AS_OP_ ## x
+
+
+cBytecodeCompileASTVisitor::cBytecodeCompileASTVisitor(cSymbolTable* global_symtbl)
+  : m_global_symtbl(global_symtbl), m_program(NULL), m_supported(true), m_fun(NULL), m_cur_symtbl(global_symtbl)
+  , m_num_top(0), m_str_top(0), m_dst(-1), m_dst_type(TYPE(INVALID))
+{
+}
+
+cBytecodeCompileASTVisitor::~cBytecodeCompileASTVisitor()
+{
+  delete m_program;
+}
+
+
+cASBytecodeProgram* cBytecodeCompileASTVisitor::Compile(cASTNode* node)
+{
+  delete m_program;
+  m_program = new cASBytecodeProgram;
+  m_supported = true;
+  m_fun_symtbls.Resize(0);
+  m_pending.Resize(0);
+
+  // The script body is function 0, its frame holds the global variables
+  int num_count = 0;
+  int str_count = 0;
+  if (!assignSlots(m_global_symtbl, m_global_slots, num_count, str_count)) {
+    delete m_program;
+    m_program = NULL;
+    return NULL;
+  }
+
+  cASBytecodeFunction* body = new cASBytecodeFunction("__asmain", TYPE(INT));
+  body->num_locals = num_count;
+  body->str_locals = str_count;
+  m_program->functions.Push(body);
+  m_fun_symtbls.Push(m_global_symtbl);
+
+  sPendingFunction main_fun;
+  main_fun.symtbl = m_global_symtbl;
+  main_fun.code = node;
+  main_fun.fun_idx = 0;
+  compileFunction(main_fun);
+
+  // Functions are queued as calls to them are compiled
+  for (int i = 0; m_supported && i < m_pending.GetSize(); i++) {
+    sPendingFunction pending = m_pending[i];
+    compileFunction(pending);
+  }
+
+  cASBytecodeProgram* program = NULL;
+  if (m_supported) program = m_program;
+  else delete m_program;
+  m_program = NULL;
+
+  return program;
+}
+
+
+void cBytecodeCompileASTVisitor::VisitAssignment(cASTAssignment& node)
+{
+  int var_id = node.GetVarID();
+
+  if (node.IsVarGlobal() && m_cur_symtbl != m_global_symtbl) {
+    ASType_t type = m_global_symtbl->GetVariableType(var_id).type;
+    sOperand value = convert(compile(node.GetExpression()), type, -1, node);
+    emit(isString(type) ? OP(SET_GLOBAL_STRING) : OP(SET_GLOBAL), m_global_slots[var_id], value.reg, 0, node);
+  } else {
+    compileInto(node.GetExpression(), m_cur_symtbl->GetVariableType(var_id).type, m_slots[var_id]);
+  }
+}
+
+
+void cBytecodeCompileASTVisitor::VisitArgumentList(cASTArgumentList& node)
+{
+  // Argument lists are processed by their owners
+  unsupported();
+}
+
+
+void cBytecodeCompileASTVisitor::VisitObjectAssignment(cASTObjectAssignment& node)
+{
+  unsupported();
+}
+
+
+
+void cBytecodeCompileASTVisitor::VisitReturnStatement(cASTReturnStatement& node)
+{
+  ASType_t rtype = m_fun->rtype;
+  sOperand value = compile(node.GetExpression());
+
+  if (rtype == TYPE(VOID)) {
+    emit(OP(RETURN_VOID), 0, 0, 0, node);
+  } else {
+    value = convert(value, rtype, -1, node);
+    emit(isString(rtype) ? OP(RETURN_STRING) : OP(RETURN), value.reg, 0, 0, node);
+  }
+}
+
+
+void cBytecodeCompileASTVisitor::VisitStatementList(cASTStatementList& node)
+{
+  tListIterator<cASTNode> it = node.Iterator();
+
+  cASTNode* stmt = NULL;
+  while (m_supported && (stmt = it.Next())) {
+    // Temporaries only live for the duration of a statement
+    int num_top = m_num_top;
+    int str_top = m_str_top;
+    stmt->Accept(*this);
+    m_num_top = num_top;
+    m_str_top = str_top;
+  }
+}
+
+
+
+void cBytecodeCompileASTVisitor::VisitForeachBlock(cASTForeachBlock& node)
+{
+  // Only integer ranges are compiled, iterated in place rather than expanded into an array
+  cASTExpressionBinary* range = dynamic_cast<cASTExpressionBinary*>(node.GetValues());
+  if (!range || range->GetOperator() != TOKEN(ARR_RANGE)) {
+    unsupported();
+    return;
+  }
+
+  int var_id = node.GetVariable()->GetVarID();
+  ASType_t var_type = m_cur_symtbl->GetVariableType(var_id).type;
+
+  int cur = allocTemps(false, 3);
+  compileInto(range->GetLeft(), TYPE(INT), cur);
+  compileInto(range->GetRight(), TYPE(INT), cur + 1);
+  emit(OP(RANGE_INIT), cur, 0, 0, node);
+
+  int top = label();
+  sOperand value = convert(sOperand(cur, TYPE(INT), false), var_type, m_slots[var_id], node);
+  if (value.reg != m_slots[var_id]) emit(OP(MOVE), m_slots[var_id], value.reg, 0, node);
+
+  node.GetCode()->Accept(*this);
+  emit(OP(RANGE_NEXT), cur, top, 0, node);
+}
+
+
+void cBytecodeCompileASTVisitor::VisitIfBlock(cASTIfBlock& node)
+{
+  Apto::Array<int> exits;
+
+  sOperand cond = convert(compile(node.GetCondition()), TYPE(BOOL), -1, node);
+  int skip = emit(OP(JUMP_FALSE), cond.reg, -1, 0, node);
+  node.GetCode()->Accept(*this);
+
+  tListIterator<cASTIfBlock::cElseIf> it = node.ElseIfIterator();
+  cASTIfBlock::cElseIf* ei = NULL;
+  while (m_supported && (ei = it.Next())) {
+    exits.Push(emit(OP(JUMP), -1, 0, 0, node));
+    patch(skip, label());
+
+    cond = convert(compile(ei->GetCondition()), TYPE(BOOL), -1, node);
+    skip = emit(OP(JUMP_FALSE), cond.reg, -1, 0, node);
+    ei->GetCode()->Accept(*this);
+  }
+
+  if (node.HasElse()) {
+    exits.Push(emit(OP(JUMP), -1, 0, 0, node));
+    patch(skip, label());
+    node.GetElseCode()->Accept(*this);
+  } else {
+    patch(skip, label());
+  }
+
+  for (int i = 0; i < exits.GetSize(); i++) patch(exits[i], label());
+}
+
+
+void cBytecodeCompileASTVisitor::VisitWhileBlock(cASTWhileBlock& node)
+{
+  int top = label();
+  sOperand cond = convert(compile(node.GetCondition()), TYPE(BOOL), -1, node);
+  int exit = emit(OP(JUMP_FALSE), cond.reg, -1, 0, node);
+
+  node.GetCode()->Accept(*this);
+  emit(OP(JUMP), top, 0, 0, node);
+  patch(exit, label());
+}
+
+
+
+void cBytecodeCompileASTVisitor::VisitFunctionDefinition(cASTFunctionDefinition& node)
+{
+  // Functions are compiled when the first call to them is encountered
+}
+
+
+void cBytecodeCompileASTVisitor::VisitVariableDefinition(cASTVariableDefinition& node)
+{
+  if (node.GetDimensions()) {
+    unsupported();
+    return;
+  }
+
+  if (node.GetAssignmentExpression()) {
+    int var_id = node.GetVarID();
+    compileInto(node.GetAssignmentExpression(), m_cur_symtbl->GetVariableType(var_id).type, m_slots[var_id]);
+  }
+}
+
+
+void cBytecodeCompileASTVisitor::VisitVariableDefinitionList(cASTVariableDefinitionList& node)
+{
+  // Variable definition lists are processed by function definitions
+  unsupported();
+}
+
+
+
+void cBytecodeCompileASTVisitor::VisitExpressionBinary(cASTExpressionBinary& node)
+{
+  ASToken_t op = node.GetOperator();
+  ASType_t type = node.GetType().type;
+  ASType_t comptype = node.GetCompareType().type;
+  if (comptype == TYPE(CHAR)) comptype = TYPE(INT);
+
+  ASType_t optype = TYPE(INVALID);
+  ASOpcode_t opcode = OP(RETURN_VOID);
+  switch (op) {
+    case TOKEN(OP_LOGIC_AND):
+    case TOKEN(OP_LOGIC_OR):
+      optype = TYPE(BOOL);
+      opcode = (op == TOKEN(OP_LOGIC_AND)) ? OP(LOGIC_AND) : OP(LOGIC_OR);
+      type = TYPE(BOOL);
+      break;
+
+    case TOKEN(OP_BIT_AND):
+    case TOKEN(OP_BIT_OR):
+      optype = type;
+      if (type == TYPE(CHAR)) opcode = (op == TOKEN(OP_BIT_AND)) ? OP(BIT_AND_CHAR) : OP(BIT_OR_CHAR);
+      else if (type == TYPE(INT)) opcode = (op == TOKEN(OP_BIT_AND)) ? OP(BIT_AND_INT) : OP(BIT_OR_INT);
+      else optype = TYPE(INVALID);
+      break;
+
+    case TOKEN(OP_EQ):
+    case TOKEN(OP_NEQ):
+      {
+        bool eq = (op == TOKEN(OP_EQ));
+        optype = comptype;
+        switch (comptype) {
+          case TYPE(BOOL):    opcode = eq ? OP(EQ_BOOL) : OP(NEQ_BOOL); break;
+          case TYPE(INT):     opcode = eq ? OP(EQ_INT) : OP(NEQ_INT); break;
+          case TYPE(FLOAT):   opcode = eq ? OP(EQ_FLOAT) : OP(NEQ_FLOAT); break;
+          case TYPE(STRING):  opcode = eq ? OP(EQ_STRING) : OP(NEQ_STRING); break;
+          default:            optype = TYPE(INVALID); break;
+        }
+        type = TYPE(BOOL);
+      }
+      break;
+
+    case TOKEN(OP_LE):
+    case TOKEN(OP_GE):
+    case TOKEN(OP_LT):
+    case TOKEN(OP_GT):
+      optype = comptype;
+      if (comptype == TYPE(INT)) {
+        switch (op) {
+          case TOKEN(OP_LE): opcode = OP(LE_INT); break;
+          case TOKEN(OP_GE): opcode = OP(GE_INT); break;
+          case TOKEN(OP_LT): opcode = OP(LT_INT); break;
+          default:           opcode = OP(GT_INT); break;
+        }
+      } else if (comptype == TYPE(FLOAT)) {
+        switch (op) {
+          case TOKEN(OP_LE): opcode = OP(LE_FLOAT); break;
+          case TOKEN(OP_GE): opcode = OP(GE_FLOAT); break;
+          case TOKEN(OP_LT): opcode = OP(LT_FLOAT); break;
+          default:           opcode = OP(GT_FLOAT); break;
+        }
+      } else {
+        optype = TYPE(INVALID);
+      }
+      type = TYPE(BOOL);
+      break;
+
+    case TOKEN(OP_ADD):
+    case TOKEN(OP_SUB):
+    case TOKEN(OP_MUL):
+    case TOKEN(OP_DIV):
+    case TOKEN(OP_MOD):
+      {
+        int offset = -1;
+        switch (type) {
+          case TYPE(CHAR):    offset = 0; break;
+          case TYPE(INT):     offset = 1; break;
+          case TYPE(FLOAT):   offset = 2; break;
+          case TYPE(STRING):  if (op == TOKEN(OP_ADD)) opcode = OP(ADD_STRING); break;
+          default: break;
+        }
+        if (offset >= 0) {
+          ASOpcode_t base = OP(ADD_CHAR);
+          switch (op) {
+            case TOKEN(OP_SUB): base = OP(SUB_CHAR); break;
+            case TOKEN(OP_MUL): base = OP(MUL_CHAR); break;
+            case TOKEN(OP_DIV): base = OP(DIV_CHAR); break;
+            case TOKEN(OP_MOD): base = OP(MOD_CHAR); break;
+            default: break;
+          }
+          opcode = static_cast<ASOpcode_t>(base + offset);
+          optype = type;
+        } else if (opcode == OP(ADD_STRING)) {
+          optype = type;
+        }
+      }
+      break;
+
+    default:
+      // Ranges, expansions and indexing produce arrays
+      break;
+  }
+
+  if (optype == TYPE(INVALID)) {
+    unsupported();
+    return;
+  }
+
+  int dst = popDest(type);
+  sOperand l = compileOperand(node.GetLeft(), optype, node.GetRight());
+  sOperand r = compileOperand(node.GetRight(), optype, NULL);
+  if (!m_supported) return;
+
+  int reg = destReg(dst, type);
+  emit(opcode, reg, l.reg, r.reg, node);
+  m_result = sOperand(reg, type, dst < 0);
+}
+
+
+void cBytecodeCompileASTVisitor::VisitExpressionUnary(cASTExpressionUnary& node)
+{
+  ASType_t type = node.GetType().type;
+  ASOpcode_t opcode = OP(RETURN_VOID);
+
+  switch (node.GetOperator()) {
+    case TOKEN(OP_BIT_NOT):
+      if (type == TYPE(CHAR)) opcode = OP(BIT_NOT_CHAR);
+      else if (type == TYPE(INT)) opcode = OP(BIT_NOT_INT);
+      break;
+
+    case TOKEN(OP_LOGIC_NOT):
+      type = TYPE(BOOL);
+      opcode = OP(LOGIC_NOT);
+      break;
+
+    case TOKEN(OP_SUB):
+      if (type == TYPE(CHAR)) opcode = OP(NEG_CHAR);
+      else if (type == TYPE(INT)) opcode = OP(NEG_INT);
+      else if (type == TYPE(FLOAT)) opcode = OP(NEG_FLOAT);
+      break;
+
+    default:
+      break;
+  }
+
+  if (opcode == OP(RETURN_VOID)) {
+    unsupported();
+    return;
+  }
+
+  int dst = popDest(type);
+  sOperand value = compileOperand(node.GetExpression(), type, NULL);
+  if (!m_supported) return;
+
+  int reg = (dst >= 0) ? dst : (value.temp ? value.reg : allocTemp(type));
+  emit(opcode, reg, value.reg, 0, node);
+  m_result = sOperand(reg, type, dst < 0);
+}
+
+
+
+void cBytecodeCompileASTVisitor::VisitBuiltInCall(cASTBuiltInCall& node)
+{
+  ASType_t type = TYPE(INVALID);
+  switch (node.GetBuiltIn()) {
+    case AS_BUILTIN_CAST_BOOL:    type = TYPE(BOOL); break;
+    case AS_BUILTIN_CAST_CHAR:    type = TYPE(CHAR); break;
+    case AS_BUILTIN_CAST_INT:     type = TYPE(INT); break;
+    case AS_BUILTIN_CAST_FLOAT:   type = TYPE(FLOAT); break;
+    case AS_BUILTIN_CAST_STRING:  type = TYPE(STRING); break;
+    default: break;
+  }
+
+  if (type == TYPE(INVALID) || !node.HasArguments()) {
+    unsupported();
+    return;
+  }
+
+  int dst = popDest(type);
+  sOperand value = compile(node.GetArguments()->Iterator().Next());
+  m_result = convert(value, type, dst, node);
+}
+
+
+void cBytecodeCompileASTVisitor::VisitFunctionCall(cASTFunctionCall& node)
+{
+  ASType_t rtype = node.GetType().type;
+  if (!isScalar(rtype) && rtype != TYPE(VOID)) {
+    unsupported();
+    return;
+  }
+  popDest(rtype);
+
+  Apto::Array<ASType_t> types;
+  Apto::Array<cASTNode*> args;
+  int num_window = 0;
+  int str_window = 0;
+
+  if (node.IsASFunction()) {
+    const cASFunction* func = node.GetASFunction();
+
+    int native_idx = -1;
+    for (int i = 0; i < m_program->natives.GetSize(); i++) {
+      if (m_program->natives[i].func == func) {
+        native_idx = i;
+        break;
+      }
+    }
+
+    if (native_idx < 0) {
+      cASBytecodeProgram::sNativeCall native;
+      native.func = func;
+      native.rtype = func->GetReturnType().type;
+      if (!isScalar(native.rtype) && native.rtype != TYPE(VOID)) {
+        unsupported();
+        return;
+      }
+      for (int i = 0; i < func->GetArity(); i++) {
+        native.arg_types.Push(func->GetArgumentType(i).type);
+        if (!isScalar(native.arg_types[i])) {
+          unsupported();
+          return;
+        }
+      }
+      native_idx = m_program->natives.GetSize();
+      m_program->natives.Push(native);
+    }
+
+    types = m_program->natives[native_idx].arg_types;
+    if (types.GetSize()) {
+      tListIterator<cASTNode> cit = node.GetArguments()->Iterator();
+      for (int i = 0; i < types.GetSize(); i++) args.Push(cit.Next());
+    }
+
+    compileArguments(types, args, rtype, num_window, str_window);
+    if (!m_supported) return;
+    emit(OP(CALL_NATIVE), native_idx, num_window, str_window, node);
+
+  } else {
+    cSymbolTable* src_symtbl = node.IsFuncGlobal() ? m_global_symtbl : m_cur_symtbl;
+    int fun_id = node.GetFuncID();
+    int fun_idx = getFunction(src_symtbl, fun_id, node);
+    if (fun_idx < 0) return;
+
+    // Missing arguments take the default value expressions from the function signature
+    cSymbolTable* func_symtbl = src_symtbl->GetFunctionSymbolTable(fun_id);
+    cASTVariableDefinitionList* sig = src_symtbl->GetFunctionSignature(fun_id);
+    if (sig) {
+      Apto::Array<cASTNode*> given;
+      if (node.HasArguments()) {
+        tListIterator<cASTNode> cit = node.GetArguments()->Iterator();
+        cASTNode* an = NULL;
+        while ((an = cit.Next())) given.Push(an);
+      }
+
+      tListIterator<cASTVariableDefinition> sit = sig->Iterator();
+      cASTVariableDefinition* arg_def = NULL;
+      while ((arg_def = sit.Next())) {
+        int i = args.GetSize();
+        types.Push(func_symtbl->GetVariableType(arg_def->GetVarID()).type);
+        args.Push((i < given.GetSize()) ? given[i] : arg_def->GetAssignmentExpression());
+      }
+    }
+
+    compileArguments(types, args, rtype, num_window, str_window);
+    if (!m_supported) return;
+    emit(OP(CALL), fun_idx, num_window, str_window, node);
+  }
+
+  if (rtype == TYPE(VOID)) m_result = sOperand(-1, TYPE(VOID), false);
+  else m_result = sOperand(isString(rtype) ? str_window : num_window, rtype, true);
+}
+
+
+void cBytecodeCompileASTVisitor::VisitLiteral(cASTLiteral& node)
+{
+  ASType_t type = node.GetType().type;
+  if (!isScalar(type)) {
+    unsupported();
+    return;
+  }
+
+  int reg = destReg(popDest(type), type);
+  switch (type) {
+    case TYPE(BOOL):
+      emit(OP(LOAD_BOOL), reg, (node.GetValue() == "true") ? 1 : 0, 0, node);
+      break;
+    case TYPE(CHAR):
+      emit(OP(LOAD_CHAR), reg, node.GetValue()[0], 0, node);
+      break;
+    case TYPE(INT):
+      emit(OP(LOAD_INT), reg, node.GetValue().AsInt(), 0, node);
+      break;
+    case TYPE(FLOAT):
+      emit(OP(LOAD_FLOAT), reg, m_program->float_consts.GetSize(), 0, node);
+      m_program->float_consts.Push(node.GetValue().AsDouble());
+      break;
+    case TYPE(STRING):
+      emit(OP(LOAD_STRING), reg, m_program->str_consts.GetSize(), 0, node);
+      m_program->str_consts.Push(node.GetValue());
+      break;
+    default:
+      break;
+  }
+
+  m_result = sOperand(reg, type, true);
+}
+
+
+void cBytecodeCompileASTVisitor::VisitLiteralArray(cASTLiteralArray& node)
+{
+  unsupported();
+}
+
+
+void cBytecodeCompileASTVisitor::VisitLiteralDict(cASTLiteralDict& node)
+{
+  unsupported();
+}
+
+
+void cBytecodeCompileASTVisitor::VisitObjectCall(cASTObjectCall& node)
+{
+  unsupported();
+}
+
+
+void cBytecodeCompileASTVisitor::VisitObjectReference(cASTObjectReference& node)
+{
+  unsupported();
+}
+
+
+void cBytecodeCompileASTVisitor::VisitVariableReference(cASTVariableReference& node)
+{
+  int var_id = node.GetVarID();
+
+  if (node.IsVarGlobal() && m_cur_symtbl != m_global_symtbl) {
+    ASType_t type = m_global_symtbl->GetVariableType(var_id).type;
+    int dst = popDest(type);
+    int reg = destReg(dst, type);
+    emit(isString(type) ? OP(GET_GLOBAL_STRING) : OP(GET_GLOBAL), reg, m_global_slots[var_id], 0, node);
+    m_result = sOperand(reg, type, dst < 0);
+  } else {
+    // Local variables are read directly from their registers
+    m_dst = -1;
+    m_result = sOperand(m_slots[var_id], m_cur_symtbl->GetVariableType(var_id).type, false);
+  }
+}
+
+
+void cBytecodeCompileASTVisitor::VisitUnpackTarget(cASTUnpackTarget& node)
+{
+  unsupported();
+}
+
+
+
+bool cBytecodeCompileASTVisitor::isPure(cASTNode* node)
+{
+  if (dynamic_cast<cASTLiteral*>(node) || dynamic_cast<cASTVariableReference*>(node)) return true;
+
+  cASTExpressionBinary* binary = dynamic_cast<cASTExpressionBinary*>(node);
+  if (binary) return (isPure(binary->GetLeft()) && isPure(binary->GetRight()));
+
+  cASTExpressionUnary* unary = dynamic_cast<cASTExpressionUnary*>(node);
+  if (unary) return isPure(unary->GetExpression());
+
+  return false;
+}
+
+
+bool cBytecodeCompileASTVisitor::castOp(ASType_t from, ASType_t to, ASOpcode_t& op)
+{
+  switch (from) {
+    case TYPE(BOOL):
+      switch (to) {
+        case TYPE(CHAR):    op = OP(B2C); return true;
+        case TYPE(INT):     op = OP(B2I); return true;
+        case TYPE(FLOAT):   op = OP(B2F); return true;
+        case TYPE(STRING):  op = OP(B2S); return true;
+        default: break;
+      }
+      break;
+    case TYPE(CHAR):
+      switch (to) {
+        case TYPE(BOOL):    op = OP(C2B); return true;
+        case TYPE(INT):     op = OP(C2I); return true;
+        case TYPE(FLOAT):   op = OP(C2F); return true;
+        case TYPE(STRING):  op = OP(C2S); return true;
+        default: break;
+      }
+      break;
+    case TYPE(INT):
+      switch (to) {
+        case TYPE(BOOL):    op = OP(I2B); return true;
+        case TYPE(CHAR):    op = OP(I2C); return true;
+        case TYPE(FLOAT):   op = OP(I2F); return true;
+        case TYPE(STRING):  op = OP(I2S); return true;
+        default: break;
+      }
+      break;
+    case TYPE(FLOAT):
+      switch (to) {
+        case TYPE(BOOL):    op = OP(F2B); return true;
+        case TYPE(INT):     op = OP(F2I); return true;
+        case TYPE(STRING):  op = OP(F2S); return true;
+        default: break;
+      }
+      break;
+    case TYPE(STRING):
+      switch (to) {
+        case TYPE(BOOL):    op = OP(S2B); return true;
+        case TYPE(INT):     op = OP(S2I); return true;
+        case TYPE(FLOAT):   op = OP(S2F); return true;
+        default: break;
+      }
+      break;
+    default: break;
+  }
+
+  // Remaining conversions are runtime errors in the interpreter
+  return false;
+}
+
+
+int cBytecodeCompileASTVisitor::getFunction(cSymbolTable* src_symtbl, int fun_id, cASTNode& node)
+{
+  cSymbolTable* symtbl = src_symtbl->GetFunctionSymbolTable(fun_id);
+  for (int i = 0; i < m_fun_symtbls.GetSize(); i++) if (m_fun_symtbls[i] == symtbl) return i;
+
+  cASTNode* code = src_symtbl->GetFunctionDefinition(fun_id);
+  ASType_t rtype = src_symtbl->GetFunctionRType(fun_id).type;
+  Apto::Array<int> slots;
+  int num_count = 0;
+  int str_count = 0;
+  if (!symtbl || !code || (!isScalar(rtype) && rtype != TYPE(VOID)) ||
+      !assignSlots(symtbl, slots, num_count, str_count)) {
+    unsupported();
+    return -1;
+  }
+
+  cASBytecodeFunction* fun = new cASBytecodeFunction(src_symtbl->GetFunctionName(fun_id), rtype);
+  fun->num_locals = num_count;
+  fun->str_locals = str_count;
+
+  cASTVariableDefinitionList* sig = src_symtbl->GetFunctionSignature(fun_id);
+  if (sig) {
+    tListIterator<cASTVariableDefinition> sit = sig->Iterator();
+    cASTVariableDefinition* arg_def = NULL;
+    while ((arg_def = sit.Next())) {
+      int var_id = arg_def->GetVarID();
+      if (isString(symtbl->GetVariableType(var_id).type)) fun->str_args.Push(slots[var_id]);
+      else fun->num_args.Push(slots[var_id]);
+    }
+  }
+
+  int fun_idx = m_program->functions.GetSize();
+  m_program->functions.Push(fun);
+  m_fun_symtbls.Push(symtbl);
+
+  sPendingFunction pending;
+  pending.symtbl = symtbl;
+  pending.code = code;
+  pending.fun_idx = fun_idx;
+  m_pending.Push(pending);
+
+  return fun_idx;
+}
+
+
+void cBytecodeCompileASTVisitor::compileFunction(const sPendingFunction& pending)
+{
+  m_fun = m_program->functions[pending.fun_idx];
+  m_cur_symtbl = pending.symtbl;
+  if (pending.fun_idx == 0) {
+    m_slots = m_global_slots;
+  } else {
+    int num_count = 0;
+    int str_count = 0;
+    assignSlots(pending.symtbl, m_slots, num_count, str_count);
+  }
+
+  m_num_top = m_fun->num_regs = m_fun->num_locals;
+  m_str_top = m_fun->str_regs = m_fun->str_locals;
+  m_dst = -1;
+
+  pending.code->Accept(*this);
+  if (!m_supported) return;
+
+  // Falling off the end of the function returns the default value of its type
+  const cASTNode& node = *pending.code;
+  switch (m_fun->rtype) {
+    case TYPE(VOID):
+      emit(OP(RETURN_VOID), 0, 0, 0, node);
+      break;
+
+    case TYPE(STRING):
+      {
+        int reg = allocTemp(TYPE(STRING));
+        emit(OP(LOAD_STRING), reg, m_program->str_consts.GetSize(), 0, node);
+        m_program->str_consts.Push(cString(""));
+        emit(OP(RETURN_STRING), reg, 0, 0, node);
+      }
+      break;
+
+    default:
+      {
+        int reg = allocTemp(TYPE(INT));
+        emit(OP(LOAD_INT), reg, 0, 0, node);
+        sOperand value = convert(sOperand(reg, TYPE(INT), true), m_fun->rtype, -1, node);
+        emit(OP(RETURN), value.reg, 0, 0, node);
+      }
+      break;
+  }
+}
+
+
+bool cBytecodeCompileASTVisitor::assignSlots(cSymbolTable* symtbl, Apto::Array<int>& slots, int& num_count,
+                                             int& str_count)
+{
+  slots.Resize(symtbl->GetNumVariables());
+  for (int i = 0; i < symtbl->GetNumVariables(); i++) {
+    ASType_t type = symtbl->GetVariableType(i).type;
+    if (!isScalar(type)) return false;
+    slots[i] = isString(type) ? str_count++ : num_count++;
+  }
+
+  return true;
+}
+
+
+inline int cBytecodeCompileASTVisitor::emit(ASOpcode_t op, int a, int b, int c, const cASTNode& node)
+{
+  m_fun->code.Push(sASInstruction(op, a, b, c));
+  m_fun->source.Push(&node);
+  return m_fun->code.GetSize() - 1;
+}
+
+
+inline void cBytecodeCompileASTVisitor::patch(int instr, int target)
+{
+  sASInstruction& in = m_fun->code[instr];
+  if (in.op == OP(JUMP)) in.a = target;
+  else in.b = target;
+}
+
+
+int cBytecodeCompileASTVisitor::allocTemp(ASType_t type)
+{
+  return allocTemps(isString(type), 1);
+}
+
+
+int cBytecodeCompileASTVisitor::allocTemps(bool str, int count)
+{
+  int& top = str ? m_str_top : m_num_top;
+  int& regs = str ? m_fun->str_regs : m_fun->num_regs;
+
+  int reg = top;
+  top += count;
+  if (top > regs) regs = top;
+
+  return reg;
+}
+
+
+int cBytecodeCompileASTVisitor::popDest(ASType_t type)
+{
+  int dst = m_dst;
+  m_dst = -1;
+  if (dst >= 0 && isString(m_dst_type) == isString(type)) return dst;
+
+  return -1;
+}
+
+
+cBytecodeCompileASTVisitor::sOperand cBytecodeCompileASTVisitor::compile(cASTNode* node)
+{
+  m_dst = -1;
+  node->Accept(*this);
+
+  return m_result;
+}
+
+
+cBytecodeCompileASTVisitor::sOperand cBytecodeCompileASTVisitor::compileOperand(cASTNode* node, ASType_t type,
+                                                                                cASTNode* next)
+{
+  sOperand value = convert(compile(node), type, -1, *node);
+
+  // A variable register must be copied if the following operand may change the variable before it is read
+  if (m_supported && !value.temp && next && !isPure(next)) {
+    int reg = allocTemp(type);
+    emit(isString(type) ? OP(MOVE_STRING) : OP(MOVE), reg, value.reg, 0, *node);
+    value = sOperand(reg, type, true);
+  }
+
+  return value;
+}
+
+
+cBytecodeCompileASTVisitor::sOperand cBytecodeCompileASTVisitor::convert(const sOperand& op, ASType_t type, int dst,
+                                                                         const cASTNode& node)
+{
+  if (!m_supported || op.type == type) return op;
+
+  ASOpcode_t cast = OP(RETURN_VOID);
+  if (!castOp(op.type, type, cast)) {
+    unsupported();
+    return m_result;
+  }
+
+  int reg = dst;
+  if (reg < 0) reg = (op.temp && isString(op.type) == isString(type)) ? op.reg : allocTemp(type);
+  emit(cast, reg, op.reg, 0, node);
+
+  return sOperand(reg, type, dst < 0);
+}
+
+
+void cBytecodeCompileASTVisitor::compileInto(cASTNode* node, ASType_t type, int dst)
+{
+  m_dst = dst;
+  m_dst_type = type;
+  node->Accept(*this);
+  m_dst = -1;
+
+  sOperand value = convert(m_result, type, dst, *node);
+  if (m_supported && value.reg != dst) emit(isString(type) ? OP(MOVE_STRING) : OP(MOVE), dst, value.reg, 0, *node);
+}
+
+
+void cBytecodeCompileASTVisitor::compileArguments(const Apto::Array<ASType_t>& types, const Apto::Array<cASTNode*>& args,
+                                                  ASType_t rtype, int& num_window, int& str_window)
+{
+  // Arguments are evaluated into consecutive registers of each bank, which also receive the return value
+  int num_args = 0;
+  int str_args = 0;
+  for (int i = 0; i < types.GetSize(); i++) {
+    if (isString(types[i])) str_args++;
+    else num_args++;
+  }
+  if (rtype != TYPE(VOID)) {
+    if (isString(rtype)) { if (str_args == 0) str_args = 1; }
+    else if (num_args == 0) num_args = 1;
+  }
+
+  num_window = allocTemps(false, num_args);
+  str_window = allocTemps(true, str_args);
+
+  int num_idx = num_window;
+  int str_idx = str_window;
+  for (int i = 0; m_supported && i < types.GetSize(); i++) {
+    if (!args[i]) {
+      unsupported();
+      return;
+    }
+    compileInto(args[i], types[i], isString(types[i]) ? str_idx++ : num_idx++);
+  }
+}
+
+
+#undef TOKEN
+#undef TYPE
+#undef OP
@@ -0,0 +1,152 @@
+/*
+ *  cBytecodeCompileASTVisitor.h
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cBytecodeCompileASTVisitor_h
+#define cBytecodeCompileASTVisitor_h
+
+#include "cASBytecode.h"
+#include "cASTVisitor.h"
+
+class cSymbolTable;
+
+
+// Lowers a semantically checked AST to register bytecode.  Only scripts made up of scalar values (bool, char, int,
+// float and string), script and library function calls, and range foreach loops are compiled; Compile returns NULL for
+// anything else (arrays, dicts, matrices, objects, var typed values) and the script should be run by
+// cDirectInterpretASTVisitor instead.
+
+class cBytecodeCompileASTVisitor : public cASTVisitor
+{
+private:
+  // --------  Internal Type Declarations  --------
+  struct sOperand
+  {
+    int reg;
+    ASType_t type;
+    bool temp;
+
+    sOperand() : reg(-1), type(AS_TYPE_INVALID), temp(false) { ; }
+    sOperand(int in_reg, ASType_t in_type, bool in_temp) : reg(in_reg), type(in_type), temp(in_temp) { ; }
+  };
+
+  struct sPendingFunction
+  {
+    cSymbolTable* symtbl;
+    cASTNode* code;
+    int fun_idx;
+  };
+
+
+  // --------  Internal Variables  --------
+  cSymbolTable* m_global_symtbl;
+  cASBytecodeProgram* m_program;
+  bool m_supported;
+
+  Apto::Array<cSymbolTable*> m_fun_symtbls;   // symbol table of each compiled function, by function index
+  Apto::Array<sPendingFunction> m_pending;
+  Apto::Array<int> m_global_slots;
+
+  cASBytecodeFunction* m_fun;
+  cSymbolTable* m_cur_symtbl;
+  Apto::Array<int> m_slots;
+  int m_num_top;
+  int m_str_top;
+
+  sOperand m_result;
+  int m_dst;                                  // preferred register for the result of the next expression, or -1
+  ASType_t m_dst_type;
+
+
+  // --------  Private Constructors  --------
+  cBytecodeCompileASTVisitor(const cBytecodeCompileASTVisitor&); // @not_implemented
+  cBytecodeCompileASTVisitor& operator=(const cBytecodeCompileASTVisitor&); // @not_implemented
+
+
+public:
+  cBytecodeCompileASTVisitor(cSymbolTable* global_symtbl);
+  ~cBytecodeCompileASTVisitor();
+
+  // Returns a new program owned by the caller, or NULL if the script uses constructs the bytecode does not support
+  cASBytecodeProgram* Compile(cASTNode* node);
+
+  void VisitAssignment(cASTAssignment&);
+  void VisitObjectAssignment(cASTObjectAssignment&);
+  void VisitArgumentList(cASTArgumentList&);
+
+  void VisitReturnStatement(cASTReturnStatement&);
+  void VisitStatementList(cASTStatementList&);
+
+  void VisitForeachBlock(cASTForeachBlock&);
+  void VisitIfBlock(cASTIfBlock&);
+  void VisitWhileBlock(cASTWhileBlock&);
+
+  void VisitFunctionDefinition(cASTFunctionDefinition&);
+  void VisitVariableDefinition(cASTVariableDefinition&);
+  void VisitVariableDefinitionList(cASTVariableDefinitionList&);
+
+  void VisitExpressionBinary(cASTExpressionBinary&);
+  void VisitExpressionUnary(cASTExpressionUnary&);
+
+  void VisitBuiltInCall(cASTBuiltInCall&);
+  void VisitFunctionCall(cASTFunctionCall&);
+  void VisitLiteral(cASTLiteral&);
+  void VisitLiteralArray(cASTLiteralArray&);
+  void VisitLiteralDict(cASTLiteralDict&);
+  void VisitObjectCall(cASTObjectCall&);
+  void VisitObjectReference(cASTObjectReference&);
+  void VisitVariableReference(cASTVariableReference&);
+  void VisitUnpackTarget(cASTUnpackTarget&);
+
+
+private:
+  // --------  Internal Utility Methods  --------
+  static inline bool isScalar(ASType_t type)
+  {
+    return (type == AS_TYPE_BOOL || type == AS_TYPE_CHAR || type == AS_TYPE_INT || type == AS_TYPE_FLOAT ||
+            type == AS_TYPE_STRING);
+  }
+  static inline bool isString(ASType_t type) { return (type == AS_TYPE_STRING); }
+  static bool isPure(cASTNode* node);
+  static bool castOp(ASType_t from, ASType_t to, ASOpcode_t& op);
+
+  int getFunction(cSymbolTable* src_symtbl, int fun_id, cASTNode& node);
+  void compileFunction(const sPendingFunction& pending);
+  bool assignSlots(cSymbolTable* symtbl, Apto::Array<int>& slots, int& num_count, int& str_count);
+
+  inline int emit(ASOpcode_t op, int a, int b, int c, const cASTNode& node);
+  inline int label() const { return m_fun->code.GetSize(); }
+  inline void patch(int instr, int target);
+
+  int allocTemp(ASType_t type);
+  int allocTemps(bool str, int count);
+  int popDest(ASType_t type);
+  inline int destReg(int dst, ASType_t type) { return (dst >= 0) ? dst : allocTemp(type); }
+
+  sOperand compile(cASTNode* node);
+  sOperand compileOperand(cASTNode* node, ASType_t type, cASTNode* next);
+  sOperand convert(const sOperand& op, ASType_t type, int dst, const cASTNode& node);
+  void compileInto(cASTNode* node, ASType_t type, int dst);
+  void compileArguments(const Apto::Array<ASType_t>& types, const Apto::Array<cASTNode*>& args, ASType_t rtype,
+                        int& num_window, int& str_window);
+
+  inline void unsupported() { m_supported = false; m_result = sOperand(); }
+};
+
+#endif
@@ -26,7 +26,9 @@
 #include "ASAvidaLib.h"
 #include "ASAnalyzeLib.h"
 
+#include "cASBytecodeVM.h"
 #include "cASLibrary.h"
+#include "cBytecodeCompileASTVisitor.h"
 #include "cDirectInterpretASTVisitor.h"
 #include "cDumpASTVisitor.h"
 #include "cFile.h"
@@ -34,6 +36,7 @@
 #include "cSemanticASTVisitor.h"
 #include "cSymbolTable.h"
 
+#include <cstring>
 #include <iostream>
 
 
@@ -43,6 +46,17 @@ int main (int argc, char * const argv[])
 
   Avida::PrintVersionBanner();
 
+  // Scripts that only use scalar values run as bytecode unless -interpret forces the tree walking interpreter
+  bool use_bytecode = true;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "-interpret") == 0) {
+      use_bytecode = false;
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [-interpret]" << std::endl;
+      exit(AS_EXIT_UNKNOWN);
+    }
+  }
+
   cASLibrary* lib = new cASLibrary;  
   RegisterASCoreLib(lib);
   RegisterASAvidaLib(lib);
@@ -69,6 +83,19 @@ int main (int argc, char * const argv[])
         exit(AS_EXIT_FAIL_SEMANTIC);
       }
       
+      // Anything the bytecode compiler does not handle falls back to the tree walking interpreter
+      cASBytecodeProgram* program = NULL;
+      if (use_bytecode) {
+        cBytecodeCompileASTVisitor compiler(&global_symtbl);
+        program = compiler.Compile(tree);
+      }
+      if (program) {
+        cASBytecodeVM vm(program);
+        int exit_code = vm.Execute();
+        delete program;
+        exit(exit_code);
+      }
+      
       cDirectInterpretASTVisitor interpeter(&global_symtbl);
       int exit_code = interpeter.Interpret(tree);
       
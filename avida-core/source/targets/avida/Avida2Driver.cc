@@ -108,11 +108,15 @@ void Avida2Driver::Run()
     const int UD_size = m_world->CalculateUpdateSize();
     const double step_size = 1.0 / (double) UD_size;
     
-    for (int i = 0; i < UD_size; i++) {
-      if(population.GetNumOrganisms() == 0) {
-        break;
+    if (population.UsesDemeExecutor()) {
+      population.ProcessUpdateByDeme(ctx, UD_size, step_size);
+    } else {
+      for (int i = 0; i < UD_size; i++) {
+        if(population.GetNumOrganisms() == 0) {
+          break;
+        }
+        (population.*ActiveProcessStep)(ctx, step_size, population.ScheduleOrganism());
       }
-      (population.*ActiveProcessStep)(ctx, step_size, population.ScheduleOrganism());
     }
     
     // end of update stats...
@@ -144,14 +148,7 @@ void Avida2Driver::Run()
     
     
     // Do Point Mutations
-    if (point_mut_prob > 0 ) {
-      for (int i = 0; i < population.GetSize(); i++) {
-        if (population.GetCell(i).IsOccupied()) {
-          int num_mut = population.GetCell(i).GetOrganism()->GetHardware().PointMutate(ctx);
-          population.GetCell(i).GetOrganism()->IncPointMutations(num_mut);
-        }
-      }
-    }
+    if (point_mut_prob > 0 ) population.PointMutateOrganisms(ctx);
     
     m_new_world->PerformUpdate(new_ctx, stats.GetUpdate());
     
@@ -312,6 +312,206 @@ protected:
 };
 
 
+#include "cPhiloxRandom.h"
+class cPhiloxRandomTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cPhiloxRandom"; }
+protected:
+  void RunTests()
+  {
+    // Philox4x32-10 known answer vectors, from the Random123 distribution (kat_vectors)
+    static const unsigned int counters[3][4] = {
+      { 0x00000000, 0x00000000, 0x00000000, 0x00000000 },
+      { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff },
+      { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }
+    };
+    static const unsigned int keys[3][2] = {
+      { 0x00000000, 0x00000000 },
+      { 0xffffffff, 0xffffffff },
+      { 0xa4093822, 0x299f31d0 }
+    };
+    static const unsigned int expected[3][4] = {
+      { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 },
+      { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd },
+      { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }
+    };
+    static const char* names[3] = {
+      "Bijection - zero counter and key",
+      "Bijection - all ones counter and key",
+      "Bijection - pi digits counter and key"
+    };
+    
+    for (int v = 0; v < 3; v++) {
+      unsigned int out[4];
+      cPhiloxRandom::Bijection(counters[v], keys[v], out);
+      bool result = true;
+      for (int i = 0; i < 4; i++) if (out[i] != expected[v][i]) result = false;
+      ReportTestResult(names[v], result);
+    }
+    
+    
+    // A stream's words are the bijection of (block, object id, stream type) under the seed
+    cPhiloxRandom rng(12345, RANDOM_STREAM_DEME, 7);
+    unsigned int counter[4] = { 1, 0, 7, RANDOM_STREAM_DEME };
+    unsigned int key[2] = { 12345, 0 };
+    unsigned int block[4];
+    cPhiloxRandom::Bijection(counter, key, block);
+    
+    double draws[8];
+    for (int i = 0; i < 8; i++) draws[i] = rng.GetDouble();
+    bool result = true;
+    for (int i = 0; i < 4; i++) if (draws[4 + i] != block[i] / 4294967296.0) result = false;
+    ReportTestResult("Stream Words", result);
+    
+    rng.SetCounter(1);
+    result = true;
+    for (int i = 0; i < 4; i++) if (rng.GetDouble() != draws[4 + i]) result = false;
+    ReportTestResult("SetCounter Replay", result);
+    
+    cPhiloxRandom other(12345, RANDOM_STREAM_DEME, 8);
+    ReportTestResult("Independent Streams", (other.GetDouble() != draws[0]));
+  }
+};
+
+
+
+#include "cGridDump.h"
+#include <sstream>
+class cGridDumpTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cGridDump"; }
+protected:
+  bool roundTrip(const Apto::Array<int>& data, int x, int y, int z, bool compress)
+  {
+    std::stringstream ss;
+    cGridDump::WriteFrame(ss, 42, x, y, z, data, compress);
+    cGridDump::cFrame frame;
+    if (!cGridDump::ReadFrame(ss, frame, x, y)) return false;
+    if (frame.update != 42 || frame.x_size != x || frame.y_size != y || frame.z_size != z) return false;
+    if (frame.type != cGridDump::TYPE_INT32 || frame.int_data.GetSize() != data.GetSize()) return false;
+    for (int i = 0; i < data.GetSize(); i++) if (frame.int_data[i] != data[i]) return false;
+    return !cGridDump::ReadFrame(ss, frame);
+  }
+  
+  bool roundTrip(const Apto::Array<double>& data, int x, int y, int z, bool compress)
+  {
+    std::stringstream ss;
+    cGridDump::WriteFrame(ss, 7, x, y, z, data, compress);
+    cGridDump::cFrame frame;
+    if (!cGridDump::ReadFrame(ss, frame, x, y)) return false;
+    if (frame.update != 7 || frame.x_size != x || frame.y_size != y || frame.z_size != z) return false;
+    if (frame.type != cGridDump::TYPE_FLOAT64 || frame.double_data.GetSize() != data.GetSize()) return false;
+    for (int i = 0; i < data.GetSize(); i++) if (frame.double_data[i] != data[i]) return false;
+    return !cGridDump::ReadFrame(ss, frame);
+  }
+  
+  void RunTests()
+  {
+    Apto::Array<int> ints(60 * 60);
+    for (int i = 0; i < ints.GetSize(); i++) ints[i] = (i % 7 == 0) ? -1 : i / 13;
+    ReportTestResult("Round Trip - int32", roundTrip(ints, 60, 60, 1, false));
+    ReportTestResult("Round Trip - int32 LZ", roundTrip(ints, 60, 60, 1, true));
+    
+    Apto::Array<double> doubles(20 * 15 * 8);
+    for (int i = 0; i < doubles.GetSize(); i++) doubles[i] = (i % 5) ? i * 0.25 : -1.0;
+    ReportTestResult("Round Trip - float64 layers", roundTrip(doubles, 20, 15, 8, false));
+    ReportTestResult("Round Trip - float64 layers LZ", roundTrip(doubles, 20, 15, 8, true));
+    
+    // Larger than one block, so the frame is split
+    Apto::Array<int> big(cGridDump::BLOCK_SIZE / 4 + 1000);
+    for (int i = 0; i < big.GetSize(); i++) big[i] = i % 1000;
+    ReportTestResult("Round Trip - multiple blocks", roundTrip(big, big.GetSize(), 1, 1, false));
+    ReportTestResult("Round Trip - multiple blocks LZ", roundTrip(big, big.GetSize(), 1, 1, true));
+    
+    std::stringstream empty;
+    cGridDump::cFrame frame;
+    ReportTestResult("Read - empty stream", !cGridDump::ReadFrame(empty, frame));
+    
+    std::stringstream mismatched;
+    cGridDump::WriteFrame(mismatched, 0, 60, 60, 1, ints, false);
+    ReportTestResult("Read - world size mismatch", !cGridDump::ReadFrame(mismatched, frame, 50, 60));
+    
+    std::stringstream full;
+    cGridDump::WriteFrame(full, 0, 60, 60, 1, ints, false);
+    std::stringstream truncated(full.str().substr(0, full.str().size() - 100));
+    ReportTestResult("Read - truncated frame", !cGridDump::ReadFrame(truncated, frame));
+    
+    // Claim a grid far larger than the file that carries it
+    std::string header = full.str().substr(0, cGridDump::HEADER_SIZE);
+    header[12] = header[13] = header[14] = 0;
+    header[15] = 0x10;
+    std::stringstream oversized(header + full.str().substr(cGridDump::HEADER_SIZE));
+    ReportTestResult("Read - oversized header", !cGridDump::ReadFrame(oversized, frame));
+  }
+};
+
+
+
+#include "cMutationRates.h"
+#include <cmath>
+class cMutationRatesTests : public cUnitTest
+{
+public:
+  const char* GetUnitName() { return "cMutationRates"; }
+protected:
+  int countCopyMuts(cAvidaContext& ctx, const cMutationRates& rates, int num_copies)
+  {
+    int count = 0;
+    for (int i = 0; i < num_copies; i++) if (rates.TestCopyMut(ctx)) count++;
+    return count;
+  }
+  
+  // Binomial count within five standard deviations of its mean
+  bool binomialCount(int count, int trials, double prob)
+  {
+    const double mean = trials * prob;
+    return fabs(count - mean) < 5.0 * sqrt(mean * (1.0 - prob));
+  }
+  
+  void RunTests()
+  {
+    const double prob = 0.0075;
+    cPhiloxRandom rng(101);
+    cAvidaContext ctx(NULL, rng);
+    
+    cMutationRates rates;
+    rates.SetCopyMutProb(prob);
+    rates.SetSkipSampling(true);
+    ReportTestResult("Skip Sampling - copy mutation rate", binomialCount(countCopyMuts(ctx, rates, 1000000), 1000000, prob));
+    
+    rates.SetCopyMutProb(0.5);
+    ReportTestResult("Skip Sampling - rate change", binomialCount(countCopyMuts(ctx, rates, 10000), 10000, 0.5));
+    
+    rates.SetCopyMutProb(prob);
+    rates.SetSkipSampling(false);
+    ReportTestResult("Per Site - copy mutation rate", binomialCount(countCopyMuts(ctx, rates, 1000000), 1000000, prob));
+    
+    // Without skip sampling each copy is a single P() draw, as it always was
+    cPhiloxRandom base_rng(202);
+    cPhiloxRandom test_rng(202);
+    cAvidaContext test_ctx(NULL, test_rng);
+    bool result = true;
+    for (int i = 0; i < 100000; i++) if (rates.TestCopyMut(test_ctx) != base_rng.P(prob)) result = false;
+    ReportTestResult("Per Site - unchanged draws", result);
+    
+    // Gaps are geometric, with mean (1 - p) / p and no gap at all with probability p
+    const int num_skips = 100000;
+    double total = 0.0;
+    int zeros = 0;
+    for (int i = 0; i < num_skips; i++) {
+      const int skip = cMutationRates::DrawSkip(ctx, prob);
+      total += skip;
+      if (skip == 0) zeros++;
+    }
+    const double std_err = sqrt(1.0 - prob) / prob / sqrt((double)num_skips);
+    ReportTestResult("DrawSkip - mean gap", fabs(total / num_skips - (1.0 - prob) / prob) < 5.0 * std_err);
+    ReportTestResult("DrawSkip - zero gaps", binomialCount(zeros, num_skips, prob));
+    ReportTestResult("DrawSkip - certain mutation", cMutationRates::DrawSkip(ctx, 1.0) == 0);
+  }
+};
+
 
 
 #define TEST(CLASS) \
@@ -333,6 +533,9 @@ int main(int argc, const char* argv[])
   
   TEST(cRawBitArray);
   TEST(cBitArray);
+  TEST(cPhiloxRandom);
+  TEST(cGridDump);
+  TEST(cMutationRates);
   
   if (failed == 0)
     cout << "All unit tests passed." << endl;
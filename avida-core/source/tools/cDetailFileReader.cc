@@ -0,0 +1,540 @@
+/*
+ *  cDetailFileReader.cc
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cDetailFileReader.h"
+
+#include "apto/core/FileSystem.h"
+#include "apto/core/Thread.h"
+#include "apto/platform.h"
+
+#include "cInitFile.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if !APTO_PLATFORM(WINDOWS)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#ifdef AVD_HAVE_ZLIB
+# include <zlib.h>
+#endif
+
+
+// Files smaller than this are indexed by a single thread
+static const size_t MIN_CHUNK_SIZE = 4 * 1024 * 1024;
+
+static const char* const s_empty_data = "";
+
+
+enum eDirective { DIRECTIVE_NONE, DIRECTIVE_COMMENT, DIRECTIVE_FILETYPE, DIRECTIVE_FORMAT, DIRECTIVE_UNSUPPORTED };
+
+static inline const char* lineEnd(const char* pos, const char* end)
+{
+  const char* eol = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+  return (eol) ? eol : end;
+}
+
+static inline bool isFieldSpace(char c) { return (c == ' ' || c == '\t' || c == '\r' || c == '\n'); }
+
+// Lines beginning with '#' are directives, as in cInitFile; unrecognized directives are comments
+static eDirective classifyLine(const char* line, const char* eol)
+{
+  if (line == eol || *line != '#') return DIRECTIVE_NONE;
+
+  const char* word_end = line;
+  while (word_end < eol && !isFieldSpace(*word_end)) word_end++;
+  const size_t len = word_end - line;
+
+  if (len == 9 && std::strncmp(line, "#filetype", 9) == 0) return DIRECTIVE_FILETYPE;
+  if (len == 7 && std::strncmp(line, "#format", 7) == 0) return DIRECTIVE_FORMAT;
+  if ((len == 8 && std::strncmp(line, "#include", 8) == 0) || (len == 7 && std::strncmp(line, "#import", 7) == 0) ||
+      (len == 7 && std::strncmp(line, "#define", 7) == 0)) {
+    return DIRECTIVE_UNSUPPORTED;
+  }
+  return DIRECTIVE_COMMENT;
+}
+
+// Bounds of the line content once comments and surrounding whitespace are removed
+static inline void lineContent(const char* line, const char* eol, const char*& begin, const char*& end)
+{
+  const char* comment = static_cast<const char*>(std::memchr(line, '#', eol - line));
+  end = (comment) ? comment : eol;
+  begin = line;
+  while (begin < end && isFieldSpace(*begin)) begin++;
+  while (end > begin && isFieldSpace(end[-1])) end--;
+}
+
+// Returns the start of the first line at or after pos that cannot be part of a continued line, so that chunks split
+// there index independently.  Safe split points follow a non-empty data line that does not end in a continuation.
+static const char* recordBoundary(const char* pos, const char* end)
+{
+  pos = lineEnd(pos, end);
+  if (pos < end) pos++;
+
+  while (pos < end) {
+    const char* eol = lineEnd(pos, end);
+    const char* next = (eol < end) ? eol + 1 : end;
+    if (classifyLine(pos, eol) == DIRECTIVE_NONE) {
+      const char* cbegin;
+      const char* cend;
+      lineContent(pos, eol, cbegin, cend);
+      if (cbegin != cend && cend[-1] != '\\') return next;
+    }
+    pos = next;
+  }
+  return end;
+}
+
+
+// Indexes the records of one chunk of the file
+class cDetailFileIndexer : public Apto::Thread
+{
+public:
+  struct sRecord
+  {
+    const char* begin;
+    int size;
+  };
+
+  const char* m_begin;
+  const char* m_end;
+  Apto::Array<sRecord> m_records;
+  Apto::Array<cString> m_spliced;
+  Apto::Array<int> m_spliced_at;
+  bool m_use_init_file;
+
+  cDetailFileIndexer(const char* begin, const char* end) : m_begin(begin), m_end(end), m_use_init_file(false) { ; }
+
+  void Index();
+
+protected:
+  void Run() { Index(); }
+
+private:
+  inline void pushRecord(const char* begin, int size)
+  {
+    sRecord rec = { begin, size };
+    m_records.Push(rec);
+  }
+
+  inline void pushSpliced(const cString& record)
+  {
+    m_spliced_at.Push(m_records.GetSize());
+    m_spliced.Push(record);
+    pushRecord(NULL, record.GetSize());
+  }
+};
+
+
+void cDetailFileIndexer::Index()
+{
+  cString record;
+  bool continued = false;
+
+  const char* pos = m_begin;
+  while (pos < m_end) {
+    const char* eol = lineEnd(pos, m_end);
+    const char* next = (eol < m_end) ? eol + 1 : m_end;
+
+    const eDirective directive = classifyLine(pos, eol);
+    if (directive != DIRECTIVE_NONE) {
+      // Directives past the header change how the rest of the file is read, leave those to cInitFile
+      if (directive != DIRECTIVE_COMMENT) {
+        m_use_init_file = true;
+        return;
+      }
+      pos = next;
+      continue;
+    }
+
+    const char* cbegin;
+    const char* cend;
+    lineContent(pos, eol, cbegin, cend);
+
+    if (!continued) {
+      if (cbegin != cend) {
+        if (cend[-1] != '\\') {
+          pushRecord(cbegin, static_cast<int>(cend - cbegin));
+        } else {
+          record = cString(cbegin, static_cast<int>(cend - cbegin) - 1);
+          continued = true;
+        }
+      }
+    } else {
+      // Continuations are joined as cInitFile does, with the continuation mark removed
+      record += cString(cbegin, static_cast<int>(cend - cbegin));
+      if (record.GetSize() && record[record.GetSize() - 1] == '\\') {
+        record.ClipEnd(1);
+      } else {
+        continued = false;
+        if (record.GetSize()) pushSpliced(record);
+      }
+    }
+
+    pos = next;
+  }
+
+  if (continued && record.GetSize()) pushSpliced(record);
+}
+
+
+
+cDetailFileReader::cDetailFileReader(const cString& filename, const cString& working_dir, Avida::Feedback& feedback,
+                                     int max_threads)
+  : m_filename(filename), m_opened(false), m_ftype("unknown"), m_data(s_empty_data), m_data_size(0), m_map_base(NULL)
+  , m_map_size(0), m_buffer(NULL)
+{
+  cString path = cString(Apto::FileSystem::GetAbsolutePath(Apto::String(filename), Apto::String(working_dir)));
+
+  std::FILE* fp = std::fopen(path, "rb");
+  if (!fp) {
+    feedback.Error("unable to open file '%s'.", (const char*)filename);
+    return;
+  }
+  unsigned char magic[2];
+  const bool compressed = (std::fread(magic, 1, 2, fp) == 2 && magic[0] == 0x1f && magic[1] == 0x8b);
+  std::fclose(fp);
+
+  if (compressed) {
+    if (!inflateFile(path, feedback)) return;
+  } else {
+    if (!mapFile(path, feedback)) return;
+  }
+
+  const char* pos = m_data;
+  bool use_init_file = false;
+  if (!processHeader(pos, feedback, use_init_file)) return;
+  if (!use_init_file) use_init_file = !indexLines(pos, max_threads);
+
+  if (use_init_file) {
+    if (compressed) {
+      feedback.Error("%s: #include, #import, and #define directives are not supported in compressed files",
+                     (const char*)filename);
+      return;
+    }
+    release();
+    m_ftype = "unknown";
+    m_format = cStringList();
+    m_opened = loadWithInitFile(filename, working_dir, feedback);
+    return;
+  }
+
+  m_opened = true;
+}
+
+
+cDetailFileReader::~cDetailFileReader()
+{
+  release();
+}
+
+
+Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> > cDetailFileReader::GetLineAsDict(int line_id) const
+{
+  Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> > dict(new Apto::Map<Apto::String, Apto::String>);
+
+  cStringList fmt = m_format;
+  cLineTokenizer fields(*this, line_id);
+  while (fmt.GetSize() && fields.Next()) dict->Set((const char*)fmt.Pop(), (const char*)fields.Field());
+
+  return dict;
+}
+
+
+bool cDetailFileReader::mapFile(const cString& path, Avida::Feedback& feedback)
+{
+#if !APTO_PLATFORM(WINDOWS)
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    feedback.Error("unable to open file '%s'.", (const char*)m_filename);
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == 0) {
+    if (st.st_size == 0) {
+      close(fd);
+      return true;
+    }
+
+    void* base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base != MAP_FAILED) {
+      madvise(base, st.st_size, MADV_SEQUENTIAL);
+      close(fd);
+      m_map_base = base;
+      m_map_size = st.st_size;
+      m_data = static_cast<const char*>(base);
+      m_data_size = st.st_size;
+      return true;
+    }
+  }
+  close(fd);
+#endif
+
+  // Mapping is unavailable, read the whole file instead
+  std::FILE* fp = std::fopen(path, "rb");
+  if (!fp) {
+    feedback.Error("unable to open file '%s'.", (const char*)m_filename);
+    return false;
+  }
+
+  size_t capacity = 1 << 20;
+  size_t size = 0;
+  char* buffer = static_cast<char*>(std::malloc(capacity));
+  while (buffer) {
+    size += std::fread(buffer + size, 1, capacity - size, fp);
+    if (size < capacity) break;
+    capacity *= 2;
+    char* grown = static_cast<char*>(std::realloc(buffer, capacity));
+    if (!grown) std::free(buffer);
+    buffer = grown;
+  }
+  const bool failed = (!buffer || std::ferror(fp));
+  std::fclose(fp);
+
+  if (failed) {
+    std::free(buffer);
+    feedback.Error("unable to read file '%s'.", (const char*)m_filename);
+    return false;
+  }
+
+  m_buffer = buffer;
+  m_data = buffer;
+  m_data_size = size;
+  return true;
+}
+
+
+bool cDetailFileReader::inflateFile(const cString& path, Avida::Feedback& feedback)
+{
+#ifdef AVD_HAVE_ZLIB
+  gzFile gz = gzopen(path, "rb");
+  if (!gz) {
+    feedback.Error("unable to open file '%s'.", (const char*)m_filename);
+    return false;
+  }
+  gzbuffer(gz, 1 << 18);
+
+  const unsigned int READ_SIZE = 1 << 24;
+  size_t capacity = READ_SIZE;
+  size_t size = 0;
+  char* buffer = static_cast<char*>(std::malloc(capacity));
+  bool failed = (buffer == NULL);
+  while (!failed) {
+    if (capacity - size < READ_SIZE) {
+      char* grown = static_cast<char*>(std::realloc(buffer, capacity * 2));
+      if (!grown) {
+        failed = true;
+        break;
+      }
+      buffer = grown;
+      capacity *= 2;
+    }
+
+    int read = gzread(gz, buffer + size, READ_SIZE);
+    if (read < 0) failed = true;
+    if (read <= 0) break;
+    size += read;
+  }
+  gzclose(gz);
+
+  if (failed) {
+    std::free(buffer);
+    feedback.Error("unable to decompress file '%s'.", (const char*)m_filename);
+    return false;
+  }
+
+  m_buffer = buffer;
+  m_data = buffer;
+  m_data_size = size;
+  return true;
+#else
+  feedback.Error("'%s' is compressed, but this build of Avida does not include zlib support.", (const char*)m_filename);
+  return false;
+#endif
+}
+
+
+void cDetailFileReader::release()
+{
+#if !APTO_PLATFORM(WINDOWS)
+  if (m_map_base) munmap(m_map_base, m_map_size);
+#endif
+  std::free(m_buffer);
+
+  m_map_base = NULL;
+  m_map_size = 0;
+  m_buffer = NULL;
+  m_data = s_empty_data;
+  m_data_size = 0;
+
+  m_lines.Resize(0);
+  m_spliced.Resize(0);
+}
+
+
+bool cDetailFileReader::processHeader(const char*& pos, Avida::Feedback& feedback, bool& use_init_file)
+{
+  const char* end = m_data + m_data_size;
+  int linenum = 0;
+
+  while (pos < end) {
+    const char* eol = lineEnd(pos, end);
+    const char* next = (eol < end) ? eol + 1 : end;
+    linenum++;
+
+    const eDirective directive = classifyLine(pos, eol);
+    if (directive == DIRECTIVE_NONE) {
+      // The header ends at the first line with content
+      const char* cbegin;
+      const char* cend;
+      lineContent(pos, eol, cbegin, cend);
+      if (cbegin != cend) return true;
+    } else if (directive == DIRECTIVE_FILETYPE || directive == DIRECTIVE_FORMAT) {
+      cString cmdstr(pos, static_cast<int>(eol - pos));
+      cmdstr.PopWord();
+
+      if (directive == DIRECTIVE_FILETYPE) {
+        cString ft = cmdstr.PopWord();
+        if (m_ftype != "unknown" && m_ftype != ft) {
+          feedback.Error("%s:%d: duplicate filetype directive", (const char*)m_filename, linenum);
+          return false;
+        }
+        m_ftype = ft;
+      } else {
+        if (m_format.GetSize() != 0) {
+          feedback.Error("%s:%d: duplicate format directive", (const char*)m_filename, linenum);
+          return false;
+        }
+        m_format.Load(cmdstr);
+      }
+    } else if (directive == DIRECTIVE_UNSUPPORTED) {
+      use_init_file = true;
+      return true;
+    }
+
+    pos = next;
+  }
+
+  return true;
+}
+
+
+bool cDetailFileReader::indexLines(const char* begin, int max_threads)
+{
+  const char* end = m_data + m_data_size;
+
+  int num_chunks = Apto::Platform::AvailableCPUs();
+  if (max_threads > 0 && max_threads < num_chunks) num_chunks = max_threads;
+  const size_t size = end - begin;
+  if (size / MIN_CHUNK_SIZE < static_cast<size_t>(num_chunks)) num_chunks = static_cast<int>(size / MIN_CHUNK_SIZE);
+  if (num_chunks < 1) num_chunks = 1;
+
+  Apto::Array<cDetailFileIndexer*> chunks(num_chunks);
+  const char* chunk_begin = begin;
+  for (int i = 0; i < num_chunks; i++) {
+    const char* chunk_end = end;
+    if (i < num_chunks - 1) {
+      chunk_end = recordBoundary(begin + (size / num_chunks) * (i + 1), end);
+      if (chunk_end < chunk_begin) chunk_end = chunk_begin;
+    }
+    chunks[i] = new cDetailFileIndexer(chunk_begin, chunk_end);
+    chunk_begin = chunk_end;
+  }
+
+  // The calling thread indexes the first chunk
+  for (int i = 1; i < num_chunks; i++) chunks[i]->Start();
+  chunks[0]->Index();
+  for (int i = 1; i < num_chunks; i++) chunks[i]->Join();
+
+  bool use_init_file = false;
+  int num_lines = 0;
+  int num_spliced = 0;
+  for (int i = 0; i < num_chunks; i++) {
+    use_init_file = use_init_file || chunks[i]->m_use_init_file;
+    num_lines += chunks[i]->m_records.GetSize();
+    num_spliced += chunks[i]->m_spliced.GetSize();
+  }
+
+  if (!use_init_file) {
+    m_lines.Resize(num_lines);
+    m_spliced.Resize(num_spliced);
+
+    int line_offset = 0;
+    int spliced_offset = 0;
+    for (int i = 0; i < num_chunks; i++) {
+      const cDetailFileIndexer& chunk = *chunks[i];
+      for (int j = 0; j < chunk.m_records.GetSize(); j++) {
+        m_lines[line_offset + j].begin = chunk.m_records[j].begin;
+        m_lines[line_offset + j].size = chunk.m_records[j].size;
+      }
+      for (int j = 0; j < chunk.m_spliced.GetSize(); j++) {
+        m_spliced[spliced_offset + j] = chunk.m_spliced[j];
+        m_lines[line_offset + chunk.m_spliced_at[j]].begin = m_spliced[spliced_offset + j];
+      }
+      line_offset += chunk.m_records.GetSize();
+      spliced_offset += chunk.m_spliced.GetSize();
+    }
+  }
+
+  for (int i = 0; i < num_chunks; i++) delete chunks[i];
+
+  return !use_init_file;
+}
+
+
+bool cDetailFileReader::loadWithInitFile(const cString& filename, const cString& working_dir, Avida::Feedback& feedback)
+{
+  cInitFile input_file(filename, working_dir, feedback);
+  if (!input_file.WasOpened()) return false;
+
+  m_ftype = input_file.GetFiletype();
+  m_format = input_file.GetFormat();
+
+  // Collect the processed lines into a single owned buffer, so that they can be indexed the same way
+  size_t total = 0;
+  for (int i = 0; i < input_file.GetNumLines(); i++) total += input_file.GetLine(i).GetSize() + 1;
+
+  m_buffer = static_cast<char*>(std::malloc(total + 1));
+  if (!m_buffer) {
+    feedback.Error("unable to allocate memory for '%s'.", (const char*)filename);
+    return false;
+  }
+  m_data = m_buffer;
+  m_data_size = total;
+
+  m_lines.Resize(input_file.GetNumLines());
+  char* pos = m_buffer;
+  for (int i = 0; i < input_file.GetNumLines(); i++) {
+    cString line = input_file.GetLine(i);
+    std::memcpy(pos, (const char*)line, line.GetSize());
+    m_lines[i].begin = pos;
+    m_lines[i].size = line.GetSize();
+    pos += line.GetSize();
+    *pos++ = '\n';
+  }
+
+  return true;
+}
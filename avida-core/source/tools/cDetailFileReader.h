@@ -0,0 +1,129 @@
+/*
+ *  cDetailFileReader.h
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cDetailFileReader_h
+#define cDetailFileReader_h
+
+#include "apto/core.h"
+#include "avida/core/Feedback.h"
+
+#include "cString.h"
+#include "cStringList.h"
+
+
+// cDetailFileReader - read-only, in place access to large column files (genotype details, saved populations)
+//
+// The file is memory mapped (gzip compressed files are inflated into memory when zlib support is available) and
+// indexed by line, splitting the input into chunks that are indexed in parallel.  Lines and fields are then read
+// directly from the mapped data; unlike cInitFile, no per-line strings are created.  Lines follow the cInitFile rules:
+// everything after a '#' is a comment, whitespace separates fields, and a trailing '\' continues a line.  The only
+// directives understood in place are #filetype and #format; a file using #include, #import, or #define is handed to
+// cInitFile instead.
+
+class cDetailFileReader
+{
+public:
+  class cLineTokenizer;
+
+private:
+  struct sLine
+  {
+    const char* begin;
+    int size;
+  };
+
+  cString m_filename;
+  bool m_opened;
+  cString m_ftype;
+  cStringList m_format;
+
+  const char* m_data;
+  size_t m_data_size;
+  void* m_map_base;          // non-NULL when m_data is a file mapping
+  size_t m_map_size;
+  char* m_buffer;            // owned copy of the data (compressed input, or when mapping is unavailable)
+
+  Apto::Array<sLine> m_lines;
+  Apto::Array<cString> m_spliced;  // continued lines, joined; referenced by m_lines
+
+
+  cDetailFileReader(); // @not_implemented
+  cDetailFileReader(const cDetailFileReader&); // @not_implemented
+  cDetailFileReader& operator=(const cDetailFileReader&); // @not_implemented
+
+public:
+  // max_threads <= 0 allows one indexing thread per available CPU
+  cDetailFileReader(const cString& filename, const cString& working_dir, Avida::Feedback& feedback, int max_threads = -1);
+  ~cDetailFileReader();
+
+  bool WasOpened() const { return m_opened; }
+
+  const cString& GetFiletype() const { return m_ftype; }
+  const cStringList& GetFormat() const { return m_format; }
+
+  int GetNumLines() const { return m_lines.GetSize(); }
+  cString GetLine(int line_id) const { return cString(m_lines[line_id].begin, m_lines[line_id].size); }
+  Apto::SmartPtr<Apto::Map<Apto::String, Apto::String> > GetLineAsDict(int line_id) const;
+
+
+  // Walks the whitespace separated fields of a single line without copying them
+  class cLineTokenizer
+  {
+  private:
+    const char* m_pos;
+    const char* m_end;
+    const char* m_field;
+    int m_field_size;
+
+  public:
+    cLineTokenizer(const cDetailFileReader& reader, int line_id)
+      : m_pos(reader.m_lines[line_id].begin), m_end(m_pos + reader.m_lines[line_id].size), m_field(NULL)
+      , m_field_size(0) { ; }
+
+    // Advances to the next field, returning false once the line is exhausted
+    inline bool Next()
+    {
+      while (m_pos < m_end && isSpace(*m_pos)) m_pos++;
+      if (m_pos == m_end) return false;
+      m_field = m_pos;
+      while (m_pos < m_end && !isSpace(*m_pos)) m_pos++;
+      m_field_size = static_cast<int>(m_pos - m_field);
+      return true;
+    }
+
+    const char* FieldData() const { return m_field; }
+    int FieldSize() const { return m_field_size; }
+    cString Field() const { return cString(m_field, m_field_size); }
+  };
+
+
+private:
+  static inline bool isSpace(char c) { return (c == ' ' || c == '\t' || c == '\r' || c == '\n'); }
+
+  bool mapFile(const cString& path, Avida::Feedback& feedback);
+  bool inflateFile(const cString& path, Avida::Feedback& feedback);
+  void release();
+
+  bool processHeader(const char*& pos, Avida::Feedback& feedback, bool& use_init_file);
+  bool indexLines(const char* begin, int max_threads);
+  bool loadWithInitFile(const cString& filename, const cString& working_dir, Avida::Feedback& feedback);
+};
+
+#endif
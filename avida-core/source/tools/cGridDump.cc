@@ -0,0 +1,363 @@
+/*
+ *  cGridDump.cc
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGridDump.h"
+
+#include <climits>
+#include <cstring>
+
+
+static const unsigned char GRID_DUMP_MAGIC[4] = { 'A', 'V', 'G', 'D' };
+static const unsigned char GRID_DUMP_VERSION = 1;
+
+static const int LZ_MIN_MATCH = 4;
+static const int LZ_MAX_OFFSET = 65535;
+static const int LZ_HASH_BITS = 14;
+static const int LZ_MAX_EXPANSION = 255;  // upper bound on raw bytes produced per stored byte
+
+
+static inline void putU32(unsigned char* p, unsigned int v)
+{
+  p[0] = (unsigned char)(v);
+  p[1] = (unsigned char)(v >> 8);
+  p[2] = (unsigned char)(v >> 16);
+  p[3] = (unsigned char)(v >> 24);
+}
+
+static inline unsigned int getU32(const unsigned char* p)
+{
+  return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static inline unsigned int lzHash(const unsigned char* p)
+{
+  return (getU32(p) * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+
+bool cGridDump::ParseFormat(const char* name, eFormat& format)
+{
+  if (std::strcmp(name, "text") == 0) format = FORMAT_TEXT;
+  else if (std::strcmp(name, "binary") == 0) format = FORMAT_BINARY;
+  else if (std::strcmp(name, "binary-lz") == 0 || std::strcmp(name, "lz") == 0) format = FORMAT_BINARY_LZ;
+  else return false;
+  return true;
+}
+
+
+void cGridDump::WriteFrame(std::ostream& fp, int update, int x_size, int y_size, int z_size,
+                           const Apto::Array<int>& data, bool compress)
+{
+  const int num_elems = data.GetSize();
+  Apto::Array<unsigned char> bytes(num_elems * 4);
+  for (int i = 0; i < num_elems; i++) putU32(&bytes[i * 4], (unsigned int)data[i]);
+  writeFrame(fp, update, x_size, y_size, z_size, TYPE_INT32, (num_elems) ? &bytes[0] : NULL, 4, num_elems, compress);
+}
+
+void cGridDump::WriteFrame(std::ostream& fp, int update, int x_size, int y_size, int z_size,
+                           const Apto::Array<double>& data, bool compress)
+{
+  const int num_elems = data.GetSize();
+  Apto::Array<unsigned char> bytes(num_elems * 8);
+  for (int i = 0; i < num_elems; i++) {
+    unsigned int words[2];
+    std::memcpy(words, &data[i], sizeof(double));
+    // Doubles share the byte order of 32-bit integers on all supported platforms, emit the low word first
+    const unsigned int probe = 1;
+    const bool little_endian = (*reinterpret_cast<const unsigned char*>(&probe) == 1);
+    putU32(&bytes[i * 8], little_endian ? words[0] : words[1]);
+    putU32(&bytes[i * 8 + 4], little_endian ? words[1] : words[0]);
+  }
+  writeFrame(fp, update, x_size, y_size, z_size, TYPE_FLOAT64, (num_elems) ? &bytes[0] : NULL, 8, num_elems, compress);
+}
+
+
+void cGridDump::writeFrame(std::ostream& fp, int update, int x_size, int y_size, int z_size, eType type,
+                           const unsigned char* data, int elem_size, int num_elems, bool compress)
+{
+  const int elems_per_block = BLOCK_SIZE / elem_size;
+  const int num_blocks = (num_elems + elems_per_block - 1) / elems_per_block;
+
+  unsigned char header[HEADER_SIZE];
+  std::memset(header, 0, HEADER_SIZE);
+  std::memcpy(header, GRID_DUMP_MAGIC, 4);
+  header[4] = GRID_DUMP_VERSION;
+  header[5] = (unsigned char)type;
+  header[6] = (unsigned char)((compress) ? COMPRESS_LZ : COMPRESS_NONE);
+  putU32(header + 8, (unsigned int)update);
+  putU32(header + 12, (unsigned int)x_size);
+  putU32(header + 16, (unsigned int)y_size);
+  putU32(header + 20, (unsigned int)z_size);
+  putU32(header + 24, (unsigned int)num_blocks);
+  fp.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+
+  Apto::Array<unsigned char> shuffled;
+  Apto::Array<unsigned char> packed;
+  if (compress && num_blocks) {
+    shuffled.Resize(elems_per_block * elem_size);
+    packed.Resize(elems_per_block * elem_size);
+  }
+
+  for (int block = 0; block < num_blocks; block++) {
+    const int first = block * elems_per_block;
+    const int count = (num_elems - first < elems_per_block) ? (num_elems - first) : elems_per_block;
+    const int raw_size = count * elem_size;
+    const unsigned char* raw = data + first * elem_size;
+
+    const unsigned char* stored = raw;
+    int stored_size = raw_size;
+    if (compress) {
+      for (int i = 0; i < count; i++) {
+        for (int b = 0; b < elem_size; b++) shuffled[b * count + i] = raw[i * elem_size + b];
+      }
+      const int packed_size = CompressBlock(&shuffled[0], raw_size, &packed[0], raw_size - 1);
+      if (packed_size > 0) {
+        stored = &packed[0];
+        stored_size = packed_size;
+      }
+    }
+
+    unsigned char block_header[8];
+    putU32(block_header, (unsigned int)raw_size);
+    putU32(block_header + 4, (unsigned int)stored_size);
+    fp.write(reinterpret_cast<const char*>(block_header), 8);
+    fp.write(reinterpret_cast<const char*>(stored), stored_size);
+  }
+}
+
+
+bool cGridDump::ReadFrame(std::istream& fp, cFrame& frame, int world_x, int world_y)
+{
+  unsigned char header[HEADER_SIZE];
+  if (!fp.read(reinterpret_cast<char*>(header), HEADER_SIZE)) return false;
+  if (std::memcmp(header, GRID_DUMP_MAGIC, 4) != 0 || header[4] != GRID_DUMP_VERSION) return false;
+
+  const int type = header[5];
+  const int compression = header[6];
+  int elem_size = 0;
+  if (type == TYPE_INT32) elem_size = 4;
+  else if (type == TYPE_FLOAT64) elem_size = 8;
+  else return false;
+  if (compression != COMPRESS_NONE && compression != COMPRESS_LZ) return false;
+
+  frame.type = (eType)type;
+  frame.update = (int)getU32(header + 8);
+  frame.x_size = (int)getU32(header + 12);
+  frame.y_size = (int)getU32(header + 16);
+  frame.z_size = (int)getU32(header + 20);
+  const int num_blocks = (int)getU32(header + 24);
+  if (frame.x_size < 0 || frame.y_size < 0 || frame.z_size < 0 || num_blocks < 0) return false;
+  if (world_x > 0 && frame.x_size != world_x) return false;
+  if (world_y > 0 && frame.y_size != world_y) return false;
+
+  // Reject dimensions whose data could not fit in an int sized buffer, or that disagree with the block count
+  const double total_bytes = (double)frame.x_size * frame.y_size * frame.z_size * elem_size;
+  if (total_bytes > INT_MAX) return false;
+  const int num_elems = frame.GetSize();
+  const int elems_per_block = BLOCK_SIZE / elem_size;
+  if (num_blocks != (num_elems + elems_per_block - 1) / elems_per_block) return false;
+
+  // Every block needs its header, and its data must be recoverable from the bytes actually left in the stream
+  const std::streampos frame_start = fp.tellg();
+  if (frame_start != std::streampos(-1)) {
+    fp.seekg(0, std::ios::end);
+    const std::streamoff remaining = fp.tellg() - frame_start;
+    fp.seekg(frame_start);
+    if (!fp) return false;
+    const double data_bytes = (double)remaining - 8.0 * num_blocks;
+    if (data_bytes < 0.0) return false;
+    if (compression == COMPRESS_NONE && data_bytes < total_bytes) return false;
+    if (compression == COMPRESS_LZ && data_bytes * LZ_MAX_EXPANSION < total_bytes) return false;
+  }
+
+  Apto::Array<unsigned char> bytes(num_elems * elem_size);
+  Apto::Array<unsigned char> stored;
+  Apto::Array<unsigned char> shuffled;
+
+  int offset = 0;
+  for (int block = 0; block < num_blocks; block++) {
+    unsigned char block_header[8];
+    if (!fp.read(reinterpret_cast<char*>(block_header), 8)) return false;
+    const int raw_size = (int)getU32(block_header);
+    const int stored_size = (int)getU32(block_header + 4);
+    if (raw_size < 0 || raw_size > elems_per_block * elem_size) return false;
+    if (stored_size < 0 || stored_size > raw_size || raw_size % elem_size) return false;
+    if (offset + raw_size > bytes.GetSize()) return false;
+    if (!raw_size) continue;
+
+    unsigned char* raw = &bytes[offset];
+    if (stored_size == raw_size) {
+      if (!fp.read(reinterpret_cast<char*>(raw), raw_size)) return false;
+    } else {
+      if (compression != COMPRESS_LZ) return false;
+      if (stored.GetSize() < stored_size) stored.Resize(stored_size);
+      if (shuffled.GetSize() < raw_size) shuffled.Resize(raw_size);
+      if (stored_size && !fp.read(reinterpret_cast<char*>(&stored[0]), stored_size)) return false;
+      if (!DecompressBlock(&stored[0], stored_size, &shuffled[0], raw_size)) return false;
+
+      const int count = raw_size / elem_size;
+      for (int i = 0; i < count; i++) {
+        for (int b = 0; b < elem_size; b++) raw[i * elem_size + b] = shuffled[b * count + i];
+      }
+    }
+    offset += raw_size;
+  }
+  if (offset != bytes.GetSize()) return false;
+
+  if (type == TYPE_INT32) {
+    frame.int_data.Resize(num_elems);
+    frame.double_data.Resize(0);
+    for (int i = 0; i < num_elems; i++) frame.int_data[i] = (int)getU32(&bytes[i * 4]);
+  } else {
+    frame.int_data.Resize(0);
+    frame.double_data.Resize(num_elems);
+    const unsigned int probe = 1;
+    const bool little_endian = (*reinterpret_cast<const unsigned char*>(&probe) == 1);
+    for (int i = 0; i < num_elems; i++) {
+      unsigned int words[2];
+      words[little_endian ? 0 : 1] = getU32(&bytes[i * 8]);
+      words[little_endian ? 1 : 0] = getU32(&bytes[i * 8 + 4]);
+      std::memcpy(&frame.double_data[i], words, sizeof(double));
+    }
+  }
+
+  return true;
+}
+
+
+// LZ block format, in the style of LZ4: a sequence of (token, literals, match) records.  The token's high nibble is the
+// literal count and its low nibble the match length minus LZ_MIN_MATCH; a nibble of 15 is continued by bytes of 255
+// terminated by a byte below 255.  Literals are followed by a 2 byte little-endian match offset.  The final record holds
+// literals only and ends the block.
+
+static inline bool lzPutLength(unsigned char*& op, const unsigned char* op_end, int len)
+{
+  for (; len >= 255; len -= 255) {
+    if (op >= op_end) return false;
+    *op++ = 255;
+  }
+  if (op >= op_end) return false;
+  *op++ = (unsigned char)len;
+  return true;
+}
+
+static inline bool lzPutSequence(unsigned char*& op, const unsigned char* op_end, const unsigned char* literals,
+                                 int num_literals, int offset, int match_len)
+{
+  if (op >= op_end) return false;
+  unsigned char* token = op++;
+  *token = (unsigned char)(((num_literals < 15) ? num_literals : 15) << 4);
+  if (num_literals >= 15 && !lzPutLength(op, op_end, num_literals - 15)) return false;
+  if (op_end - op < num_literals) return false;
+  std::memcpy(op, literals, num_literals);
+  op += num_literals;
+
+  if (match_len == 0) return true;  // final literal-only record
+
+  if (op_end - op < 2) return false;
+  *op++ = (unsigned char)(offset);
+  *op++ = (unsigned char)(offset >> 8);
+  const int match_code = match_len - LZ_MIN_MATCH;
+  *token |= (unsigned char)((match_code < 15) ? match_code : 15);
+  if (match_code >= 15 && !lzPutLength(op, op_end, match_code - 15)) return false;
+  return true;
+}
+
+int cGridDump::CompressBlock(const unsigned char* src, int src_size, unsigned char* dst, int dst_capacity)
+{
+  if (dst_capacity <= 0) return 0;
+
+  Apto::Array<int> table(1 << LZ_HASH_BITS);
+  table.SetAll(-1);
+
+  unsigned char* op = dst;
+  const unsigned char* op_end = dst + dst_capacity;
+
+  int anchor = 0;
+  int ip = 0;
+  while (ip + LZ_MIN_MATCH <= src_size) {
+    const unsigned int h = lzHash(src + ip);
+    const int ref = table[h];
+    table[h] = ip;
+
+    if (ref >= 0 && ip - ref <= LZ_MAX_OFFSET && std::memcmp(src + ref, src + ip, LZ_MIN_MATCH) == 0) {
+      int match_len = LZ_MIN_MATCH;
+      while (ip + match_len < src_size && src[ref + match_len] == src[ip + match_len]) match_len++;
+
+      if (!lzPutSequence(op, op_end, src + anchor, ip - anchor, ip - ref, match_len)) return 0;
+      ip += match_len;
+      anchor = ip;
+    } else {
+      ip++;
+    }
+  }
+
+  if (!lzPutSequence(op, op_end, src + anchor, src_size - anchor, 0, 0)) return 0;
+  return op - dst;
+}
+
+bool cGridDump::DecompressBlock(const unsigned char* src, int src_size, unsigned char* dst, int dst_size)
+{
+  const unsigned char* ip = src;
+  const unsigned char* ip_end = src + src_size;
+  unsigned char* op = dst;
+  unsigned char* op_end = dst + dst_size;
+
+  while (ip < ip_end) {
+    const int token = *ip++;
+
+    int num_literals = token >> 4;
+    if (num_literals == 15) {
+      int b = 255;
+      while (b == 255) {
+        if (ip >= ip_end) return false;
+        b = *ip++;
+        num_literals += b;
+      }
+    }
+    if (ip_end - ip < num_literals || op_end - op < num_literals) return false;
+    std::memcpy(op, ip, num_literals);
+    ip += num_literals;
+    op += num_literals;
+
+    if (ip == ip_end) break;  // final literal-only record
+
+    if (ip_end - ip < 2) return false;
+    const int offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    int match_len = (token & 0x0F);
+    if (match_len == 15) {
+      int b = 255;
+      while (b == 255) {
+        if (ip >= ip_end) return false;
+        b = *ip++;
+        match_len += b;
+      }
+    }
+    match_len += LZ_MIN_MATCH;
+
+    if (offset == 0 || offset > op - dst || op_end - op < match_len) return false;
+    const unsigned char* match = op - offset;
+    for (int i = 0; i < match_len; i++) op[i] = match[i];  // byte-wise, matches may overlap their own output
+    op += match_len;
+  }
+
+  return op == op_end;
+}
@@ -0,0 +1,99 @@
+/*
+ *  cGridDump.h
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cGridDump_h
+#define cGridDump_h
+
+#include "apto/core/Array.h"
+
+#include <iostream>
+
+
+// cGridDump - binary frames of typed 2D/3D grid data, as written by the Dump*Grid actions
+//
+// A grid dump file is a sequence of frames.  Each frame is a fixed 32 byte header followed by the cell data, split into
+// blocks of at most BLOCK_SIZE raw bytes:
+//
+//   char[4]  magic "AVGD"
+//   uint8    format version (1)
+//   uint8    element type (TYPE_INT32, TYPE_FLOAT64)
+//   uint8    compression (COMPRESS_NONE, COMPRESS_LZ)
+//   uint8    reserved (0)
+//   int32    update
+//   int32    x, y, z dimensions (x varies fastest; z is 1 for 2D grids, the number of layers for population dumps)
+//   int32    number of blocks
+//   int32    reserved (0)
+//
+//   per block: uint32 raw size, uint32 stored size, stored bytes
+//
+// All integers and elements are little-endian.  Compressed blocks are byte-shuffled (all first bytes of each element,
+// then all second bytes, ...) and then LZ compressed; a block whose stored size equals its raw size was stored as-is.
+
+class cGridDump
+{
+public:
+  enum eFormat { FORMAT_TEXT = 0, FORMAT_BINARY, FORMAT_BINARY_LZ };
+  enum eType { TYPE_INT32 = 1, TYPE_FLOAT64 = 2 };
+  enum eCompression { COMPRESS_NONE = 0, COMPRESS_LZ = 1 };
+
+  static const int HEADER_SIZE = 32;
+  static const int BLOCK_SIZE = 1 << 20;
+
+  class cFrame
+  {
+  public:
+    int update;
+    int x_size;
+    int y_size;
+    int z_size;
+    eType type;
+    Apto::Array<int> int_data;        // populated for TYPE_INT32 frames
+    Apto::Array<double> double_data;  // populated for TYPE_FLOAT64 frames
+
+    cFrame() : update(-1), x_size(0), y_size(0), z_size(0), type(TYPE_INT32) { ; }
+
+    inline int GetSize() const { return x_size * y_size * z_size; }
+    inline double GetValue(int idx) const { return (type == TYPE_INT32) ? int_data[idx] : double_data[idx]; }
+  };
+
+
+  // Accepts "text", "binary", and "binary-lz" (alias "lz")
+  static bool ParseFormat(const char* name, eFormat& format);
+
+  static void WriteFrame(std::ostream& fp, int update, int x_size, int y_size, int z_size,
+                         const Apto::Array<int>& data, bool compress);
+  static void WriteFrame(std::ostream& fp, int update, int x_size, int y_size, int z_size,
+                         const Apto::Array<double>& data, bool compress);
+
+  // Reads the next frame, returning false at end of stream or on a malformed frame.  The header dimensions are checked
+  // against the bytes left in the stream (when it is seekable) and, if world_x and world_y are given, against the world.
+  static bool ReadFrame(std::istream& fp, cFrame& frame, int world_x = 0, int world_y = 0);
+
+
+  // LZ block codec.  CompressBlock returns the compressed size, or 0 if the result would not fit in dst_capacity.
+  static int CompressBlock(const unsigned char* src, int src_size, unsigned char* dst, int dst_capacity);
+  static bool DecompressBlock(const unsigned char* src, int src_size, unsigned char* dst, int dst_size);
+
+private:
+  static void writeFrame(std::ostream& fp, int update, int x_size, int y_size, int z_size, eType type,
+                         const unsigned char* data, int elem_size, int num_elems, bool compress);
+};
+
+#endif
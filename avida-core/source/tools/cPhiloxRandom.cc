@@ -0,0 +1,104 @@
+/*
+ *  cPhiloxRandom.cc
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cPhiloxRandom.h"
+
+#include <ctime>
+
+
+static const unsigned int PHILOX_M0 = 0xD2511F53;
+static const unsigned int PHILOX_M1 = 0xCD9E8D57;
+static const unsigned int PHILOX_W0 = 0x9E3779B9;
+static const unsigned int PHILOX_W1 = 0xBB67AE85;
+static const int PHILOX_ROUNDS = 10;
+
+static const double WORD_TO_DOUBLE = 1.0 / 4294967296.0;
+
+
+static inline void philoxBijection(const unsigned int counter[4], const unsigned int key[2], unsigned int out[4])
+{
+  unsigned int c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+  unsigned int k0 = key[0], k1 = key[1];
+  for (int round = 0; round < PHILOX_ROUNDS; round++) {
+    const unsigned long long p0 = (unsigned long long)PHILOX_M0 * c0;
+    const unsigned long long p1 = (unsigned long long)PHILOX_M1 * c2;
+    c0 = (unsigned int)(p1 >> 32) ^ c1 ^ k0;
+    c1 = (unsigned int)p1;
+    c2 = (unsigned int)(p0 >> 32) ^ c3 ^ k1;
+    c3 = (unsigned int)p0;
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+}
+
+
+cPhiloxRandom::cPhiloxRandom(int seed, int stream_type, int object_id) : m_counter(0), m_block_pos(4)
+{
+  m_stream[0] = (unsigned int)object_id;
+  m_stream[1] = (unsigned int)stream_type;
+  ResetSeed(seed);
+}
+
+
+void cPhiloxRandom::ResetSeed(int seed)
+{
+  m_original_seed = seed;
+  if (seed < 0) seed = (int)(time(NULL) & 0x7FFFFFFF);
+  m_seed = seed;
+
+  m_key[0] = (unsigned int)seed;
+  m_key[1] = 0;
+  m_counter = 0;
+  m_block_pos = 4;
+}
+
+
+void cPhiloxRandom::Bijection(const unsigned int counter[4], const unsigned int key[2], unsigned int out[4])
+{
+  philoxBijection(counter, key, out);
+}
+
+
+double cPhiloxRandom::getNext()
+{
+  if (m_block_pos == 4) {
+    generateBlocks(m_block, 1);
+    m_block_pos = 0;
+  }
+  return m_block[m_block_pos++] * WORD_TO_DOUBLE;
+}
+
+
+void cPhiloxRandom::generateBlocks(unsigned int* out, int num_blocks)
+{
+  // Blocks do not depend on one another, so this loop carries no state beyond the counter
+  unsigned int counter[4] = { 0, 0, m_stream[0], m_stream[1] };
+  for (int i = 0; i < num_blocks; i++) {
+    const unsigned long long block = m_counter + i;
+    counter[0] = (unsigned int)block;
+    counter[1] = (unsigned int)(block >> 32);
+    philoxBijection(counter, m_key, out + 4 * i);
+  }
+  m_counter += num_blocks;
+}
@@ -0,0 +1,83 @@
+/*
+ *  cPhiloxRandom.h
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef cPhiloxRandom_h
+#define cPhiloxRandom_h
+
+#include "apto/core.h"
+#include "apto/rng.h"
+
+
+// Stream types, kept apart so that equal object ids of different kinds never share a stream.  The values are part of
+// each stream's identity, so existing ones must not be renumbered.  1 and 4 are reserved for organism and test CPU
+// streams, which are not handed out: organisms draw from their deme's stream (or the world's) as they execute.
+enum eRandomStream {
+  RANDOM_STREAM_WORLD = 0,
+  RANDOM_STREAM_DEME = 2,
+  RANDOM_STREAM_ANALYZE_JOB = 3,
+  RANDOM_STREAM_SCHEDULER = 5
+};
+
+
+// cPhiloxRandom     : Counter-based random number generator (Philox4x32-10)
+//
+// Each block of four 32-bit outputs is a keyed bijection of a 128-bit counter, so any position in the sequence can be
+// reached directly.  The key is taken from the seed, the upper half of the counter from the stream (type, object id),
+// and the lower half counts blocks.  Generators built from the same seed and different streams are independent, and
+// two generators built from the same (seed, stream, counter) produce the same values on any thread.
+
+class cPhiloxRandom : public Apto::Random
+{
+private:
+  unsigned int m_key[2];
+  unsigned int m_stream[2];
+  unsigned long long m_counter;     // Next block to generate
+  unsigned int m_block[4];
+  int m_block_pos;                  // Next unused word of m_block, 4 if exhausted
+
+
+  cPhiloxRandom(const cPhiloxRandom&); // @not_implemented
+  cPhiloxRandom& operator=(const cPhiloxRandom&); // @not_implemented
+
+public:
+  cPhiloxRandom(int seed = -1, int stream_type = RANDOM_STREAM_WORLD, int object_id = 0);
+  ~cPhiloxRandom() { ; }
+
+  void ResetSeed(int seed);
+  int MaxSeed() const { return 0x7FFFFFFF; }
+
+  inline int GetStreamType() const { return (int)m_stream[1]; }
+  inline int GetObjectID() const { return (int)m_stream[0]; }
+
+  // Position in the stream, in blocks of four words.  Restoring a saved counter replays the stream from that point.
+  inline unsigned long long GetCounter() const { return m_counter; }
+  inline void SetCounter(unsigned long long counter) { m_counter = counter; m_block_pos = 4; }
+
+  // The Philox4x32-10 bijection, exposed so that other generators may be checked against it
+  static void Bijection(const unsigned int counter[4], const unsigned int key[2], unsigned int out[4]);
+
+protected:
+  double getNext();
+
+private:
+  void generateBlocks(unsigned int* out, int num_blocks);
+};
+
+#endif
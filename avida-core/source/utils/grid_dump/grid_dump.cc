@@ -0,0 +1,77 @@
+/*
+ *  grid_dump.cc
+ *  Avida
+ *
+ *  Copyright 1999-2013 Michigan State University. All rights reserved.
+ *
+ *
+ *  This file is part of Avida.
+ *
+ *  Avida is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  Avida is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License along with Avida.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cGridDump.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+
+// Prints every frame of a binary grid dump (format=binary or format=binary-lz) in the text layout of the Dump*Grid
+// actions, preceded by a comment line describing the frame.  Layers of 3D frames are separated by a blank line.
+int main(int argc, char* argv[])
+{
+  if (argc != 2 && argc != 4) {
+    cerr << "Usage: " << argv[0] << " [grid_file] [world_x world_y]" << endl
+         << "  [grid_file] is a binary grid dump written by a Dump*Grid action." << endl
+         << "  [world_x world_y], if given, reject frames whose dimensions do not match the world." << endl
+         << endl;
+    exit(1);
+  }
+  const int world_x = (argc == 4) ? atoi(argv[2]) : 0;
+  const int world_y = (argc == 4) ? atoi(argv[3]) : 0;
+
+  ifstream fp(argv[1], ios::in | ios::binary);
+  if (!fp.good()) {
+    cerr << "error: unable to open '" << argv[1] << "'" << endl;
+    exit(1);
+  }
+
+  cGridDump::cFrame frame;
+  int num_frames = 0;
+  while (cGridDump::ReadFrame(fp, frame, world_x, world_y)) {
+    cout << "# update " << frame.update << " (" << frame.x_size << "x" << frame.y_size;
+    if (frame.z_size > 1) cout << "x" << frame.z_size;
+    cout << ")" << endl;
+
+    for (int k = 0; k < frame.z_size; k++) {
+      if (k > 0) cout << endl;
+      for (int j = 0; j < frame.y_size; j++) {
+        for (int i = 0; i < frame.x_size; i++) {
+          const int idx = (k * frame.y_size + j) * frame.x_size + i;
+          if (frame.type == cGridDump::TYPE_INT32) cout << frame.int_data[idx] << " ";
+          else cout << frame.double_data[idx] << " ";
+        }
+        cout << endl;
+      }
+    }
+    num_frames++;
+  }
+
+  if (!fp.eof()) {
+    cerr << "error: malformed frame after " << num_frames << " frame(s)" << endl;
+    exit(1);
+  }
+
+  return 0;
+}
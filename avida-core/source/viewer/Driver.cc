@@ -53,7 +53,7 @@
 
 Avida::Viewer::Driver::Driver(cWorld* world, World* new_world)
 : Apto::Thread(), m_world(world), m_new_world(new_world), m_pause_state(DRIVER_UNPAUSED), m_started(false), m_done(false)
-, m_paused(false), m_pause_at(-2), m_map(NULL)
+, m_paused(false), m_map_refresh(false), m_pause_at(-2), m_map(NULL)
 {
   GlobalObjectManager::Register(this);
 }
@@ -300,6 +300,17 @@ void Avida::Viewer::Driver::Sync()
 
 
 
+void Avida::Viewer::Driver::RefreshMap()
+{
+  // Maps are only rebuilt on the driver thread, between updates or while paused
+  m_mutex.Lock();
+  m_map_refresh = true;
+  m_mutex.Unlock();
+  m_pause_cv.Broadcast();
+}
+
+
+
 void Avida::Viewer::Driver::Abort(AbortCondition condition)
 {
   throw condition;
@@ -414,9 +425,17 @@ void Avida::Viewer::Driver::Run()
             delete info;
           }
         }
-        
+        m_map_refresh = false;
+      }
+      Map* map = m_map;
+      m_mutex.Unlock();
+      
+      // Map snapshots are built without holding the driver lock, viewers reading a snapshot never block the update
+      if (map) map->UpdateMaps(population);
+      
+      m_mutex.Lock();
+      {
         // Listeners can be attached and detached asynchronously, must be locked while working with them
-        if (m_map) m_map->UpdateMaps(population);
         for (Apto::Set<Listener*>::Iterator it = m_listeners.Begin(); it.Next();) {
           if ((*it.Get())->WantsMap()) {
             (*it.Get())->NotifyMap(m_map);
@@ -456,6 +475,15 @@ void Avida::Viewer::Driver::Run()
       m_mutex.Lock();
       while (!m_done && m_pause_state != DRIVER_UNPAUSED) {
         m_paused = true;
+        if (m_map_refresh) {
+          // The population is idle while paused, so a newly selected map mode can be built right away
+          m_map_refresh = false;
+          if (m_map) {
+            m_map->UpdateMaps(population);
+            notifyMap();
+          }
+          continue;
+        }
         m_pause_cv.Wait(m_mutex);
       }
       m_paused = false;
@@ -468,6 +496,15 @@ void Avida::Viewer::Driver::Run()
 }
 
 
+void Avida::Viewer::Driver::notifyMap()
+{
+  // Must be called with m_mutex held
+  for (Apto::Set<Listener*>::Iterator it = m_listeners.Begin(); it.Next();) {
+    if ((*it.Get())->WantsMap()) (*it.Get())->NotifyMap(m_map);
+  }
+}
+
+
 void Avida::Viewer::Driver::StdIOFeedback::Error(const char* fmt, ...)
 {
   printf("error: ");
@@ -503,7 +540,7 @@ void Avida::Viewer::Driver::AttachListener(Listener* listener)
   m_mutex.Lock();
   m_listeners.Insert(listener);
   
-  if (listener->WantsMap() && !m_map) m_map = new Map(m_world);
+  if (listener->WantsMap() && !m_map) m_map = new Map(m_world, this);
   m_mutex.Unlock();
 }
 
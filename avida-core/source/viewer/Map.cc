@@ -25,11 +25,13 @@
 #include "avida/viewer/Map.h"
 
 #include "avida/viewer/ClassificationInfo.h"
+#include "avida/viewer/Driver.h"
 
 #include "cEnvironment.h"
 #include "cOrganism.h"
 #include "cPopulation.h"
 #include "cPopulationCell.h"
+#include "cStats.h"
 #include "cStringUtil.h"
 #include "cWorld.h"
 
@@ -58,6 +60,9 @@ private:
   Apto::Array<int> m_color_count;
   Apto::Array<DiscreteScale::Entry> m_scale_labels;
   
+  Apto::Array<double> m_cell_values;  // property value of the organism in each cell, as of its last change
+  Apto::Array<bool> m_cell_occupied;
+  
   double m_cur_min;
   double m_cur_max;
   double m_target_max;
@@ -92,38 +97,49 @@ public:
   bool SetProperty(const Apto::String&, const Apto::String&) { return false; }
   Apto::String GetProperty(const Apto::String&) const { return ""; }
   
-  void Update(cPopulation& pop);
+  void Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>* changed_cells);
   
   
   // DiscreteScale Interface
   int GetScaleRange() const { return m_color_count.GetSize() - Avida::Viewer::MAP_RESERVED_COLORS; }
   int GetNumLabeledEntries() const { return m_scale_labels.GetSize(); }
   DiscreteScale::Entry GetEntry(int index) const { return m_scale_labels[index]; }
+  
+private:
+  void readCell(cPopulation& pop, int cell_id);
+  int colorOf(int cell_id) const;
 };
 
 const double DoublePropMapMode::RESCALE_TOLERANCE = 0.1;
 const double DoublePropMapMode::MAX_RESCALE_FACTOR = 0.03;
 
-void DoublePropMapMode::Update(cPopulation& pop)
+void DoublePropMapMode::Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>* changed_cells)
 {
-  m_color_grid.Resize(pop.GetSize());
-  
-  // Keep track of how many times each color was assigned.
-  m_color_count.SetAll(0);
+  // Only cells whose organism changed need their property looked up again
+  if (changed_cells == NULL || m_cell_values.GetSize() != pop.GetSize()) {
+    changed_cells = NULL;
+    m_cell_values.Resize(pop.GetSize());
+    m_cell_occupied.Resize(pop.GetSize());
+    for (int i = 0; i < pop.GetSize(); i++) readCell(pop, i);
+  } else {
+    for (int i = 0; i < changed_cells->GetSize(); i++) readCell(pop, (*changed_cells)[i]);
+  }
   
   // Determine the max and min in the population.
   double max_fit = 0.0;
   double min_fit = 0.0;
   
-  for (int i = 0; i < pop.GetSize(); i++) {
-    cOrganism* org = pop.GetCell(i).GetOrganism();
-    if (org == NULL) continue;
-    double fit = org->Properties().Get(m_prop_id);
+  for (int i = 0; i < m_cell_values.GetSize(); i++) {
+    if (!m_cell_occupied[i]) continue;
+    double fit = m_cell_values[i];
     if (fit == 0.0) continue;
     if (fit > max_fit) max_fit = fit;
     if (fit < min_fit) min_fit = fit;
   }
   
+  const double prev_min = m_cur_min;
+  const double prev_max = m_cur_max;
+  
   if (m_cur_max == 0.0) {
     // Reset range
     m_cur_max = max_fit;
@@ -165,36 +181,48 @@ void DoublePropMapMode::Update(cPopulation& pop)
     }
   }
   
-  // Now fill out the color grid.
-  for (int i = 0; i < pop.GetSize(); i++) {
-    cOrganism* org = pop.GetCell(i).GetOrganism();
-    if (org == NULL) {
-      m_color_grid[i] = Avida::Viewer::MAP_RESERVED_COLOR_BLACK;
-      m_color_count[Avida::Viewer::MAP_RESERVED_COLORS - Avida::Viewer::MAP_RESERVED_COLOR_BLACK]++;
-      continue;
-    }
-    
-    double fit = org->Properties().Get(m_prop_id);
-    if (fit == 0.0) {
-      m_color_grid[i] = Avida::Viewer::MAP_RESERVED_COLOR_DARK_GRAY;
-      m_color_count[Avida::Viewer::MAP_RESERVED_COLORS - Avida::Viewer::MAP_RESERVED_COLOR_DARK_GRAY]++;
-      continue;
+  // Now fill out the color grid.  Colors depend only on the cell value and the current range, so unless the range moved
+  // only the changed cells need to be recolored.
+  if (changed_cells == NULL || m_cur_min != prev_min || m_cur_max != prev_max) {
+    m_color_grid.Resize(pop.GetSize());
+    m_color_count.SetAll(0);
+    for (int i = 0; i < m_color_grid.GetSize(); i++) {
+      m_color_grid[i] = colorOf(i);
+      m_color_count[m_color_grid[i] + Avida::Viewer::MAP_RESERVED_COLORS]++;
     }
-    
-    //    fit = log2(fit);
-    
-    fit = (fit - m_cur_min) / (m_cur_max - m_cur_min);
-    if (fit > 1.0) {
-      m_color_grid[i] = Avida::Viewer::MAP_RESERVED_COLOR_WHITE;
-      m_color_count[Avida::Viewer::MAP_RESERVED_COLORS - Avida::Viewer::MAP_RESERVED_COLOR_WHITE]++;
-    } else {
-      int color = fit * static_cast<double>(SCALE_MAX - 1);
-      m_color_grid[i] = color;
-      m_color_count[color + Avida::Viewer::MAP_RESERVED_COLORS]++;
+  } else {
+    for (int i = 0; i < changed_cells->GetSize(); i++) {
+      const int cell_id = (*changed_cells)[i];
+      m_color_count[m_color_grid[cell_id] + Avida::Viewer::MAP_RESERVED_COLORS]--;
+      m_color_grid[cell_id] = colorOf(cell_id);
+      m_color_count[m_color_grid[cell_id] + Avida::Viewer::MAP_RESERVED_COLORS]++;
     }
   }
 }
 
+void DoublePropMapMode::readCell(cPopulation& pop, int cell_id)
+{
+  cOrganism* org = pop.GetCell(cell_id).GetOrganism();
+  m_cell_occupied[cell_id] = (org != NULL);
+  m_cell_values[cell_id] = 0.0;
+  if (org != NULL) m_cell_values[cell_id] = org->Properties().Get(m_prop_id);
+}
+
+int DoublePropMapMode::colorOf(int cell_id) const
+{
+  if (!m_cell_occupied[cell_id]) return Avida::Viewer::MAP_RESERVED_COLOR_BLACK;
+  
+  double fit = m_cell_values[cell_id];
+  if (fit == 0.0) return Avida::Viewer::MAP_RESERVED_COLOR_DARK_GRAY;
+  
+  //    fit = log2(fit);
+  
+  fit = (fit - m_cur_min) / (m_cur_max - m_cur_min);
+  if (fit > 1.0) return Avida::Viewer::MAP_RESERVED_COLOR_WHITE;
+  
+  return fit * static_cast<double>(SCALE_MAX - 1);
+}
+
 const Apto::String& DoublePropMapMode::GetScaleLabel() const
 {  
   if (m_rescale_rate_max != 0) return m_prop_desc_rescale;
@@ -220,6 +248,9 @@ private:
   Apto::Array<int> m_color_count;
   Apto::Array<DiscreteScale::Entry> m_scale_labels;
   
+  Apto::Array<Systematics::GroupPtr> m_cell_groups;  // group of the organism in each cell, as of its last change
+  Apto::Array<bool> m_cell_occupied;
+  
 public:
   ClassificationMapMode(cWorld* world, const Apto::String& role_id, const Apto::String& role_desc);
   virtual ~ClassificationMapMode() { delete m_info; }
@@ -239,7 +270,7 @@ public:
   bool SetProperty(const Apto::String&, const Apto::String&) { return false; }
   Apto::String GetProperty(const Apto::String&) const { return ""; }
   
-  void Update(cPopulation& pop);
+  void Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>* changed_cells);
   
   
   // DiscreteScale Interface
@@ -247,6 +278,9 @@ public:
   int GetNumLabeledEntries() const { return m_scale_labels.GetSize(); }
   DiscreteScale::Entry GetEntry(int index) const { return m_scale_labels[index]; }
   bool IsCategorical() const { return true; }
+  
+private:
+  void readCell(cPopulation& pop, int cell_id);
 };
 
 ClassificationMapMode::ClassificationMapMode(cWorld* world, const Apto::String& role_id, const Apto::String& role_desc)
@@ -268,18 +302,28 @@ ClassificationMapMode::ClassificationMapMode(cWorld* world, const Apto::String&
   m_color_grid.SetAll(-4);
 }
 
-void ClassificationMapMode::Update(cPopulation& pop)
+void ClassificationMapMode::Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>* changed_cells)
 {
   m_info->Update();
+  
+  // Group membership only changes along with the organism in the cell
+  if (changed_cells == NULL || m_cell_groups.GetSize() != pop.GetSize()) {
+    m_cell_groups.Resize(pop.GetSize());
+    m_cell_occupied.Resize(pop.GetSize());
+    for (int i = 0; i < pop.GetSize(); i++) readCell(pop, i);
+  } else {
+    for (int i = 0; i < changed_cells->GetSize(); i++) readCell(pop, (*changed_cells)[i]);
+  }
+  
+  // Map colors are reassigned as groups rise and fall, so every cell is recolored from the cached groups
   m_color_grid.Resize(pop.GetSize());
   m_color_count.SetAll(0);            // reset all color counts
-  for (int i = 0; i < pop.GetSize(); i++) {
-    cOrganism* org = pop.GetCell(i).GetOrganism();
-    if (org == NULL) {
+  for (int i = 0; i < m_color_grid.GetSize(); i++) {
+    if (!m_cell_occupied[i]) {
       m_color_grid[i] = -4;
       m_color_count[0]++;
     } else {
-      Systematics::GroupPtr bg = org->SystematicsGroup(m_role_id);
+      Systematics::GroupPtr bg = m_cell_groups[i];
       if (bg) {
         Avida::Viewer::ClassificationInfo::MapColorPtr mapcolor = bg->GetData<Avida::Viewer::ClassificationInfo::MapColor>();
         if (mapcolor) {
@@ -296,6 +340,13 @@ void ClassificationMapMode::Update(cPopulation& pop)
   for (int i = 0; i < m_color_count.GetSize(); i++) if (m_color_count[i] == 0) m_scale_labels[i].label = "-";
 }
 
+void ClassificationMapMode::readCell(cPopulation& pop, int cell_id)
+{
+  cOrganism* org = pop.GetCell(cell_id).GetOrganism();
+  m_cell_occupied[cell_id] = (org != NULL);
+  m_cell_groups[cell_id] = (org != NULL) ? org->SystematicsGroup(m_role_id) : Systematics::GroupPtr();
+}
+
 
 
 
@@ -305,6 +356,7 @@ private:
   cWorld* m_world;
   Apto::Array<int> m_action_grid;
   Apto::Array<Apto::Array<int> > m_raw_action_counts;
+  Apto::Array<Systematics::GroupID> m_cell_genotypes;  // genotype the raw counts of each cell were taken from, -1 = empty
   Apto::Array<int> m_action_counts;
   Apto::Array<Apto::String> m_action_ids;
   int m_num_enabled;
@@ -331,7 +383,7 @@ public:
   bool SetProperty(const Apto::String& property, const Apto::String& value);
   Apto::String GetProperty(const Apto::String& property) const;
   
-  void Update(cPopulation& pop);
+  void Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>* changed_cells);
   
   
   // DiscreteScale Interface
@@ -341,6 +393,7 @@ public:
   
   
 private:
+  void readCell(cAvidaContext& ctx, cPopulation& pop, int cell_id);
   void updateTagStates();
 };
 
@@ -402,38 +455,55 @@ Apto::String EnvActionMapMode::GetProperty(const Apto::String& property) const
   return "";
 }
 
-void EnvActionMapMode::Update(cPopulation& pop)
+void EnvActionMapMode::Update(cPopulation& pop, const Apto::Array<int, Apto::Smart>* changed_cells)
 {
   cAvidaContext ctx(&m_world->GetDriver(), m_world->GetRandom());
 
-  m_action_grid.Resize(pop.GetSize());
-  m_raw_action_counts.Resize(pop.GetSize());
-  for (int i = 0; i < m_raw_action_counts.GetSize(); i++) m_raw_action_counts[i].Resize(m_action_ids.GetSize());
-  m_action_counts.SetAll(0);            // reset all color counts
-  
-  for (int i = 0; i < pop.GetSize(); i++) {
-    cOrganism* org = pop.GetCell(i).GetOrganism();
-    if (org == NULL) {
-      m_raw_action_counts[i].SetAll(0);
-    } else {
-      for (int task_id = 0; task_id < m_action_ids.GetSize(); task_id++) {
-//        if (org->GetPhenotype().GetLastTaskCount()[task_id] > 0) m_raw_action_counts[i][task_id] = 1;
-//        else if (org->GetPhenotype().GetCurTaskCount()[task_id] > 0) m_raw_action_counts[i][task_id] = 2;
-        Systematics::GroupPtr genotype = org->SystematicsGroup("genotype");
-        Systematics::GenomeTestMetricsPtr metrics(Systematics::GenomeTestMetrics::GetMetrics(m_world, ctx, genotype));
-        const Apto::Array<int>& task_counts = metrics->GetTaskCounts();
-        if (task_counts[task_id] > 0) m_raw_action_counts[i][task_id] = 1;
-        else m_raw_action_counts[i][task_id] = 0;
-      }
+  // Genome test metrics are only gathered for cells that received a new genotype
+  if (changed_cells == NULL || m_raw_action_counts.GetSize() != pop.GetSize()) {
+    m_action_grid.Resize(pop.GetSize());
+    m_raw_action_counts.Resize(pop.GetSize());
+    m_cell_genotypes.Resize(pop.GetSize());
+    for (int i = 0; i < m_raw_action_counts.GetSize(); i++) {
+      m_raw_action_counts[i].Resize(m_action_ids.GetSize());
+      m_cell_genotypes[i] = -2;
+      readCell(ctx, pop, i);
     }
+  } else {
+    for (int i = 0; i < changed_cells->GetSize(); i++) readCell(ctx, pop, (*changed_cells)[i]);
   }
   
   updateTagStates();
 }
 
 
+void EnvActionMapMode::readCell(cAvidaContext& ctx, cPopulation& pop, int cell_id)
+{
+  cOrganism* org = pop.GetCell(cell_id).GetOrganism();
+  if (org == NULL) {
+    m_raw_action_counts[cell_id].SetAll(0);
+    m_cell_genotypes[cell_id] = -1;
+    return;
+  }
+  
+  Systematics::GroupPtr genotype = org->SystematicsGroup("genotype");
+  if (genotype->ID() == m_cell_genotypes[cell_id]) return;
+  m_cell_genotypes[cell_id] = genotype->ID();
+  
+  Systematics::GenomeTestMetricsPtr metrics(Systematics::GenomeTestMetrics::GetMetrics(m_world, ctx, genotype));
+  const Apto::Array<int>& task_counts = metrics->GetTaskCounts();
+  for (int task_id = 0; task_id < m_action_ids.GetSize(); task_id++) {
+//    if (org->GetPhenotype().GetLastTaskCount()[task_id] > 0) m_raw_action_counts[cell_id][task_id] = 1;
+//    else if (org->GetPhenotype().GetCurTaskCount()[task_id] > 0) m_raw_action_counts[cell_id][task_id] = 2;
+    if (task_counts[task_id] > 0) m_raw_action_counts[cell_id][task_id] = 1;
+    else m_raw_action_counts[cell_id][task_id] = 0;
+  }
+}
+
+
 void EnvActionMapMode::updateTagStates()
 {
+  m_action_counts.SetAll(0);            // reset all color counts
   if (m_num_enabled == 0) {
     m_action_grid.SetAll(-4);
     return;
@@ -457,8 +527,10 @@ void EnvActionMapMode::updateTagStates()
 
 
 
-Avida::Viewer::Map::Map(cWorld* world)
-  : m_width(world->GetPopulation().GetWorldX())
+Avida::Viewer::Map::Map(cWorld* world, Driver* driver)
+  : m_world(world)
+  , m_driver(driver)
+  , m_width(world->GetPopulation().GetWorldX())
   , m_height(world->GetPopulation().GetWorldY())
   , m_num_viewer_colors(-1)
   , m_color_mode(0)
@@ -490,6 +562,11 @@ Avida::Viewer::Map::Map(cWorld* world)
 //    mode_name.Insert("Task/");
 //    AddViewMode(mode_name, &cViewer_Map::TagCells_Task, VIEW_TAGS, i);
 //  }
+  
+  m_mode_current.Resize(m_view_modes.GetSize());
+  m_mode_current.SetAll(false);
+  
+  publishSnapshot(ConstMapSnapshotPtr(buildSnapshot(-1, 0)));
 }
 
 Avida::Viewer::Map::~Map()
@@ -499,32 +576,130 @@ Avida::Viewer::Map::~Map()
 
 bool Avida::Viewer::Map::SetModeProperty(int idx, const Apto::String& property, const Apto::String& value)
 {
-  m_rw_lock.WriteLock();
+  Apto::MutexAutoLock lock(m_mode_mutex);
   bool rval = m_view_modes[idx]->SetProperty(property, value);
-  m_rw_lock.WriteUnlock();
+  
+  // Property changes are applied from the mode's existing state, so the displayed layers can be republished directly
+  if (rval && (idx == m_color_mode || idx == m_symbol_mode || idx == m_tag_mode)) {
+    ConstMapSnapshotPtr current = CurrentSnapshot();
+    publishSnapshot(ConstMapSnapshotPtr(buildSnapshot(current->GetUpdate(), current->GetNumOrganisms())));
+  }
   return rval;
 }
 
 void Avida::Viewer::Map::UpdateMaps(cPopulation& pop)
 {
-  m_rw_lock.WriteLock();
+  Apto::MutexAutoLock lock(m_mode_mutex);
   
   m_width = pop.GetWorldX();
   m_height = pop.GetWorldY();
   
-  for (int i = 0; i < m_view_modes.GetSize(); i++) m_view_modes[i]->Update(pop);
+  bool full = false;
+  findChangedCells(pop, full);
+  
+  // Only the displayed modes are kept up to date, any other mode is recomputed in full once it is selected
+  Apto::Array<bool> updated(m_view_modes.GetSize());
+  updated.SetAll(false);
+  const int displayed[3] = { m_color_mode, m_symbol_mode, m_tag_mode };
+  for (int i = 0; i < 3; i++) {
+    const int mode = displayed[i];
+    if (mode < 0 || updated[mode]) continue;
+    m_view_modes[mode]->Update(pop, (full || !m_mode_current[mode]) ? NULL : &m_changed_cells);
+    updated[mode] = true;
+  }
+  m_mode_current = updated;
   
-  m_rw_lock.WriteUnlock();
+  publishSnapshot(ConstMapSnapshotPtr(buildSnapshot(m_world->GetStats().GetUpdate(), pop.GetNumOrganisms())));
 }
 
 
 void Avida::Viewer::Map::SetMode(int mode)
 {
+  m_mode_mutex.Lock();
   int type = m_view_modes[mode]->GetSupportedTypes();
   if (type == MAP_GRID_VIEW_COLOR) m_color_mode = mode;
   else if (type == MAP_GRID_VIEW_SYMBOLS) m_symbol_mode = mode;
   else if (type == MAP_GRID_VIEW_TAGS) m_tag_mode = mode;
   else assert(false);
+  bool current = m_mode_current[mode];
+  m_mode_mutex.Unlock();
+  
+  // A mode that has not been kept up to date needs the population, which only the driver thread may touch
+  if (!current && m_driver) m_driver->RefreshMap();
+}
+
+
+Avida::Viewer::ConstMapSnapshotPtr Avida::Viewer::Map::CurrentSnapshot() const
+{
+  Apto::MutexAutoLock lock(m_snapshot_mutex);
+  return m_snapshot;
+}
+
+
+void Avida::Viewer::Map::findChangedCells(cPopulation& pop, bool& full)
+{
+  // A cell has changed when it holds a different organism, or when its organism divided (and so updated its last_*
+  // properties) since the last update
+  if (m_cell_org_ids.GetSize() != pop.GetSize()) {
+    m_cell_org_ids.Resize(pop.GetSize());
+    m_cell_divides.Resize(pop.GetSize());
+    full = true;
+  }
+  
+  m_changed_cells.Resize(0);
+  for (int i = 0; i < pop.GetSize(); i++) {
+    cOrganism* org = pop.GetCell(i).GetOrganism();
+    const int org_id = (org) ? org->GetID() : -1;
+    const int divides = (org) ? org->GetPhenotype().GetNumDivides() : 0;
+    if (full || org_id != m_cell_org_ids[i] || divides != m_cell_divides[i]) {
+      m_cell_org_ids[i] = org_id;
+      m_cell_divides[i] = divides;
+      m_changed_cells.Push(i);
+    }
+  }
+}
+
+
+Avida::Viewer::MapSnapshot* Avida::Viewer::Map::buildSnapshot(int update, int num_organisms) const
+{
+  // Must be called with the mode mutex held
+  MapSnapshot* snapshot = new MapSnapshot;
+  snapshot->m_update = update;
+  snapshot->m_width = m_width;
+  snapshot->m_height = m_height;
+  snapshot->m_num_organisms = num_organisms;
+  
+  fillLayer(snapshot->m_color, m_color_mode);
+  fillLayer(snapshot->m_symbol, m_symbol_mode);
+  fillLayer(snapshot->m_tag, m_tag_mode);
+  
+  return snapshot;
+}
+
+
+void Avida::Viewer::Map::fillLayer(MapLayer& layer, int mode) const
+{
+  layer.m_mode = mode;
+  if (mode < 0) return;
+  
+  const MapMode& map_mode = *m_view_modes[mode];
+  const DiscreteScale& scale = map_mode.GetScale();
+  
+  layer.m_values = map_mode.GetGridValues();
+  layer.m_counts = map_mode.GetValueCounts();
+  layer.m_scale_range = scale.GetScaleRange();
+  layer.m_categorical = scale.IsCategorical();
+  layer.m_scale_label = map_mode.GetScaleLabel();
+  layer.m_entries.Resize(scale.GetNumLabeledEntries());
+  for (int i = 0; i < layer.m_entries.GetSize(); i++) layer.m_entries[i] = scale.GetEntry(i);
+}
+
+
+void Avida::Viewer::Map::publishSnapshot(ConstMapSnapshotPtr snapshot)
+{
+  // Readers copy the pointer under this lock and release it immediately, the snapshot itself is never locked
+  Apto::MutexAutoLock lock(m_snapshot_mutex);
+  m_snapshot = snapshot;
 }
 
 
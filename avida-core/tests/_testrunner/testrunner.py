@@ -197,6 +197,10 @@ email =                  ; Email address for the test's creator
 [consistency]
 enabled = yes            ; Is this test a consistency test?
 long = no                ; Is this test a long test?
+; Arguments for a second run of the application, whose output files must all
+; match those of the first run.  Tests with comparison arguments are run even
+; without expected results.
+compare_args =
 
 [performance]
 enabled = no             ; Is this test a performance test?
@@ -413,6 +417,7 @@ class cTest:
       sys.exit(-1)
     
     self.args = self.getConfig("main", "args", "")
+    self.compare_args = self.getConfig("consistency", "compare_args", "")
     
     if self.getConfig("consistency", "enabled", "yes") in TRUE_STRINGS: self.consistency_enabled = True
     else: self.consistency_enabled = False
@@ -463,6 +468,93 @@ class cTest:
 
   
 
+  # bool cTest::runApp(string confdir, string rundir, string args) {
+  def runApp(self, confdir, rundir, args):
+    global settings
+    
+    # Create run directory and populate with config
+    try:
+      shutil.copytree(confdir, rundir)
+    except (IOError, OSError), e:
+      print "Error: unable to create run dir"
+      print "  -- root cause: %s" % e
+      self.success = False
+      return False
+      
+    self.scm.deleteMetadata(rundir)
+          
+
+    # Run test app, capturing output and exitcode
+    p = subprocess.Popen("cd %s; %s %s" % (rundir, self.app, args), shell=True, stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, close_fds=True)
+    
+    # Process output from app
+    # Note: must at least swallow app output so that the process output buffer does not fill and block execution
+    if settings.has_key("_verbose"): print
+    for line in p.stdout:
+      if settings.has_key("_verbose"):
+        sys.stdout.write("%s output: %s" % (self.name, line))
+        sys.stdout.flush()
+    
+    self.exitcode = p.wait()
+    
+
+    # Check exit code, depending on mode setting
+    nz = self.getConfig("main", "nonzeroexit", "disallow")
+    if (nz == "disallow" and self.exitcode != 0) or (nz == "require" and self.exitcode == 0):
+      self.success = False
+      return False
+    
+    return True
+  # } // End of cTest::runApp()
+  
+  
+  # (bool, string) cTest::compareFiles(string path, string expectpath) {
+  def compareFiles(self, path, expectpath):
+    global settings
+    
+    if not os.path.isfile(path) or not os.path.isfile(expectpath): return (False, cTest.NOTFOUND)
+    
+    # string[] getStippedLines(string filename) {
+    def getStrippedLines(filename):
+      fp = open(filename, "U")
+      filelines = fp.readlines()
+      fp.close()
+      
+      retlines = []
+      for line in filelines: 
+        line = string.lstrip(line)
+        if len(line) != 0 and line[0] != "#": retlines.append(line)
+      return retlines
+    # } // End of getStrippedLines()
+    
+    if os.path.getsize(expectpath) < settings['diff-max-threshold']:
+      # Generate the diff between the two files, ignoring comments and blank lines
+      differ = difflib.Differ()
+      elines = getStrippedLines(path)
+      tlines = getStrippedLines(expectpath)
+      diff = list(differ.compare(tlines, elines))
+
+      for line in diff:
+        if line[0] != ' ':
+          message = cTest.DONOTMATCH
+          if settings.has_key("show-diff"):
+            message += "\n\n"
+            for l in diff: message += l
+            message += "\n"
+          return (False, message)
+    else:
+      elines = getStrippedLines(path)
+      tlines = getStrippedLines(expectpath)
+      if len(elines) != len(tlines): return (False, cTest.DONOTMATCH)
+      for i in range(len(elines)):
+        if elines[i] != tlines[i]:
+          return (False, cTest.DONOTMATCH)
+    
+    return (True, "")
+  # } // End of cTest::compareFiles()
+  
+  
+
   # void cTest::runConsistencyTest() {
   def runConsistencyTest(self, dolongtest):
     global settings, tmpdir, CONFIGDIR, EXPECTDIR
@@ -477,8 +569,8 @@ class cTest:
       self.disabled = True
       return
     
-    # If no expected results exist and in slave mode
-    if not self.has_expected and settings["mode"] == "slave":
+    # If no expected results exist and in slave mode, only a comparison run can check the results
+    if not self.has_expected and settings["mode"] == "slave" and self.compare_args == "":
       self.result = "skipped (no expected results)"
       self.disabled = True
       return
@@ -500,41 +592,13 @@ class cTest:
       self.disabled = True
       return
       
-    # Create test directory and populate with config
-    try:
-      shutil.copytree(confdir, rundir)
-    except (IOError, OSError), e:
-      print "Error: unable to create run dir"
-      print "  -- root cause: %s" % e
-      self.success = False
+    # Run test app, capturing exitcode
+    if not self.runApp(confdir, rundir, self.args):
+      try:
+        shutil.rmtree(rundir, True) # Clean up test directory
+      except (IOError, OSError): pass
       return
       
-    self.scm.deleteMetadata(rundir)
-          
-
-    # Run test app, capturing output and exitcode
-    p = subprocess.Popen("cd %s; %s %s" % (rundir, self.app, self.args), shell=True, stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, close_fds=True)
-    
-    # Process output from app
-    # Note: must at least swallow app output so that the process output buffer does not fill and block execution
-    if settings.has_key("_verbose"): print
-    for line in p.stdout:
-      if settings.has_key("_verbose"):
-        sys.stdout.write("%s output: %s" % (self.name, line))
-        sys.stdout.flush()
-    
-    self.exitcode = p.wait()
-    
-
-    # Check exit code, depending on mode setting
-    nz = self.getConfig("main", "nonzeroexit", "disallow")
-    if (nz == "disallow" and self.exitcode != 0) or (nz == "require" and self.exitcode == 0):
-        self.success = False
-        try:
-          shutil.rmtree(rundir, True) # Clean up test directory
-        except (IOError, OSError): pass
-        return
-      
       
 
     # Build dictionary of config structure
@@ -545,7 +609,37 @@ class cTest:
         path = os.path.abspath(os.path.join(root, file))
         key = path[len(confdir) + 1:] # remove confdir from path
         confstruct[key] = path
+    
+    
+    # Run the app again with the comparison arguments, every output file of the two runs must match
+    if self.compare_args != "":
+      comparedir = rundir + "-compare"
+      if self.runApp(confdir, comparedir, self.compare_args):
+        outputs = {}
+        for dir in (rundir, comparedir):
+          for root, dirs, files in os.walk(dir):
+            for file in files:
+              key = os.path.abspath(os.path.join(root, file))[len(dir) + 1:] # remove run dir from path
+              if not confstruct.has_key(key): outputs[key] = True
+        
+        for key in outputs.keys():
+          match, message = self.compareFiles(os.path.join(rundir, key), os.path.join(comparedir, key))
+          if not match:
+            self.errors.append("%s : %s (compared with: %s)" % (key, message, self.compare_args))
+            self.success = False
+      else:
+        self.errors.append("comparison run failed (%s)" % self.compare_args)
         
+      try:
+        shutil.rmtree(comparedir, True) # Clean up comparison directory
+      except (IOError, OSError): pass
+      
+      if not self.success or (not self.has_expected and settings["mode"] == "slave"):
+        try:
+          shutil.rmtree(rundir, True) # Clean up test directory
+        except (IOError, OSError): pass
+        return
+      
       
     # If no expected results exist, defer processing of new expected results to results phase
     if not self.has_expected: 
@@ -570,48 +664,7 @@ class cTest:
         path = os.path.abspath(os.path.join(root, file))
         key = path[len(rundir) + 1:] # remove confdir from path
         if expectstruct.has_key(key):
-          # string[] getStippedLines(string filename) {
-          def getStrippedLines(filename):
-            fp = open(filename, "U")
-            filelines = fp.readlines()
-            fp.close()
-            
-            retlines = []
-            for line in filelines: 
-              line = string.lstrip(line)
-              if len(line) != 0 and line[0] != "#": retlines.append(line)
-            return retlines
-          # } // End of getStrippedLines()
-          
-          match = True
-          
-          
-          if os.path.getsize(expectstruct[key][0]) < settings['diff-max-threshold']:
-            # Generate the diff between the two files, ignoring comments and blank lines
-            differ = difflib.Differ()
-            elines = getStrippedLines(path)
-            tlines = getStrippedLines(expectstruct[key][0])
-            diff = list(differ.compare(tlines, elines))
-  
-            for line in diff:
-              if line[0] != ' ':
-                expectstruct[key][2] = cTest.DONOTMATCH
-                if settings.has_key("show-diff"):
-                  expectstruct[key][2] += "\n\n"
-                  for l in diff: expectstruct[key][2] += l
-                  expectstruct[key][2] += "\n"
-                match = False
-                break
-          else:
-            elines = getStrippedLines(path)
-            tlines = getStrippedLines(expectstruct[key][0])
-            for i in range(len(elines)):
-              if elines[i] != tlines[i]:
-                expectstruct[key][2] = cTest.DONOTMATCH
-                match = False
-                break
-          
-          expectstruct[key][1] = match
+          expectstruct[key][1], expectstruct[key][2] = self.compareFiles(path, expectstruct[key][0])
     
     for key in expectstruct.keys():
       entry = expectstruct[key]
@@ -830,7 +883,8 @@ class cTest:
       else:
         if self.handleNewExpected():
           if settings["mode"] == "slave":
-            print "skipped (no expected results)"
+            if self.compare_args != "": print self.result
+            else: print "skipped (no expected results)"
           else:
             print "new expected results generated"
         else: